@@ -17,13 +17,12 @@
 #include <fstream>
 #include <sys/stat.h>
 #include <fcntl.h>
-#include <termios.h>	
-#include <map>
 #include <string.h>
 #include <dirent.h>
 
 #include "utility/LinxDevice.h"
 #include "utility/LinxBeagleBone.h"
+#include "utility/LinxLog.h"
 #include "LinxBeagleBoneBlack.h"
 
 using namespace std;
@@ -49,7 +48,9 @@ const unsigned char LinxBeagleBoneBlack::m_DigitalChans[NUM_DIGITAL_CHANS] = { 7
 const unsigned char LinxBeagleBoneBlack::m_gpioChan[NUM_DIGITAL_CHANS] =     {66, 67, 69, 68, 45, 44, 47, 46, 27, 65, 61,      60, 48, 49, 115, 112};
 
 //PWM - Default to 7.x Layout, Updated B
-unsigned char LinxBeagleBoneBlack::m_PwmChans[NUM_PWM_CHANS] = {13, 19, 60, 62};
+const unsigned char LinxBeagleBoneBlack::m_PwmChans[NUM_PWM_CHANS] = {13, 19, 60, 62};
+string LinxBeagleBoneBlack::m_PwmDtoNames[NUM_PWM_CHANS] = {"bone_pwm_P8_13", "bone_pwm_P8_19", "bone_pwm_P9_14", "bone_pwm_P9_16"};		//7.x Only
+string LinxBeagleBoneBlack::m_PwmMuxPaths[NUM_PWM_CHANS] = {"/sys/devices/platform/ocp/ocp:P8_13_pinmux/state", "/sys/devices/platform/ocp/ocp:P8_19_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_14_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_16_pinmux/state"};		//8.x And Later
 //unsigned char LinxBeagleBoneBlack::m_PwmChips[NUM_PWM_CHANS] = {6, 5, 3, 4};
 //unsigned long m_PwmDefaultPeriod = 500000;
 //string LinxBeagleBoneBlack::m_PwmExportPaths = "/sys/class/pwm/export";
@@ -63,26 +64,34 @@ unsigned char LinxBeagleBoneBlack::m_PwmChans[NUM_PWM_CHANS] = {13, 19, 60, 62};
 //SPI
 string m_SpiPaths[NUM_SPI_CHANS] = { "/dev/spidev1.1"};
 string m_SpiDtoNames[NUM_SPI_CHANS] = { "BB-SPIDEV0"};
-unsigned char LinxBeagleBoneBlack::m_SpiChans[NUM_SPI_CHANS] = {0};
+string m_SpiMuxPaths[3] = {"/sys/devices/platform/ocp/ocp:P9_18_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_21_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_22_pinmux/state"};		//8.x And Later, SCLK Last
+const unsigned char LinxBeagleBoneBlack::m_SpiChans[NUM_SPI_CHANS] = {0};
 unsigned long LinxBeagleBoneBlack::m_SpiSupportedSpeeds[NUM_SPI_SPEEDS] = {7629, 15200, 30500, 61000, 122000, 244000, 488000, 976000, 1953000, 3900000, 7800000, 15600000, 31200000};
 int LinxBeagleBoneBlack::m_SpiSpeedCodes[NUM_SPI_SPEEDS] = {7629, 15200, 30500, 61000, 122000, 244000, 488000, 976000, 1953000, 3900000, 7800000, 15600000, 31200000};
 
 //I2C
-unsigned char LinxBeagleBoneBlack::m_I2cChans[NUM_I2C_CHANS] = {2};
+const unsigned char LinxBeagleBoneBlack::m_I2cChans[NUM_I2C_CHANS] = {2};
 unsigned char LinxBeagleBoneBlack::m_I2cRefCount[NUM_I2C_CHANS];
 string m_I2cPaths[NUM_I2C_CHANS] = {"/dev/i2c-1" };		//Out of order numbering is correct for BBB 7.x!!
 string m_I2cDtoNames[NUM_I2C_CHANS] = {"BB-I2C2"};
 
 //UART
 string m_UartDtoNames[NUM_UART_CHANS] = {"BB-UART0", "BB-UART1", "BB-UART4"};
-unsigned char LinxBeagleBoneBlack::m_UartChans[NUM_UART_CHANS] = {0, 1, 4};
+const unsigned char LinxBeagleBoneBlack::m_UartChans[NUM_UART_CHANS] = {0, 1, 4};
 string LinxBeagleBoneBlack::m_UartPaths[NUM_UART_CHANS] = { "/dev/ttyO0", "/dev/ttyO1", "/dev/ttyO4"};
-unsigned long LinxBeagleBoneBlack::m_UartSupportedSpeeds[NUM_UART_SPEEDS] = {0, 50, 75, 110, 134, 150, 200, 300, 600, 1200, 1800, 2400, 4800, 9600, 19200, 38400, 57600, 115200};
-unsigned long LinxBeagleBoneBlack::m_UartSupportedSpeedsCodes[NUM_UART_SPEEDS] = {B0, B50, B75, B110, B134, B150, B200, B300, B600, B1200, B1800, B2400, B4800, B9600, B19200, B38400, B57600, B115200};
+string m_UartMuxPaths[NUM_UART_CHANS][2] = {{"", ""}, {"/sys/devices/platform/ocp/ocp:P9_24_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_26_pinmux/state"}, {"/sys/devices/platform/ocp/ocp:P9_11_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_13_pinmux/state"}};		//8.x And Later, UART0 Is The Console
 
 //SERVO
 //None
 
+//Channel Slots - Built At Compile Time From The Channel Lists Above
+constexpr LinxChannelSlots LinxBeagleBoneBlack::m_AiSlots(NUM_AI_CHANS, LinxBeagleBoneBlack::m_AiChans);
+constexpr LinxChannelSlots LinxBeagleBoneBlack::m_DigitalSlots(NUM_DIGITAL_CHANS, LinxBeagleBoneBlack::m_DigitalChans);
+constexpr LinxChannelSlots LinxBeagleBoneBlack::m_PwmSlots(NUM_PWM_CHANS, LinxBeagleBoneBlack::m_PwmChans);
+constexpr LinxChannelSlots LinxBeagleBoneBlack::m_SpiSlots(NUM_SPI_CHANS, LinxBeagleBoneBlack::m_SpiChans);
+constexpr LinxChannelSlots LinxBeagleBoneBlack::m_I2cSlots(NUM_I2C_CHANS, LinxBeagleBoneBlack::m_I2cChans);
+constexpr LinxChannelSlots LinxBeagleBoneBlack::m_UartSlots(NUM_UART_CHANS, LinxBeagleBoneBlack::m_UartChans);
+
 /****************************************************************************************
 **  Constructors /  Destructor
 ****************************************************************************************/
@@ -129,21 +138,18 @@ LinxBeagleBoneBlack::LinxBeagleBoneBlack()
 	//Shared Non Varying Components
 	
 	unsigned long m_PwmDefaultPeriod = 500000;	
-	string m_PolarityFileName = "polarity";
-	
-	//7.x Only
-	string m_PwmDtoNames[NUM_PWM_CHANS] = {"bone_pwm_P8_13", "bone_pwm_P8_19", "bone_pwm_P9_14", "bone_pwm_P9_16"};
-		
-	//8.x Only
-	string m_PwmMuxPaths[NUM_PWM_CHANS] = {"/sys/devices/platform/ocp/ocp:P8_13_pinmux/state", "/sys/devices/platform/ocp/ocp:P8_19_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_14_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_16_pinmux/state"};
-	string m_SpiMuxPaths[3] = {"/sys/devices/platform/ocp/ocp:P9_18_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_21_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_22_pinmux/state"};
-	string m_UartMuxPaths[4] = {"/sys/devices/platform/ocp/ocp:P9_24_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_26_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_11_pinmux/state", "/sys/devices/platform/ocp/ocp:P9_13_pinmux/state"};
-
 	
 	//Shared, Varying Components - Default To 7.x
-	string m_PwmExportPaths[NUM_PWM_CHANS] = {"/sys/class/pwm/export", "/sys/class/pwm/export", "/sys/class/pwm/export", "/sys/class/pwm/export"};
-	unsigned char m_PwmExportVal[NUM_PWM_CHANS] = {6, 5, 3, 4};
-	string m_PwmDirPaths[NUM_PWM_CHANS] = {"/sys/class/pwm/pwm6/", "/sys/class/pwm/pwm5/", "/sys/class/pwm/pwm3/", "/sys/class/pwm/pwm4/"};
+	const unsigned char pwmExportVals7[NUM_PWM_CHANS] = {6, 5, 3, 4};
+	const char* pwmDirPaths7[NUM_PWM_CHANS] = {"/sys/class/pwm/pwm6/", "/sys/class/pwm/pwm5/", "/sys/class/pwm/pwm3/", "/sys/class/pwm/pwm4/"};
+	for(int i=0; i<NUM_PWM_CHANS; i++)
+	{
+		m_PwmExportPaths[i] = "/sys/class/pwm/export";
+		m_PwmExportVal[i] = pwmExportVals7[i];
+		m_PwmDirPaths[i] = pwmDirPaths7[i];
+		m_PwmReady[i] = false;
+	}
+	m_PwmChipLoaded = false;
 	string m_DutyCycleFileName = "duty_ns";
 	string m_PeriodFileName = "period_ns";
 	m_EnableFileName = "run";
@@ -272,10 +278,7 @@ LinxBeagleBoneBlack::LinxBeagleBoneBlack()
 	//UART
 	NumUartChans = NUM_UART_CHANS;
 	UartChans = m_UartChans;	
-	UartMaxBaud = m_UartSupportedSpeeds[NUM_UART_SPEEDS - 1];
-	NumUartSpeeds = NUM_UART_SPEEDS;
-	UartSupportedSpeeds = m_UartSupportedSpeeds;
-	UartSupportedSpeedsCodes = m_UartSupportedSpeedsCodes;
+	UartMaxBaud = UART_MAX_BAUD;
 
 	//I2C
 	NumI2cChans = NUM_I2C_CHANS;	
@@ -296,203 +299,36 @@ LinxBeagleBoneBlack::LinxBeagleBoneBlack()
 	//SERVO
 	NumServoChans = 0;
 	
+	//Overlays, Exports And Pinmux Happen On First Use Of Each Channel So Startup Does Not Wait On Hardware
+	
 	//------------------------------------- ANALOG -------------------------------------
-	//Export Dev Tree Overlay For AI If It DNE And Open AI Handles
-	bool dtoLoaded = false;
-	if(!fileExists("/sys/bus/iio/devices/iio:device0"))
-	{
-		if(loadDto("BB-ADC"))
-		{
-			dtoLoaded = true;			
-		}
-		else
-		{
-			DebugPrintln("AI Fail - Failed To Load BB-ADC DTO");
-		}
-	}
-	else
+	bindAiSlots(&m_AiSlots);
+	for(int i=0; i<NUM_AI_CHANS; i++)
 	{
-		//DTO Already Loaded
-		dtoLoaded = true;
+		AiValuePaths[m_AiChans[i]] = m_AiValuePaths[i];
+		AiValueHandles[m_AiChans[i]] = NULL;
 	}
 	
-	if(dtoLoaded)
-	{
-		//Open AI Handles		
-		for(int i=0; i<NUM_AI_CHANS; i++)
-		{
-			AiValuePaths[m_AiChans[i]] = m_AiValuePaths[i];
-			AiValueHandles[m_AiChans[i]] = fopen(m_AiValuePaths[i].c_str(), "r+");
-			
-			if(AiValueHandles[m_AiChans[i]] <= 0)
-			{
-				DebugPrintln("AI Fail - Failed Open AI Channel Handle");
-			}			
-		}
-	}	
-	
 	//------------------------------------- DIGITAL -------------------------------------
-	//Export GPIO - Set All Digital Handles To NULL
+	bindDigitalSlots(&m_DigitalSlots);
 	for(int i=0; i<NUM_DIGITAL_CHANS; i++)
 	{
-		char gpioPath[64];
-		sprintf(gpioPath, "/sys/class/gpio/gpio%d", m_gpioChan[i]);
-		if (!fileExists(gpioPath)) {
-			FILE* digitalExportHandle = fopen("/sys/class/gpio/export", "w");
-			if(digitalExportHandle != NULL)
-			{
-				fprintf(digitalExportHandle, "%d", m_gpioChan[i]);
-				fclose(digitalExportHandle);
-			}
-		}
 		DigitalDirHandles[m_DigitalChans[i]] = NULL;
 		DigitalValueHandles[m_DigitalChans[i]] = NULL;
 		DigitalChannels[m_DigitalChans[i]] = m_gpioChan[i];
 	}
 	
 	//------------------------------------- PWM -------------------------------------
-	
-	//PWM General Initialization
-	if(FilePathLayout == 7)
-	{
-		//Load AM33xx_PWM DTO If No PWM Channels Have Been Exported Since Boot
-		if(!fileExists(m_PwmDirPaths[NUM_PWM_CHANS-1].c_str(), m_PeriodFileName.c_str()))
-		{
-			if(!loadDto("am33xx_pwm"))
-			{
-				DebugPrintln("PWM Fail - Failed To Load am33xx_pwm DTO");
-			}
-			
-			//Export PWM Channels Before Loading Channel Specific DTOs Below
-			/*
-			for(int i=0; i< NUM_PWM_CHANS; i++)
-			{
-				
-			}
-			*/
-		}
-	}
-	else if(FilePathLayout >= 8)
-	{
-		//Set Mux to PWM
-		for(int i=0; i<NUM_PWM_CHANS; i++)
-		{
-			FILE* pwmMuxHandle = fopen(m_PwmMuxPaths[i].c_str(), "r+w+");
-			if(pwmMuxHandle != NULL)
-			{
-				fprintf(pwmMuxHandle, "pwm");
-				fclose(pwmMuxHandle);							
-			}
-		}
-	}
-	
-	//Per Pin Initialization
+	bindPwmSlots(&m_PwmSlots);
 	for(int i=0; i<NUM_PWM_CHANS; i++)
 	{
-		//Store Default Values
 		PwmDirPaths[m_PwmChans[i]] = m_PwmDirPaths[i];
 		PwmPeriods[m_PwmChans[i]] = m_PwmDefaultPeriod;
-		
-		//Export PWM Channels - This Must Happend Before 7.x Loads Channel Specific DTOs
-		if(!fileExists(m_PwmDirPaths[i].c_str(), m_PeriodFileName.c_str()))
-		{
-			FILE* pwmExportHandle = fopen(m_PwmExportPaths[i].c_str(), "w");
-			if(pwmExportHandle != NULL)
-			{
-				fprintf(pwmExportHandle, "%u", m_PwmExportVal[i]);
-				fclose(pwmExportHandle);
-			}
-			else
-			{
-				DebugPrintln("PWM Fail - Unable to open pwmExportHandle");
-			}
-
-			//Set Default Period Only First Time
-			char periodPath[64];
-			sprintf(periodPath, "%s%s", m_PwmDirPaths[i].c_str(), m_PeriodFileName.c_str());
-			
-			FILE* pwmPeriodleHandle = fopen(periodPath, "r+w+");
-			if(pwmPeriodleHandle != NULL)
-			{
-				fprintf(pwmPeriodleHandle, "%lu", m_PwmDefaultPeriod);
-				fclose(pwmPeriodleHandle);							
-			}
-			else
-			{
-				DebugPrintln("PWM Fail - Unable to open pwmPeriodHandle");
-			}
-		}
-		
-		//7.x Per Pin Init
-		if(FilePathLayout == 7)
-		{	
-			//Load Chip Specific PWM DTO If Not Already Loaded
-			if(!loadDto(m_PwmDtoNames[i].c_str()))
-			{
-				DebugPrint("PWM Fail - Failed To Load PWM DTO ");
-				DebugPrintln(m_PwmDtoNames[i].c_str());
-			}
-			
-			//Make Sure DTO Has Time To Load Before Opening Handles
-			else if(!fileExists(m_PwmDirPaths[i].c_str(), "period_ns", 3000))
-			{
-				DebugPrint("PWM Fail - PWM DTO Did Not Load Correctly: ");				
-				DebugPrintln(m_PwmDirPaths[i].c_str());				
-			}		
-		}
-		//Export PWM Chans.  If 7.x layout this is done above.  This should probably be moved.
-		if(FilePathLayout >= 8)
-		{
-			//Nothing 8.x Specific For Now
-		}
-		
-		//Set Polarity To 0 So PWM Value Corresponds To 'Percent On' Rather Than 'Percent Off'
-		char polarityPath[64];
-		sprintf(polarityPath, "%s%s", PwmDirPaths[m_PwmChans[i]].c_str(), m_PolarityFileName.c_str());
-		
-		FILE* pwmPolarityHandle = fopen(polarityPath, "w");
-		if(pwmPolarityHandle != NULL)
-		{
-			fprintf(pwmPolarityHandle, "0");
-			fclose(pwmPolarityHandle);
-		}
-		else
-		{
-			DebugPrint("PWM Fail - Unable to open pwmPolarityHandle");				
-		}
-			
-		//Set Default Duty Cycle To 0	
-		char dutyCyclePath[64];
-		sprintf(dutyCyclePath, "%s%s", PwmDirPaths[m_PwmChans[i]].c_str(), m_DutyCycleFileName.c_str());			
-		
-		FILE* pwmDutyCycleHandle = fopen(dutyCyclePath, "r+w+");
-		if(pwmDutyCycleHandle != NULL)
-		{
-			fprintf(pwmDutyCycleHandle, "0");
-			fclose(pwmDutyCycleHandle);
-		}
-		else
-		{
-			DebugPrint("PWM Fail - Unable to open pwmDutyCycleHandle");				
-		}		
-		
-		//Turn On PWM		
-		char enablePath[64];
-		sprintf(enablePath, "%s%s", PwmDirPaths[m_PwmChans[i]].c_str(), m_EnableFileName.c_str());			
-		FILE* pwmEnableHandle = fopen(enablePath, "r+w+");
-		if(pwmEnableHandle != NULL)
-		{
-			fprintf(pwmEnableHandle, "1");
-			fclose(pwmEnableHandle);		
-		}
-		else
-		{
-			DebugPrint("PWM Fail - Unable to open pwmEnableHandle");				
-		}	
-	}	
+	}
 	
 	//------------------------------------- I2C -------------------------------------
-	//Store I2C Master Paths In Map
+	//Store I2C Master Paths
+	bindI2cSlots(&m_I2cSlots);
 	for(int i=0; i<NUM_I2C_CHANS; i++)
 	{	
 		I2cPaths[I2cChans[i]] = m_I2cPaths[i];
@@ -500,20 +336,7 @@ LinxBeagleBoneBlack::LinxBeagleBoneBlack()
 	}
 	
 	//------------------------------------- UART ------------------------------------
-	if(FilePathLayout >= 8)
-	{
-		//Set Mux to UART
-		for(int i=0; i<4; i++)
-		{
-			FILE* uartMuxHandle = fopen(m_UartMuxPaths[i].c_str(), "r+w+");
-			if(uartMuxHandle != NULL)
-			{
-				fprintf(uartMuxHandle, "uart");
-				fclose(uartMuxHandle);							
-			}
-		}
-	}
-	
+	bindUartSlots(&m_UartSlots);
 	for(int i=0; i<NUM_UART_CHANS; i++)
 	{
 		UartPaths[m_UartChans[i]] = m_UartPaths[i];
@@ -521,33 +344,10 @@ LinxBeagleBoneBlack::LinxBeagleBoneBlack()
 		UartDtoNames[m_UartChans[i]] = m_UartDtoNames[i];
 	}
 	
-	
 	//------------------------------------- SPI ------------------------------------
-	if(FilePathLayout >= 8)
-	{
-		//Set Mux to SPI
-		for(int i=0; i<3; i++)
-		{
-			FILE* spiMuxHandle = fopen(m_SpiMuxPaths[i].c_str(), "r+w+");
-			if(spiMuxHandle != NULL)
-			{
-				// in later debian versions the state value for the clk line changed
-				if (FilePathLayout == 8)
-					fprintf(spiMuxHandle, "spi");
-				else if (FilePathLayout >= 9 && (i%3) < 2)
-					fprintf(spiMuxHandle, "spi");
-				else if (FilePathLayout >= 9 && (i%3) == 2)
-					fprintf(spiMuxHandle, "spi_sclk");  // assume last mux path is the sclk
-				else
-					DebugPrint("SPI Fail - Unexpected SpiMuxPath");
-				fclose(spiMuxHandle);
-			}
-		}
-	}
-
-	
 	//Load SPI Paths and DTO Names, Configure SPI Master Default Values	
 	SpiDefaultSpeed = 3900000;
+	bindSpiSlots(&m_SpiSlots);
 	for(int i=0; i<NUM_SPI_CHANS; i++)
 	{
 		SpiDtoNames[SpiChans[i]] = m_SpiDtoNames[i];
@@ -557,9 +357,7 @@ LinxBeagleBoneBlack::LinxBeagleBoneBlack()
 		SpiPaths[SpiChans[i]] = m_SpiPaths[i];
 	}
 	
-	
-	
-	//If Debugging Is Enabled Call EnableDebug()
+		//If Debugging Is Enabled Call EnableDebug()
 	#if DEBUG_ENABLED >= 0
 		EnableDebug(DEBUG_ENABLED);
 	#endif
@@ -571,7 +369,7 @@ LinxBeagleBoneBlack::~LinxBeagleBoneBlack()
 	//Close AI Handles
 	for(int i=0; i<NUM_AI_CHANS; i++)
 	{
-		if(AiValueHandles[m_AiChans[i]] != 0)
+		if(AiValueHandles[m_AiChans[i]] != NULL)
 		{
 			fclose(AiValueHandles[m_AiChans[i]]);
 		}
@@ -602,6 +400,11 @@ LinxBeagleBoneBlack::~LinxBeagleBoneBlack()
 	//Close PWM Handles If Open
 	for(int i=0; i<NUM_PWM_CHANS; i++)
 	{
+		if(!m_PwmReady[i])
+		{
+			continue;
+		}
+		
 		if(PwmPeriodHandles[m_PwmChans[i]] != NULL)
 		{
 			fclose(PwmPeriodHandles[m_PwmChans[i]]);
@@ -623,7 +426,7 @@ LinxBeagleBoneBlack::~LinxBeagleBoneBlack()
 		}
 		else
 		{
-			DebugPrint("PWM Fail - Unable to open pwmEnableHandle");
+			LINX_LOG_ERROR("PWM Fail - Unable to open pwmEnableHandle");
 		}
 	}
 	
@@ -642,7 +445,7 @@ LinxBeagleBoneBlack::~LinxBeagleBoneBlack()
 	{
 		if(UartHandles[m_UartChans[i]] != 0)
 		{	
-			close(UartHandles[m_UartChans[i]]);
+			UartClose(m_UartChans[i]);
 		}
 	}
 	
@@ -652,4 +455,205 @@ LinxBeagleBoneBlack::~LinxBeagleBoneBlack()
 /****************************************************************************************
 **  Functions
 ****************************************************************************************/
+//Set Up A PWM Channel The First Time It Is Used.  Every Channel Is Exported And Its Overlay Queued Before
+//Waiting On Any Of Them, So Overlays For Several Channels Load Concurrently.
+int LinxBeagleBoneBlack::pwmSmartOpen(unsigned char numChans, unsigned char* channels)
+{
+	bool pending[NUM_PWM_CHANS] = {false};
+	bool anyPending = false;
+	
+	for(int c=0; c<numChans; c++)
+	{
+		int i = pwmIndex(channels[c]);
+		if(i < 0 || m_PwmReady[i] || pending[i])
+		{
+			continue;
+		}
+		pending[i] = true;
+		anyPending = true;
+		
+		if(FilePathLayout == 7 && !m_PwmChipLoaded)
+		{
+			//Load AM33xx_PWM DTO If No PWM Channels Have Been Exported Since Boot
+			if(!fileExists(m_PwmDirPaths[NUM_PWM_CHANS-1].c_str(), PwmPeriodFileName.c_str()) && !loadDto("am33xx_pwm"))
+			{
+				LINX_LOG_ERROR("PWM Fail - Failed To Load am33xx_pwm DTO");
+			}
+			m_PwmChipLoaded = true;
+		}
+		else if(FilePathLayout >= 8)
+		{
+			//Set Mux to PWM
+			FILE* pwmMuxHandle = fopen(m_PwmMuxPaths[i].c_str(), "r+w+");
+			if(pwmMuxHandle != NULL)
+			{
+				fprintf(pwmMuxHandle, "pwm");
+				fclose(pwmMuxHandle);							
+			}
+		}
+		
+		//Export PWM Channels - This Must Happend Before 7.x Loads Channel Specific DTOs
+		if(!fileExists(m_PwmDirPaths[i].c_str(), PwmPeriodFileName.c_str()))
+		{
+			FILE* pwmExportHandle = fopen(m_PwmExportPaths[i].c_str(), "w");
+			if(pwmExportHandle != NULL)
+			{
+				fprintf(pwmExportHandle, "%u", m_PwmExportVal[i]);
+				fclose(pwmExportHandle);
+			}
+			else
+			{
+				LINX_LOG_ERROR("PWM Fail - Unable to open pwmExportHandle");
+			}
+
+			//Set Default Period Only First Time
+			char periodPath[64];
+			sprintf(periodPath, "%s%s", m_PwmDirPaths[i].c_str(), PwmPeriodFileName.c_str());
+			
+			FILE* pwmPeriodleHandle = fopen(periodPath, "r+w+");
+			if(pwmPeriodleHandle != NULL)
+			{
+				fprintf(pwmPeriodleHandle, "%lu", PwmDefaultPeriod);
+				fclose(pwmPeriodleHandle);							
+			}
+			else
+			{
+				LINX_LOG_ERROR("PWM Fail - Unable to open pwmPeriodHandle");
+			}
+		}
+		
+		//7.x Loads A Chip Specific PWM DTO Per Channel
+		if(FilePathLayout == 7 && !loadDto(m_PwmDtoNames[i].c_str()))
+		{
+			LINX_LOG_ERROR("PWM Fail - Failed To Load PWM DTO %s", m_PwmDtoNames[i].c_str());
+		}
+	}
+	
+	for(int i=0; anyPending && i<NUM_PWM_CHANS; i++)
+	{
+		if(!pending[i])
+		{
+			continue;
+		}
+		
+		//Make Sure DTO Has Time To Load Before Opening Handles
+		if(!fileExists(m_PwmDirPaths[i].c_str(), PwmPeriodFileName.c_str(), DTO_LOAD_TIMEOUT))
+		{
+			LINX_LOG_ERROR("PWM Fail - PWM DTO Did Not Load Correctly: %s", m_PwmDirPaths[i].c_str());
+		}
+		
+		//Set Polarity To 0 So PWM Value Corresponds To 'Percent On' Rather Than 'Percent Off'
+		char polarityPath[64];
+		sprintf(polarityPath, "%s%s", m_PwmDirPaths[i].c_str(), "polarity");
+		
+		FILE* pwmPolarityHandle = fopen(polarityPath, "w");
+		if(pwmPolarityHandle != NULL)
+		{
+			fprintf(pwmPolarityHandle, "0");
+			fclose(pwmPolarityHandle);
+		}
+		else
+		{
+			LINX_LOG_ERROR("PWM Fail - Unable to open pwmPolarityHandle");
+		}
+			
+		//Set Default Duty Cycle To 0	
+		char dutyCyclePath[64];
+		sprintf(dutyCyclePath, "%s%s", m_PwmDirPaths[i].c_str(), PwmDutyCycleFileName.c_str());			
+		
+		FILE* pwmDutyCycleHandle = fopen(dutyCyclePath, "r+w+");
+		if(pwmDutyCycleHandle != NULL)
+		{
+			fprintf(pwmDutyCycleHandle, "0");
+			fclose(pwmDutyCycleHandle);
+		}
+		else
+		{
+			LINX_LOG_ERROR("PWM Fail - Unable to open pwmDutyCycleHandle");
+		}		
+		
+		//Turn On PWM		
+		char enablePath[64];
+		sprintf(enablePath, "%s%s", m_PwmDirPaths[i].c_str(), m_EnableFileName.c_str());			
+		FILE* pwmEnableHandle = fopen(enablePath, "r+w+");
+		if(pwmEnableHandle != NULL)
+		{
+			fprintf(pwmEnableHandle, "1");
+			fclose(pwmEnableHandle);		
+		}
+		else
+		{
+			LINX_LOG_ERROR("PWM Fail - Unable to open pwmEnableHandle");
+		}
+		
+		m_PwmReady[i] = true;
+	}
+	
+	return LinxBeagleBone::pwmSmartOpen(numChans, channels);
+}
+
+void LinxBeagleBoneBlack::uartPinmux(unsigned char channel)
+{
+	if(FilePathLayout < 8)
+	{
+		return;
+	}
+	
+	for(int i=0; i<NUM_UART_CHANS; i++)
+	{
+		if(m_UartChans[i] != channel)
+		{
+			continue;
+		}
+		
+		//Set Mux to UART
+		for(int j=0; j<2; j++)
+		{
+			FILE* uartMuxHandle = (m_UartMuxPaths[i][j] == "") ? NULL : fopen(m_UartMuxPaths[i][j].c_str(), "r+w+");
+			if(uartMuxHandle != NULL)
+			{
+				fprintf(uartMuxHandle, "uart");
+				fclose(uartMuxHandle);							
+			}
+		}
+	}
+}
 
+void LinxBeagleBoneBlack::spiPinmux(unsigned char channel)
+{
+	if(FilePathLayout < 8)
+	{
+		return;
+	}
+	
+	//Set Mux to SPI
+	for(int i=0; i<3; i++)
+	{
+		FILE* spiMuxHandle = fopen(m_SpiMuxPaths[i].c_str(), "r+w+");
+		if(spiMuxHandle != NULL)
+		{
+			// in later debian versions the state value for the clk line changed
+			if (FilePathLayout == 8)
+				fprintf(spiMuxHandle, "spi");
+			else if (FilePathLayout >= 9 && (i%3) < 2)
+				fprintf(spiMuxHandle, "spi");
+			else if (FilePathLayout >= 9 && (i%3) == 2)
+				fprintf(spiMuxHandle, "spi_sclk");  // assume last mux path is the sclk
+			else
+				LINX_LOG_ERROR("SPI Fail - Unexpected SpiMuxPath");
+			fclose(spiMuxHandle);
+		}
+	}
+}
+
+int LinxBeagleBoneBlack::pwmIndex(unsigned char channel)
+{
+	for(int i=0; i<NUM_PWM_CHANS; i++)
+	{
+		if(m_PwmChans[i] == channel)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
@@ -32,7 +32,7 @@
 #define NUM_I2C_CHANS 1
 
 #define NUM_UART_CHANS 3
-#define NUM_UART_SPEEDS 18
+#define UART_MAX_BAUD 3686400
 
 #define NUM_SERVO_CHANS 0
 
@@ -41,7 +41,6 @@
 ****************************************************************************************/	
 #include "utility/LinxDevice.h"
 #include "utility/LinxBeagleBone.h"
-#include <map>
 #include <string>
 
 using namespace std;
@@ -70,32 +69,42 @@ class LinxBeagleBoneBlack : public LinxBeagleBone
 		static const unsigned char m_gpioChan[NUM_DIGITAL_CHANS];
 		
 		//PWM
-		static unsigned char m_PwmChans[NUM_PWM_CHANS];
+		static const unsigned char m_PwmChans[NUM_PWM_CHANS];
 		string m_PwmDirPaths[NUM_PWM_CHANS];
+		string m_PwmExportPaths[NUM_PWM_CHANS];
+		unsigned char m_PwmExportVal[NUM_PWM_CHANS];
+		bool m_PwmReady[NUM_PWM_CHANS];							//Exported, Overlay Loaded And Enabled
+		bool m_PwmChipLoaded;											//7.x am33xx_pwm Overlay Checked
 		static string m_PwmDtoNames[NUM_PWM_CHANS];
 		static string m_PwmMuxPaths[NUM_PWM_CHANS];
 		string m_EnableFileName;
 		unsigned char m_PwmPeriods[NUM_PWM_CHANS];
 		
 		//SPI
-		static unsigned char m_SpiChans[NUM_SPI_CHANS];
+		static const unsigned char m_SpiChans[NUM_SPI_CHANS];
 		static int m_SpiHandles[NUM_SPI_CHANS];
 		static unsigned long m_SpiSupportedSpeeds[NUM_SPI_SPEEDS];
 		static int m_SpiSpeedCodes[NUM_SPI_SPEEDS];
 				
 		//I2C
-		static unsigned char m_I2cChans[NUM_I2C_CHANS];
+		static const unsigned char m_I2cChans[NUM_I2C_CHANS];
 		static unsigned char m_I2cRefCount[NUM_I2C_CHANS];
 		
 		//UART
-		static unsigned char m_UartChans[NUM_UART_CHANS];
-		static unsigned long m_UartSupportedSpeeds[NUM_UART_SPEEDS];
-		static unsigned long m_UartSupportedSpeedsCodes[NUM_UART_SPEEDS];
+		static const unsigned char m_UartChans[NUM_UART_CHANS];
 		static int m_UartHandles[NUM_UART_CHANS];
 		static string m_UartPaths[NUM_UART_CHANS];
 		
 		//Servo		
 		//none
+
+		//Channel Slots
+		static const LinxChannelSlots m_AiSlots;
+		static const LinxChannelSlots m_DigitalSlots;
+		static const LinxChannelSlots m_PwmSlots;
+		static const LinxChannelSlots m_SpiSlots;
+		static const LinxChannelSlots m_I2cSlots;
+		static const LinxChannelSlots m_UartSlots;
 		
 		/****************************************************************************************
 		**  Constructors /  Destructor
@@ -116,6 +125,15 @@ class LinxBeagleBoneBlack : public LinxBeagleBone
 		/****************************************************************************************
 		**  Functions
 		****************************************************************************************/
+		int pwmIndex(unsigned char channel);
+		
+	protected:
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		virtual int pwmSmartOpen(unsigned char numChans, unsigned char* channels);
+		virtual void uartPinmux(unsigned char channel);
+		virtual void spiPinmux(unsigned char channel);
 				
 };
 
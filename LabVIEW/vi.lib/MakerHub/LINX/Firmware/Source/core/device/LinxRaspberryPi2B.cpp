@@ -12,7 +12,6 @@
 /****************************************************************************************
 **  Includes
 ****************************************************************************************/		
-#include <termios.h>
 #include <unistd.h>
 
 #include "utility/LinxDevice.h"
@@ -37,7 +36,8 @@ const unsigned char LinxRaspberryPi2B::m_DigitalChans[NUM_DIGITAL_CHANS] = {7, 1
 const unsigned int LinxRaspberryPi2B::m_gpioChan[NUM_DIGITAL_CHANS] =     {4, 17, 18, 27, 22, 23, 24, 25, 5, 6, 12, 13, 19, 16, 26, 20, 21};
 
 //PWM
-//None
+const unsigned char LinxRaspberryPi2B::m_PwmChans[NUM_PWM_CHANS] = {12, 35};
+const unsigned char LinxRaspberryPi2B::m_PwmChipChans[NUM_PWM_CHANS] = {0, 1};		//GPIO 18 / 19 On pwmchip0 (dtoverlay=pwm-2chan)
 
 //QE
 //None
@@ -45,23 +45,30 @@ const unsigned int LinxRaspberryPi2B::m_gpioChan[NUM_DIGITAL_CHANS] =     {4, 17
 //SPI
 const unsigned char LinxRaspberryPi2B::m_SpiChans[NUM_SPI_CHANS] = {0};
 string m_SpiPaths[NUM_SPI_CHANS] = { "/dev/spidev0.1"};
+const unsigned char LinxRaspberryPi2B::m_SpiHwCsChans[NUM_SPI_CHANS] = {26};		//spidev0.1 Drives CE1 (GPIO 7, Header Pin 26)
 unsigned long LinxRaspberryPi2B::m_SpiSupportedSpeeds[NUM_SPI_SPEEDS] = {7629, 15200, 30500, 61000, 122000, 244000, 488000, 976000, 1953000, 3900000, 7800000, 15600000, 31200000};
 int LinxRaspberryPi2B::m_SpiSpeedCodes[NUM_SPI_SPEEDS] = {7629, 15200, 30500, 61000, 122000, 244000, 488000, 976000, 1953000, 3900000, 7800000, 15600000, 31200000};
 
 //I2C
-unsigned char LinxRaspberryPi2B::m_I2cChans[NUM_I2C_CHANS] = {1};
+const unsigned char LinxRaspberryPi2B::m_I2cChans[NUM_I2C_CHANS] = {1};
 string m_I2cPaths[NUM_I2C_CHANS] = {"/dev/i2c-1"};
 unsigned char LinxRaspberryPi2B::m_I2cRefCount[NUM_I2C_CHANS];
 
 //UART
-unsigned char LinxRaspberryPi2B::m_UartChans[NUM_UART_CHANS] = {0};
+const unsigned char LinxRaspberryPi2B::m_UartChans[NUM_UART_CHANS] = {0};
 int LinxRaspberryPi2B::m_UartHandles[NUM_UART_CHANS];
 string LinxRaspberryPi2B::m_UartPaths[NUM_UART_CHANS] = {"/dev/serial0"};
-unsigned long LinxRaspberryPi2B::m_UartSupportedSpeeds[NUM_UART_SPEEDS] = {0, 50, 75, 110, 134, 150, 200, 300, 600, 1200, 1800, 2400, 4800, 9600, 19200, 38400, 57600, 115200};
-unsigned long LinxRaspberryPi2B::m_UartSupportedSpeedsCodes[NUM_UART_SPEEDS] = {B0, B50, B75, B110, B134, B150, B200, B300, B600, B1200, B1800, B2400, B4800, B9600, B19200, B38400, B57600, B115200};
 
 //SERVO
-//None
+//Same As Digital
+
+//Channel Slots - Built At Compile Time From The Channel Lists Above
+constexpr LinxChannelSlots LinxRaspberryPi2B::m_DigitalSlots(NUM_DIGITAL_CHANS, LinxRaspberryPi2B::m_DigitalChans);
+constexpr LinxChannelSlots LinxRaspberryPi2B::m_PwmSlots(NUM_PWM_CHANS, LinxRaspberryPi2B::m_PwmChans);
+constexpr LinxChannelSlots LinxRaspberryPi2B::m_PwmOutputSlots(NUM_PWM_CHANS, LinxRaspberryPi2B::m_PwmChans, NUM_DIGITAL_CHANS, LinxRaspberryPi2B::m_DigitalChans);
+constexpr LinxChannelSlots LinxRaspberryPi2B::m_SpiSlots(NUM_SPI_CHANS, LinxRaspberryPi2B::m_SpiChans);
+constexpr LinxChannelSlots LinxRaspberryPi2B::m_I2cSlots(NUM_I2C_CHANS, LinxRaspberryPi2B::m_I2cChans);
+constexpr LinxChannelSlots LinxRaspberryPi2B::m_UartSlots(NUM_UART_CHANS, LinxRaspberryPi2B::m_UartChans);
 
 /****************************************************************************************
 **  Constructors /  Destructor
@@ -107,7 +114,7 @@ LinxRaspberryPi2B::LinxRaspberryPi2B()
 	
 	//PWM
 	NumPwmChans = NUM_PWM_CHANS;
-	PwmChans = 0;
+	PwmChans = m_PwmChans;
 	
 	//QE
 	NumQeChans = 0;
@@ -116,10 +123,7 @@ LinxRaspberryPi2B::LinxRaspberryPi2B()
 	//UART
 	NumUartChans = NUM_UART_CHANS;
 	UartChans = m_UartChans;	
-	UartMaxBaud = m_UartSupportedSpeeds[NUM_UART_SPEEDS - 1];
-	NumUartSpeeds = NUM_UART_SPEEDS;
-	UartSupportedSpeeds = m_UartSupportedSpeeds;
-	UartSupportedSpeedsCodes = m_UartSupportedSpeedsCodes;
+	UartMaxBaud = UART_MAX_BAUD;
 	
 	//I2C
 	NumI2cChans = NUM_I2C_CHANS;	
@@ -137,9 +141,10 @@ LinxRaspberryPi2B::LinxRaspberryPi2B()
 	NumCanChans = NUM_CAN_CHANS;
 	CanChans = 0;
 	
-	//Servo 
+	//Servo - Software Scheduler On Any Digital Channel
 	NumServoChans = NUM_SERVO_CHANS;
-	ServoChans = 0;
+	ServoChans = m_DigitalChans;
+	startupPhase("Device Properties");
 			
 	//------------------------------------- Digital -------------------------------------
 	
@@ -149,21 +154,31 @@ LinxRaspberryPi2B::LinxRaspberryPi2B()
 		//Failed to read the GPIO base
 		m_gpioBase = 0; //Default for older PI OS versions
 	}
-	//Export GPIO - Set All Digital Handles To NULL
+	GpioChipBase = m_gpioBase;
+	startupPhase("GPIO Base");
+
+	//Set All Digital Handles To NULL - GPIOs Are Exported On First Use Or By DigitalPrewarm()
+	bindDigitalSlots(&m_DigitalSlots);
 	for(int i=0; i<NUM_DIGITAL_CHANS; i++)
 	{
-		FILE* digitalExportHandle = fopen("/sys/class/gpio/export", "w");
-		fprintf(digitalExportHandle, "%d", m_gpioBase + m_gpioChan[i]);
-		fclose(digitalExportHandle);
-		
 		DigitalDirHandles[m_DigitalChans[i]] = NULL;
 		DigitalValueHandles[m_DigitalChans[i]] = NULL;
 		DigitalChannels[m_DigitalChans[i]] = m_gpioBase + m_gpioChan[i];
 		DigitalDirs[m_DigitalChans[i]] = PI_OS_GPIO_DIRECTION;
 	}
 	
+	//------------------------------------- PWM -------------------------------------
+	PwmChipPath = "/sys/class/pwm/pwmchip0/";
+	PwmDefaultFrequency = 2000;
+	bindPwmSlots(&m_PwmSlots, &m_PwmOutputSlots);
+	for(int i=0; i<NUM_PWM_CHANS; i++)
+	{
+		PwmChipChans[m_PwmChans[i]] = m_PwmChipChans[i];
+	}
+	
 	//------------------------------------- I2C -------------------------------------
-	//Store I2C Master Paths In Map
+	//Store I2C Master Paths
+	bindI2cSlots(&m_I2cSlots);
 	for(int i=0; i<NUM_I2C_CHANS; i++)
 	{	
 		I2cPaths[I2cChans[i]] = m_I2cPaths[i];
@@ -172,19 +187,23 @@ LinxRaspberryPi2B::LinxRaspberryPi2B()
 	//------------------------------------- SPI -------------------------------------
 	//Load SPI Paths And Configure SPI Master Default Values	
 	SpiDefaultSpeed = 3900000;
+	bindSpiSlots(&m_SpiSlots);
 	for(int i=0; i<NUM_SPI_CHANS; i++)
 	{				
 		SpiBitOrders[SpiChans[i]] = MSBFIRST;		//MSB First
 		SpiSetSpeeds[SpiChans[i]] = SpiDefaultSpeed;
 		SpiPaths[SpiChans[i]] = m_SpiPaths[i];
+		SpiHwCsChans[SpiChans[i]] = m_SpiHwCsChans[i];
 	}
 	
 	//------------------------------------- UART -------------------------------------
+	bindUartSlots(&m_UartSlots);
 	for(int i=0; i<NUM_UART_CHANS; i++)
 	{
 		UartPaths[m_UartChans[i]] = m_UartPaths[i];
 		UartHandles[m_UartChans[i]] = 0;
 	}	
+	startupPhase("Channel Maps");
 	
 	//If Debuging Is Enabled Call EnableDebug()
 	#if DEBUG_ENABLED > -1
@@ -208,6 +227,16 @@ LinxRaspberryPi2B::~LinxRaspberryPi2B()
 		}
 	}
 	
+	//Close PWM Handles If They Are Open
+	for(int i=0; i<NUM_PWM_CHANS; i++)
+	{
+		if(PwmPeriodHandles[m_PwmChans[i]] >= 0)
+		{
+			close(PwmPeriodHandles[m_PwmChans[i]]);
+			close(PwmDutyCycleHandles[m_PwmChans[i]]);
+		}
+	}
+	
 	//Close I2C Handles
 	for(int i=0; i<NUM_I2C_CHANS; i++)
 	{
@@ -231,7 +260,7 @@ LinxRaspberryPi2B::~LinxRaspberryPi2B()
 	{
 		if(UartHandles[m_UartChans[i]] != 0)
 		{	
-			close(UartHandles[m_UartChans[i]]);
+			UartClose(m_UartChans[i]);
 		}
 	}	
 }
@@ -26,7 +26,7 @@
 
 #define NUM_DIGITAL_CHANS 17
 
-#define NUM_PWM_CHANS 0
+#define NUM_PWM_CHANS 2
 
 #define NUM_SPI_CHANS 1
 #define NUM_SPI_SPEEDS 13
@@ -34,9 +34,9 @@
 #define NUM_I2C_CHANS 1
 
 #define NUM_UART_CHANS 1
-#define NUM_UART_SPEEDS 18
+#define UART_MAX_BAUD 4000000
 
-#define NUM_SERVO_CHANS 0
+#define NUM_SERVO_CHANS NUM_DIGITAL_CHANS
 
 #define PI_OS_GPIO_DIRECTION 3
 
@@ -46,7 +46,6 @@
 #include "utility/LinxDevice.h"
 #include "utility/LinxRaspberryPi.h"
 #include <string>
-#include <map>
 
 using namespace std;
 	
@@ -73,28 +72,36 @@ class LinxRaspberryPi2B : public LinxRaspberryPi
 		static const unsigned int m_gpioChan[NUM_DIGITAL_CHANS];
 		
 		//PWM
-		//None
+		static const unsigned char m_PwmChans[NUM_PWM_CHANS];
+		static const unsigned char m_PwmChipChans[NUM_PWM_CHANS];
 		
 		//SPI
 		static const unsigned char m_SpiChans[NUM_SPI_CHANS];
+		static const unsigned char m_SpiHwCsChans[NUM_SPI_CHANS];
 		static int m_SpiHandles[NUM_SPI_CHANS];
 		static unsigned long m_SpiSupportedSpeeds[NUM_SPI_SPEEDS];
 		static int m_SpiSpeedCodes[NUM_SPI_SPEEDS];
 				
 		//I2C
-		static unsigned char m_I2cChans[NUM_I2C_CHANS];
+		static const unsigned char m_I2cChans[NUM_I2C_CHANS];
 		static unsigned char m_I2cRefCount[NUM_I2C_CHANS];		
 		
 		//UART
-		static unsigned char m_UartChans[NUM_UART_CHANS];
-		static unsigned long m_UartSupportedSpeeds[NUM_UART_SPEEDS];
-		static unsigned long m_UartSupportedSpeedsCodes[NUM_UART_SPEEDS];
+		static const unsigned char m_UartChans[NUM_UART_CHANS];
 		static int m_UartHandles[NUM_UART_CHANS];
 		static string m_UartPaths[NUM_UART_CHANS];
 
 		
 		//Servo		
-		//None
+		//Same As Digital
+
+		//Channel Slots
+		static const LinxChannelSlots m_DigitalSlots;
+		static const LinxChannelSlots m_PwmSlots;
+		static const LinxChannelSlots m_PwmOutputSlots;
+		static const LinxChannelSlots m_SpiSlots;
+		static const LinxChannelSlots m_I2cSlots;
+		static const LinxChannelSlots m_UartSlots;
 		
 		/****************************************************************************************
 		**  Constructors /  Destructor
@@ -0,0 +1,524 @@
+/****************************************************************************************
+**  LINX Raspberry Pi 5 Code
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#include "utility/LinxDevice.h"
+#include "utility/LinxRaspberryPi.h"
+#include "utility/LinxBitPack.h"
+#include "utility/LinxLog.h"
+#include "LinxRaspberryPi5.h"
+
+/****************************************************************************************
+**  Member Variables
+****************************************************************************************/
+//System
+const unsigned char LinxRaspberryPi5::m_DeviceName[DEVICE_NAME_LEN] = "Raspberry Pi 5";
+
+//AI
+//None
+
+//AO
+//None
+
+//DIGITAL - RP1 Line Offsets Match The BCM GPIO Numbers Of Earlier Models
+const unsigned char LinxRaspberryPi5::m_DigitalChans[NUM_DIGITAL_CHANS] = {7, 11, 12, 13, 15, 16, 18, 22, 29, 31, 32, 33, 35, 36, 37, 38, 40};
+const unsigned int LinxRaspberryPi5::m_gpioChan[NUM_DIGITAL_CHANS] =     {4, 17, 18, 27, 22, 23, 24, 25, 5, 6, 12, 13, 19, 16, 26, 20, 21};
+
+//PWM
+const unsigned char LinxRaspberryPi5::m_PwmChans[NUM_PWM_CHANS] = {12, 32, 33, 35};
+const unsigned char LinxRaspberryPi5::m_PwmChipChans[NUM_PWM_CHANS] = {2, 0, 1, 3};		//GPIO 18 / 12 / 13 / 19 On RP1 PWM0 (dtoverlay=pwm-2chan Routes 18 And 19)
+
+//QE
+//None
+
+//SPI
+const unsigned char LinxRaspberryPi5::m_SpiChans[NUM_SPI_CHANS] = {0};
+string LinxRaspberryPi5::m_SpiPaths[NUM_SPI_CHANS] = { "/dev/spidev0.1"};
+const unsigned char LinxRaspberryPi5::m_SpiHwCsChans[NUM_SPI_CHANS] = {26};		//spidev0.1 Drives CE1 (GPIO 7, Header Pin 26)
+unsigned long LinxRaspberryPi5::m_SpiSupportedSpeeds[NUM_SPI_SPEEDS] = {12207, 24414, 48828, 97656, 195312, 390625, 781250, 1562500, 3125000, 6250000, 12500000, 25000000, 50000000};		//200 MHz RP1 SPI Clock / 2^n
+int LinxRaspberryPi5::m_SpiSpeedCodes[NUM_SPI_SPEEDS] = {12207, 24414, 48828, 97656, 195312, 390625, 781250, 1562500, 3125000, 6250000, 12500000, 25000000, 50000000};
+
+//I2C
+const unsigned char LinxRaspberryPi5::m_I2cChans[NUM_I2C_CHANS] = {1};
+string LinxRaspberryPi5::m_I2cPaths[NUM_I2C_CHANS] = {"/dev/i2c-1"};
+unsigned char LinxRaspberryPi5::m_I2cRefCount[NUM_I2C_CHANS];
+
+//UART
+const unsigned char LinxRaspberryPi5::m_UartChans[NUM_UART_CHANS] = {0};
+string LinxRaspberryPi5::m_UartPaths[NUM_UART_CHANS] = {"/dev/ttyAMA0"};		//RP1 UART0 On Header Pins 8 / 10
+
+//SERVO
+//Same As Digital
+
+//Channel Slots - Built At Compile Time From The Channel Lists Above
+constexpr LinxChannelSlots LinxRaspberryPi5::m_DigitalSlots(NUM_DIGITAL_CHANS, LinxRaspberryPi5::m_DigitalChans);
+constexpr LinxChannelSlots LinxRaspberryPi5::m_PwmSlots(NUM_PWM_CHANS, LinxRaspberryPi5::m_PwmChans);
+constexpr LinxChannelSlots LinxRaspberryPi5::m_PwmOutputSlots(NUM_PWM_CHANS, LinxRaspberryPi5::m_PwmChans, NUM_DIGITAL_CHANS, LinxRaspberryPi5::m_DigitalChans);
+constexpr LinxChannelSlots LinxRaspberryPi5::m_SpiSlots(NUM_SPI_CHANS, LinxRaspberryPi5::m_SpiChans);
+constexpr LinxChannelSlots LinxRaspberryPi5::m_I2cSlots(NUM_I2C_CHANS, LinxRaspberryPi5::m_I2cChans);
+constexpr LinxChannelSlots LinxRaspberryPi5::m_UartSlots(NUM_UART_CHANS, LinxRaspberryPi5::m_UartChans);
+
+/****************************************************************************************
+**  Constructors /  Destructor
+****************************************************************************************/
+LinxRaspberryPi5::LinxRaspberryPi5()
+{
+	DeviceFamily = 0x04;	//Raspberry Pi Family Code
+	DeviceId = 0x05;			//Raspberry Pi 5
+	DeviceNameLen = DEVICE_NAME_LEN;
+	DeviceName =  m_DeviceName;
+
+	//LINX API Version
+	LinxApiMajor = 2;
+	LinxApiMinor = 2;
+	LinxApiSubminor = 0;
+
+	//DIGITAL
+	NumDigitalChans = NUM_DIGITAL_CHANS;
+	DigitalChans = m_DigitalChans;
+
+	//AI
+	NumAiChans = NUM_AI_CHANS;
+	AiChans = 0;
+	AiResolution = 0;
+	AiRefSet = 0;
+
+	AiRefDefault = AI_REFV;
+	AiRefSet = AI_REFV;
+	AiRefCodes = NULL;
+
+	NumAiRefIntVals = NUM_AI_INT_REFS;
+	AiRefIntVals = NULL;
+
+	AiRefExtMin = 0;
+	AiRefExtMax = 0;
+
+	//AO
+	NumAoChans = 0;
+	AoChans = 0;
+	AoResolution = 0;
+	AoRefDefault = 0;
+	AoRefSet = 0;
+
+	//PWM
+	NumPwmChans = NUM_PWM_CHANS;
+	PwmChans = m_PwmChans;
+
+	//QE
+	NumQeChans = 0;
+	QeChans = 0;
+
+	//UART
+	NumUartChans = NUM_UART_CHANS;
+	UartChans = m_UartChans;
+	UartMaxBaud = UART_MAX_BAUD;
+
+	//I2C
+	NumI2cChans = NUM_I2C_CHANS;
+	I2cChans = m_I2cChans;
+	I2cRefCount = m_I2cRefCount;
+
+	//SPI
+	NumSpiChans = NUM_SPI_CHANS;
+	SpiChans = m_SpiChans;
+	NumSpiSpeeds = NUM_SPI_SPEEDS;
+	SpiSupportedSpeeds = m_SpiSupportedSpeeds;
+	SpiSpeedCodes = m_SpiSpeedCodes;
+
+	//CAN
+	NumCanChans = NUM_CAN_CHANS;
+	CanChans = 0;
+
+	//Servo - Software Scheduler On Any Digital Channel
+	NumServoChans = NUM_SERVO_CHANS;
+	ServoChans = m_DigitalChans;
+	startupPhase("Device Properties");
+
+	//------------------------------------- Digital -------------------------------------
+	//Lines Are Requested On First Use Or By DigitalPrewarm(), Nothing Is Exported
+	GpioChipPath = getGpioChipPath();
+	GpioChipBase = 0;
+	startupPhase("GPIO Chip");
+	bindDigitalSlots(&m_DigitalSlots);
+	DigitalLineHandles.Fill(-1);
+	if(!DigitalLineHandles.Bind(&m_DigitalSlots))
+	{
+		LINX_LOG_ERROR("Digital Channels Do Not Fit The Line Handle Table");
+	}
+	for(int i=0; i<NUM_DIGITAL_CHANS; i++)
+	{
+		DigitalChannels[m_DigitalChans[i]] = m_gpioChan[i];
+		DigitalDirs[m_DigitalChans[i]] = 0xFF;		//Unknown Until The Line Is Requested
+	}
+
+	//------------------------------------- PWM -------------------------------------
+	PwmChipPath = getPwmChipPath();
+	PwmDefaultFrequency = 2000;
+	startupPhase("PWM Chip");
+	bindPwmSlots(&m_PwmSlots, &m_PwmOutputSlots);
+	for(int i=0; i<NUM_PWM_CHANS; i++)
+	{
+		PwmChipChans[m_PwmChans[i]] = m_PwmChipChans[i];
+	}
+
+	//------------------------------------- I2C -------------------------------------
+	//Store I2C Master Paths
+	bindI2cSlots(&m_I2cSlots);
+	for(int i=0; i<NUM_I2C_CHANS; i++)
+	{
+		I2cPaths[I2cChans[i]] = m_I2cPaths[i];
+	}
+
+	//------------------------------------- SPI -------------------------------------
+	//Load SPI Paths And Configure SPI Master Default Values
+	SpiDefaultSpeed = 3125000;
+	bindSpiSlots(&m_SpiSlots);
+	for(int i=0; i<NUM_SPI_CHANS; i++)
+	{
+		SpiBitOrders[SpiChans[i]] = MSBFIRST;		//MSB First
+		SpiSetSpeeds[SpiChans[i]] = SpiDefaultSpeed;
+		SpiPaths[SpiChans[i]] = m_SpiPaths[i];
+		SpiHwCsChans[SpiChans[i]] = m_SpiHwCsChans[i];
+	}
+
+	//------------------------------------- UART -------------------------------------
+	bindUartSlots(&m_UartSlots);
+	for(int i=0; i<NUM_UART_CHANS; i++)
+	{
+		UartPaths[m_UartChans[i]] = m_UartPaths[i];
+		UartHandles[m_UartChans[i]] = 0;
+	}
+	startupPhase("Channel Maps");
+
+	//If Debuging Is Enabled Call EnableDebug()
+	#if DEBUG_ENABLED > -1
+		EnableDebug(DEBUG_ENABLED);
+	#endif
+}
+
+//Destructor
+LinxRaspberryPi5::~LinxRaspberryPi5()
+{
+	//Stop The Software PWM Scheduler Before Its Lines Are Given Back
+	if(SoftPwm != NULL)
+	{
+		SoftPwm->Close();
+	}
+
+	//Release GPIO Line Requests
+	for(int i=0; i<NUM_DIGITAL_CHANS; i++)
+	{
+		if(DigitalLineHandles[m_DigitalChans[i]] >= 0)
+		{
+			close(DigitalLineHandles[m_DigitalChans[i]]);
+			DigitalLineHandles[m_DigitalChans[i]] = -1;
+		}
+	}
+
+	//Close PWM Handles If They Are Open
+	for(int i=0; i<NUM_PWM_CHANS; i++)
+	{
+		if(PwmPeriodHandles[m_PwmChans[i]] >= 0)
+		{
+			close(PwmPeriodHandles[m_PwmChans[i]]);
+			close(PwmDutyCycleHandles[m_PwmChans[i]]);
+		}
+	}
+
+	//Close I2C Handles
+	for(int i=0; i<NUM_I2C_CHANS; i++)
+	{
+		if(I2cHandles[m_I2cChans[i]] != 0)
+		{
+			close(I2cHandles[m_I2cChans[i]]);
+		}
+	}
+
+	//Close SPI Handles
+	for(int i=0; i<NUM_SPI_CHANS; i++)
+	{
+		if(SpiHandles[m_SpiChans[i]] != 0)
+		{
+			close(SpiHandles[m_SpiChans[i]]);
+		}
+	}
+
+	//Close UART Handles
+	for(int i=0; i<NUM_UART_CHANS; i++)
+	{
+		if(UartHandles[m_UartChans[i]] != 0)
+		{
+			UartClose(m_UartChans[i]);
+		}
+	}
+}
+
+/****************************************************************************************
+**  Protected Functions
+****************************************************************************************/
+//Request Each Channel's Line As Is (Direction Unchanged) If It Is Not Already Held
+int LinxRaspberryPi5::digitalSmartOpen(unsigned char numChans, unsigned char* channels)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(!DigitalChannels.Contains(channels[i]))
+		{
+			LINX_LOG_ERROR("Digital Fail - Not A Digital Channel");
+			return L_UNKNOWN_ERROR;
+		}
+
+		//Digital I/O Cancels Any Square Wave, PWM Or Servo Running On The Pin
+		if(SoftPwm != NULL && SoftPwm->HasChannel(channels[i]))
+		{
+			softPwmClose(channels[i]);
+		}
+
+		if(DigitalLineHandles[channels[i]] >= 0)
+		{
+			continue;
+		}
+
+		LINX_LOG_DEBUG("Requesting GPIO Line For LINX DIO %ld (GPIO %ld)", (long)channels[i], (long)DigitalChannels[channels[i]]);
+
+		int chipHandle = open(GpioChipPath.c_str(), O_RDWR | O_CLOEXEC);
+		if(chipHandle < 0)
+		{
+			LINX_LOG_ERROR("Digital Fail - Unable To Open GPIO Chip");
+			return L_UNKNOWN_ERROR;
+		}
+
+		struct gpio_v2_line_request request;
+		memset(&request, 0, sizeof(request));
+		request.offsets[0] = DigitalChannels[channels[i]] - GpioChipBase;
+		request.num_lines = 1;
+		strncpy(request.consumer, "linx", sizeof(request.consumer) - 1);
+
+		int status = gpioIoctl(chipHandle, GPIO_V2_GET_LINE_IOCTL, &request);
+		close(chipHandle);
+		if(status < 0)
+		{
+			LINX_LOG_ERROR("Digital Fail - Unable To Request GPIO Line");
+			return L_UNKNOWN_ERROR;
+		}
+
+		DigitalLineHandles[channels[i]] = request.fd;
+		DigitalDirs[channels[i]] = 0xFF;
+	}
+	return L_OK;
+}
+
+//Give A Channel's Line To The Software PWM Scheduler
+void LinxRaspberryPi5::digitalRelease(unsigned char channel)
+{
+	if(DigitalLineHandles[channel] >= 0)
+	{
+		close(DigitalLineHandles[channel]);
+		DigitalLineHandles[channel] = -1;
+	}
+}
+
+//The Line Is Requested Again On Next Digital Use
+void LinxRaspberryPi5::digitalRestore(unsigned char channel)
+{
+	DigitalDirs[channel] = 0xFF;
+}
+
+//Reconfigure A Requested Line Only If Its Direction Changes
+int LinxRaspberryPi5::digitalSetDirection(unsigned char channel, unsigned char direction)
+{
+	if(DigitalDirs[channel] == direction)
+	{
+		return L_OK;
+	}
+
+	struct gpio_v2_line_config config;
+	memset(&config, 0, sizeof(config));
+	config.flags = (direction == OUTPUT) ? GPIO_V2_LINE_FLAG_OUTPUT : GPIO_V2_LINE_FLAG_INPUT;
+
+	if(gpioIoctl(DigitalLineHandles[channel], GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0)
+	{
+		LINX_LOG_ERROR("Digital Fail - Unable To Set GPIO Line Direction");
+		return L_UNKNOWN_ERROR;
+	}
+	DigitalDirs[channel] = direction;
+	return L_OK;
+}
+
+int LinxRaspberryPi5::digitalWriteLine(unsigned char channel, unsigned char value)
+{
+	struct gpio_v2_line_values lineValues;
+	lineValues.mask = 1;
+	lineValues.bits = (value == LOW) ? 0 : 1;
+
+	if(gpioIoctl(DigitalLineHandles[channel], GPIO_V2_LINE_SET_VALUES_IOCTL, &lineValues) < 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	return L_OK;
+}
+
+int LinxRaspberryPi5::digitalReadLine(unsigned char channel, unsigned char* value)
+{
+	struct gpio_v2_line_values lineValues;
+	lineValues.mask = 1;
+	lineValues.bits = 0;
+
+	if(gpioIoctl(DigitalLineHandles[channel], GPIO_V2_LINE_GET_VALUES_IOCTL, &lineValues) < 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	*value = (unsigned char)(lineValues.bits & 0x01);
+	return L_OK;
+}
+
+int LinxRaspberryPi5::gpioIoctl(int handle, unsigned long request, void* arg)
+{
+	return ioctl(handle, request, arg);
+}
+
+/****************************************************************************************
+**  Private Functions
+****************************************************************************************/
+//Find The RP1 gpiochip By Label.  Its Number Depends On Probe Order.
+string LinxRaspberryPi5::getGpioChipPath()
+{
+	char chipPath[32];
+	for(int i=0; i<MAX_GPIO_CHIPS; i++)
+	{
+		sprintf(chipPath, "/dev/gpiochip%d", i);
+		int chipHandle = open(chipPath, O_RDONLY | O_CLOEXEC);
+		if(chipHandle < 0)
+		{
+			continue;
+		}
+
+		struct gpiochip_info info;
+		memset(&info, 0, sizeof(info));
+		int status = ioctl(chipHandle, GPIO_GET_CHIPINFO_IOCTL, &info);
+		close(chipHandle);
+		if(status == 0 && strncmp(info.label, RP1_GPIO_LABEL, strlen(RP1_GPIO_LABEL)) == 0)
+		{
+			return chipPath;
+		}
+	}
+	return "/dev/gpiochip0";
+}
+
+//Find The pwmchip Whose Device Is RP1 PWM0
+string LinxRaspberryPi5::getPwmChipPath()
+{
+	char chipPath[48];
+	char linkTarget[256];
+	for(int i=0; i<MAX_PWM_CHIPS; i++)
+	{
+		sprintf(chipPath, "/sys/class/pwm/pwmchip%d", i);
+		ssize_t len = readlink(chipPath, linkTarget, sizeof(linkTarget) - 1);
+		if(len <= 0)
+		{
+			continue;
+		}
+		linkTarget[len] = 0;
+		if(strstr(linkTarget, RP1_PWM_DEVICE) != NULL)
+		{
+			return string(chipPath) + "/";
+		}
+	}
+	return "/sys/class/pwm/pwmchip0/";
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+//------------------------------------- Digital -------------------------------------
+int LinxRaspberryPi5::DigitalSetDirection(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	if(digitalSmartOpen(numChans, channels) != L_OK)
+	{
+		LINX_LOG_ERROR("Smart Open Failed");
+		return L_UNKNOWN_ERROR;
+	}
+
+	unsigned char directions[numChans];
+	LinxBitPack::UnpackBits(numChans, values, directions);
+
+	for(int i=0; i<numChans; i++)
+	{
+		if(digitalSetDirection(channels[i], directions[i]) != L_OK)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+	}
+	return L_OK;
+}
+
+int LinxRaspberryPi5::DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	unsigned char bits[numChans];
+	LinxBitPack::UnpackBits(numChans, values, bits);
+	return DigitalWriteNoPacking(numChans, channels, bits);
+}
+
+int LinxRaspberryPi5::DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	if(digitalSmartOpen(numChans, channels) != L_OK)
+	{
+		LINX_LOG_ERROR("Digital Write Fail - Smart Open Failed");
+		return L_UNKNOWN_ERROR;
+	}
+
+	for(int i=0; i<numChans; i++)
+	{
+		if(digitalSetDirection(channels[i], OUTPUT) != L_OK || digitalWriteLine(channels[i], values[i]) != L_OK)
+		{
+			LINX_LOG_ERROR("Digital Write Fail");
+			return L_UNKNOWN_ERROR;
+		}
+	}
+	return L_OK;
+}
+
+//Values Are Bit Packed MSb First, Matching The sysfs Implementation
+int LinxRaspberryPi5::DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	unsigned char bits[numChans];
+	int status = DigitalReadNoPacking(numChans, channels, bits);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	LinxBitPack::PackBits(numChans, bits, values);
+	return L_OK;
+}
+
+int LinxRaspberryPi5::DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	if(digitalSmartOpen(numChans, channels) != L_OK)
+	{
+		LINX_LOG_ERROR("Digital Read Fail - Smart Open Failed");
+		return L_UNKNOWN_ERROR;
+	}
+
+	for(int i=0; i<numChans; i++)
+	{
+		if(digitalSetDirection(channels[i], INPUT) != L_OK || digitalReadLine(channels[i], values + i) != L_OK)
+		{
+			LINX_LOG_ERROR("Digital Read Fail");
+			return L_UNKNOWN_ERROR;
+		}
+	}
+	return L_OK;
+}
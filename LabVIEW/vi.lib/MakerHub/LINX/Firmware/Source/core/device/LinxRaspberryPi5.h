@@ -0,0 +1,147 @@
+/****************************************************************************************
+**  LINX header for Raspberry Pi 5
+**
+**  The 40 pin header is driven by the RP1 I/O controller.  Digital I/O uses the GPIO
+**  character device, since the Pi 5 kernel no longer gives the header a fixed sysfs
+**  GPIO base.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_RASPBERRYPI5_H
+#define LINX_RASPBERRYPI5_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define DEVICE_NAME_LEN 15
+
+#define NUM_AI_CHANS 0
+#define AI_RES_BITS 0
+#define AI_REFV 0
+#define NUM_AI_INT_REFS 0
+
+#define NUM_CAN_CHANS 0
+
+#define NUM_DIGITAL_CHANS 17
+
+#define NUM_PWM_CHANS 4
+
+#define NUM_SPI_CHANS 1
+#define NUM_SPI_SPEEDS 13
+
+#define NUM_I2C_CHANS 1
+
+#define NUM_UART_CHANS 1
+#define UART_MAX_BAUD 3000000
+
+#define NUM_SERVO_CHANS NUM_DIGITAL_CHANS
+
+#define RP1_GPIO_LABEL "pinctrl-rp1"						//gpiochip Label Of The Header GPIO
+#define RP1_PWM_DEVICE "1f00098000.pwm"					//RP1 PWM0 Platform Device
+#define MAX_GPIO_CHIPS 16
+#define MAX_PWM_CHIPS 8
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "utility/LinxDevice.h"
+#include "utility/LinxRaspberryPi.h"
+#include <string>
+
+using namespace std;
+
+class LinxRaspberryPi5 : public LinxRaspberryPi
+{
+	public:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		//System
+		static const unsigned char m_DeviceName[DEVICE_NAME_LEN];
+
+		//AI
+		//None
+
+		//AO
+		//None
+
+		//CAN
+		//None
+
+		//DIGITAL
+		static const unsigned char m_DigitalChans[NUM_DIGITAL_CHANS];
+		static const unsigned int m_gpioChan[NUM_DIGITAL_CHANS];
+		LinxChannelTable<int, RPI_MAX_PIN_SLOTS> DigitalLineHandles;	//GPIO Character Device Line Requests, One Per Channel, -1 = Not Requested
+
+		//PWM
+		static const unsigned char m_PwmChans[NUM_PWM_CHANS];
+		static const unsigned char m_PwmChipChans[NUM_PWM_CHANS];
+
+		//SPI
+		static const unsigned char m_SpiChans[NUM_SPI_CHANS];
+		static string m_SpiPaths[NUM_SPI_CHANS];
+		static const unsigned char m_SpiHwCsChans[NUM_SPI_CHANS];
+		static unsigned long m_SpiSupportedSpeeds[NUM_SPI_SPEEDS];
+		static int m_SpiSpeedCodes[NUM_SPI_SPEEDS];
+
+		//I2C
+		static const unsigned char m_I2cChans[NUM_I2C_CHANS];
+		static string m_I2cPaths[NUM_I2C_CHANS];
+		static unsigned char m_I2cRefCount[NUM_I2C_CHANS];
+
+		//UART
+		static const unsigned char m_UartChans[NUM_UART_CHANS];
+		static string m_UartPaths[NUM_UART_CHANS];
+
+		//Servo
+		//Same As Digital
+
+		//Channel Slots
+		static const LinxChannelSlots m_DigitalSlots;
+		static const LinxChannelSlots m_PwmSlots;
+		static const LinxChannelSlots m_PwmOutputSlots;
+		static const LinxChannelSlots m_SpiSlots;
+		static const LinxChannelSlots m_I2cSlots;
+		static const LinxChannelSlots m_UartSlots;
+
+		/****************************************************************************************
+		**  Constructors /  Destructor
+		****************************************************************************************/
+		LinxRaspberryPi5();
+		virtual ~LinxRaspberryPi5();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		//DIGITAL
+		virtual int DigitalSetDirection(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);
+
+	protected:
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		virtual int digitalSmartOpen(unsigned char numChans, unsigned char* channels);
+		virtual void digitalRelease(unsigned char channel);
+		virtual void digitalRestore(unsigned char channel);
+		int digitalSetDirection(unsigned char channel, unsigned char direction);
+		int digitalWriteLine(unsigned char channel, unsigned char value);
+		int digitalReadLine(unsigned char channel, unsigned char* value);
+		virtual int gpioIoctl(int handle, unsigned long request, void* arg);		//All GPIO Character Device ioctls Go Through Here
+
+	private:
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		string getGpioChipPath();
+		string getPwmChipPath();
+};
+
+#endif //LINX_RASPBERRYPI5_H
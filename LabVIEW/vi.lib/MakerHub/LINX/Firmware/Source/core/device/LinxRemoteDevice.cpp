@@ -0,0 +1,1514 @@
+/****************************************************************************************
+**  LINX remote device code.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <asm/termbits.h>
+
+#include "utility/LinxDevice.h"
+#include "utility/LinxBitPack.h"
+#include "LinxRemoteDevice.h"
+
+/****************************************************************************************
+**  Helpers
+****************************************************************************************/
+static void putU16(unsigned char* buffer, unsigned long value)
+{
+	buffer[0] = (value >> 8) & 0xFF;
+	buffer[1] = value & 0xFF;
+}
+
+static void putU32(unsigned char* buffer, unsigned long value)
+{
+	buffer[0] = (value >> 24) & 0xFF;
+	buffer[1] = (value >> 16) & 0xFF;
+	buffer[2] = (value >> 8) & 0xFF;
+	buffer[3] = value & 0xFF;
+}
+
+static unsigned long getU32(const unsigned char* buffer)
+{
+	return ((unsigned long)buffer[0] << 24) | ((unsigned long)buffer[1] << 16) | ((unsigned long)buffer[2] << 8) | (unsigned long)buffer[3];
+}
+
+static unsigned long long monotonicMs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/****************************************************************************************
+**  LinxRemoteFuture
+****************************************************************************************/
+LinxRemoteFuture::LinxRemoteFuture()
+{
+	Done = true;
+	Status = L_OK;
+	NumBytes = 0;
+	Device = NULL;
+}
+
+int LinxRemoteFuture::Wait()
+{
+	while(!Done)
+	{
+		Device->receive(true);
+	}
+	return Status;
+}
+
+bool LinxRemoteFuture::Ready()
+{
+	while(!Done && Device->receive(false) == L_OK)
+	{
+	}
+	return Done;
+}
+
+/****************************************************************************************
+**  Constructors /  Destructor
+****************************************************************************************/
+LinxRemoteDevice::LinxRemoteDevice()
+{
+	Fd = -1;
+	PacketNumber = 0;
+	Batching = false;
+	FirstFailure = L_OK;
+	RequestHead = 0;
+	RequestCount = 0;
+	RxStart = 0;
+	RxEnd = 0;
+	StreamNumChans = 0;
+
+	MaxInFlight = REMOTE_TCP_WINDOW;
+	Timeout = REMOTE_DEFAULT_TIMEOUT;
+	NumRequests = 0;
+	NumPassthroughFrames = 0;
+
+	//Set ListenerBufferSize Lower Before Connecting To Listeners With Smaller Buffers
+	ListenerBufferSize = REMOTE_MAX_PACKET;
+
+	clearDescription();
+}
+
+LinxRemoteDevice::~LinxRemoteDevice()
+{
+	Close();
+}
+
+/****************************************************************************************
+**  Connection
+****************************************************************************************/
+int LinxRemoteDevice::ConnectTcp(const char* host, unsigned short port)
+{
+	Close();
+
+	char service[8];
+	snprintf(service, sizeof(service), "%u", port);
+
+	struct addrinfo hints;
+	struct addrinfo* addresses = NULL;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if(getaddrinfo(host, service, &hints, &addresses) != 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	for(struct addrinfo* address = addresses; address != NULL && Fd < 0; address = address->ai_next)
+	{
+		Fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+		if(Fd >= 0 && connect(Fd, address->ai_addr, address->ai_addrlen) != 0)
+		{
+			close(Fd);
+			Fd = -1;
+		}
+	}
+	freeaddrinfo(addresses);
+	if(Fd < 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	//Requests Are Small And Latency Bound
+	int noDelay = 1;
+	setsockopt(Fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+	MaxInFlight = REMOTE_TCP_WINDOW;
+	return Refresh();
+}
+
+int LinxRemoteDevice::ConnectSerial(const char* path, unsigned long baudRate)
+{
+	Close();
+
+	Fd = open(path, O_RDWR | O_NOCTTY);
+	if(Fd < 0)
+	{
+		return LUART_OPEN_FAIL;
+	}
+
+	//Raw 8N1 At Any Rate, Same As The Linux UARTs
+	struct termios2 options;
+	if(ioctl(Fd, TCGETS2, &options) == 0)
+	{
+		options.c_cflag = BOTHER | CS8 | CLOCAL | CREAD;
+		options.c_iflag = IGNPAR;
+		options.c_oflag = 0;
+		options.c_lflag = 0;
+		options.c_cc[VMIN] = 0;
+		options.c_cc[VTIME] = 0;
+		options.c_ispeed = baudRate;
+		options.c_ospeed = baudRate;
+		ioctl(Fd, TCFLSH, TCIOFLUSH);
+		if(ioctl(Fd, TCSETS2, &options) != 0)
+		{
+			close(Fd);
+			Fd = -1;
+			return LUART_SET_BAUD_FAIL;
+		}
+	}
+
+	MaxInFlight = REMOTE_SERIAL_WINDOW;
+	return Refresh();
+}
+
+bool LinxRemoteDevice::IsConnected()
+{
+	return Fd >= 0;
+}
+
+//Everything Is Requested Before Anything Is Waited For, So This Costs About Two Round Trips
+int LinxRemoteDevice::Refresh()
+{
+	if(Fd < 0)
+	{
+		return L_DISCONNECT;
+	}
+	clearDescription();
+
+	//Channel Lists And Name
+	const unsigned short listCommands[] = {0x0008, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F, 0x0010, 0x0025, 0x0024};
+	unsigned char* lists[] = {m_DigitalChans, m_AiChans, m_AoChans, m_PwmChans, m_QeChans, m_UartChans, m_I2cChans, m_SpiChans, m_CanChans, m_ServoChans, m_DeviceName};
+	const int numLists = sizeof(listCommands) / sizeof(listCommands[0]);
+	LinxRemoteFuture listFutures[numLists];
+
+	//Single Values, The User Configured Ones Are Missing From Older Listeners So Only The First Four Must Succeed
+	const unsigned short valueCommands[] = {0x0003, 0x0004, 0x0005, 0x0061, 0x0013, 0x0015, 0x0017, 0x0019, 0x001B, 0x001F, 0x0023};
+	const int numRequired = 4;
+	const int numValues = sizeof(valueCommands) / sizeof(valueCommands[0]);
+	unsigned char values[numValues][4];
+	LinxRemoteFuture valueFutures[numValues];
+
+	memset(values, 0, sizeof(values));
+	for(int i=0; i<numLists; i++)
+	{
+		submit(listCommands[i], NULL, 0, lists[i], 0, REMOTE_MAX_PACKET, 0, &listFutures[i]);
+	}
+	for(int i=0; i<numValues; i++)
+	{
+		submit(valueCommands[i], NULL, 0, values[i], 0, sizeof(values[i]), 0, &valueFutures[i]);
+	}
+
+	int status = L_OK;
+	for(int i=0; i<numLists; i++)
+	{
+		if(listFutures[i].Wait() != L_OK && status == L_OK)
+		{
+			status = listFutures[i].Status;
+		}
+	}
+	for(int i=0; i<numValues; i++)
+	{
+		if(valueFutures[i].Wait() != L_OK && i < numRequired && status == L_OK)
+		{
+			status = valueFutures[i].Status;
+		}
+	}
+	if(status != L_OK)
+	{
+		clearDescription();
+		return status;
+	}
+
+	NumDigitalChans = listFutures[0].NumBytes;
+	NumAiChans = listFutures[1].NumBytes;
+	NumAoChans = listFutures[2].NumBytes;
+	NumPwmChans = listFutures[3].NumBytes;
+	NumQeChans = listFutures[4].NumBytes;
+	NumUartChans = listFutures[5].NumBytes;
+	NumI2cChans = listFutures[6].NumBytes;
+	NumSpiChans = listFutures[7].NumBytes;
+	NumCanChans = listFutures[8].NumBytes;
+	NumServoChans = listFutures[9].NumBytes;
+	DeviceNameLen = listFutures[10].NumBytes;
+	m_DeviceName[(DeviceNameLen < REMOTE_MAX_PACKET - 1) ? DeviceNameLen : REMOTE_MAX_PACKET - 1] = '\0';
+
+	DeviceFamily = values[0][0];
+	DeviceId = values[0][1];
+	LinxApiMajor = values[1][0];
+	LinxApiMinor = values[1][1];
+	LinxApiSubminor = values[1][2];
+	UartMaxBaud = getU32(values[2]);
+	AiRefDefault = getU32(values[3]);
+	AiRefSet = AiRefDefault;
+	userId = (values[4][0] << 8) | values[4][1];
+	ethernetIp = getU32(values[5]);
+	ethernetPort = (values[6][0] << 8) | values[6][1];
+	WifiIp = getU32(values[7]);
+	WifiPort = (values[8][0] << 8) | values[8][1];
+	WifiSecurity = values[9][0];
+	serialInterfaceMaxBaud = getU32(values[10]);
+
+	//AI Resolution Is Only Reported With Readings
+	if(NumAiChans > 0)
+	{
+		unsigned char response[REMOTE_MAX_PACKET];
+		unsigned char numBytesRead = 0;
+		if(transact(0x0064, AiChans, 1, response, sizeof(response), 0, &numBytesRead) == L_OK && numBytesRead > 0)
+		{
+			AiResolution = response[0];
+		}
+	}
+
+	return L_OK;
+}
+
+int LinxRemoteDevice::Close()
+{
+	if(Fd < 0)
+	{
+		return L_OK;
+	}
+
+	Batching = false;
+	Sync();
+	int status = transactStatus(0x0011, NULL, 0);
+
+	if(Fd >= 0)
+	{
+		close(Fd);
+		Fd = -1;
+	}
+	failOutstanding(L_DISCONNECT);
+	RxStart = 0;
+	RxEnd = 0;
+	return status;
+}
+
+/****************************************************************************************
+**  Pipelining
+****************************************************************************************/
+void LinxRemoteDevice::BeginBatch()
+{
+	Batching = true;
+}
+
+int LinxRemoteDevice::EndBatch()
+{
+	Batching = false;
+	return Sync();
+}
+
+int LinxRemoteDevice::Sync()
+{
+	while(RequestCount > 0)
+	{
+		receive(true);
+	}
+
+	int status = FirstFailure;
+	FirstFailure = L_OK;
+	return status;
+}
+
+int LinxRemoteDevice::Command(unsigned short command, const unsigned char* payload, unsigned char numBytes, unsigned char* response, unsigned char maxBytes, unsigned char* numBytesRead)
+{
+	return transact(command, payload, numBytes, response, maxBytes, 0, numBytesRead);
+}
+
+int LinxRemoteDevice::CommandAsync(unsigned short command, const unsigned char* payload, unsigned char numBytes, unsigned char* response, unsigned char maxBytes, LinxRemoteFuture* future)
+{
+	return submit(command, payload, numBytes, response, 0, maxBytes, 0, future);
+}
+
+int LinxRemoteDevice::DigitalWriteAsync(unsigned char numChans, unsigned char* channels, unsigned char* values, LinxRemoteFuture* future)
+{
+	unsigned int numValueBytes = (numChans + 7) / 8;
+	unsigned int numBytes = 1 + numChans + numValueBytes;
+	if(numBytes > maxPayload())
+	{
+		return reject(future);
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = numChans;
+	memcpy(&payload[1], channels, numChans);
+	memcpy(&payload[1 + numChans], values, numValueBytes);
+	return submit(0x0041, payload, numBytes, NULL, 0, 0, 0, future);
+}
+
+int LinxRemoteDevice::DigitalReadAsync(unsigned char numChans, unsigned char* channels, unsigned char* values, LinxRemoteFuture* future)
+{
+	return submit(0x0042, channels, numChans, values, 0, (numChans + 7) / 8, 0, future);
+}
+
+//Response Starts With The Resolution, Which Is Not Copied
+int LinxRemoteDevice::AnalogReadAsync(unsigned char numChans, unsigned char* channels, unsigned char* values, LinxRemoteFuture* future)
+{
+	return submit(0x0064, channels, numChans, values, 1, LinxBitPack::PackedSize(numChans, (AiResolution > 0) ? AiResolution : 32), 0, future);
+}
+
+int LinxRemoteDevice::PwmSetDutyCycleAsync(unsigned char numChans, unsigned char* channels, unsigned char* values, LinxRemoteFuture* future)
+{
+	unsigned int numBytes = 1 + 2 * numChans;
+	if(numBytes > maxPayload())
+	{
+		return reject(future);
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = numChans;
+	memcpy(&payload[1], channels, numChans);
+	memcpy(&payload[1 + numChans], values, numChans);
+	return submit(0x0083, payload, numBytes, NULL, 0, 0, 0, future);
+}
+
+int LinxRemoteDevice::SpiWriteReadAsync(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer, LinxRemoteFuture* future)
+{
+	unsigned int numDataBytes = (unsigned int)frameSize * numFrames;
+	unsigned int numBytes = 4 + numDataBytes;
+	if(frameSize == 0 || numBytes > maxPayload())
+	{
+		return reject(future);
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = channel;
+	payload[1] = frameSize;
+	payload[2] = csChan;
+	payload[3] = csLL;
+	memcpy(&payload[4], sendBuffer, numDataBytes);
+	return submit(0x0107, payload, numBytes, recBuffer, 0, numDataBytes, 0, future);
+}
+
+int LinxRemoteDevice::I2cWriteAsync(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer, LinxRemoteFuture* future)
+{
+	unsigned int numPayloadBytes = 3 + numBytes;
+	if(numPayloadBytes > maxPayload())
+	{
+		return reject(future);
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = channel;
+	payload[1] = slaveAddress;
+	payload[2] = eofConfig;
+	memcpy(&payload[3], sendBuffer, numBytes);
+	return submit(0x00E2, payload, numPayloadBytes, NULL, 0, 0, 0, future);
+}
+
+int LinxRemoteDevice::I2cReadAsync(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer, LinxRemoteFuture* future)
+{
+	unsigned char payload[6];
+	payload[0] = channel;
+	payload[1] = slaveAddress;
+	payload[2] = numBytes;
+	putU16(&payload[3], timeout);
+	payload[5] = eofConfig;
+	return submit(0x00E3, payload, sizeof(payload), recBuffer, 0, numBytes, timeout, future);
+}
+
+int LinxRemoteDevice::I2cWriteReadAsync(unsigned char channel, unsigned char slaveAddress, unsigned char numWriteBytes, unsigned char* sendBuffer, unsigned char numReadBytes, unsigned int timeout, unsigned char* recBuffer, LinxRemoteFuture* future)
+{
+	unsigned int numBytes = 5 + numWriteBytes;
+	if(numBytes > maxPayload())
+	{
+		return reject(future);
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = channel;
+	payload[1] = slaveAddress;
+	payload[2] = numReadBytes;
+	putU16(&payload[3], timeout);
+	memcpy(&payload[5], sendBuffer, numWriteBytes);
+	return submit(0x00E5, payload, numBytes, recBuffer, 0, numReadBytes, timeout, future);
+}
+
+int LinxRemoteDevice::UartWriteAsync(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer, LinxRemoteFuture* future)
+{
+	unsigned int numPayloadBytes = 1 + numBytes;
+	if(numPayloadBytes > maxPayload())
+	{
+		return reject(future);
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = channel;
+	memcpy(&payload[1], sendBuffer, numBytes);
+	return submit(0x00C4, payload, numPayloadBytes, NULL, 0, 0, 0, future);
+}
+
+int LinxRemoteDevice::ServoSetPulseWidthAsync(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths, LinxRemoteFuture* future)
+{
+	unsigned int numBytes = 1 + 3 * numChans;
+	if(numBytes > maxPayload())
+	{
+		return reject(future);
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = numChans;
+	memcpy(&payload[1], channels, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		putU16(&payload[1 + numChans + 2*i], pulseWidths[i]);
+	}
+	return submit(0x0141, payload, numBytes, NULL, 0, 0, 0, future);
+}
+
+/****************************************************************************************
+**  Analog
+****************************************************************************************/
+int LinxRemoteDevice::AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	LinxRemoteFuture future;
+	return finish(AnalogReadAsync(numChans, channels, values, &future), &future);
+}
+
+int LinxRemoteDevice::AnalogReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned long* values)
+{
+	unsigned char response[REMOTE_MAX_PACKET];
+	unsigned char numBytesRead = 0;
+	int status = transact(0x0064, channels, numChans, response, sizeof(response), 0, &numBytesRead);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	if(numBytesRead < 1 || response[0] < 1 || response[0] > 32 || (unsigned long)(numBytesRead - 1) < LinxBitPack::PackedSize(numChans, response[0]))
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	AiResolution = response[0];
+	LinxBitPack::Unpack(numChans, &response[1], AiResolution, values);
+	return L_OK;
+}
+
+int LinxRemoteDevice::AnalogSetRef(unsigned char mode, unsigned long voltage)
+{
+	unsigned char payload[5];
+	payload[0] = mode;
+	putU32(&payload[1], voltage);
+	int status = transactStatus(0x0060, payload, sizeof(payload));
+
+	//The Device Works Out The Voltage For Each Mode, So Ask It
+	unsigned char ref[4];
+	if(status == L_OK && transact(0x0061, NULL, 0, ref, sizeof(ref), 0, NULL) == L_OK)
+	{
+		AiRefSet = getU32(ref);
+	}
+	return status;
+}
+
+int LinxRemoteDevice::AnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize)
+{
+	unsigned int numBytes = 1 + numChans + 4;
+	if(numBytes > maxPayload())
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = numChans;
+	memcpy(&payload[1], channels, numChans);
+	putU32(&payload[1 + numChans], bufferSize);
+	int status = transactStatus(0x0066, payload, numBytes);
+	StreamNumChans = (status == L_OK) ? numChans : 0;
+	return status;
+}
+
+int LinxRemoteDevice::AnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned char* values, unsigned long* numScansRead)
+{
+	unsigned char resolution = 0;
+	unsigned char packed[REMOTE_MAX_PACKET];
+	int status = streamRead(numScans, timeout, packed, numScansRead, &resolution);
+	if(*numScansRead > 0)
+	{
+		memcpy(values, packed, LinxBitPack::PackedSize(*numScansRead * StreamNumChans, resolution));
+	}
+	return status;
+}
+
+int LinxRemoteDevice::AnalogStreamReadNoPacking(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead)
+{
+	unsigned char resolution = 0;
+	unsigned char packed[REMOTE_MAX_PACKET];
+	int status = streamRead(numScans, timeout, packed, numScansRead, &resolution);
+	if(*numScansRead > 0)
+	{
+		LinxBitPack::Unpack(*numScansRead * StreamNumChans, packed, resolution, values);
+	}
+	return status;
+}
+
+int LinxRemoteDevice::AnalogStreamGetScansBuffered(unsigned long* numScans)
+{
+	//Reading Zero Scans Returns Just The Count
+	unsigned char payload[4] = {0, 0, 0, 0};
+	unsigned char response[REMOTE_MAX_PACKET];
+	unsigned char numBytesRead = 0;
+	int status = transact(0x0067, payload, sizeof(payload), response, sizeof(response), 0, &numBytesRead);
+	*numScans = (numBytesRead >= 7) ? getU32(&response[3]) : 0;
+	return status;
+}
+
+int LinxRemoteDevice::AnalogStreamStop()
+{
+	StreamNumChans = 0;
+	return transactStatus(0x0068, NULL, 0);
+}
+
+/****************************************************************************************
+**  Digital
+****************************************************************************************/
+int LinxRemoteDevice::DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	LinxRemoteFuture future;
+	LinxRemoteFuture* pending = Batching ? NULL : &future;
+	return finish(DigitalWriteAsync(numChans, channels, values, pending), pending);
+}
+
+//Commands Carry The First Channel In The LSb
+int LinxRemoteDevice::DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	unsigned char packed[(REMOTE_MAX_PACKET + 7) / 8];
+	memset(packed, 0, sizeof(packed));
+	for(int i=0; i<numChans; i++)
+	{
+		if(values[i])
+		{
+			packed[i / 8] |= 1 << (i % 8);
+		}
+	}
+	return DigitalWrite(numChans, channels, packed);
+}
+
+int LinxRemoteDevice::DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	LinxRemoteFuture future;
+	return finish(DigitalReadAsync(numChans, channels, values, &future), &future);
+}
+
+//Responses Carry The First Channel In The MSb
+int LinxRemoteDevice::DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	unsigned char packed[(REMOTE_MAX_PACKET + 7) / 8];
+	int status = DigitalRead(numChans, channels, packed);
+	for(int i=0; i<numChans; i++)
+	{
+		values[i] = (status == L_OK) ? (packed[i / 8] >> (7 - (i % 8))) & 0x01 : 0;
+	}
+	return status;
+}
+
+int LinxRemoteDevice::DigitalWriteSquareWave(unsigned char channel, unsigned long freq, unsigned long duration)
+{
+	unsigned char payload[9];
+	payload[0] = channel;
+	putU32(&payload[1], freq);
+	putU32(&payload[5], duration);
+	return transactStatus(0x0043, payload, sizeof(payload));
+}
+
+int LinxRemoteDevice::DigitalReadPulseWidth(unsigned char stimChan, unsigned char stimType, unsigned char respChan, unsigned char respType, unsigned long timeout, unsigned long* width)
+{
+	unsigned char payload[8];
+	payload[0] = respChan;
+	payload[1] = stimChan;
+	payload[2] = stimType;
+	payload[3] = respType;
+	putU32(&payload[4], timeout);
+
+	//Timeout Is In uS
+	unsigned char response[4];
+	int status = transact(0x0044, payload, sizeof(payload), response, sizeof(response), timeout / 1000 + 1, NULL);
+	*width = (status == L_OK) ? getU32(response) : 0;
+	return status;
+}
+
+/****************************************************************************************
+**  PWM
+****************************************************************************************/
+int LinxRemoteDevice::PwmSetDutyCycle(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	LinxRemoteFuture future;
+	LinxRemoteFuture* pending = Batching ? NULL : &future;
+	return finish(PwmSetDutyCycleAsync(numChans, channels, values, pending), pending);
+}
+
+int LinxRemoteDevice::PwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned long* values)
+{
+	unsigned int numBytes = 1 + 5 * numChans;
+	if(numBytes > maxPayload())
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	payload[0] = numChans;
+	memcpy(&payload[1], channels, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		putU32(&payload[1 + numChans + 4*i], values[i]);
+	}
+	return transactStatus(0x0082, payload, numBytes);
+}
+
+/****************************************************************************************
+**  SPI
+****************************************************************************************/
+int LinxRemoteDevice::SpiOpenMaster(unsigned char channel)
+{
+	return transactStatus(0x0100, &channel, 1);
+}
+
+int LinxRemoteDevice::SpiSetBitOrder(unsigned char channel, unsigned char bitOrder)
+{
+	unsigned char payload[2] = {channel, bitOrder};
+	return transactStatus(0x0101, payload, sizeof(payload));
+}
+
+int LinxRemoteDevice::SpiSetMode(unsigned char channel, unsigned char mode)
+{
+	unsigned char payload[2] = {channel, mode};
+	return transactStatus(0x0103, payload, sizeof(payload));
+}
+
+int LinxRemoteDevice::SpiSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed)
+{
+	unsigned char payload[5];
+	payload[0] = channel;
+	putU32(&payload[1], speed);
+
+	unsigned char response[4];
+	int status = transact(0x0102, payload, sizeof(payload), response, sizeof(response), 0, NULL);
+	*actualSpeed = (status == L_OK) ? getU32(response) : 0;
+	return status;
+}
+
+int LinxRemoteDevice::SpiWriteRead(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer)
+{
+	LinxRemoteFuture future;
+	return finish(SpiWriteReadAsync(channel, frameSize, numFrames, csChan, csLL, sendBuffer, recBuffer, &future), &future);
+}
+
+int LinxRemoteDevice::SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments)
+{
+	//Header Then [Type][Num Bytes][Speed 32][Delay 16][Tx Data Unless Rx Only] Per Segment
+	unsigned char payload[REMOTE_MAX_PACKET];
+	unsigned int numBytes = 4;
+	unsigned int numRxBytes = 0;
+	payload[0] = channel;
+	payload[1] = csChan;
+	payload[2] = csLL;
+	payload[3] = numSegments;
+	for(int i=0; i<numSegments; i++)
+	{
+		unsigned int numTxBytes = (segments[i].type != SPI_SEGMENT_RX_ONLY) ? segments[i].numBytes : 0;
+		if(numBytes + 8 + numTxBytes > maxPayload())
+		{
+			return LSPI_INVALID_TRANSACTION;
+		}
+
+		payload[numBytes] = segments[i].type;
+		payload[numBytes + 1] = segments[i].numBytes;
+		putU32(&payload[numBytes + 2], segments[i].speed);
+		putU16(&payload[numBytes + 6], segments[i].delayUs);
+		numBytes += 8;
+		if(numTxBytes > 0)
+		{
+			if(segments[i].sendBuffer != NULL)
+			{
+				memcpy(&payload[numBytes], segments[i].sendBuffer, numTxBytes);
+			}
+			else
+			{
+				memset(&payload[numBytes], 0, numTxBytes);
+			}
+			numBytes += numTxBytes;
+		}
+		if(segments[i].type != SPI_SEGMENT_TX_ONLY)
+		{
+			numRxBytes += segments[i].numBytes;
+		}
+	}
+
+	unsigned char response[REMOTE_MAX_PACKET];
+	unsigned char numBytesRead = 0;
+	int status = transact(0x0108, payload, numBytes, response, sizeof(response), 0, &numBytesRead);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	if(numBytesRead < numRxBytes)
+	{
+		return LSPI_TRANSFER_FAIL;
+	}
+
+	//Rx Data Of Each Full Duplex And Rx Only Segment, In Order
+	unsigned int offset = 0;
+	for(int i=0; i<numSegments; i++)
+	{
+		if(segments[i].type != SPI_SEGMENT_TX_ONLY)
+		{
+			if(segments[i].recBuffer != NULL)
+			{
+				memcpy(segments[i].recBuffer, &response[offset], segments[i].numBytes);
+			}
+			offset += segments[i].numBytes;
+		}
+	}
+	return L_OK;
+}
+
+/****************************************************************************************
+**  I2C
+****************************************************************************************/
+int LinxRemoteDevice::I2cOpenMaster(unsigned char channel)
+{
+	return transactStatus(0x00E0, &channel, 1);
+}
+
+int LinxRemoteDevice::I2cSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed)
+{
+	unsigned char payload[5];
+	payload[0] = channel;
+	putU32(&payload[1], speed);
+
+	unsigned char response[4];
+	int status = transact(0x00E1, payload, sizeof(payload), response, sizeof(response), 0, NULL);
+	if(actualSpeed != NULL)
+	{
+		*actualSpeed = (status == L_OK) ? getU32(response) : 0;
+	}
+	return status;
+}
+
+int LinxRemoteDevice::I2cWrite(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer)
+{
+	LinxRemoteFuture future;
+	LinxRemoteFuture* pending = Batching ? NULL : &future;
+	return finish(I2cWriteAsync(channel, slaveAddress, eofConfig, numBytes, sendBuffer, pending), pending);
+}
+
+int LinxRemoteDevice::I2cRead(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer)
+{
+	LinxRemoteFuture future;
+	return finish(I2cReadAsync(channel, slaveAddress, eofConfig, numBytes, timeout, recBuffer, &future), &future);
+}
+
+int LinxRemoteDevice::I2cWriteRead(unsigned char channel, unsigned char slaveAddress, unsigned char numWriteBytes, unsigned char* sendBuffer, unsigned char numReadBytes, unsigned int timeout, unsigned char* recBuffer)
+{
+	LinxRemoteFuture future;
+	return finish(I2cWriteReadAsync(channel, slaveAddress, numWriteBytes, sendBuffer, numReadBytes, timeout, recBuffer, &future), &future);
+}
+
+int LinxRemoteDevice::I2cClose(unsigned char channel)
+{
+	return transactStatus(0x00E4, &channel, 1);
+}
+
+/****************************************************************************************
+**  UART
+****************************************************************************************/
+int LinxRemoteDevice::UartOpen(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud)
+{
+	unsigned char payload[5];
+	payload[0] = channel;
+	putU32(&payload[1], baudRate);
+
+	unsigned char response[4];
+	int status = transact(0x00C0, payload, sizeof(payload), response, sizeof(response), 0, NULL);
+	*actualBaud = (status == L_OK) ? getU32(response) : 0;
+	return status;
+}
+
+int LinxRemoteDevice::UartSetBaudRate(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud)
+{
+	unsigned char payload[5];
+	payload[0] = channel;
+	putU32(&payload[1], baudRate);
+
+	unsigned char response[4];
+	int status = transact(0x00C1, payload, sizeof(payload), response, sizeof(response), 0, NULL);
+	*actualBaud = (status == L_OK) ? getU32(response) : 0;
+	return status;
+}
+
+int LinxRemoteDevice::UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes)
+{
+	unsigned char response[1] = {0};
+	int status = transact(0x00C2, &channel, 1, response, sizeof(response), 0, NULL);
+	*numBytes = response[0];
+	return status;
+}
+
+int LinxRemoteDevice::UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead)
+{
+	unsigned char payload[2] = {channel, numBytes};
+	*numBytesRead = 0;
+	return transact(0x00C3, payload, sizeof(payload), recBuffer, numBytes, 0, numBytesRead);
+}
+
+//Longer Writes Are Split Into Packets That Fit The Listener
+int LinxRemoteDevice::UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer)
+{
+	LinxRemoteFuture future;
+	LinxRemoteFuture* pending = Batching ? NULL : &future;
+	unsigned int maxBytes = maxPayload() - 1;
+	unsigned int numSent = 0;
+	int status = L_OK;
+	do
+	{
+		unsigned int numChunkBytes = (numBytes - numSent < maxBytes) ? numBytes - numSent : maxBytes;
+		status = finish(UartWriteAsync(channel, numChunkBytes, sendBuffer + numSent, pending), pending);
+		numSent += numChunkBytes;
+	}
+	while(numSent < numBytes && status == L_OK);
+	return status;
+}
+
+int LinxRemoteDevice::UartEnableRxThread(unsigned char channel, unsigned long bufferSize)
+{
+	unsigned char payload[5];
+	payload[0] = channel;
+	putU32(&payload[1], bufferSize);
+	return transactStatus(0x00C6, payload, sizeof(payload));
+}
+
+//Each Request Returns At Most One Packet, So Keep Asking Until Enough Arrives Or Time Runs Out
+int LinxRemoteDevice::UartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp)
+{
+	unsigned long long deadline = monotonicMs() + timeout;
+	unsigned char response[REMOTE_MAX_PACKET];
+	int status = L_OK;
+	*numBytesRead = 0;
+	*timestamp = 0;
+
+	do
+	{
+		unsigned long long now = monotonicMs();
+		unsigned long remaining = (now < deadline) ? (unsigned long)(deadline - now) : 0;
+		unsigned long numWanted = numBytes - *numBytesRead;
+		unsigned char payload[4];
+		payload[0] = channel;
+		payload[1] = (numWanted < 255) ? numWanted : 255;
+		putU16(&payload[2], (remaining < 0xFFFF) ? remaining : 0xFFFF);
+
+		unsigned char numResponseBytes = 0;
+		status = transact(0x00C7, payload, sizeof(payload), response, sizeof(response), remaining, &numResponseBytes);
+		if(status != L_OK || numResponseBytes < 8)
+		{
+			break;
+		}
+
+		unsigned long numChunkBytes = numResponseBytes - 8;
+		if(numChunkBytes > numWanted)
+		{
+			numChunkBytes = numWanted;
+		}
+		if(*numBytesRead == 0 && numChunkBytes > 0)
+		{
+			for(int i=0; i<8; i++)
+			{
+				*timestamp = (*timestamp << 8) | response[i];
+			}
+		}
+		memcpy(recBuffer + *numBytesRead, &response[8], numChunkBytes);
+		*numBytesRead += numChunkBytes;
+	}
+	while(*numBytesRead < numBytes && monotonicMs() < deadline);
+
+	return status;
+}
+
+int LinxRemoteDevice::UartClose(unsigned char channel)
+{
+	return transactStatus(0x00C5, &channel, 1);
+}
+
+/****************************************************************************************
+**  Servo
+****************************************************************************************/
+int LinxRemoteDevice::ServoOpen(unsigned char numChans, unsigned char* channels)
+{
+	return transactStatus(0x0140, channels, numChans);
+}
+
+int LinxRemoteDevice::ServoSetPulseWidth(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths)
+{
+	LinxRemoteFuture future;
+	LinxRemoteFuture* pending = Batching ? NULL : &future;
+	return finish(ServoSetPulseWidthAsync(numChans, channels, pulseWidths, pending), pending);
+}
+
+int LinxRemoteDevice::ServoClose(unsigned char numChans, unsigned char* channels)
+{
+	return transactStatus(0x0142, channels, numChans);
+}
+
+int LinxRemoteDevice::SoftPwmGetStats(LinxSoftPwmStats* stats, unsigned char reset)
+{
+	unsigned char response[21];
+	unsigned char numBytesRead = 0;
+	int status = transact(0x0143, &reset, 1, response, sizeof(response), 0, &numBytesRead);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	if(numBytesRead < sizeof(response))
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	stats->realTime = response[0];
+	stats->numWakeups = getU32(&response[1]);
+	stats->numEdges = getU32(&response[5]);
+	stats->latencyMin = getU32(&response[9]);
+	stats->latencyMax = getU32(&response[13]);
+	stats->latencyMean = getU32(&response[17]);
+	return L_OK;
+}
+
+/****************************************************************************************
+**  WS2812
+****************************************************************************************/
+int LinxRemoteDevice::Ws2812Open(unsigned short numLeds, unsigned char dataChan)
+{
+	unsigned char payload[3];
+	putU16(payload, numLeds);
+	payload[2] = dataChan;
+	return transactStatus(0x0160, payload, sizeof(payload));
+}
+
+int LinxRemoteDevice::Ws2812WriteOnePixel(unsigned short pixelIndex, unsigned char red, unsigned char green, unsigned char blue, unsigned char refresh)
+{
+	unsigned char payload[6];
+	putU16(payload, pixelIndex);
+	payload[2] = red;
+	payload[3] = green;
+	payload[4] = blue;
+	payload[5] = refresh;
+	return transactStatus(0x0161, payload, sizeof(payload));
+}
+
+int LinxRemoteDevice::Ws2812WriteNPixels(unsigned short startPixel, unsigned short numPixels, unsigned char* data, unsigned char refresh)
+{
+	unsigned int numBytes = 5 + 3 * (unsigned int)numPixels;
+	if(numBytes > maxPayload())
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	unsigned char payload[REMOTE_MAX_PACKET];
+	putU16(&payload[0], startPixel);
+	putU16(&payload[2], numPixels);
+	payload[4] = refresh;
+	memcpy(&payload[5], data, 3 * numPixels);
+	return transactStatus(0x0162, payload, numBytes);
+}
+
+int LinxRemoteDevice::Ws2812Refresh()
+{
+	return transactStatus(0x0163, NULL, 0);
+}
+
+int LinxRemoteDevice::Ws2812Close()
+{
+	return transactStatus(0x0164, NULL, 0);
+}
+
+/****************************************************************************************
+**  General
+****************************************************************************************/
+unsigned long LinxRemoteDevice::GetMilliSeconds()
+{
+	return (unsigned long)(remoteTime(0) / 1000);
+}
+
+unsigned long LinxRemoteDevice::GetSeconds()
+{
+	return (unsigned long)(remoteTime(0) / 1000000);
+}
+
+unsigned long long LinxRemoteDevice::GetMicroSeconds()
+{
+	return remoteTime(0);
+}
+
+unsigned long long LinxRemoteDevice::GetNanoSeconds()
+{
+	return remoteTime(1);
+}
+
+void LinxRemoteDevice::DelayMs(unsigned long ms)
+{
+	struct timespec delay;
+	delay.tv_sec = ms / 1000;
+	delay.tv_nsec = (ms % 1000) * 1000000;
+	nanosleep(&delay, NULL);
+}
+
+void LinxRemoteDevice::NonVolatileWrite(int address, unsigned char data)
+{
+}
+
+unsigned char LinxRemoteDevice::NonVolatileRead(int address)
+{
+	return 0;
+}
+
+int LinxRemoteDevice::NonVolatileWriteBlock(int address, unsigned char numBytes, const unsigned char* data)
+{
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
+int LinxRemoteDevice::NonVolatileReadBlock(int address, unsigned char numBytes, unsigned char* data)
+{
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
+/****************************************************************************************
+**  Private Functions
+****************************************************************************************/
+void LinxRemoteDevice::clearDescription()
+{
+	DeviceFamily = 0;
+	DeviceId = 0;
+	DeviceNameLen = 0;
+	DeviceName = m_DeviceName;
+	LinxApiMajor = 0;
+	LinxApiMinor = 0;
+	LinxApiSubminor = 0;
+
+	NumDigitalChans = 0;
+	DigitalChans = m_DigitalChans;
+	NumAiChans = 0;
+	AiChans = m_AiChans;
+	AiResolution = 0;
+	AiRefDefault = 0;
+	AiRefSet = 0;
+	NumAoChans = 0;
+	AoChans = m_AoChans;
+	AoResolution = 0;
+	AoRefDefault = 0;
+	AoRefSet = 0;
+	NumPwmChans = 0;
+	PwmChans = m_PwmChans;
+	NumQeChans = 0;
+	QeChans = m_QeChans;
+	NumUartChans = 0;
+	UartChans = m_UartChans;
+	UartMaxBaud = 0;
+	NumI2cChans = 0;
+	I2cChans = m_I2cChans;
+	NumSpiChans = 0;
+	SpiChans = m_SpiChans;
+	NumCanChans = 0;
+	CanChans = m_CanChans;
+	NumServoChans = 0;
+	ServoChans = m_ServoChans;
+}
+
+//Largest Payload That Fits The Listener's Buffer After The 7 Byte Header And Checksum
+unsigned long LinxRemoteDevice::maxPayload()
+{
+	unsigned long packetSize = (ListenerBufferSize < REMOTE_MAX_PACKET) ? ListenerBufferSize : REMOTE_MAX_PACKET;
+	return (packetSize > 7) ? packetSize - 7 : 0;
+}
+
+int LinxRemoteDevice::reject(LinxRemoteFuture* future)
+{
+	if(future != NULL)
+	{
+		future->Done = true;
+		future->Status = L_UNKNOWN_ERROR;
+		future->NumBytes = 0;
+	}
+	return L_UNKNOWN_ERROR;
+}
+
+//Waits For A Submitted Request Unless It Was Fire And Forget Or Never Sent
+int LinxRemoteDevice::finish(int status, LinxRemoteFuture* future)
+{
+	if(future == NULL || status != L_OK)
+	{
+		return status;
+	}
+	return future->Wait();
+}
+
+int LinxRemoteDevice::submit(unsigned short command, const unsigned char* payload, unsigned int numBytes, unsigned char* response, unsigned char skip, unsigned long maxBytes, unsigned long extraMs, LinxRemoteFuture* future)
+{
+	if(future != NULL)
+	{
+		future->Done = false;
+		future->Status = L_UNKNOWN_ERROR;
+		future->NumBytes = 0;
+		future->Device = this;
+	}
+
+	int status = L_OK;
+	if(Fd < 0)
+	{
+		status = L_DISCONNECT;
+	}
+	else if(numBytes > maxPayload())
+	{
+		status = L_UNKNOWN_ERROR;
+	}
+
+	//Make Room In The Window, A Timeout Here Fails Everything Outstanding And Leaves Room
+	unsigned long window = (MaxInFlight < 1) ? 1 : (MaxInFlight > REMOTE_MAX_REQUESTS) ? REMOTE_MAX_REQUESTS : MaxInFlight;
+	while(status == L_OK && RequestCount >= window)
+	{
+		receive(true);
+		status = (Fd < 0) ? L_DISCONNECT : L_OK;
+	}
+
+	if(status == L_OK)
+	{
+		unsigned char packet[REMOTE_MAX_PACKET];
+		packet[0] = 0xFF;
+		packet[1] = numBytes + 7;
+		putU16(&packet[2], PacketNumber);
+		putU16(&packet[4], command);
+		if(numBytes > 0)
+		{
+			memcpy(&packet[6], payload, numBytes);
+		}
+		unsigned char checksum = 0;
+		for(unsigned int i=0; i<numBytes + 6; i++)
+		{
+			checksum += packet[i];
+		}
+		packet[numBytes + 6] = checksum;
+		status = writeFully(packet, numBytes + 7);
+	}
+
+	if(status != L_OK)
+	{
+		if(future != NULL)
+		{
+			future->Done = true;
+			future->Status = status;
+		}
+		return status;
+	}
+
+	LinxRemoteRequest* request = &Requests[(RequestHead + RequestCount) & (REMOTE_MAX_REQUESTS - 1)];
+	request->packetNumber = PacketNumber;
+	request->command = command;
+	request->future = future;
+	request->data = response;
+	request->skip = skip;
+	request->maxBytes = (maxBytes < REMOTE_MAX_PACKET) ? maxBytes : REMOTE_MAX_PACKET;
+	request->extraMs = extraMs;
+	RequestCount++;
+	PacketNumber++;
+	NumRequests++;
+	return L_OK;
+}
+
+//Fire And Forget While Batching Unless The Caller Wants Data Back
+int LinxRemoteDevice::transact(unsigned short command, const unsigned char* payload, unsigned int numBytes, unsigned char* response, unsigned char maxBytes, unsigned long extraMs, unsigned char* numBytesRead)
+{
+	if(Batching && response == NULL)
+	{
+		return submit(command, payload, numBytes, NULL, 0, 0, extraMs, NULL);
+	}
+
+	LinxRemoteFuture future;
+	int status = finish(submit(command, payload, numBytes, response, 0, maxBytes, extraMs, &future), &future);
+	if(numBytesRead != NULL)
+	{
+		*numBytesRead = future.NumBytes;
+	}
+	return status;
+}
+
+int LinxRemoteDevice::transactStatus(unsigned short command, const unsigned char* payload, unsigned int numBytes)
+{
+	return transact(command, payload, numBytes, NULL, 0, 0, NULL);
+}
+
+//Completes The Oldest Request, Returns L_OK If One Was
+int LinxRemoteDevice::receive(bool wait)
+{
+	while(RequestCount > 0)
+	{
+		unsigned long timeout = wait ? Timeout + Requests[RequestHead].extraMs : 0;
+		unsigned char packet[REMOTE_MAX_PACKET];
+		int status = readPacket(packet, timeout);
+		if(status != L_OK)
+		{
+			//Give Up On Everything Outstanding Rather Than Match Late Responses To The Wrong Requests
+			if(wait || status == L_DISCONNECT)
+			{
+				failOutstanding(status);
+			}
+			return status;
+		}
+
+		//Responses Nobody Is Waiting For Were Timed Out Earlier
+		unsigned short packetNumber = (packet[2] << 8) | packet[3];
+		unsigned long position = 0;
+		while(position < RequestCount && Requests[(RequestHead + position) & (REMOTE_MAX_REQUESTS - 1)].packetNumber != packetNumber)
+		{
+			position++;
+		}
+		if(position == RequestCount)
+		{
+			continue;
+		}
+
+		//Requests Ahead Of This One Were Dropped By The Listener
+		for(unsigned long i=0; i<=position; i++)
+		{
+			LinxRemoteRequest* request = &Requests[RequestHead];
+			RequestHead = (RequestHead + 1) & (REMOTE_MAX_REQUESTS - 1);
+			RequestCount--;
+			if(i < position)
+			{
+				complete(request, L_REQUEST_RESEND, NULL, 0);
+			}
+			else
+			{
+				complete(request, packet[4], &packet[5], packet[1] - 6);
+			}
+		}
+		return L_OK;
+	}
+	return L_UNKNOWN_ERROR;
+}
+
+void LinxRemoteDevice::complete(LinxRemoteRequest* request, int status, const unsigned char* data, unsigned char numBytes)
+{
+	unsigned char numCopied = 0;
+	if(request->data != NULL && numBytes > request->skip)
+	{
+		numCopied = numBytes - request->skip;
+		if(numCopied > request->maxBytes)
+		{
+			numCopied = request->maxBytes;
+		}
+		memcpy(request->data, data + request->skip, numCopied);
+	}
+
+	if(request->future != NULL)
+	{
+		request->future->NumBytes = numCopied;
+		request->future->Status = status;
+		request->future->Done = true;
+	}
+	else if(status != L_OK && FirstFailure == L_OK)
+	{
+		FirstFailure = status;
+	}
+}
+
+void LinxRemoteDevice::failOutstanding(int status)
+{
+	while(RequestCount > 0)
+	{
+		LinxRemoteRequest* request = &Requests[RequestHead];
+		RequestHead = (RequestHead + 1) & (REMOTE_MAX_REQUESTS - 1);
+		RequestCount--;
+		complete(request, status, NULL, 0);
+	}
+}
+
+//Next Response With A Good Checksum.  Passthrough Frames And Noise Are Skipped.
+int LinxRemoteDevice::readPacket(unsigned char* packet, unsigned long timeout)
+{
+	unsigned long long deadline = monotonicMs() + timeout;
+	while(true)
+	{
+		while(RxEnd - RxStart >= 2)
+		{
+			unsigned char* start = &RxBuffer[RxStart];
+			unsigned char size = start[1];
+			bool response = (start[0] == 0xFF && size >= 6);
+			bool passthrough = (start[0] == REMOTE_PASSTHROUGH_SOF && size >= 4);
+			if(!response && !passthrough)
+			{
+				RxStart++;
+				continue;
+			}
+			if(RxEnd - RxStart < size)
+			{
+				break;
+			}
+
+			unsigned char checksum = 0;
+			for(int i=0; i<size - 1; i++)
+			{
+				checksum += start[i];
+			}
+			if(checksum != start[size - 1])
+			{
+				RxStart++;
+				continue;
+			}
+
+			RxStart += size;
+			if(passthrough)
+			{
+				NumPassthroughFrames++;
+				continue;
+			}
+			memcpy(packet, start, size);
+			return L_OK;
+		}
+
+		unsigned long long now = monotonicMs();
+		int status = fill((now < deadline) ? (unsigned long)(deadline - now) : 0);
+		if(status != L_OK)
+		{
+			return status;
+		}
+	}
+}
+
+//Read Whatever Arrives Within timeout mS
+int LinxRemoteDevice::fill(unsigned long timeout)
+{
+	if(Fd < 0)
+	{
+		return L_DISCONNECT;
+	}
+
+	if(RxStart > 0)
+	{
+		memmove(RxBuffer, &RxBuffer[RxStart], RxEnd - RxStart);
+		RxEnd -= RxStart;
+		RxStart = 0;
+	}
+
+	struct pollfd poller;
+	poller.fd = Fd;
+	poller.events = POLLIN;
+	poller.revents = 0;
+	if(poll(&poller, 1, timeout) <= 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	ssize_t numRead = read(Fd, &RxBuffer[RxEnd], sizeof(RxBuffer) - RxEnd);
+	if(numRead <= 0)
+	{
+		close(Fd);
+		Fd = -1;
+		return L_DISCONNECT;
+	}
+	RxEnd += numRead;
+	return L_OK;
+}
+
+int LinxRemoteDevice::writeFully(const unsigned char* buffer, unsigned long numBytes)
+{
+	unsigned long numWritten = 0;
+	while(numWritten < numBytes)
+	{
+		ssize_t result = write(Fd, buffer + numWritten, numBytes - numWritten);
+		if(result > 0)
+		{
+			numWritten += result;
+			continue;
+		}
+
+		//Serial Ports May Be Non Blocking
+		struct pollfd poller;
+		poller.fd = Fd;
+		poller.events = POLLOUT;
+		poller.revents = 0;
+		if(result < 0 && (errno == EAGAIN || errno == EINTR) && poll(&poller, 1, Timeout) > 0)
+		{
+			continue;
+		}
+
+		close(Fd);
+		Fd = -1;
+		failOutstanding(L_DISCONNECT);
+		return L_DISCONNECT;
+	}
+	return L_OK;
+}
+
+unsigned long long LinxRemoteDevice::remoteTime(unsigned char nanoSeconds)
+{
+	unsigned char response[8];
+	unsigned char numBytesRead = 0;
+	if(transact(0x0026, &nanoSeconds, 1, response, sizeof(response), 0, &numBytesRead) != L_OK || numBytesRead < sizeof(response))
+	{
+		return 0;
+	}
+
+	unsigned long long time = 0;
+	for(int i=0; i<8; i++)
+	{
+		time = (time << 8) | response[i];
+	}
+	return time;
+}
+
+//Bytes After The Resolution, Scans Read And Scans Buffered Fields
+int LinxRemoteDevice::streamRead(unsigned long numScans, unsigned long timeout, unsigned char* packed, unsigned long* numScansRead, unsigned char* resolution)
+{
+	unsigned char payload[4];
+	putU16(&payload[0], (numScans < 0xFFFF) ? numScans : 0xFFFF);
+	putU16(&payload[2], (timeout < 0xFFFF) ? timeout : 0xFFFF);
+
+	unsigned char response[REMOTE_MAX_PACKET];
+	unsigned char numBytesRead = 0;
+	*numScansRead = 0;
+	int status = transact(0x0067, payload, sizeof(payload), response, sizeof(response), timeout, &numBytesRead);
+	if(numBytesRead < 7)
+	{
+		return (status != L_OK) ? status : L_UNKNOWN_ERROR;
+	}
+
+	*resolution = response[0];
+	*numScansRead = (response[1] << 8) | response[2];
+	unsigned long numDataBytes = (StreamNumChans > 0 && *resolution > 0) ? LinxBitPack::PackedSize(*numScansRead * StreamNumChans, *resolution) : 0;
+	if(numDataBytes > (unsigned long)(numBytesRead - 7))
+	{
+		*numScansRead = 0;
+		return L_UNKNOWN_ERROR;
+	}
+	memcpy(packed, &response[7], numDataBytes);
+	return status;
+}
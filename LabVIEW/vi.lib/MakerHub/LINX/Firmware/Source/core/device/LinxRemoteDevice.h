@@ -0,0 +1,260 @@
+/****************************************************************************************
+**  LINX header for a remote LINX device.
+**
+**  A host side LinxDevice that forwards every call to a LINX listener over TCP or a
+**  serial port, so code written against LinxDevice can drive a board on the network or
+**  on a USB cable.  Channel lists, the device name, API version and other values that
+**  do not change are fetched once when connecting and kept in the usual LinxDevice
+**  members.
+**
+**  Requests are tagged with their packet number and the listener answers them in
+**  order, so several can be outstanding at once.  The *Async() calls send a request and
+**  return straight away, filling in a LinxRemoteFuture when the response arrives.
+**  Between BeginBatch() and EndBatch() calls that only return a status are sent without
+**  waiting and the first failure is returned by EndBatch().
+**
+**  Linux only.  Not thread safe, use one LinxRemoteDevice per thread.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_REMOTEDEVICE_H
+#define LINX_REMOTEDEVICE_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define REMOTE_MAX_REQUESTS 64						//Requests Outstanding At Once, Must Be A Power Of Two
+#define REMOTE_TCP_WINDOW 16						//Default MaxInFlight Over TCP
+#define REMOTE_SERIAL_WINDOW 1						//Default MaxInFlight Over Serial, MCU UART Buffers Hold About One Packet
+#define REMOTE_DEFAULT_TIMEOUT 1000					//mS To Wait For Each Response
+#define REMOTE_RX_BUFFER_SIZE 4096
+#define REMOTE_MAX_PACKET 255
+#define REMOTE_PASSTHROUGH_SOF 0xFE					//UART Passthrough Frames From The Listener, Discarded
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "utility/LinxDevice.h"
+
+/****************************************************************************************
+**  Classes
+****************************************************************************************/
+class LinxRemoteDevice;
+
+//Result Of An *Async() Call.  Must Stay In Scope Until Done, Wait() Or Sync() Returns.
+class LinxRemoteFuture
+{
+	public:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		bool Done;
+		int Status;											//Valid Once Done
+		unsigned char NumBytes;								//Response Data Bytes Copied Out
+
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxRemoteFuture();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		int Wait();											//Block Until The Response Arrives, Returns Its Status
+		bool Ready();										//Take In Whatever Responses Have Arrived Without Blocking
+
+	private:
+		friend class LinxRemoteDevice;
+		LinxRemoteDevice* Device;
+};
+
+//One Outstanding Request.  Responses Come Back In Order So These Form A FIFO.
+typedef struct LinxRemoteRequest
+{
+	unsigned short packetNumber;
+	unsigned short command;
+	LinxRemoteFuture* future;						//NULL = Fire And Forget, Failures Go To Sync()
+	unsigned char* data;							//Response Data Is Copied Here
+	unsigned char skip;								//Leading Response Data Bytes Not Copied
+	unsigned char maxBytes;
+	unsigned long extraMs;							//Added To Timeout For Requests That Wait On The Device
+}LinxRemoteRequest;
+
+class LinxRemoteDevice : public LinxDevice
+{
+	public:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		unsigned char MaxInFlight;						//Requests Sent Before Waiting For The Oldest, 1 To REMOTE_MAX_REQUESTS
+		unsigned long Timeout;							//mS To Wait For Each Response
+		unsigned long NumRequests;						//Requests Sent Since Connecting
+		unsigned long NumPassthroughFrames;				//UART Passthrough Frames Received And Discarded
+
+		/****************************************************************************************
+		**  Constructors /  Destructor
+		****************************************************************************************/
+		LinxRemoteDevice();
+		virtual ~LinxRemoteDevice();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		//Connection
+		int ConnectTcp(const char* host, unsigned short port);
+		int ConnectSerial(const char* path, unsigned long baudRate);
+		int Refresh();									//Fetch The Cached Device Description Again
+		bool IsConnected();
+		int Close();									//Tell The Listener To Disconnect And Close The Transport
+
+		//Pipelining
+		void BeginBatch();
+		int EndBatch();
+		int Sync();										//Wait For Every Outstanding Request, Returns The First Fire And Forget Failure Since The Last Sync()
+		int Command(unsigned short command, const unsigned char* payload, unsigned char numBytes, unsigned char* response, unsigned char maxBytes, unsigned char* numBytesRead);
+		int CommandAsync(unsigned short command, const unsigned char* payload, unsigned char numBytes, unsigned char* response, unsigned char maxBytes, LinxRemoteFuture* future);
+
+		//Async Variants, Output Buffers Are Filled In When The Future Completes
+		int DigitalWriteAsync(unsigned char numChans, unsigned char* channels, unsigned char* values, LinxRemoteFuture* future);
+		int DigitalReadAsync(unsigned char numChans, unsigned char* channels, unsigned char* values, LinxRemoteFuture* future);
+		int AnalogReadAsync(unsigned char numChans, unsigned char* channels, unsigned char* values, LinxRemoteFuture* future);
+		int PwmSetDutyCycleAsync(unsigned char numChans, unsigned char* channels, unsigned char* values, LinxRemoteFuture* future);
+		int SpiWriteReadAsync(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer, LinxRemoteFuture* future);
+		int I2cWriteAsync(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer, LinxRemoteFuture* future);
+		int I2cReadAsync(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer, LinxRemoteFuture* future);
+		int I2cWriteReadAsync(unsigned char channel, unsigned char slaveAddress, unsigned char numWriteBytes, unsigned char* sendBuffer, unsigned char numReadBytes, unsigned int timeout, unsigned char* recBuffer, LinxRemoteFuture* future);
+		int UartWriteAsync(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer, LinxRemoteFuture* future);
+		int ServoSetPulseWidthAsync(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths, LinxRemoteFuture* future);
+
+		//Analog
+		virtual int AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int AnalogReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned long* values);
+		virtual int AnalogSetRef(unsigned char mode, unsigned long voltage);
+		virtual int AnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize);
+		virtual int AnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned char* values, unsigned long* numScansRead);		//Returns At Most One Packet Of Scans
+		virtual int AnalogStreamReadNoPacking(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead);
+		virtual int AnalogStreamGetScansBuffered(unsigned long* numScans);
+		virtual int AnalogStreamStop();
+
+		//DIGITAL
+		virtual int DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalWriteSquareWave(unsigned char channel, unsigned long freq, unsigned long duration);
+		virtual int DigitalReadPulseWidth(unsigned char stimChan, unsigned char stimType, unsigned char respChan, unsigned char respType, unsigned long timeout, unsigned long* width);
+
+		//PWM
+		virtual int PwmSetDutyCycle(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int PwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned long* values);
+
+		//SPI
+		virtual int SpiOpenMaster(unsigned char channel);
+		virtual int SpiSetBitOrder(unsigned char channel, unsigned char bitOrder);
+		virtual int SpiSetMode(unsigned char channel, unsigned char mode);
+		virtual int SpiSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed);
+		virtual int SpiWriteRead(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer);
+		virtual int SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments);
+
+		//I2C
+		virtual int I2cOpenMaster(unsigned char channel);
+		virtual int I2cSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed);
+		virtual int I2cWrite(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer);
+		virtual int I2cRead(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer);
+		virtual int I2cWriteRead(unsigned char channel, unsigned char slaveAddress, unsigned char numWriteBytes, unsigned char* sendBuffer, unsigned char numReadBytes, unsigned int timeout, unsigned char* recBuffer);
+		virtual int I2cClose(unsigned char channel);
+
+		//UART
+		virtual int UartOpen(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud);
+		virtual int UartSetBaudRate(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud);
+		virtual int UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes);
+		virtual int UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead);
+		virtual int UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer);
+		virtual int UartEnableRxThread(unsigned char channel, unsigned long bufferSize);
+		virtual int UartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp);
+		virtual int UartClose(unsigned char channel);
+
+		//Servo
+		virtual int ServoOpen(unsigned char numChans, unsigned char* channels);
+		virtual int ServoSetPulseWidth(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths);
+		virtual int ServoClose(unsigned char numChans, unsigned char* channels);
+		virtual int SoftPwmGetStats(LinxSoftPwmStats* stats, unsigned char reset);
+
+		//WS2812
+		virtual int Ws2812Open(unsigned short numLeds, unsigned char dataChan);
+		virtual int Ws2812WriteOnePixel(unsigned short pixelIndex, unsigned char red, unsigned char green, unsigned char blue, unsigned char refresh);
+		virtual int Ws2812WriteNPixels(unsigned short startPixel, unsigned short numPixels, unsigned char* data, unsigned char refresh);
+		virtual int Ws2812Refresh();
+		virtual int Ws2812Close();
+
+		//General - Times Are The Remote Device's, Each Is One Round Trip
+		virtual unsigned long GetMilliSeconds();
+		virtual unsigned long GetSeconds();
+		virtual unsigned long long GetMicroSeconds();
+		virtual unsigned long long GetNanoSeconds();
+		virtual void DelayMs(unsigned long ms);			//Sleeps Here, Not On The Device
+		virtual void NonVolatileWrite(int address, unsigned char data);		//The Protocol Has No Raw NVS Access
+		virtual unsigned char NonVolatileRead(int address);
+		virtual int NonVolatileWriteBlock(int address, unsigned char numBytes, const unsigned char* data);
+		virtual int NonVolatileReadBlock(int address, unsigned char numBytes, unsigned char* data);
+
+	private:
+		friend class LinxRemoteFuture;
+
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		int Fd;
+		unsigned short PacketNumber;
+		bool Batching;
+		int FirstFailure;								//First Fire And Forget Failure Since The Last Sync()
+
+		//Outstanding Requests
+		LinxRemoteRequest Requests[REMOTE_MAX_REQUESTS];
+		unsigned long RequestHead;
+		unsigned long RequestCount;
+
+		//Received Bytes Not Yet Parsed
+		unsigned char RxBuffer[REMOTE_RX_BUFFER_SIZE];
+		unsigned long RxStart;
+		unsigned long RxEnd;
+
+		//Cached Device Description
+		unsigned char m_DeviceName[REMOTE_MAX_PACKET];
+		unsigned char m_DigitalChans[REMOTE_MAX_PACKET];
+		unsigned char m_AiChans[REMOTE_MAX_PACKET];
+		unsigned char m_AoChans[REMOTE_MAX_PACKET];
+		unsigned char m_PwmChans[REMOTE_MAX_PACKET];
+		unsigned char m_QeChans[REMOTE_MAX_PACKET];
+		unsigned char m_UartChans[REMOTE_MAX_PACKET];
+		unsigned char m_I2cChans[REMOTE_MAX_PACKET];
+		unsigned char m_SpiChans[REMOTE_MAX_PACKET];
+		unsigned char m_CanChans[REMOTE_MAX_PACKET];
+		unsigned char m_ServoChans[REMOTE_MAX_PACKET];
+		unsigned char StreamNumChans;
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		void clearDescription();
+		unsigned long maxPayload();
+		int reject(LinxRemoteFuture* future);
+		int finish(int status, LinxRemoteFuture* future);
+		int submit(unsigned short command, const unsigned char* payload, unsigned int numBytes, unsigned char* response, unsigned char skip, unsigned long maxBytes, unsigned long extraMs, LinxRemoteFuture* future);
+		int transact(unsigned short command, const unsigned char* payload, unsigned int numBytes, unsigned char* response, unsigned char maxBytes, unsigned long extraMs, unsigned char* numBytesRead);
+		int transactStatus(unsigned short command, const unsigned char* payload, unsigned int numBytes);
+		int receive(bool wait);							//wait = false Only Takes What Has Already Arrived
+		void complete(LinxRemoteRequest* request, int status, const unsigned char* data, unsigned char numBytes);
+		void failOutstanding(int status);
+		int readPacket(unsigned char* packet, unsigned long timeout);
+		int fill(unsigned long timeout);
+		int writeFully(const unsigned char* buffer, unsigned long numBytes);
+		unsigned long long remoteTime(unsigned char nanoSeconds);
+		int streamRead(unsigned long numScans, unsigned long timeout, unsigned char* packed, unsigned long* numScansRead, unsigned char* resolution);
+};
+
+#endif //LINX_REMOTEDEVICE_H
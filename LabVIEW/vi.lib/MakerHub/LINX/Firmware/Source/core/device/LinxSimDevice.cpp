@@ -0,0 +1,1186 @@
+/****************************************************************************************
+**  LINX simulated device code.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "utility/LinxDevice.h"
+#include "utility/LinxBitPack.h"
+#include "LinxSimDevice.h"
+
+/****************************************************************************************
+**  Member Variables
+****************************************************************************************/
+//System
+const unsigned char LinxSimDevice::m_DeviceName[DEVICE_NAME_LEN] = "Simulated Device";
+
+//AI
+const unsigned char LinxSimDevice::m_AiChans[NUM_AI_CHANS] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+//DIGITAL - Channel Numbers Are Their Own Index
+const unsigned char LinxSimDevice::m_DigitalChans[NUM_DIGITAL_CHANS] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31};
+
+//PWM
+const unsigned char LinxSimDevice::m_PwmChans[NUM_PWM_CHANS] = {3, 5, 6, 9, 10, 11};
+
+//SPI
+const unsigned char LinxSimDevice::m_SpiChans[NUM_SPI_CHANS] = {0, 1};
+unsigned long LinxSimDevice::m_SpiSupportedSpeeds[NUM_SPI_SPEEDS] = {125000, 250000, 500000, 1000000, 2000000, 4000000, 8000000, 16000000};
+
+//I2C
+const unsigned char LinxSimDevice::m_I2cChans[NUM_I2C_CHANS] = {0, 1};
+
+//UART
+const unsigned char LinxSimDevice::m_UartChans[NUM_UART_CHANS] = {0, 1, 2};
+
+//SERVO
+//Same As Digital
+
+/****************************************************************************************
+**  LinxSimSlave
+****************************************************************************************/
+LinxSimSlave::LinxSimSlave()
+{
+	memset(Registers, 0, sizeof(Registers));
+	Pointer = 0;
+}
+
+LinxSimSlave::~LinxSimSlave()
+{
+}
+
+//Full Duplex Register Access: MISO Returns The Registers From The Pointer While MOSI Bytes After The First Are Stored
+void LinxSimSlave::SpiTransfer(unsigned char numBytes, const unsigned char* mosi, unsigned char* miso)
+{
+	for(int i=0; i<numBytes; i++)
+	{
+		if(i == 0)
+		{
+			miso[i] = 0;
+			Pointer = mosi[0];
+		}
+		else
+		{
+			miso[i] = Registers[Pointer];
+			Registers[Pointer] = mosi[i];
+			Pointer++;
+		}
+	}
+}
+
+bool LinxSimSlave::I2cWrite(unsigned char numBytes, const unsigned char* data)
+{
+	if(numBytes > 0)
+	{
+		Pointer = data[0];
+		for(int i=1; i<numBytes; i++)
+		{
+			Registers[Pointer++] = data[i];
+		}
+	}
+	return true;
+}
+
+bool LinxSimSlave::I2cRead(unsigned char numBytes, unsigned char* data)
+{
+	for(int i=0; i<numBytes; i++)
+	{
+		data[i] = Registers[Pointer++];
+	}
+	return true;
+}
+
+/****************************************************************************************
+**  Constructors /  Destructor
+****************************************************************************************/
+LinxSimDevice::LinxSimDevice()
+{
+	DeviceFamily = 0xFE;	//Simulated Family Code
+	DeviceId = 0x01;			//Simulated Device
+	DeviceNameLen = DEVICE_NAME_LEN;
+	DeviceName = m_DeviceName;
+	ListenerBufferSize = 255;
+
+	//LINX API Version
+	LinxApiMajor = 2;
+	LinxApiMinor = 2;
+	LinxApiSubminor = 0;
+
+	//DIGITAL
+	NumDigitalChans = NUM_DIGITAL_CHANS;
+	DigitalChans = m_DigitalChans;
+
+	//AI
+	NumAiChans = NUM_AI_CHANS;
+	AiChans = m_AiChans;
+	AiResolution = AI_RES_BITS;
+	AiRefDefault = AI_REFV;
+	AiRefSet = AI_REFV;
+
+	//AO
+	NumAoChans = 0;
+	AoChans = 0;
+	AoResolution = 0;
+	AoRefDefault = 0;
+	AoRefSet = 0;
+
+	//PWM
+	NumPwmChans = NUM_PWM_CHANS;
+	PwmChans = m_PwmChans;
+
+	//QE
+	NumQeChans = 0;
+	QeChans = 0;
+
+	//UART
+	NumUartChans = NUM_UART_CHANS;
+	UartChans = m_UartChans;
+	UartMaxBaud = UART_MAX_BAUD;
+
+	//I2C
+	NumI2cChans = NUM_I2C_CHANS;
+	I2cChans = m_I2cChans;
+
+	//SPI
+	NumSpiChans = NUM_SPI_CHANS;
+	SpiChans = m_SpiChans;
+
+	//CAN
+	NumCanChans = 0;
+	CanChans = 0;
+
+	//Servo
+	NumServoChans = NUM_SERVO_CHANS;
+	ServoChans = m_DigitalChans;
+
+	//Simulated State
+	StartTime = GetNanoSeconds();
+	Seed = 1;
+	memset(Latencies, 0, sizeof(Latencies));
+	memset(OpCounts, 0, sizeof(OpCounts));
+	memset(Nvs, 0xFF, sizeof(Nvs));
+
+	for(int i=0; i<NUM_AI_CHANS; i++)
+	{
+		AiGenerators[i].waveform = SIM_WAVE_CONSTANT;
+		AiGenerators[i].offset = 0;
+		AiGenerators[i].amplitude = 0;
+		AiGenerators[i].frequency = 0;
+	}
+
+	memset(DigitalDirs, INPUT, sizeof(DigitalDirs));
+	memset(DigitalOutputs, LOW, sizeof(DigitalOutputs));
+	memset(DigitalInputs, LOW, sizeof(DigitalInputs));
+	memset(SquareWaveFreqs, 0, sizeof(SquareWaveFreqs));
+	PulseWidth = 0;
+
+	memset(PwmDutyCycles, 0, sizeof(PwmDutyCycles));
+	memset(PwmFrequencies, 0, sizeof(PwmFrequencies));
+
+	for(int i=0; i<NUM_SPI_CHANS; i++)
+	{
+		SpiBitOrders[i] = MSBFIRST;
+		SpiModes[i] = 0;
+		SpiSpeeds[i] = m_SpiSupportedSpeeds[NUM_SPI_SPEEDS - 1];
+		SpiSlaves[i] = NULL;
+	}
+
+	for(int i=0; i<NUM_I2C_CHANS; i++)
+	{
+		I2cOpen[i] = false;
+		for(int j=0; j<128; j++)
+		{
+			I2cSlaves[i][j] = NULL;
+		}
+	}
+
+	for(int i=0; i<NUM_UART_CHANS; i++)
+	{
+		UartOpened[i] = false;
+		UartBauds[i] = 0;
+		UartHandles[i] = -1;
+		UartHeads[i] = 0;
+		UartCounts[i] = 0;
+	}
+
+	memset(ServoPulseWidths, 0, sizeof(ServoPulseWidths));
+
+	StreamRunning = false;
+	StreamNumChans = 0;
+	StreamRate = SIM_STREAM_DEFAULT_RATE;
+	StreamBufferScans = 0;
+	StreamStart = 0;
+	StreamConsumed = 0;
+	StreamOverrun = false;
+}
+
+//Attached Slaves And UART Handles Belong To The Caller
+LinxSimDevice::~LinxSimDevice()
+{
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+//------------------------------------- Simulation Setup -------------------------------------
+void LinxSimDevice::SetLatency(unsigned char op, unsigned long fixedNs, unsigned long perItemNs, unsigned long jitterNs)
+{
+	if(op < NUM_SIM_OPS)
+	{
+		Latencies[op].fixedNs = fixedNs;
+		Latencies[op].perItemNs = perItemNs;
+		Latencies[op].jitterNs = jitterNs;
+	}
+}
+
+void LinxSimDevice::SetAnalogWaveform(unsigned char channel, unsigned char waveform, unsigned long offset, unsigned long amplitude, double frequency)
+{
+	int index = aiIndex(channel);
+	if(index >= 0)
+	{
+		AiGenerators[index].waveform = waveform;
+		AiGenerators[index].offset = offset;
+		AiGenerators[index].amplitude = amplitude;
+		AiGenerators[index].frequency = frequency;
+	}
+}
+
+void LinxSimDevice::SetAnalogStreamRate(unsigned long scansPerSecond)
+{
+	if(scansPerSecond > 0)
+	{
+		StreamRate = scansPerSecond;
+	}
+}
+
+void LinxSimDevice::SetDigitalInput(unsigned char channel, unsigned char value)
+{
+	if(channel < NUM_DIGITAL_CHANS)
+	{
+		DigitalInputs[channel] = (value != LOW) ? HIGH : LOW;
+	}
+}
+
+void LinxSimDevice::AttachSpiSlave(unsigned char channel, LinxSimSlave* slave)
+{
+	int index = spiIndex(channel);
+	if(index >= 0)
+	{
+		SpiSlaves[index] = slave;
+	}
+}
+
+void LinxSimDevice::AttachI2cSlave(unsigned char channel, unsigned char address, LinxSimSlave* slave)
+{
+	int index = i2cIndex(channel);
+	if(index >= 0 && address < 128)
+	{
+		I2cSlaves[index][address] = slave;
+	}
+}
+
+int LinxSimDevice::UartAttach(unsigned char channel, int handle)
+{
+	int index = uartIndex(channel);
+	if(index < 0)
+	{
+		return LUART_OPEN_FAIL;
+	}
+	UartHandles[index] = handle;
+	UartCounts[index] = 0;
+	return L_OK;
+}
+
+int LinxSimDevice::UartInject(unsigned char channel, unsigned long numBytes, const unsigned char* data)
+{
+	int index = uartIndex(channel);
+	if(index < 0 || UartHandles[index] >= 0)
+	{
+		return LUART_WRITE_FAIL;
+	}
+
+	//Oldest Bytes Are Dropped When The Ring Is Full, Like A Hardware FIFO Overrun
+	for(unsigned long i=0; i<numBytes; i++)
+	{
+		UartBuffers[index][(UartHeads[index] + UartCounts[index]) % SIM_UART_BUFFER_SIZE] = data[i];
+		if(UartCounts[index] < SIM_UART_BUFFER_SIZE)
+		{
+			UartCounts[index]++;
+		}
+		else
+		{
+			UartHeads[index] = (UartHeads[index] + 1) % SIM_UART_BUFFER_SIZE;
+		}
+	}
+	return L_OK;
+}
+
+//------------------------------------- Analog -------------------------------------
+int LinxSimDevice::AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	unsigned long aiVals[256];
+	int status = AnalogReadNoPacking(numChans, channels, aiVals);
+	if(status != L_OK)
+	{
+		return status;
+	}
+
+	//Byte Packet AI Values In Response Packet
+	LinxBitPack::Pack(numChans, aiVals, AiResolution, values);
+	return L_OK;
+}
+
+int LinxSimDevice::AnalogReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned long* values)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(aiIndex(channels[i]) < 0)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+	}
+
+	simulate(SIM_OP_ANALOG, numChans);
+	unsigned long long now = GetNanoSeconds() - StartTime;
+	for(int i=0; i<numChans; i++)
+	{
+		values[i] = aiValue(channels[i], now);
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::AnalogSetRef(unsigned char mode, unsigned long voltage)
+{
+	switch(mode)
+	{
+		case 0: //Default
+			AiRefSet = AiRefDefault;
+			return L_OK;
+		case 2: //External
+			AiRefSet = voltage;
+			return L_OK;
+		default:
+			return LANALOG_REF_MODE_ERROR;
+	}
+}
+
+int LinxSimDevice::AnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize)
+{
+	if(numChans == 0 || numChans > NUM_AI_CHANS)
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	for(int i=0; i<numChans; i++)
+	{
+		if(aiIndex(channels[i]) < 0)
+		{
+			return LANALOG_STREAM_OPEN_FAIL;
+		}
+		StreamChans[i] = channels[i];
+	}
+
+	StreamNumChans = numChans;
+	StreamBufferScans = (bufferSize == 0) ? SIM_STREAM_DEFAULT_SCANS : bufferSize;
+	StreamStart = GetNanoSeconds();
+	StreamConsumed = 0;
+	StreamOverrun = false;
+	StreamRunning = true;
+	return L_OK;
+}
+
+int LinxSimDevice::AnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned char* values, unsigned long* numScansRead)
+{
+	*numScansRead = 0;
+	if(!StreamRunning)
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+
+	unsigned long* ticks = new unsigned long[numScans * StreamNumChans + 1];
+	int status = AnalogStreamReadNoPacking(numScans, timeout, ticks, numScansRead);
+	LinxBitPack::Pack(*numScansRead * StreamNumChans, ticks, AiResolution, values);
+	delete[] ticks;
+	return status;
+}
+
+//Scans Are Generated At StreamRate From The Start Time, So Reading Late Shows The Same Samples A Real ADC Would Have Buffered
+int LinxSimDevice::AnalogStreamReadNoPacking(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead)
+{
+	*numScansRead = 0;
+	if(!StreamRunning)
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+
+	unsigned long startTime = GetMilliSeconds();
+	unsigned long long available = streamAvailable();
+	while(available < numScans && GetMilliSeconds() - startTime < timeout)
+	{
+		usleep(1000);
+		available = streamAvailable();
+	}
+
+	unsigned long numRead = (available < numScans) ? (unsigned long)available : numScans;
+	simulate(SIM_OP_ANALOG, numRead * StreamNumChans);
+	for(unsigned long s=0; s<numRead; s++)
+	{
+		unsigned long long scan = StreamConsumed + s;
+		unsigned long long timeNs = (StreamStart - StartTime) + scan * 1000000000ULL / StreamRate;
+		for(int c=0; c<StreamNumChans; c++)
+		{
+			values[c*numRead + s] = aiValue(StreamChans[c], timeNs);
+		}
+	}
+	StreamConsumed += numRead;
+	*numScansRead = numRead;
+
+	if(StreamOverrun)
+	{
+		StreamOverrun = false;
+		return LANALOG_STREAM_OVERRUN;
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::AnalogStreamGetScansBuffered(unsigned long* numScans)
+{
+	*numScans = 0;
+	if(!StreamRunning)
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	*numScans = (unsigned long)streamAvailable();
+	return L_OK;
+}
+
+int LinxSimDevice::AnalogStreamStop()
+{
+	StreamRunning = false;
+	return L_OK;
+}
+
+//------------------------------------- Digital -------------------------------------
+int LinxSimDevice::DigitalSetDirection(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(channels[i] >= NUM_DIGITAL_CHANS)
+		{
+			return LDIGITAL_PIN_DNE;
+		}
+	}
+
+	unsigned char directions[numChans];
+	LinxBitPack::UnpackBits(numChans, values, directions);
+
+	simulate(SIM_OP_DIGITAL, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		DigitalDirs[channels[i]] = directions[i];
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	unsigned char bits[numChans];
+	LinxBitPack::UnpackBits(numChans, values, bits);
+	return DigitalWriteNoPacking(numChans, channels, bits);
+}
+
+int LinxSimDevice::DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(channels[i] >= NUM_DIGITAL_CHANS)
+		{
+			return LDIGITAL_PIN_DNE;
+		}
+	}
+
+	simulate(SIM_OP_DIGITAL, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		DigitalDirs[channels[i]] = OUTPUT;
+		DigitalOutputs[channels[i]] = (values[i] != LOW) ? HIGH : LOW;
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	unsigned char bits[numChans];
+	int status = DigitalReadNoPacking(numChans, channels, bits);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	LinxBitPack::PackBits(numChans, bits, values);
+	return L_OK;
+}
+
+//Reading Makes The Pin An Input, Like The Hardware Backends
+int LinxSimDevice::DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(channels[i] >= NUM_DIGITAL_CHANS)
+		{
+			return LDIGITAL_PIN_DNE;
+		}
+	}
+
+	simulate(SIM_OP_DIGITAL, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		DigitalDirs[channels[i]] = INPUT;
+		values[i] = DigitalInputs[channels[i]];
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::DigitalWriteSquareWave(unsigned char channel, unsigned long freq, unsigned long duration)
+{
+	if(channel >= NUM_DIGITAL_CHANS)
+	{
+		return LDIGITAL_PIN_DNE;
+	}
+
+	simulate(SIM_OP_DIGITAL, 1);
+	DigitalDirs[channel] = OUTPUT;
+	SquareWaveFreqs[channel] = freq;
+	return L_OK;
+}
+
+int LinxSimDevice::DigitalReadPulseWidth(unsigned char stimChan, unsigned char stimType, unsigned char respChan, unsigned char respType, unsigned long timeout, unsigned long* width)
+{
+	if(stimChan >= NUM_DIGITAL_CHANS || respChan >= NUM_DIGITAL_CHANS)
+	{
+		return LDIGITAL_PIN_DNE;
+	}
+
+	simulate(SIM_OP_DIGITAL, 2);
+	*width = (PulseWidth <= timeout * 1000) ? PulseWidth : 0;
+	return L_OK;
+}
+
+//------------------------------------- PWM -------------------------------------
+int LinxSimDevice::PwmSetDutyCycle(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(memchr(m_PwmChans, channels[i], NUM_PWM_CHANS) == NULL)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+	}
+
+	simulate(SIM_OP_PWM, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		PwmDutyCycles[channels[i]] = values[i];
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::PwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned long* values)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(memchr(m_PwmChans, channels[i], NUM_PWM_CHANS) == NULL)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+	}
+
+	simulate(SIM_OP_PWM, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		PwmFrequencies[channels[i]] = values[i];
+	}
+	return L_OK;
+}
+
+//------------------------------------- SPI -------------------------------------
+int LinxSimDevice::SpiOpenMaster(unsigned char channel)
+{
+	if(spiIndex(channel) < 0)
+	{
+		return LSPI_OPEN_FAIL;
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::SpiSetBitOrder(unsigned char channel, unsigned char bitOrder)
+{
+	int index = spiIndex(channel);
+	if(index < 0)
+	{
+		return LSPI_OPEN_FAIL;
+	}
+	SpiBitOrders[index] = bitOrder;
+	return L_OK;
+}
+
+int LinxSimDevice::SpiSetMode(unsigned char channel, unsigned char mode)
+{
+	int index = spiIndex(channel);
+	if(index < 0 || mode > 3)
+	{
+		return LSPI_OPEN_FAIL;
+	}
+	SpiModes[index] = mode;
+	return L_OK;
+}
+
+//Closest Supported Speed That Is Not Faster Than Requested
+int LinxSimDevice::SpiSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed)
+{
+	int index = spiIndex(channel);
+	if(index < 0)
+	{
+		return LSPI_OPEN_FAIL;
+	}
+
+	int speedIndex = 0;
+	while(speedIndex < NUM_SPI_SPEEDS-1 && m_SpiSupportedSpeeds[speedIndex+1] <= speed)
+	{
+		speedIndex++;
+	}
+	SpiSpeeds[index] = m_SpiSupportedSpeeds[speedIndex];
+	*actualSpeed = SpiSpeeds[index];
+	return L_OK;
+}
+
+int LinxSimDevice::SpiWriteRead(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer)
+{
+	LinxSpiSegment segments[numFrames];
+	for(int i=0; i<numFrames; i++)
+	{
+		segments[i].type = SPI_SEGMENT_FULL_DUPLEX;
+		segments[i].numBytes = frameSize;
+		segments[i].speed = 0;
+		segments[i].delayUs = 0;
+		segments[i].sendBuffer = sendBuffer + i*frameSize;
+		segments[i].recBuffer = recBuffer + i*frameSize;
+	}
+
+	//CS Is Released Between Frames
+	for(int i=0; i<numFrames; i++)
+	{
+		int status = SpiTransaction(channel, csChan, csLL, 1, &segments[i]);
+		if(status != L_OK)
+		{
+			return status;
+		}
+	}
+	return L_OK;
+}
+
+//An Attached Slave Sees Bytes As They Are On The Wire, So LSb First Transfers Reach It Bit Reversed
+int LinxSimDevice::SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments)
+{
+	int index = spiIndex(channel);
+	if(index < 0)
+	{
+		return LSPI_OPEN_FAIL;
+	}
+	if(csChan >= NUM_DIGITAL_CHANS)
+	{
+		return LSPI_TRANSFER_FAIL;
+	}
+
+	unsigned long numBytes = 0;
+	for(int i=0; i<numSegments; i++)
+	{
+		numBytes += segments[i].numBytes;
+	}
+	simulate(SIM_OP_SPI, numBytes);
+
+	LinxSimSlave* slave = SpiSlaves[index];
+	bool reverseBits = (SpiBitOrders[index] == LSBFIRST && slave != NULL);
+
+	DigitalDirs[csChan] = OUTPUT;
+	DigitalOutputs[csChan] = csLL & 0x01;
+	for(int i=0; i<numSegments; i++)
+	{
+		unsigned char mosi[256];
+		unsigned char miso[256];
+		if(segments[i].type == SPI_SEGMENT_RX_ONLY || segments[i].sendBuffer == NULL)
+		{
+			memset(mosi, 0, segments[i].numBytes);
+		}
+		else if(reverseBits)
+		{
+			LinxBitPack::ReverseBits(segments[i].numBytes, segments[i].sendBuffer, mosi);
+		}
+		else
+		{
+			memcpy(mosi, segments[i].sendBuffer, segments[i].numBytes);
+		}
+
+		if(slave != NULL)
+		{
+			slave->SpiTransfer(segments[i].numBytes, mosi, miso);
+			if(reverseBits)
+			{
+				LinxBitPack::ReverseBits(segments[i].numBytes, miso, miso);
+			}
+		}
+		else
+		{
+			memcpy(miso, mosi, segments[i].numBytes);
+		}
+
+		if(segments[i].type != SPI_SEGMENT_TX_ONLY && segments[i].recBuffer != NULL)
+		{
+			memcpy(segments[i].recBuffer, miso, segments[i].numBytes);
+		}
+		if(segments[i].delayUs > 0)
+		{
+			usleep(segments[i].delayUs);
+		}
+	}
+	DigitalOutputs[csChan] = ~csLL & 0x01;
+	return L_OK;
+}
+
+//------------------------------------- I2C -------------------------------------
+int LinxSimDevice::I2cOpenMaster(unsigned char channel)
+{
+	int index = i2cIndex(channel);
+	if(index < 0)
+	{
+		return LI2C_OPEN_FAIL;
+	}
+	I2cOpen[index] = true;
+	return L_OK;
+}
+
+int LinxSimDevice::I2cSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed)
+{
+	if(i2cIndex(channel) < 0)
+	{
+		return LI2C_OPEN_FAIL;
+	}
+	*actualSpeed = speed;
+	return L_OK;
+}
+
+int LinxSimDevice::I2cWrite(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer)
+{
+	int index = i2cIndex(channel);
+	if(index < 0 || !I2cOpen[index])
+	{
+		return LI2C_WRITE_FAIL;
+	}
+	if(eofConfig > EOF_NOSTOP)
+	{
+		return LI2C_EOF;
+	}
+	if(slaveAddress >= 128)
+	{
+		return LI2C_SADDR;
+	}
+
+	simulate(SIM_OP_I2C, numBytes + 1);
+	LinxSimSlave* slave = I2cSlaves[index][slaveAddress];
+	if(slave == NULL || !slave->I2cWrite(numBytes, sendBuffer))
+	{
+		return LI2C_WRITE_FAIL;
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::I2cRead(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer)
+{
+	int index = i2cIndex(channel);
+	if(index < 0 || !I2cOpen[index])
+	{
+		return LI2C_READ_FAIL;
+	}
+	if(eofConfig > EOF_NOSTOP)
+	{
+		return LI2C_EOF;
+	}
+	if(slaveAddress >= 128)
+	{
+		return LI2C_SADDR;
+	}
+
+	simulate(SIM_OP_I2C, numBytes + 1);
+	LinxSimSlave* slave = I2cSlaves[index][slaveAddress];
+	if(slave == NULL || !slave->I2cRead(numBytes, recBuffer))
+	{
+		return LI2C_READ_FAIL;
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::I2cClose(unsigned char channel)
+{
+	int index = i2cIndex(channel);
+	if(index < 0)
+	{
+		return LI2C_CLOSE_FAIL;
+	}
+	I2cOpen[index] = false;
+	return L_OK;
+}
+
+//------------------------------------- UART -------------------------------------
+int LinxSimDevice::UartOpen(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud)
+{
+	int index = uartIndex(channel);
+	if(index < 0)
+	{
+		return LUART_OPEN_FAIL;
+	}
+	UartOpened[index] = true;
+	return UartSetBaudRate(channel, baudRate, actualBaud);
+}
+
+int LinxSimDevice::UartSetBaudRate(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud)
+{
+	int index = uartIndex(channel);
+	if(index < 0)
+	{
+		return LUART_SET_BAUD_FAIL;
+	}
+	UartBauds[index] = (baudRate > UART_MAX_BAUD) ? UART_MAX_BAUD : baudRate;
+	*actualBaud = UartBauds[index];
+	return L_OK;
+}
+
+int LinxSimDevice::UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes)
+{
+	unsigned long buffered = 0;
+	int status = UartGetBytesBuffered(channel, &buffered);
+	*numBytes = (buffered > 255) ? 255 : (unsigned char)buffered;
+	return status;
+}
+
+int LinxSimDevice::UartGetBytesBuffered(unsigned char channel, unsigned long* numBytes)
+{
+	*numBytes = 0;
+	int index = uartIndex(channel);
+	if(index < 0 || !UartOpened[index])
+	{
+		return LUART_AVAILABLE_FAIL;
+	}
+
+	if(UartHandles[index] >= 0)
+	{
+		int available = 0;
+		if(ioctl(UartHandles[index], FIONREAD, &available) < 0)
+		{
+			return LUART_AVAILABLE_FAIL;
+		}
+		*numBytes = available;
+	}
+	else
+	{
+		*numBytes = UartCounts[index];
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead)
+{
+	*numBytesRead = 0;
+	int index = uartIndex(channel);
+	if(index < 0 || !UartOpened[index])
+	{
+		return LUART_READ_FAIL;
+	}
+
+	simulate(SIM_OP_UART, numBytes);
+	if(UartHandles[index] >= 0)
+	{
+		int bytesRead = read(UartHandles[index], recBuffer, numBytes);
+		if(bytesRead < 0)
+		{
+			if(errno == EAGAIN || errno == EINTR)
+			{
+				return L_OK;
+			}
+			return LUART_READ_FAIL;
+		}
+		*numBytesRead = bytesRead;
+		return L_OK;
+	}
+
+	unsigned char count = (UartCounts[index] < numBytes) ? (unsigned char)UartCounts[index] : numBytes;
+	for(int i=0; i<count; i++)
+	{
+		recBuffer[i] = UartBuffers[index][UartHeads[index]];
+		UartHeads[index] = (UartHeads[index] + 1) % SIM_UART_BUFFER_SIZE;
+	}
+	UartCounts[index] -= count;
+	*numBytesRead = count;
+	return L_OK;
+}
+
+int LinxSimDevice::UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer)
+{
+	int index = uartIndex(channel);
+	if(index < 0 || !UartOpened[index])
+	{
+		return LUART_WRITE_FAIL;
+	}
+
+	simulate(SIM_OP_UART, numBytes);
+	if(UartHandles[index] >= 0)
+	{
+		unsigned char written = 0;
+		while(written < numBytes)
+		{
+			int result = write(UartHandles[index], sendBuffer + written, numBytes - written);
+			if(result < 0)
+			{
+				if(errno == EINTR || errno == EAGAIN)
+				{
+					continue;
+				}
+				return LUART_WRITE_FAIL;
+			}
+			written += result;
+		}
+		return L_OK;
+	}
+
+	return UartInject(channel, numBytes, sendBuffer);
+}
+
+int LinxSimDevice::UartGetFileDescriptor(unsigned char channel)
+{
+	int index = uartIndex(channel);
+	return (index < 0) ? -1 : UartHandles[index];
+}
+
+int LinxSimDevice::UartClose(unsigned char channel)
+{
+	int index = uartIndex(channel);
+	if(index < 0)
+	{
+		return LUART_CLOSE_FAIL;
+	}
+	UartOpened[index] = false;
+	return L_OK;
+}
+
+//------------------------------------- Servo -------------------------------------
+int LinxSimDevice::ServoOpen(unsigned char numChans, unsigned char* channels)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(channels[i] >= NUM_DIGITAL_CHANS)
+		{
+			return LDIGITAL_PIN_DNE;
+		}
+	}
+	simulate(SIM_OP_SERVO, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		DigitalDirs[channels[i]] = OUTPUT;
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::ServoSetPulseWidth(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(channels[i] >= NUM_DIGITAL_CHANS)
+		{
+			return LDIGITAL_PIN_DNE;
+		}
+	}
+	simulate(SIM_OP_SERVO, numChans);
+	for(int i=0; i<numChans; i++)
+	{
+		ServoPulseWidths[channels[i]] = pulseWidths[i];
+	}
+	return L_OK;
+}
+
+int LinxSimDevice::ServoClose(unsigned char numChans, unsigned char* channels)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(channels[i] < NUM_DIGITAL_CHANS)
+		{
+			ServoPulseWidths[channels[i]] = 0;
+		}
+	}
+	return L_OK;
+}
+
+//------------------------------------- General -------------------------------------
+unsigned long LinxSimDevice::GetMilliSeconds()
+{
+	return (unsigned long)(GetNanoSeconds() / 1000000);
+}
+
+unsigned long LinxSimDevice::GetSeconds()
+{
+	return (unsigned long)(GetNanoSeconds() / 1000000000);
+}
+
+unsigned long long LinxSimDevice::GetMicroSeconds()
+{
+	return GetNanoSeconds() / 1000;
+}
+
+unsigned long long LinxSimDevice::GetNanoSeconds()
+{
+	timespec mTime;
+	clock_gettime(CLOCK_MONOTONIC, &mTime);
+	return (unsigned long long)mTime.tv_sec * 1000000000ULL + mTime.tv_nsec;
+}
+
+void LinxSimDevice::DelayMs(unsigned long ms)
+{
+	usleep(ms * 1000);
+}
+
+void LinxSimDevice::NonVolatileWrite(int address, unsigned char data)
+{
+	if(address >= 0 && address < SIM_NVS_SIZE)
+	{
+		simulate(SIM_OP_NVS, 1);
+		Nvs[address] = data;
+	}
+}
+
+unsigned char LinxSimDevice::NonVolatileRead(int address)
+{
+	if(address < 0 || address >= SIM_NVS_SIZE)
+	{
+		return 0xFF;
+	}
+	return Nvs[address];
+}
+
+/****************************************************************************************
+**  Private Functions
+****************************************************************************************/
+//Sleep Most Of A Long Latency, Then Spin So Short Ones Are Still Accurate
+void LinxSimDevice::simulate(unsigned char op, unsigned long numItems)
+{
+	OpCounts[op]++;
+
+	LinxSimLatency* latency = &Latencies[op];
+	unsigned long long delay = latency->fixedNs + (unsigned long long)latency->perItemNs * numItems;
+	if(latency->jitterNs > 0)
+	{
+		delay += (unsigned long long)rand_r(&Seed) % (latency->jitterNs + 1);
+	}
+	if(delay == 0)
+	{
+		return;
+	}
+
+	unsigned long long deadline = GetNanoSeconds() + delay;
+	if(delay > 200000)
+	{
+		struct timespec sleepTime;
+		sleepTime.tv_sec = (delay - 100000) / 1000000000ULL;
+		sleepTime.tv_nsec = (delay - 100000) % 1000000000ULL;
+		nanosleep(&sleepTime, NULL);
+	}
+	while(GetNanoSeconds() < deadline)
+	{
+	}
+}
+
+unsigned long LinxSimDevice::aiValue(unsigned char channel, unsigned long long timeNs)
+{
+	LinxSimGenerator* generator = &AiGenerators[aiIndex(channel)];
+	double phase = generator->frequency * ((double)timeNs / 1e9);
+	phase -= floor(phase);
+
+	double shape = 0;
+	switch(generator->waveform)
+	{
+		case SIM_WAVE_SINE:
+			shape = sin(2 * M_PI * phase);
+			break;
+		case SIM_WAVE_SQUARE:
+			shape = (phase < 0.5) ? 1 : -1;
+			break;
+		case SIM_WAVE_TRIANGLE:
+			shape = (phase < 0.5) ? (4 * phase - 1) : (3 - 4 * phase);
+			break;
+		case SIM_WAVE_SAWTOOTH:
+			shape = 2 * phase - 1;
+			break;
+		case SIM_WAVE_NOISE:
+			shape = 2.0 * rand_r(&Seed) / RAND_MAX - 1;
+			break;
+		default:
+			break;
+	}
+
+	double value = floor(generator->offset + generator->amplitude * shape + 0.5);
+	double maxValue = (double)((1UL << AiResolution) - 1);
+	if(value < 0)
+	{
+		value = 0;
+	}
+	else if(value > maxValue)
+	{
+		value = maxValue;
+	}
+	return (unsigned long)value;
+}
+
+int LinxSimDevice::aiIndex(unsigned char channel)
+{
+	const void* found = memchr(m_AiChans, channel, NUM_AI_CHANS);
+	return (found == NULL) ? -1 : (const unsigned char*)found - m_AiChans;
+}
+
+int LinxSimDevice::spiIndex(unsigned char channel)
+{
+	const void* found = memchr(m_SpiChans, channel, NUM_SPI_CHANS);
+	return (found == NULL) ? -1 : (const unsigned char*)found - m_SpiChans;
+}
+
+int LinxSimDevice::i2cIndex(unsigned char channel)
+{
+	const void* found = memchr(m_I2cChans, channel, NUM_I2C_CHANS);
+	return (found == NULL) ? -1 : (const unsigned char*)found - m_I2cChans;
+}
+
+int LinxSimDevice::uartIndex(unsigned char channel)
+{
+	const void* found = memchr(m_UartChans, channel, NUM_UART_CHANS);
+	return (found == NULL) ? -1 : (const unsigned char*)found - m_UartChans;
+}
+
+//Scans Generated Since Start And Not Yet Read.  Once More Than The Buffer Holds The Oldest Are Dropped.
+unsigned long long LinxSimDevice::streamAvailable()
+{
+	unsigned long long produced = (GetNanoSeconds() - StreamStart) * StreamRate / 1000000000ULL;
+	if(produced - StreamConsumed > StreamBufferScans)
+	{
+		StreamConsumed = produced - StreamBufferScans;
+		StreamOverrun = true;
+	}
+	return produced - StreamConsumed;
+}
@@ -0,0 +1,279 @@
+/****************************************************************************************
+**  LINX header for the simulated LINX device.
+**
+**  A host only device with no hardware behind it, for testing listeners and measuring
+**  them in CI.  Pins live in memory, AI channels are driven by waveform generators, SPI
+**  loops MOSI back to MISO unless a slave is attached, I2C addresses answer only when a
+**  slave is attached and UARTs loop back unless bound to a file descriptor.  Each kind
+**  of operation can be given a latency so timing looks like a real board.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_SIMDEVICE_H
+#define LINX_SIMDEVICE_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define DEVICE_NAME_LEN 17
+
+#define NUM_AI_CHANS 8
+#define AI_RES_BITS 12
+#define AI_REFV 3300000
+
+#define NUM_DIGITAL_CHANS 32
+
+#define NUM_PWM_CHANS 6
+
+#define NUM_SPI_CHANS 2
+#define NUM_SPI_SPEEDS 8
+
+#define NUM_I2C_CHANS 2
+
+#define NUM_UART_CHANS 3
+#define UART_MAX_BAUD 4000000
+
+#define NUM_SERVO_CHANS NUM_DIGITAL_CHANS
+
+#define SIM_NVS_SIZE 1024
+#define SIM_UART_BUFFER_SIZE 4096					//Loopback Bytes Held Per Channel
+#define SIM_STREAM_DEFAULT_RATE 1000				//AI Stream Scans Per Second
+#define SIM_STREAM_DEFAULT_SCANS 65536				//Stream Buffer Size Used When 0 Is Requested (Scans)
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "utility/LinxDevice.h"
+
+/****************************************************************************************
+**  Typedefs
+****************************************************************************************/
+typedef enum LinxSimOp
+{
+	SIM_OP_ANALOG = 0,
+	SIM_OP_DIGITAL,
+	SIM_OP_PWM,
+	SIM_OP_SPI,
+	SIM_OP_I2C,
+	SIM_OP_UART,
+	SIM_OP_SERVO,
+	SIM_OP_NVS,
+	NUM_SIM_OPS
+}LinxSimOp;
+
+//Time Each Call Of One Kind Takes: fixedNs + perItemNs * Channels Or Bytes + Up To jitterNs
+typedef struct LinxSimLatency
+{
+	unsigned long fixedNs;
+	unsigned long perItemNs;
+	unsigned long jitterNs;
+}LinxSimLatency;
+
+typedef enum LinxSimWaveform
+{
+	SIM_WAVE_CONSTANT = 0,
+	SIM_WAVE_SINE,
+	SIM_WAVE_SQUARE,
+	SIM_WAVE_TRIANGLE,
+	SIM_WAVE_SAWTOOTH,
+	SIM_WAVE_NOISE
+}LinxSimWaveform;
+
+typedef struct LinxSimGenerator
+{
+	unsigned char waveform;							//LinxSimWaveform
+	unsigned long offset;							//ADC Ticks
+	unsigned long amplitude;						//ADC Ticks, Peak
+	double frequency;								//Hz
+}LinxSimGenerator;
+
+//A Device On A Simulated Bus.  The Defaults Make A 256 Byte Register File: The First Byte
+//Written Sets The Register Pointer, Later Bytes Are Stored And Reads Return From The
+//Pointer, Auto Incrementing.  Override To Script Other Behaviour.
+class LinxSimSlave
+{
+	public:
+		unsigned char Registers[256];
+		unsigned char Pointer;
+
+		LinxSimSlave();
+		virtual ~LinxSimSlave();
+
+		virtual void SpiTransfer(unsigned char numBytes, const unsigned char* mosi, unsigned char* miso);
+		virtual bool I2cWrite(unsigned char numBytes, const unsigned char* data);		//false = NACK
+		virtual bool I2cRead(unsigned char numBytes, unsigned char* data);
+};
+
+class LinxSimDevice : public LinxDevice
+{
+	public:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		//System
+		static const unsigned char m_DeviceName[DEVICE_NAME_LEN];
+
+		//AI
+		static const unsigned char m_AiChans[NUM_AI_CHANS];
+		LinxSimGenerator AiGenerators[NUM_AI_CHANS];
+
+		//DIGITAL
+		static const unsigned char m_DigitalChans[NUM_DIGITAL_CHANS];
+		unsigned char DigitalDirs[NUM_DIGITAL_CHANS];
+		unsigned char DigitalOutputs[NUM_DIGITAL_CHANS];	//Level Driven When The Pin Is An Output
+		unsigned char DigitalInputs[NUM_DIGITAL_CHANS];		//Level Seen When The Pin Is An Input
+		unsigned long SquareWaveFreqs[NUM_DIGITAL_CHANS];
+		unsigned long PulseWidth;							//Reported By DigitalReadPulseWidth (uS, 0 = Timeout)
+
+		//PWM
+		static const unsigned char m_PwmChans[NUM_PWM_CHANS];
+		unsigned char PwmDutyCycles[NUM_DIGITAL_CHANS];
+		unsigned long PwmFrequencies[NUM_DIGITAL_CHANS];
+
+		//SPI
+		static const unsigned char m_SpiChans[NUM_SPI_CHANS];
+		static unsigned long m_SpiSupportedSpeeds[NUM_SPI_SPEEDS];
+		unsigned char SpiBitOrders[NUM_SPI_CHANS];
+		unsigned char SpiModes[NUM_SPI_CHANS];
+		unsigned long SpiSpeeds[NUM_SPI_CHANS];
+		LinxSimSlave* SpiSlaves[NUM_SPI_CHANS];			//NULL = MOSI Looped Back To MISO
+
+		//I2C
+		static const unsigned char m_I2cChans[NUM_I2C_CHANS];
+		bool I2cOpen[NUM_I2C_CHANS];
+		LinxSimSlave* I2cSlaves[NUM_I2C_CHANS][128];		//NULL = Address NACKs
+
+		//UART
+		static const unsigned char m_UartChans[NUM_UART_CHANS];
+		bool UartOpened[NUM_UART_CHANS];
+		unsigned long UartBauds[NUM_UART_CHANS];
+		int UartHandles[NUM_UART_CHANS];					//-1 = Loopback
+
+		//Servo
+		unsigned short ServoPulseWidths[NUM_DIGITAL_CHANS];
+
+		//Latency And Call Counts
+		LinxSimLatency Latencies[NUM_SIM_OPS];
+		unsigned long OpCounts[NUM_SIM_OPS];
+
+		/****************************************************************************************
+		**  Constructors /  Destructor
+		****************************************************************************************/
+		LinxSimDevice();
+		virtual ~LinxSimDevice();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		//Simulation Setup
+		void SetLatency(unsigned char op, unsigned long fixedNs, unsigned long perItemNs, unsigned long jitterNs);
+		void SetAnalogWaveform(unsigned char channel, unsigned char waveform, unsigned long offset, unsigned long amplitude, double frequency);
+		void SetAnalogStreamRate(unsigned long scansPerSecond);
+		void SetDigitalInput(unsigned char channel, unsigned char value);
+		void AttachSpiSlave(unsigned char channel, LinxSimSlave* slave);
+		void AttachI2cSlave(unsigned char channel, unsigned char address, LinxSimSlave* slave);
+		int UartAttach(unsigned char channel, int handle);				//Carry A UART Over A pty Or Socket Instead Of Loopback
+		int UartInject(unsigned char channel, unsigned long numBytes, const unsigned char* data);		//Bytes As If Received From Outside
+
+		//Analog
+		virtual int AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int AnalogReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned long* values);
+		virtual int AnalogSetRef(unsigned char mode, unsigned long voltage);
+		virtual int AnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize);
+		virtual int AnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned char* values, unsigned long* numScansRead);
+		virtual int AnalogStreamReadNoPacking(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead);
+		virtual int AnalogStreamGetScansBuffered(unsigned long* numScans);
+		virtual int AnalogStreamStop();
+
+		//DIGITAL
+		virtual int DigitalSetDirection(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int DigitalWriteSquareWave(unsigned char channel, unsigned long freq, unsigned long duration);
+		virtual int DigitalReadPulseWidth(unsigned char stimChan, unsigned char stimType, unsigned char respChan, unsigned char respType, unsigned long timeout, unsigned long* width);
+
+		//PWM
+		virtual int PwmSetDutyCycle(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int PwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned long* values);
+
+		//SPI
+		virtual int SpiOpenMaster(unsigned char channel);
+		virtual int SpiSetBitOrder(unsigned char channel, unsigned char bitOrder);
+		virtual int SpiSetMode(unsigned char channel, unsigned char mode);
+		virtual int SpiSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed);
+		virtual int SpiWriteRead(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer);
+		virtual int SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments);
+
+		//I2C
+		virtual int I2cOpenMaster(unsigned char channel);
+		virtual int I2cSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed);
+		virtual int I2cWrite(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer);
+		virtual int I2cRead(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer);
+		virtual int I2cClose(unsigned char channel);
+
+		//UART
+		virtual int UartOpen(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud);
+		virtual int UartSetBaudRate(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud);
+		virtual int UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes);
+		virtual int UartGetBytesBuffered(unsigned char channel, unsigned long* numBytes);
+		virtual int UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead);
+		virtual int UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer);
+		virtual int UartGetFileDescriptor(unsigned char channel);
+		virtual int UartClose(unsigned char channel);
+
+		//Servo
+		virtual int ServoOpen(unsigned char numChans, unsigned char* channels);
+		virtual int ServoSetPulseWidth(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths);
+		virtual int ServoClose(unsigned char numChans, unsigned char* channels);
+
+		//General
+		virtual unsigned long GetMilliSeconds();
+		virtual unsigned long GetSeconds();
+		virtual unsigned long long GetMicroSeconds();
+		virtual unsigned long long GetNanoSeconds();
+		virtual void DelayMs(unsigned long ms);
+		virtual void NonVolatileWrite(int address, unsigned char data);
+		virtual unsigned char NonVolatileRead(int address);
+
+	private:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		unsigned long long StartTime;						//nS, Waveform Time 0
+		unsigned int Seed;									//Jitter And Noise
+		unsigned char Nvs[SIM_NVS_SIZE];
+
+		//UART Loopback Rings
+		unsigned char UartBuffers[NUM_UART_CHANS][SIM_UART_BUFFER_SIZE];
+		unsigned long UartHeads[NUM_UART_CHANS];
+		unsigned long UartCounts[NUM_UART_CHANS];
+
+		//AI Stream
+		bool StreamRunning;
+		unsigned char StreamNumChans;
+		unsigned char StreamChans[NUM_AI_CHANS];
+		unsigned long StreamRate;
+		unsigned long StreamBufferScans;
+		unsigned long long StreamStart;					//nS
+		unsigned long long StreamConsumed;				//Scans Read Or Dropped
+		bool StreamOverrun;
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		void simulate(unsigned char op, unsigned long numItems);
+		unsigned long aiValue(unsigned char channel, unsigned long long timeNs);
+		int aiIndex(unsigned char channel);
+		int spiIndex(unsigned char channel);
+		int i2cIndex(unsigned char channel);
+		int uartIndex(unsigned char channel);
+		unsigned long long streamAvailable();
+};
+
+#endif //LINX_SIMDEVICE_H
@@ -18,18 +18,24 @@
 ****************************************************************************************/	
 #include "LinxDevice.h"
 #include "LinxBeagleBone.h"
+#include "LinxBitPack.h"
+#include "LinxLog.h"
 
-#include <map>
+#include <vector>
 #include <fcntl.h>
 #include <time.h>
 #include <math.h>
+#include <string.h>
 #include <errno.h>
 #include <iostream>
 #include <unistd.h>
 #include <fstream>
 #include <sys/stat.h>
-#include <termios.h>	
+#include <poll.h>
+#include <sys/inotify.h>
 #include <sys/ioctl.h>
+#include <asm/termbits.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include <linux/spi/spidev.h>
 
@@ -66,31 +72,156 @@ LinxBeagleBone::LinxBeagleBone()
 		FilePathLayout = 9;
 	}
 	
-	// TODO Load User Config Data From Non Volatile Storage
-	//userId = NonVolatileRead(NVS_USERID) << 8 | NonVolatileRead(NVS_USERID + 1);
+	//AI Overlay And Buffered Acquisition
+	AiDtoName = "BB-ADC";
+	AiIioPath = "/sys/bus/iio/devices/iio:device0";
+	AiIioDevPath = "/dev/iio:device0";
+	AiStream = NULL;
+	
+	//Channel State Is Flat Per Slot, Boards Bind Their Channel Lists Before Filling It In
+	for(int i=0; i<BB_NUM_GPIO_BANKS; i++)
+	{
+		SoftPwmBanks[i] = NULL;
+	}
+	I2cSlaveAddrs.Fill(0xFF);
+	
+	//Load User Config Data From Non Volatile Storage
+	Nvs = new LinxNvs(LINX_NVS_PATH, NVS_SIZE);
+	unsigned char config[4];
+	if(NonVolatileReadBlock(NVS_USERID, 2, config) == L_OK)
+	{
+		userId = config[0] << 8 | config[1];
+	}
+	if(NonVolatileReadBlock(NVS_ETHERNET_IP, 4, config) == L_OK)
+	{
+		ethernetIp = (unsigned long)config[0] << 24 | (unsigned long)config[1] << 16 | (unsigned long)config[2] << 8 | config[3];
+	}
+	if(NonVolatileReadBlock(NVS_ETHERNET_PORT, 2, config) == L_OK)
+	{
+		ethernetPort = config[0] << 8 | config[1];
+	}
+	if(NonVolatileReadBlock(NVS_SERIAL_INTERFACE_MAX_BAUD, 4, config) == L_OK)
+	{
+		serialInterfaceMaxBaud = (unsigned long)config[0] << 24 | (unsigned long)config[1] << 16 | (unsigned long)config[2] << 8 | config[3];
+	}
 }
 
 LinxBeagleBone::~LinxBeagleBone()
 {
-
+	for(int i=0; i<BB_NUM_GPIO_BANKS; i++)
+	{
+		delete SoftPwmBanks[i];
+	}
+	delete AiStream;
+	delete Nvs;
 }
 /****************************************************************************************
 **  Private Functions
 ****************************************************************************************/
+void LinxBeagleBone::bindDigitalSlots(const LinxChannelSlots* slots)
+{
+	bool bound = DigitalChannels.Bind(slots)
+		&& DigitalDirs.Bind(slots)
+		&& DigitalDirHandles.Bind(slots)
+		&& DigitalValueHandles.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("Digital Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxBeagleBone::bindPwmSlots(const LinxChannelSlots* slots)
+{
+	bool bound = PwmDirPaths.Bind(slots)
+		&& PwmPeriodHandles.Bind(slots)
+		&& PwmDutyCycleHandles.Bind(slots)
+		&& PwmPeriods.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("PWM Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxBeagleBone::bindAiSlots(const LinxChannelSlots* slots)
+{
+	bool bound = AiValueHandles.Bind(slots)
+		&& AiValuePaths.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("AI Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxBeagleBone::bindUartSlots(const LinxChannelSlots* slots)
+{
+	bool bound = UartPaths.Bind(slots)
+		&& UartHandles.Bind(slots)
+		&& UartDtoNames.Bind(slots)
+		&& UartRxThreads.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("UART Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxBeagleBone::bindSpiSlots(const LinxChannelSlots* slots)
+{
+	bool bound = SpiDtoNames.Bind(slots)
+		&& SpiPaths.Bind(slots)
+		&& SpiHandles.Bind(slots)
+		&& SpiBitOrders.Bind(slots)
+		&& SpiSetSpeeds.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("SPI Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxBeagleBone::bindI2cSlots(const LinxChannelSlots* slots)
+{
+	bool bound = I2cPaths.Bind(slots)
+		&& I2cHandles.Bind(slots)
+		&& I2cDtoNames.Bind(slots)
+		&& I2cSlaveAddrs.Bind(slots)
+		&& I2cPendingMsgs.Bind(slots)
+		&& I2cPendingData.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("I2C Channels Do Not Fit The Slot Tables");
+	}
+}
+
 
 //Open Direction And Value Handles If They Are Not Already Open And Set Direction
 int LinxBeagleBone::digitalSmartOpen(unsigned char numChans, unsigned char* channels)
 {
 	for(int i=0; i<numChans; i++)
 	{		
+		//Digital I/O Cancels Any Square Wave Running On The Pin
+		softPwmClose(channels[i]);
+		
+		//Export The GPIO On First Use
+		char gpioPath[64];
+		sprintf(gpioPath, "/sys/class/gpio/gpio%d", DigitalChannels[channels[i]]);
+		if(DigitalDirHandles[channels[i]] == NULL && !fileExists(gpioPath))
+		{
+			FILE* exportHandle = fopen("/sys/class/gpio/export", "w");
+			if(exportHandle != NULL)
+			{
+				fprintf(exportHandle, "%d", DigitalChannels[channels[i]]);
+				fclose(exportHandle);
+			}
+			if(!fileExists(gpioPath, "/direction", GPIO_EXPORT_TIMEOUT))
+			{
+				LINX_LOG_ERROR("Digital Fail - Unable To Export GPIO");
+				return L_UNKNOWN_ERROR;
+			}
+		}
+		
 		//Open Direction Handle If It Is Not Already		
 		if(DigitalDirHandles[channels[i]] == NULL)
 		{
-			DebugPrint("Opening Digital Direction Handle For LINX DIO ");
-			DebugPrint(channels[i], DEC);
-			DebugPrint("(GPIO ");
-			DebugPrint(DigitalChannels[channels[i]], DEC);
-			DebugPrintln(")");
+			LINX_LOG_DEBUG("Opening Digital Direction Handle For LINX DIO %ld (GPIO %ld)", (long)channels[i], (long)DigitalChannels[channels[i]]);
 			
 			char dirPath[64];
 			sprintf(dirPath, "/sys/class/gpio/gpio%d/direction", DigitalChannels[channels[i]]);
@@ -98,7 +229,7 @@ int LinxBeagleBone::digitalSmartOpen(unsigned char numChans, unsigned char* chan
 			
 			if(DigitalDirHandles[channels[i]] == NULL)
 			{
-				DebugPrintln("Digital Fail - Unable To Open Direction File Handles");
+				LINX_LOG_ERROR("Digital Fail - Unable To Open Direction File Handles");
 				return L_UNKNOWN_ERROR;
 			}
 		}
@@ -106,14 +237,14 @@ int LinxBeagleBone::digitalSmartOpen(unsigned char numChans, unsigned char* chan
 		//Open Value Handle If It Is Not Already		
 		if(DigitalValueHandles[channels[i]] == NULL)
 		{
-			DebugPrintln("Opening Digital Value Handle");
+			LINX_LOG_DEBUG("Opening Digital Value Handle");
 			char valuePath[64];
 			sprintf(valuePath, "/sys/class/gpio/gpio%d/value", DigitalChannels[channels[i]]);
 			DigitalValueHandles[channels[i]] = fopen(valuePath, "r+w+");
 			
 			if(DigitalValueHandles[channels[i]] == NULL)
 			{
-				DebugPrintln("Digital Fail - Unable To Open Value File Handles");
+				LINX_LOG_ERROR("Digital Fail - Unable To Open Value File Handles");
 				return L_UNKNOWN_ERROR;
 			}
 		}
@@ -121,6 +252,82 @@ int LinxBeagleBone::digitalSmartOpen(unsigned char numChans, unsigned char* chan
 	return L_OK;
 }
 
+//Hand A Digital Channel To The Software Scheduler Of Its GPIO Bank.  The Line Moves From sysfs To The GPIO Character Device.
+LinxSoftPwm* LinxBeagleBone::softPwmOpen(unsigned char channel, unsigned long period)
+{
+	if(!DigitalChannels.Contains(channel))
+	{
+		LINX_LOG_ERROR("Soft PWM Fail - Not A Digital Channel");
+		return NULL;
+	}
+	
+	//32 Lines Per Bank, gpiochipN Holds GPIO N*32 To N*32+31
+	unsigned char bank = DigitalChannels[channel] / 32;
+	if(SoftPwmBanks[bank] == NULL)
+	{
+		char chipPath[32];
+		sprintf(chipPath, "/dev/gpiochip%d", bank);
+		SoftPwmBanks[bank] = new LinxSoftPwm(chipPath);
+	}
+	LinxSoftPwm* softPwm = SoftPwmBanks[bank];
+	if(softPwm->HasChannel(channel))
+	{
+		return softPwm;
+	}
+	
+	//A Line Exported Through sysfs Is Busy For The Character Device
+	if(DigitalDirHandles[channel] != NULL)
+	{
+		fclose(DigitalDirHandles[channel]);
+		DigitalDirHandles[channel] = NULL;
+	}
+	if(DigitalValueHandles[channel] != NULL)
+	{
+		fclose(DigitalValueHandles[channel]);
+		DigitalValueHandles[channel] = NULL;
+	}
+	FILE* unexportHandle = fopen("/sys/class/gpio/unexport", "w");
+	if(unexportHandle != NULL)
+	{
+		fprintf(unexportHandle, "%d", DigitalChannels[channel]);
+		fclose(unexportHandle);
+	}
+	
+	if(softPwm->AddChannel(channel, DigitalChannels[channel] % 32, period) != L_OK)
+	{
+		LINX_LOG_ERROR("Soft PWM Fail - Unable To Request GPIO Line");
+		return NULL;
+	}
+	return softPwm;
+}
+
+//Take A Channel Off Its Software Scheduler And Give It Back To sysfs For Digital I/O
+int LinxBeagleBone::softPwmClose(unsigned char channel)
+{
+	if(!DigitalChannels.Contains(channel))
+	{
+		return L_OK;
+	}
+	
+	unsigned char bank = DigitalChannels[channel] / 32;
+	if(SoftPwmBanks[bank] == NULL || !SoftPwmBanks[bank]->HasChannel(channel))
+	{
+		return L_OK;
+	}
+	
+	int status = SoftPwmBanks[bank]->RemoveChannel(channel);
+	
+	FILE* exportHandle = fopen("/sys/class/gpio/export", "w");
+	if(exportHandle != NULL)
+	{
+		fprintf(exportHandle, "%d", DigitalChannels[channel]);
+		fclose(exportHandle);
+	}
+	DigitalDirs[channel] = 0xFF;		//Unknown, Set Again On Next Digital Use
+	
+	return status;
+}
+
 //Open Direction And Value Handles If They Are Not Already Open And Set Direction
 int LinxBeagleBone::pwmSmartOpen(unsigned char numChans, unsigned char* channels)
 {
@@ -131,8 +338,7 @@ int LinxBeagleBone::pwmSmartOpen(unsigned char numChans, unsigned char* channels
 		{
 			char periodPath[64];
 			sprintf(periodPath, "%s%s", PwmDirPaths[channels[i]].c_str(), PwmPeriodFileName.c_str());
-			DebugPrint("Opening ");
-			DebugPrintln(periodPath);
+			LINX_LOG_DEBUG("Opening %s", periodPath);
 			PwmPeriodHandles[channels[i]] = fopen(periodPath, "r+w+");
 			
 			//Initialize PWM Period
@@ -146,14 +352,63 @@ int LinxBeagleBone::pwmSmartOpen(unsigned char numChans, unsigned char* channels
 		{
 			char dutyCyclePath[64];
 			sprintf(dutyCyclePath, "%s%s", PwmDirPaths[channels[i]].c_str(), PwmDutyCycleFileName.c_str());
-			DebugPrint("Opening ");
-			DebugPrintln(dutyCyclePath);
+			LINX_LOG_DEBUG("Opening %s", dutyCyclePath);
 			PwmDutyCycleHandles[channels[i]] = fopen(dutyCyclePath, "r+w+");
 		}
 	}
 	return L_OK;		
 }
 
+//Load The ADC Overlay If The IIO Device Is Missing And Wait For It To Appear
+int LinxBeagleBone::aiLoadDto()
+{
+	if(fileExists(AiIioPath.c_str()))
+	{
+		return L_OK;
+	}
+	
+	if(!loadDto(AiDtoName.c_str()) || !fileExists(AiIioPath.c_str(), "", DTO_LOAD_TIMEOUT))
+	{
+		LINX_LOG_ERROR("AI Fail - Failed To Load %s DTO", AiDtoName.c_str());
+		return L_UNKNOWN_ERROR;
+	}
+	return L_OK;
+}
+
+//Open AI Value Handles If They Are Not Already Open
+int LinxBeagleBone::aiSmartOpen(unsigned char numChans, unsigned char* channels)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(AiValueHandles[channels[i]] != NULL)
+		{
+			continue;
+		}
+		
+		if(aiLoadDto() != L_OK)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+		
+		AiValueHandles[channels[i]] = fopen(AiValuePaths[channels[i]].c_str(), "r+");
+		if(AiValueHandles[channels[i]] == NULL)
+		{
+			LINX_LOG_ERROR("AI Fail - Failed Open AI Channel Handle");
+			return L_UNKNOWN_ERROR;
+		}
+	}
+	return L_OK;
+}
+
+//Board Specific Pin Muxing, Applied When A Channel Is First Opened
+void LinxBeagleBone::uartPinmux(unsigned char channel)
+{
+}
+
+void LinxBeagleBone::spiPinmux(unsigned char channel)
+{
+}
+
 //Return True If File Specified By path Exists.
 bool LinxBeagleBone::fileExists(const char* path)
 {
@@ -169,24 +424,87 @@ bool LinxBeagleBone::fileExists(const char* directory, const char* fileName)
 	return (stat(fullPath, &buffer) == 0);  
 }
 
+//Wait Up To timeout mS For A File.  inotify On The Deepest Existing Parent Wakes Us As Soon As devtmpfs Creates
+//A Node.  sysfs Sends No Events For Kernel Created Files, So The Wait Is Also Capped At FILE_WAIT_POLL_MS.
 bool LinxBeagleBone::fileExists(const char* directory, const char* fileName, unsigned long timeout)
 {
 	char fullPath[128];
 	sprintf(fullPath, "%s%s", directory, fileName);				
 	struct stat buffer;
 	
+	if(stat(fullPath, &buffer) == 0)
+	{
+		return true;
+	}
+	
+	int notifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
 	unsigned long startTime = GetMilliSeconds();
-	while(GetMilliSeconds()-startTime < timeout)
+	bool found = false;
+	while(true)
 	{
+		//Path Components Can Appear One At A Time, Move The Watch Down As They Do
+		if(notifyHandle >= 0)
+		{
+			char parent[128];
+			strcpy(parent, fullPath);
+			char* slash;
+			while((slash = strrchr(parent, '/')) != NULL && slash != parent)
+			{
+				*slash = '\0';
+				if(stat(parent, &buffer) == 0)
+				{
+					inotify_add_watch(notifyHandle, parent, IN_CREATE | IN_MOVED_TO | IN_ATTRIB);
+					break;
+				}
+			}
+		}
+		
 		if(stat(fullPath, &buffer) == 0)
 		{
-			DebugPrint("DTO Took ");
-			DebugPrintln(GetMilliSeconds()-startTime < timeout, DEC);
-			return true;
+			found = true;
+			break;
+		}
+		
+		unsigned long elapsed = GetMilliSeconds() - startTime;
+		if(elapsed >= timeout)
+		{
+			break;
+		}
+		int wait = (timeout - elapsed < FILE_WAIT_POLL_MS) ? (timeout - elapsed) : FILE_WAIT_POLL_MS;
+		
+		if(notifyHandle >= 0)
+		{
+			struct pollfd notify;
+			notify.fd = notifyHandle;
+			notify.events = POLLIN;
+			if(poll(&notify, 1, wait) > 0)
+			{
+				char events[1024];
+				while(read(notifyHandle, events, sizeof(events)) > 0)
+				{
+				}
+			}
 		}
+		else
+		{
+			usleep(wait * 1000);
+		}
+	}
+	
+	if(notifyHandle >= 0)
+	{
+		close(notifyHandle);
+	}
+	
+	if(found)
+	{
+		LINX_LOG_DEBUG("DTO Took %ld", (long)(GetMilliSeconds() - startTime));
+	}
+	else
+	{
+		LINX_LOG_ERROR("Timeout");
 	}
-	DebugPrintln("Timeout");
-	return false;
+	return found;
 }
 
 //Load Device Tree Overlay
@@ -203,73 +521,166 @@ bool LinxBeagleBone::loadDto(const char* dtoName)
 	}
 	else
 	{
-		DebugPrintln("Unable To Open slotsHandle");
+		LINX_LOG_ERROR("Unable To Open slotsHandle");
 	}
 	
 	return false;	
 }
 
 
-/****************************************************************************************
-**  Public Functions
-****************************************************************************************/
-	
-//--------------------------------------------------------ANALOG-------------------------------------------------------
-int LinxBeagleBone::AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
+//Writes That Do Not End With A Stop (EOF_RESTART, EOF_NOSTOP...) Are Held Back And Sent With The Next Transfer
+//As One I2C_RDWR Message Array, So The Slave Sees A Repeated Start Instead Of Stop / Start.
+//Plain Transfers Use read() / write() And Only Set I2C_SLAVE When The Slave Address Changes.
+int LinxBeagleBone::i2cTransfer(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* buffer, bool isRead)
 {
-
-	//unsigned int analogValue = 0;
-	unsigned char responseByteOffset = 0;
-	unsigned char responseBitsRemaining = 8; 
-	unsigned char dataBitsRemaining = AiResolution;
-	fstream fs;	//AI File Handle
+	vector<unsigned char>& pendingMsgs = I2cPendingMsgs[channel];		//(Address, Length, EOF) For Each Held Back Write
+	vector<unsigned char>& pendingData = I2cPendingData[channel];
 	
-	values[responseByteOffset] = 0x00;    //Clear First	Response Byte   
-
-	//Loop Over All AI channels In Command Packet
-	for(int i=0; i<numChans; i++)
+	if(eofConfig > EOF_NOSTOP)
 	{
-		//Acquire AI Sample
-		int aiVal = 0;
-		AiValueHandles[channels[i]] = freopen(AiValuePaths[channels[i]].c_str(), "r+", AiValueHandles[channels[i]]);
-		fscanf(AiValueHandles[channels[i]], "%u", &aiVal);
+		LINX_LOG_ERROR("I2C Fail - EOF Not Supported");
+		return LI2C_EOF;
+	}
+	
+	if(!isRead)
+	{
+		//No Start Condition After EOF_NOSTOP - Continue The Previous Write To The Same Slave
+		unsigned int numMsgs = pendingMsgs.size() / 3;
+		if(numMsgs > 0 && pendingMsgs[3*numMsgs-3] == slaveAddress && pendingMsgs[3*numMsgs-1] >= EOF_RESTART_NOSTOP && pendingMsgs[3*numMsgs-2] + numBytes <= 0xFF)
+		{
+			pendingMsgs[3*numMsgs-2] += numBytes;
+			pendingMsgs[3*numMsgs-1] = eofConfig;
+		}
+		else
+		{
+			if(numMsgs >= I2C_RDWR_IOCTL_MAX_MSGS - 1)
+			{
+				LINX_LOG_ERROR("I2C Fail - Too Many Messages Without A Stop");
+				pendingMsgs.clear();
+				pendingData.clear();
+				return LI2C_WRITE_FAIL;
+			}
+			pendingMsgs.push_back(slaveAddress);
+			pendingMsgs.push_back(numBytes);
+			pendingMsgs.push_back(eofConfig);
+		}
+		pendingData.insert(pendingData.end(), buffer, buffer + numBytes);
 		
-		/*
-		fs.open(AiPaths[channels[i]], fstream::in);
-		fs >> analogValue;
-		fs.close();
-		*/
+		if(eofConfig != EOF_STOP)
+		{
+			return L_OK;
+		}
 		
-		dataBitsRemaining = AiResolution;
-
-		//Byte Packet AI Values In Response Packet
-		while(dataBitsRemaining > 0)
+		//Single Write - No Need For A Message Array
+		if(pendingMsgs.size() == 3)
 		{
-			*(values+responseByteOffset) |= ( ((unsigned int)aiVal>>(AiResolution - dataBitsRemaining)) << (8 - responseBitsRemaining) );
-			//*(values+responseByteOffset) = 69;
-
-			if(responseBitsRemaining > dataBitsRemaining)
+			pendingMsgs.clear();
+			pendingData.clear();
+			
+			if(I2cSlaveAddrs[channel] != slaveAddress)
 			{
-				//Current Byte Still Has Empty Bits
-				responseBitsRemaining -= dataBitsRemaining;
-				dataBitsRemaining = 0;
+				if(ioctl(I2cHandles[channel], I2C_SLAVE, slaveAddress) < 0)
+				{
+					LINX_LOG_ERROR("I2C Fail - Failed To Set Slave Address");
+					I2cSlaveAddrs.Reset(channel);
+					return LI2C_SADDR;
+				}
+				I2cSlaveAddrs[channel] = slaveAddress;
 			}
-			else
+			
+			if(write(I2cHandles[channel], buffer, numBytes) != numBytes)
 			{
-				//Current Byte Full
-				dataBitsRemaining = dataBitsRemaining - responseBitsRemaining;
-				responseByteOffset++;
-				responseBitsRemaining = 8;
-				values[responseByteOffset] = 0x00;    //Clear Next Response Byte     
+				LINX_LOG_ERROR("I2C Fail - Failed To Write All Data");
+				return errno;
 			}
+			return L_OK;
 		}
 	}
+	else if(pendingMsgs.empty())
+	{
+		//Single Read.  Linux Always Ends An I2C Transfer With A Stop
+		if(I2cSlaveAddrs[channel] != slaveAddress)
+		{
+			if(ioctl(I2cHandles[channel], I2C_SLAVE, slaveAddress) < 0)
+			{
+				I2cSlaveAddrs.Reset(channel);
+				return LI2C_SADDR;
+			}
+			I2cSlaveAddrs[channel] = slaveAddress;
+		}
+		
+		if(read(I2cHandles[channel], buffer, numBytes) < numBytes)
+		{
+			return LI2C_READ_FAIL;
+		}
+		return L_OK;
+	}
+	
+	//Held Back Writes (Plus This Read) Go Out As One Combined Transaction
+	unsigned int numMsgs = pendingMsgs.size() / 3;
+	struct i2c_msg msgs[numMsgs + 1];
+	unsigned int dataOffset = 0;
+	for(unsigned int i=0; i<numMsgs; i++)
+	{
+		msgs[i].addr = pendingMsgs[3*i];
+		msgs[i].flags = 0;
+		msgs[i].len = pendingMsgs[3*i+1];
+		msgs[i].buf = &pendingData[0] + dataOffset;
+		dataOffset += msgs[i].len;
+	}
+	if(isRead)
+	{
+		msgs[numMsgs].addr = slaveAddress;
+		msgs[numMsgs].flags = I2C_M_RD;
+		msgs[numMsgs].len = numBytes;
+		msgs[numMsgs].buf = buffer;
+		numMsgs++;
+	}
+	
+	struct i2c_rdwr_ioctl_data transaction;
+	transaction.msgs = msgs;
+	transaction.nmsgs = numMsgs;
+	int retVal = ioctl(I2cHandles[channel], I2C_RDWR, &transaction);
+	
+	pendingMsgs.clear();
+	pendingData.clear();
+	
+	if(retVal < 0)
+	{
+		LINX_LOG_ERROR("I2C Fail - Combined Transfer Failed");
+		return isRead ? LI2C_READ_FAIL : LI2C_WRITE_FAIL;
+	}
+	
+	return L_OK;
+}
+
+/****************************************************************************************
+**  Public Functions
+****************************************************************************************/
+	
+//--------------------------------------------------------ANALOG-------------------------------------------------------
+int LinxBeagleBone::AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
+{
+	unsigned long aiVals[256];
+	int status = AnalogReadNoPacking(numChans, channels, aiVals);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	
+	//Byte Packet AI Values In Response Packet
+	LinxBitPack::Pack(numChans, aiVals, AiResolution, values);
 	
 	return L_OK;
 }
 
 int LinxBeagleBone::AnalogReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned long* values)
 {
+	if(aiSmartOpen(numChans, channels) != L_OK)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	
 	//Loop Over All AI channels In Command Packet
 	for(int i=0; i<numChans; i++)
 	{
@@ -285,43 +696,109 @@ int LinxBeagleBone::AnalogSetRef(unsigned char mode, unsigned long voltage)
 	return L_FUNCTION_NOT_SUPPORTED;
 }
 
+int LinxBeagleBone::AnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(!AiValuePaths.Contains(channels[i]))
+		{
+			return LANALOG_STREAM_OPEN_FAIL;
+		}
+	}
+	
+	if(aiLoadDto() != L_OK)
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	
+	if(AiStream == NULL)
+	{
+		AiStream = new LinxIioBuffer(AiIioPath.c_str(), AiIioDevPath.c_str());
+	}
+	
+	int status = AiStream->Start(numChans, channels, bufferSize);
+	if(status != L_OK)
+	{
+		LINX_LOG_ERROR("AI Fail - Unable To Start Buffered Acquisition");
+	}
+	return status;
+}
+
+int LinxBeagleBone::AnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned char* values, unsigned long* numScansRead)
+{
+	*numScansRead = 0;
+	if(AiStream == NULL || !AiStream->IsRunning())
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	
+	vector<unsigned long> ticks(numScans * AiStream->NumChans() + 1);
+	int status = AnalogStreamReadNoPacking(numScans, timeout, &ticks[0], numScansRead);
+	LinxBitPack::Pack(*numScansRead * AiStream->NumChans(), &ticks[0], AiResolution, values);
+	return status;
+}
+
+int LinxBeagleBone::AnalogStreamReadNoPacking(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead)
+{
+	*numScansRead = 0;
+	if(AiStream == NULL || !AiStream->IsRunning())
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	
+	bool overrun = false;
+	*numScansRead = AiStream->Read(numScans, timeout, values, &overrun);
+	if(overrun)
+	{
+		return LANALOG_STREAM_OVERRUN;
+	}
+	return L_OK;
+}
+
+int LinxBeagleBone::AnalogStreamGetScansBuffered(unsigned long* numScans)
+{
+	*numScans = 0;
+	if(AiStream == NULL || !AiStream->IsRunning())
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	
+	*numScans = AiStream->Available();
+	return L_OK;
+}
+
+int LinxBeagleBone::AnalogStreamStop()
+{
+	if(AiStream != NULL)
+	{
+		AiStream->Stop();
+	}
+	return L_OK;
+}
+
 //--------------------------------------------------------DIGITAL-------------------------------------------------------
 int LinxBeagleBone::DigitalSetDirection(unsigned char numChans, unsigned char* channels, unsigned char* values)
 {
 	if(digitalSmartOpen(numChans, channels) != L_OK)
 	{
-		DebugPrintln("Smart Open Failed");
+		LINX_LOG_ERROR("Smart Open Failed");
 		return L_UNKNOWN_ERROR;			
 	}
 	
+	unsigned char directions[numChans];
+	LinxBitPack::UnpackBits(numChans, values, directions);
+	
 	//Set Direction Only If Necessary
-	//Avoid Divide By Zero By Doing First Iteration
-	if( (values[0] & 0x01) == OUTPUT && DigitalDirs[channels[0]] != OUTPUT)
-	{
-		//Set As Output
-		fprintf(DigitalDirHandles[channels[0]], "out");		
-		fflush(DigitalDirHandles[channels[0]]);
-		DigitalDirs[channels[0]] = OUTPUT;		
-	}
-	else if((values[0] & 0x01) == INPUT && DigitalDirs[channels[0]] != INPUT)
-	{
-		//Set As Input
-		fprintf(DigitalDirHandles[channels[0]], "in");	
-		fflush(DigitalDirHandles[channels[0]]);
-		DigitalDirs[channels[0]] = INPUT;
-	}
-		
-	//Set Directions
-	for(int i=1; i<numChans; i++)
+	for(int i=0; i<numChans; i++)
 	{		
-		if( (values[i] & 0x01) == OUTPUT && DigitalDirs[channels[i]] != OUTPUT)
+		if(directions[i] == OUTPUT && DigitalDirs[channels[i]] != OUTPUT)
 		{
 			//Set As Output
 			fprintf(DigitalDirHandles[channels[i]], "out");		
 			fflush(DigitalDirHandles[channels[i]]);
 			DigitalDirs[channels[i]] = OUTPUT;				
 		}
-		else if( (values[i] & 0x01) == INPUT && DigitalDirs[channels[i]] != INPUT)
+		else if(directions[i] == INPUT && DigitalDirs[channels[i]] != INPUT)
 		{
 			//Set As Input
 			fprintf(DigitalDirHandles[channels[i]], "in");	
@@ -345,14 +822,17 @@ int LinxBeagleBone::DigitalWrite(unsigned char numChans, unsigned char* channels
 	
 	if(DigitalSetDirection(numChans, channels, directions) != L_OK)
 	{
-		DebugPrintln("Digital Write Fail - Set Direction Failed");
+		LINX_LOG_ERROR("Digital Write Fail - Set Direction Failed");
 	}
+	
+	unsigned char bits[numChans];
+	LinxBitPack::UnpackBits(numChans, values, bits);
 			
 	for(int i=0; i<numChans; i++)
 	{
 		//Set Value
 		if (DigitalValueHandles[channels[i]]) {
-			if( ((values[i/8] >> i%8) & 0x01) == LOW)
+			if(bits[i] == LOW)
 			{
 				fprintf(DigitalValueHandles[channels[i]], "0");
 				fflush(DigitalValueHandles[channels[i]]);
@@ -373,6 +853,19 @@ int LinxBeagleBone::DigitalWrite(unsigned char channel, unsigned char value)
 	return DigitalWrite(1, &channel, &value);
 }
 
+//Export Declared Pins Now Instead Of On Their First Digital Call
+int LinxBeagleBone::DigitalPrewarm(unsigned char numChans, unsigned char* channels)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(!DigitalChannels.Contains(channels[i]))
+		{
+			return LDIGITAL_PIN_DNE;
+		}
+	}
+	return digitalSmartOpen(numChans, channels);
+}
+
 int LinxBeagleBone::DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
 {
 	//Generate Directions Array (waste some memory, save some CPU)
@@ -385,7 +878,7 @@ int LinxBeagleBone::DigitalWriteNoPacking(unsigned char numChans, unsigned char*
 	
 	if(DigitalSetDirection(numChans, channels, directions) != L_OK)
 	{
-		DebugPrintln("Digital Write Fail - Set Direction Failed");
+		LINX_LOG_ERROR("Digital Write Fail - Set Direction Failed");
 	}
 			
 	for(int i=0; i<numChans; i++)
@@ -421,32 +914,15 @@ int LinxBeagleBone::DigitalRead(unsigned char numChans, unsigned char* channels,
 	//Set Directions To Inputs		
 	if(DigitalSetDirection(numChans, channels, directions) != L_OK)
 	{
-		DebugPrintln("Digital Write Fail - Set Direction Failed");
+		LINX_LOG_ERROR("Digital Write Fail - Set Direction Failed");
 	}
 	
-	unsigned char bitOffset = 8;
-	unsigned char byteOffset = 0;
-	unsigned char retVal = 0;
+	unsigned char bits[numChans];
 	int diVal = 0;
 	
 	//Loop Over channels To Read
 	for(int i=0; i<numChans; i++)
 	{
-		
-		//If bitOffset Is 0 We Have To Start A New Byte, Store Old Byte And Increment OFfsets
-		if(bitOffset == 0)
-		{
-			//Insert retVal Into Response Buffer
-			values[byteOffset] = retVal;
-			retVal = 0x00;
-			byteOffset++;
-			bitOffset = 7;      
-		}
-		else
-		{
-			bitOffset--;
-		}
-		
 		//Reopen Value Handle
 		char valPath[64];
 		sprintf(valPath, "/sys/class/gpio/gpio%d/value", DigitalChannels[channels[i]]);
@@ -455,15 +931,10 @@ int LinxBeagleBone::DigitalRead(unsigned char numChans, unsigned char* channels,
 		//Read From Next Pin
 		fscanf(DigitalValueHandles[channels[i]], "%u", &diVal);
 		
-		//DebugPrint("Value = ");
-		//DebugPrintln((unsigned char)diVal, DEC);
-		
-					
-		retVal = retVal | ((unsigned char)diVal << bitOffset);	//Read Pin And Insert Value Into retVal
+		bits[i] = (unsigned char)diVal;
 	}
 
-	//Store Last Byte
-	values[byteOffset] = retVal;
+	LinxBitPack::PackBits(numChans, bits, values);
 		
 	return L_OK;
 }
@@ -481,7 +952,7 @@ int LinxBeagleBone::DigitalReadNoPacking(unsigned char numChans, unsigned char*
 	//Set Directions To Inputs		
 	if(DigitalSetDirection(numChans, channels, directions) != L_OK)
 	{
-		DebugPrintln("Digital Write Fail - Set Direction Failed");
+		LINX_LOG_ERROR("Digital Write Fail - Set Direction Failed");
 	}
 	
 	//Loop Over channels To Read
@@ -498,9 +969,31 @@ int LinxBeagleBone::DigitalReadNoPacking(unsigned char numChans, unsigned char*
 	return L_OK;
 }
 
+//Runs On A Software Scheduler So The Listener Is Not Blocked.  A New Wave On The Same Channel Replaces The Old One.
 int LinxBeagleBone::DigitalWriteSquareWave(unsigned char channel, unsigned long freq, unsigned long duration)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
+	//0 Hz Stops The Wave And Returns The Pin To Digital I/O
+	if(freq == 0)
+	{
+		return softPwmClose(channel);
+	}
+	
+	//The Scheduler Sleeps Between Edges, Faster Waves Would Not Come Out As Asked
+	unsigned long period = 1000000000UL / freq;
+	if(period < SOFT_PWM_MIN_PERIOD_NS)
+	{
+		LINX_LOG_ERROR("Square Wave Fail - Frequency Too High");
+		return L_UNKNOWN_ERROR;
+	}
+	
+	LinxSoftPwm* softPwm = softPwmOpen(channel, period);
+	if(softPwm == NULL)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	
+	//Duration Is In mS, 0 Runs Until Stopped
+	return softPwm->Restart(channel, period, period / 2, (unsigned long long)duration * 1000000ULL);
 }
 
 int LinxBeagleBone::DigitalReadPulseWidth(unsigned char stimChan, unsigned char stimType, unsigned char respChan, unsigned char respType, unsigned long timeout, unsigned long* width)
@@ -534,12 +1027,9 @@ int LinxBeagleBone::PwmSetDutyCycle(unsigned char numChans, unsigned char* chann
 		}
 		
 		//Update Output
-		DebugPrint("Setting Duty Cycle = ");
-		DebugPrint(dutyCycle, DEC);
 		fprintf(PwmDutyCycleHandles[channels[i]], "%lu", dutyCycle);	
-		DebugPrint(" ... Duty Cycle Set ... ");
 		fflush(PwmDutyCycleHandles[channels[i]]);
-		DebugPrintln("Flushing.");
+		LINX_LOG_DEBUG("PWM %u Duty Cycle Set To %lu", channels[i], dutyCycle);
 	}
 	
 	return L_OK;
@@ -553,12 +1043,14 @@ int PwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned lo
 //--------------------------------------------------------SPI-------------------------------------------------------
 int LinxBeagleBone::SpiOpenMaster(unsigned char channel)
 {
+	spiPinmux(channel);
+	
 	//Load SPI DTO If Necessary
 	if(!fileExists(SpiPaths[channel].c_str()))
 	{
-		if(!loadDto(SpiDtoNames[channel].c_str()))		
+		if(!loadDto(SpiDtoNames[channel].c_str()) || !fileExists(SpiPaths[channel].c_str(), "", DTO_LOAD_TIMEOUT))
 		{
-			DebugPrint("SPI Fail - Failed To Load SPI DTO");
+			LINX_LOG_ERROR("SPI Fail - Failed To Load SPI DTO");
 			return  LSPI_OPEN_FAIL;
 		}
 	}
@@ -575,16 +1067,14 @@ int LinxBeagleBone::SpiOpenMaster(unsigned char channel)
 		unsigned long spi_Mode = SPI_MODE_0;			
 		if(ioctl(SpiHandles[channel], SPI_IOC_WR_MODE, &spi_Mode) < 0)					
 		{
-			DebugPrint("SPI Fail - Failed To Set SPI Mode - ");
-			DebugPrintln(spi_Mode, BIN);
+			LINX_LOG_ERROR("SPI Fail - Failed To Set SPI Mode - 0x%lX", (unsigned long)spi_Mode);
 			return LSPI_OPEN_FAIL;
 		}
 		
 		//Default Max Speed To 
 		if (ioctl(SpiHandles[channel], SPI_IOC_WR_MAX_SPEED_HZ, &SpiDefaultSpeed) < 0)
 		{			
-			DebugPrint("SPI Fail - Failed To Set SPI Max Speed - ");
-			DebugPrintln(SpiDefaultSpeed, DEC);
+			LINX_LOG_ERROR("SPI Fail - Failed To Set SPI Max Speed - %ld", (long)SpiDefaultSpeed);
 			return LSPI_OPEN_FAIL;
 		}			
 		
@@ -603,7 +1093,7 @@ int LinxBeagleBone::SpiSetMode(unsigned char channel, unsigned char mode)
 	unsigned long spi_Mode = (unsigned long) mode;
 	if(ioctl(SpiHandles[channel], SPI_IOC_WR_MODE, &spi_Mode) < 0)
 	{
-		DebugPrintln("Failed To Set SPI Mode");
+		LINX_LOG_ERROR("Failed To Set SPI Mode");
 		return  L_UNKNOWN_ERROR;
 	}		
 	return L_OK;
@@ -639,10 +1129,7 @@ int LinxBeagleBone::SpiWriteRead(unsigned char channel, unsigned char frameSize,
 	//SPI Hardware Only Supports MSb First Transfer.  If  Configured for LSb First Reverse Bits In Software
 	if( SpiBitOrders[channel] == LSBFIRST )
 	{
-		for(int i=0; i< frameSize*numFrames; i++)
-		{			
-			sendBuffer[i] = ReverseBits(sendBuffer[i]);
-		}
+		LinxBitPack::ReverseBits(frameSize*numFrames, sendBuffer, sendBuffer);
 	}
 	
 	struct spi_ioc_transfer transfer = {};
@@ -672,7 +1159,7 @@ int LinxBeagleBone::SpiWriteRead(unsigned char channel, unsigned char frameSize,
 		
 		if (retVal < 0)
 		{
-			DebugPrintln("SPI Fail - Failed To Transfer Data");
+			LINX_LOG_ERROR("SPI Fail - Failed To Transfer Data");
 			return  LSPI_TRANSFER_FAIL;
 		}
 		
@@ -689,13 +1176,12 @@ int LinxBeagleBone::I2cOpenMaster(unsigned char channel)
 	//Export Dev Tree Overlay If Device DNE
 	if(!fileExists(I2cPaths[channel].c_str()))
 	{		
-		DebugPrint("I2C - Loading DTO ");
-		DebugPrintln(I2cDtoNames[channel].c_str());
+		LINX_LOG_DEBUG("I2C - Loading DTO %s", I2cDtoNames[channel].c_str());
 		if(FilePathLayout == 7)
 		{
-			if(!loadDto(I2cDtoNames[channel].c_str()))		
+			if(!loadDto(I2cDtoNames[channel].c_str()) || !fileExists(I2cPaths[channel].c_str(), "", DTO_LOAD_TIMEOUT))
 			{
-				DebugPrintln("I2C Fail - Failed To Load BB-I2C DTO");
+				LINX_LOG_ERROR("I2C Fail - Failed To Load BB-I2C DTO");
 				return  LI2C_OPEN_FAIL;
 			}
 		}
@@ -704,12 +1190,13 @@ int LinxBeagleBone::I2cOpenMaster(unsigned char channel)
 	int handle = open(I2cPaths[channel].c_str(), O_RDWR);
 	if (handle < 0)
 	{
-		DebugPrintln("I2C Fail - Failed To Open I2C Channel");
+		LINX_LOG_ERROR("I2C Fail - Failed To Open I2C Channel");
 		return  LI2C_OPEN_FAIL;
 	}
 	else
 	{
 		I2cHandles[channel] = handle;
+		I2cSlaveAddrs.Reset(channel);
 	}
 	return L_OK;
 }
@@ -721,58 +1208,20 @@ int LinxBeagleBone::I2cSetSpeed(unsigned char channel, unsigned long speed, unsi
 
 int LinxBeagleBone::I2cWrite(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer)
 {
-	//Check EOF - Currently Only Support 0x00
-	if(eofConfig != EOF_STOP)
-	{
-		DebugPrintln("I2C Fail - EOF Not Supported");
-		return LI2C_EOF;	
-	}
-	
-	//Set Slave Address
-	if (ioctl(I2cHandles[channel], I2C_SLAVE, slaveAddress) < 0) 
-	{			
-		//Failed To Set Slave Address
-		DebugPrintln("I2C Fail - Failed To Set Slave Address");
-		return LI2C_SADDR;
-	}
-		
-	//Write Data
-	int retVal = write(I2cHandles[channel], sendBuffer, numBytes);
-	if(retVal != numBytes)
-	{
-		DebugPrintln("I2C Fail - Failed To Write All Data");
-		//return LI2C_WRITE_FAIL;
-		return errno;
-	}
-	
-	return L_OK;
+	return i2cTransfer(channel, slaveAddress, eofConfig, numBytes, sendBuffer, false);
 }
 
 int LinxBeagleBone::I2cRead(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer)
 {
-	//Check EOF - Currently Only Support 0x00
-	if(eofConfig != EOF_STOP)
-	{
-		return LI2C_EOF;	
-	}
-	
-	//Set Slave Address
-	if (ioctl(I2cHandles[channel], I2C_SLAVE, slaveAddress) < 0) 
-	{
-		//Failed To Set Slave Address
-		return LI2C_SADDR;
-	}
-	
-	if(read(I2cHandles[channel], recBuffer, numBytes) < numBytes)
-	{
-		return LI2C_READ_FAIL;	
-	}
-	
-	return L_OK;
+	return i2cTransfer(channel, slaveAddress, eofConfig, numBytes, recBuffer, true);
 }
 
 int LinxBeagleBone::I2cClose(unsigned char channel)
 {
+	I2cSlaveAddrs.Reset(channel);
+	I2cPendingMsgs.Reset(channel);
+	I2cPendingData.Reset(channel);
+	
 	//Close I2C Channel
 	if(close(I2cHandles[channel]) < 0)
 	{
@@ -787,16 +1236,16 @@ int LinxBeagleBone::I2cClose(unsigned char channel)
 int LinxBeagleBone::UartOpen(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud)
 {
 	
-	DebugPrintln("UART Open");
+	LINX_LOG_DEBUG("UART Open");
+	
+	uartPinmux(channel);
 	
 	//Load DTO If Needed
 	if(!fileExists(UartPaths[channel].c_str()))
 	{
-		if(!loadDto(UartDtoNames[channel].c_str()))	
+		if(!loadDto(UartDtoNames[channel].c_str()) || !fileExists(UartPaths[channel].c_str(), "", DTO_LOAD_TIMEOUT))
 		{
-			DebugPrint("UART Fail - Failed To Load ");
-			DebugPrint(UartDtoNames[channel].c_str());
-			DebugPrintln(" DTO");
+			LINX_LOG_ERROR("UART Fail - Failed To Load %s DTO", UartDtoNames[channel].c_str());
 			return  LUART_OPEN_FAIL;
 		}			
 	}
@@ -809,8 +1258,7 @@ if(UartHandles[channel] <= 0)
 			
 		if (handle <= 0)
 		{
-			DebugPrint("UART Fail - Failed To Open UART Handle -  ");
-			DebugPrintln(UartPaths[channel].c_str());
+			LINX_LOG_ERROR("UART Fail - Failed To Open UART Handle -  %s", UartPaths[channel].c_str());
 			return  LUART_OPEN_FAIL;
 		}
 		else
@@ -820,14 +1268,12 @@ if(UartHandles[channel] <= 0)
 	}
 	/*else
 	{
-		DebugPrint("UART ");		
-		DebugPrint(channel, DEC);
-		DebugPrintln(" already Open.");		
+		LINX_LOG_DEBUG("UART %ld already Open.", (long)channel);
 	}*/
 	
 	if(UartSetBaudRate(channel, baudRate, actualBaud) != L_OK)
 	{
-		DebugPrintln("Failed to set baud rate");
+		LINX_LOG_ERROR("Failed to set baud rate");
 	}
 	
 	return L_OK;
@@ -835,80 +1281,207 @@ if(UartHandles[channel] <= 0)
 
 int LinxBeagleBone::UartSetBaudRate(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud)
 {
-	//Get Closest Support Baud Rate Without Going Over
-
-	//Loop Over All Supported SPI Speeds
-	int index = 0;
-	for(index=0; index < NumUartSpeeds; index++)
-	{				
-		if(baudRate < *(UartSupportedSpeeds+index))
-		{		
-			//Previous Index Was Closest Supported Baud Without Going Over, Index Will Be Decremented Accordingly Below.
-			break;
-		}	
+	//Any Rate Up To The Controller Limit Is Allowed, The B* Constants Are Bypassed Using termios2 / BOTHER
+	if(baudRate > UartMaxBaud)
+	{
+		baudRate = UartMaxBaud;
 	}
 	
-	//Once Loop Completes Index Is One Higher Than The Correct Baud, But Could Be Zero So Check And Decrement Accordingly
-	//If The Entire Loop Runs Then index == NumUartSpeeds So Decrement It To Get Max Baud
-	if(index != 0)
+	struct termios2 options;
+	if(ioctl(UartHandles[channel], TCGETS2, &options) < 0)
 	{
-		index = index -1;
+		LINX_LOG_ERROR("UART Fail - Failed To Get Port Settings");
+		return LUART_SET_BAUD_FAIL;
 	}
 	
-	//Store Actual Baud Used
-	*actualBaud = (unsigned long) *(UartSupportedSpeeds+index);
-	
-	//Set Baud Rate
-	struct termios options;	
-	tcgetattr(UartHandles[channel], &options);
-	
-	options.c_cflag = *(UartSupportedSpeedsCodes+index) | CS8 | CLOCAL | CREAD;
+	options.c_cflag = BOTHER | CS8 | CLOCAL | CREAD;
 	options.c_iflag = IGNPAR;
 	options.c_oflag = 0;
 	options.c_lflag = 0;
+	options.c_ispeed = baudRate;
+	options.c_ospeed = baudRate;
 	
-	tcflush(UartHandles[channel], TCIFLUSH);	
-	tcsetattr(UartHandles[channel], TCSANOW, &options);
+	ioctl(UartHandles[channel], TCFLSH, TCIFLUSH);
+	if(ioctl(UartHandles[channel], TCSETS2, &options) < 0)
+	{
+		LINX_LOG_ERROR("UART Fail - Failed To Set Baud Rate");
+		return LUART_SET_BAUD_FAIL;
+	}
+	
+	//Read Back The Rate The Driver Actually Achieved (Limited By The UART Clock Divider)
+	*actualBaud = baudRate;
+	if(ioctl(UartHandles[channel], TCGETS2, &options) == 0)
+	{
+		*actualBaud = options.c_ospeed;
+	}
 	
 	return  L_OK;
 }
 
 int LinxBeagleBone::UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes)
 {
+	unsigned long available = 0;
+	int status = UartGetBytesBuffered(channel, &available);
+	
+	//Clamp Rather Than Truncate - 300 Bytes Pending Must Not Read As 44
+	*numBytes = (available > 255) ? 255 : (unsigned char)available;
+	
+	return status;
+}
+
+int LinxBeagleBone::UartGetBytesBuffered(unsigned char channel, unsigned long* numBytes)
+{
+	LinxUartRx* rx = UartRxThreads[channel];
+	if(rx != NULL)
+	{
+		*numBytes = rx->Available();
+		return L_OK;
+	}
+	
 	int bytesAtPort = -1;
 	ioctl(UartHandles[channel], FIONREAD, &bytesAtPort);
 	
 	if(bytesAtPort < 0)
 	{
+		*numBytes = 0;
 		return LUART_AVAILABLE_FAIL;
 	}
-	else
-	{
-		*numBytes = (unsigned char) bytesAtPort;
-	}
+	*numBytes = (unsigned long)bytesAtPort;
+	
 	return  L_OK;
 }
 
 int LinxBeagleBone::UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead)
 {
+	*numBytesRead = 0;
+	
 	//Check If Enough Bytes Are Available
-	unsigned char bytesAvailable = -1;
-	UartGetBytesAvailable(channel, &bytesAvailable);
+	unsigned long bytesAvailable = 0;
+	UartGetBytesBuffered(channel, &bytesAvailable);
 	
 	if(bytesAvailable >= numBytes)
 	{
+		LinxUartRx* rx = UartRxThreads[channel];
+		if(rx != NULL)
+		{
+			bool overrun = false;
+			*numBytesRead = (unsigned char)rx->Read(recBuffer, numBytes, 0, NULL, &overrun);
+			if(overrun)
+			{
+				return LUART_OVERRUN;
+			}
+			return L_OK;
+		}
+		
 		//Read Bytes From Input Buffer
 		int bytesRead = read(UartHandles[channel], recBuffer, numBytes);
-		*numBytesRead = (unsigned char) bytesRead;
-		
 		if(bytesRead != numBytes)
 		{
 			return LUART_READ_FAIL;
-		}		
+		}
+		*numBytesRead = (unsigned char) bytesRead;
 	}
+	
 	return  L_OK;
 }
 
+int LinxBeagleBone::UartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp)
+{
+	*numBytesRead = 0;
+	if(timestamp != NULL)
+	{
+		*timestamp = 0;
+	}
+	
+	LinxUartRx* rx = UartRxThreads[channel];
+	if(rx != NULL)
+	{
+		bool overrun = false;
+		*numBytesRead = rx->Read(recBuffer, numBytes, timeout, timestamp, &overrun);
+		if(overrun)
+		{
+			return LUART_OVERRUN;
+		}
+		return L_OK;
+	}
+	
+	//No RX Thread - Wait On The tty Directly
+	unsigned long startTime = GetMilliSeconds();
+	while(*numBytesRead < numBytes)
+	{
+		unsigned long elapsed = GetMilliSeconds() - startTime;
+		struct pollfd port;
+		port.fd = UartHandles[channel];
+		port.events = POLLIN;
+		
+		int ready = poll(&port, 1, (elapsed >= timeout) ? 0 : (int)(timeout - elapsed));
+		if(ready < 0 && errno != EINTR)
+		{
+			return LUART_READ_FAIL;
+		}
+		if(ready == 0)
+		{
+			break;
+		}
+		if(ready < 0)
+		{
+			continue;
+		}
+		
+		int bytesRead = read(UartHandles[channel], recBuffer + *numBytesRead, numBytes - *numBytesRead);
+		if(bytesRead < 0 && errno != EINTR && errno != EAGAIN)
+		{
+			return LUART_READ_FAIL;
+		}
+		if(bytesRead > 0)
+		{
+			if(*numBytesRead == 0 && timestamp != NULL)
+			{
+				struct timespec now;
+				clock_gettime(CLOCK_MONOTONIC, &now);
+				*timestamp = (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+			}
+			*numBytesRead += bytesRead;
+		}
+	}
+	
+	return L_OK;
+}
+
+//The tty Handle Is Only Handed Out While Nothing Else Reads From It
+int LinxBeagleBone::UartGetFileDescriptor(unsigned char channel)
+{
+	if(UartHandles[channel] <= 0 || UartRxThreads[channel] != NULL)
+	{
+		return -1;
+	}
+	
+	return UartHandles[channel];
+}
+
+int LinxBeagleBone::UartEnableRxThread(unsigned char channel, unsigned long bufferSize)
+{
+	if(UartHandles[channel] <= 0)
+	{
+		return LUART_OPEN_FAIL;
+	}
+	if(UartRxThreads[channel] != NULL)
+	{
+		return L_OK;
+	}
+	
+	LinxUartRx* rx = new LinxUartRx();
+	int status = rx->Start(UartHandles[channel], bufferSize);
+	if(status != L_OK)
+	{
+		delete rx;
+		return status;
+	}
+	UartRxThreads[channel] = rx;
+	
+	return L_OK;
+}
+
 int LinxBeagleBone::UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer)
 {
 	int bytesSent = write(UartHandles[channel], sendBuffer, numBytes);	
@@ -921,6 +1494,14 @@ int LinxBeagleBone::UartWrite(unsigned char channel, unsigned char numBytes, uns
 
 int LinxBeagleBone::UartClose(unsigned char channel)
 {
+	//Stop The RX Thread Before Its Handle Goes Away
+	LinxUartRx* rx = UartRxThreads[channel];
+	if(rx != NULL)
+	{
+		delete rx;
+		UartRxThreads[channel] = NULL;
+	}
+	
 	//Close UART Channel, Return OK or Error
 	if (close(UartHandles[channel]) < 0)
 	{
@@ -964,6 +1545,18 @@ unsigned long LinxBeagleBone::GetSeconds()
 	return mTime.tv_sec;
 }
 
+unsigned long long LinxBeagleBone::GetMicroSeconds()
+{
+	return GetNanoSeconds() / 1000;
+}
+
+unsigned long long LinxBeagleBone::GetNanoSeconds()
+{
+	timespec mTime;
+	clock_gettime(CLOCK_MONOTONIC, &mTime);
+	return (unsigned long long)mTime.tv_sec * 1000000000ULL + mTime.tv_nsec;
+}
+
 void LinxBeagleBone::DelayMs(unsigned long ms)
 {
 	usleep(ms * 1000);
@@ -971,11 +1564,31 @@ void LinxBeagleBone::DelayMs(unsigned long ms)
 
 void LinxBeagleBone::NonVolatileWrite(int address, unsigned char data)
 {
-	
+	Nvs->Write(address, 1, &data);
 }
 
 unsigned char LinxBeagleBone::NonVolatileRead(int address)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
+	unsigned char data = 0;
+	if(Nvs->Read(address, 1, &data) != L_OK)
+	{
+		return L_FUNCTION_NOT_SUPPORTED;
+	}
+	return data;
+}
+
+int LinxBeagleBone::NonVolatileWriteBlock(int address, unsigned char numBytes, const unsigned char* data)
+{
+	return Nvs->Write(address, numBytes, data);
+}
+
+int LinxBeagleBone::NonVolatileReadBlock(int address, unsigned char numBytes, unsigned char* data)
+{
+	return Nvs->Read(address, numBytes, data);
+}
+
+int LinxBeagleBone::NonVolatileCommit()
+{
+	return Nvs->Commit();
 }
 
@@ -25,13 +25,26 @@
 #define UART_PATH_LEN 64
 */
 #define AI_PATH_LEN 64
+#define DTO_LOAD_TIMEOUT 3000							//Max Wait For An Overlay's Device Files (mS)
+#define GPIO_EXPORT_TIMEOUT 1000						//Max Wait For An Exported GPIO's Files (mS)
+#define FILE_WAIT_POLL_MS 10							//Recheck Interval For Files That Send No inotify Events (sysfs)
+#define BB_MAX_DIGITAL_SLOTS 72						//Header Pins Usable As Digital Channels
+#define BB_MAX_PWM_SLOTS 8
+#define BB_MAX_AI_SLOTS 8
+#define BB_MAX_BUS_SLOTS 6								//UART / SPI / I2C Masters
+#define BB_NUM_GPIO_BANKS 4							//gpiochip0 - gpiochip3, 32 Lines Each
 
 /****************************************************************************************
 **  Includes
 ****************************************************************************************/		
 #include "LinxDevice.h"
+#include "LinxUartRx.h"
+#include "LinxSoftPwm.h"
+#include "LinxNvs.h"
+#include "LinxIioBuffer.h"
+#include "LinxChannelTable.h"
 #include <stdio.h>
-#include <map>
+#include <vector>
 #include <string>
 
 using namespace std;
@@ -51,56 +64,65 @@ class LinxBeagleBone : public LinxDevice
 		int FilePathLayout;																	//Used to indicate the file path layout 7 for 7.x and 8 for 8.x
 		
 		//DIO
-		map<unsigned char, unsigned char> DigitalChannels;				//Maps LINX DIO Channel Numbers To BB GPIO Channels
-		map<unsigned char, unsigned char> DigitalDirs;						//Current DIO Direction Values
-		map<unsigned char, FILE*> DigitalDirHandles;							//File Handles For Digital Pin Directions
-		map<unsigned char, FILE*> DigitalValueHandles;						//File Handles For Digital Pin Values
+		LinxChannelTable<unsigned char, BB_MAX_DIGITAL_SLOTS> DigitalChannels;				//Maps LINX DIO Channel Numbers To BB GPIO Channels
+		LinxChannelTable<unsigned char, BB_MAX_DIGITAL_SLOTS> DigitalDirs;						//Current DIO Direction Values
+		LinxChannelTable<FILE*, BB_MAX_DIGITAL_SLOTS> DigitalDirHandles;							//File Handles For Digital Pin Directions
+		LinxChannelTable<FILE*, BB_MAX_DIGITAL_SLOTS> DigitalValueHandles;						//File Handles For Digital Pin Values
+		LinxSoftPwm* SoftPwmBanks[BB_NUM_GPIO_BANKS];						//Square Wave Schedulers, One Per GPIO Bank (gpiochip), Created On First Use
 		
 		//PWM
-		map<unsigned char, string> PwmDirPaths;								//PWM Device Tree Overlay Names			
-		map<unsigned char, FILE*> PwmPeriodHandles;						//File Handles For PWM Period Values
-		map<unsigned char, FILE*> PwmDutyCycleHandles;				//File Handles For PWM Duty Cycle Values		
-		map<unsigned char, unsigned long> PwmPeriods;					//Current PWM  Values
+		LinxChannelTable<string, BB_MAX_PWM_SLOTS> PwmDirPaths;								//PWM Device Tree Overlay Names			
+		LinxChannelTable<FILE*, BB_MAX_PWM_SLOTS> PwmPeriodHandles;						//File Handles For PWM Period Values
+		LinxChannelTable<FILE*, BB_MAX_PWM_SLOTS> PwmDutyCycleHandles;				//File Handles For PWM Duty Cycle Values		
+		LinxChannelTable<unsigned long, BB_MAX_PWM_SLOTS> PwmPeriods;					//Current PWM  Values
 		unsigned long PwmDefaultPeriod;											//Default Period For PWM Channels (nS)
 		string PwmDutyCycleFileName;
 		string PwmPeriodFileName;
 		string PwmEnableFileName;
 				
 		//AI
-		map<unsigned char, FILE*> AiValueHandles;							//AI Value Handles
-		map<unsigned char, string> AiValuePaths;								//AI Value Paths
+		LinxChannelTable<FILE*, BB_MAX_AI_SLOTS> AiValueHandles;							//AI Value Handles
+		LinxChannelTable<string, BB_MAX_AI_SLOTS> AiValuePaths;								//AI Value Paths
 		unsigned char NumAiRefIntVals;												//Number Of Internal AI Reference Voltages
 		const unsigned long* AiRefIntVals;											//Supported AI Reference Voltages (uV)
 		const int* AiRefCodes;															//AI Ref Values (AI Ref Macros In Wiring Case)		
 		unsigned long AiRefExtMin;														//Min External AI Ref Value (uV)
 		unsigned long AiRefExtMax;					   								//Max External AI Ref Value (uV)		
+		string AiDtoName;																	//ADC Device Tree Overlay, Loaded On First AI Use
+		string AiIioPath;																	//Sysfs Directory Of The ADC IIO Device
+		string AiIioDevPath;																//Character Device Buffered Scans Are Read From
+		LinxIioBuffer* AiStream;														//Buffered Acquisition, Created On First Stream Start
 		//int* AiHandles;																	//AI File Handles
 		//const char (*AiPaths)[AI_PATH_LEN];									//AI Channel File Paths
 		
 		//UART		
-		map<unsigned char, string> UartPaths;									//UART Channel File Paths
-		map<unsigned char, int> UartHandles;									//File Handles For UARTs - Must Be Int For Termios Functions
-		map<unsigned char, string> UartDtoNames;							//UART Device Tree Overlay Names	
-		unsigned char NumUartSpeeds;												//Number Of Support UART Buads
-		unsigned long* UartSupportedSpeeds;										//Supported UART Bauds Frequencies
-		unsigned long* UartSupportedSpeedsCodes;							//Supported UART Baud Divider Codes
+		LinxChannelTable<string, BB_MAX_BUS_SLOTS> UartPaths;									//UART Channel File Paths
+		LinxChannelTable<int, BB_MAX_BUS_SLOTS> UartHandles;									//File Handles For UARTs - Must Be Int For Termios Functions
+		LinxChannelTable<string, BB_MAX_BUS_SLOTS> UartDtoNames;							//UART Device Tree Overlay Names	
+		LinxChannelTable<LinxUartRx*, BB_MAX_BUS_SLOTS> UartRxThreads;					//Background Receive Threads, NULL For Channels That Have Not Enabled One
 		
 		//SPI
-		map<unsigned char, string> SpiDtoNames;  							//Device Tree Overlay Names For SPI Master(s)
-		map<unsigned char, string> SpiPaths;  									//File Paths For SPI Master(s)		
-		map<unsigned char, int> SpiHandles;										//File Handles For SPI Master(s)
+		LinxChannelTable<string, BB_MAX_BUS_SLOTS> SpiDtoNames;  							//Device Tree Overlay Names For SPI Master(s)
+		LinxChannelTable<string, BB_MAX_BUS_SLOTS> SpiPaths;  									//File Paths For SPI Master(s)		
+		LinxChannelTable<int, BB_MAX_BUS_SLOTS> SpiHandles;										//File Handles For SPI Master(s)
 		unsigned char NumSpiSpeeds;												//Number Of Supported SPI Speeds
 		unsigned long* SpiSupportedSpeeds;										//Supported SPI Clock Frequencies
 		int* SpiSpeedCodes;																//SPI Speed Values (Clock Divider Macros In Wiring Case)
-		map<unsigned char, unsigned char> SpiBitOrders;					//Stores Bit Orders For SPI Channels (LSBFIRST / MSBFIRST)
-		map<unsigned char, unsigned long> SpiSetSpeeds; 				//Stores The Set Clock Rate Of Each SPI Channel
+		LinxChannelTable<unsigned char, BB_MAX_BUS_SLOTS> SpiBitOrders;					//Stores Bit Orders For SPI Channels (LSBFIRST / MSBFIRST)
+		LinxChannelTable<unsigned long, BB_MAX_BUS_SLOTS> SpiSetSpeeds; 				//Stores The Set Clock Rate Of Each SPI Channel
 		unsigned long SpiDefaultSpeed;
 		
 		//I2C
-		map<unsigned char, string> I2cPaths;										//File Paths For I2C Master(s)
-		map<unsigned char, int> I2cHandles;										//File Handles For I2C Master(s)
-		map<unsigned char, string> I2cDtoNames;								//Device Tree Overlay Names For I2C Master(s)
+		LinxChannelTable<string, BB_MAX_BUS_SLOTS> I2cPaths;										//File Paths For I2C Master(s)
+		LinxChannelTable<int, BB_MAX_BUS_SLOTS> I2cHandles;										//File Handles For I2C Master(s)
+		LinxChannelTable<string, BB_MAX_BUS_SLOTS> I2cDtoNames;								//Device Tree Overlay Names For I2C Master(s)
 		unsigned char* I2cRefCount;													//Number Opens - Closes On I2C Channel
+		LinxChannelTable<unsigned char, BB_MAX_BUS_SLOTS> I2cSlaveAddrs;					//Slave Address Currently Set With I2C_SLAVE On Each I2C Master, 0xFF = None
+		LinxChannelTable<vector<unsigned char>, BB_MAX_BUS_SLOTS> I2cPendingMsgs;		//Writes Held Back For A Repeated Start - (Address, Length, EOF) Per Message
+		LinxChannelTable<vector<unsigned char>, BB_MAX_BUS_SLOTS> I2cPendingData;		//Data For Held Back Writes
+		
+		//NVS
+		LinxNvs* Nvs;																	//Non-Volatile Storage File (Mapped On First Use)
 		
 		
 		/****************************************************************************************
@@ -117,6 +139,11 @@ class LinxBeagleBone : public LinxDevice
 		virtual int AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
 		virtual int AnalogReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned long* values);
 		virtual int AnalogSetRef(unsigned char mode, unsigned long voltage);
+		virtual int AnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize);
+		virtual int AnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned char* values, unsigned long* numScansRead);
+		virtual int AnalogStreamReadNoPacking(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead);
+		virtual int AnalogStreamGetScansBuffered(unsigned long* numScans);
+		virtual int AnalogStreamStop();
 		
 		//DIGITAL
 		virtual int DigitalSetDirection(unsigned char numChans, unsigned char* channels, unsigned char* values);
@@ -125,6 +152,7 @@ class LinxBeagleBone : public LinxDevice
 		virtual int DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);											//Values Not Bit Packed
 		virtual int DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
 		virtual int DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);											//Response Not Bit Packed
+		virtual int DigitalPrewarm(unsigned char numChans, unsigned char* channels);
 		virtual int DigitalWriteSquareWave(unsigned char channel, unsigned long freq, unsigned long duration);
 		virtual int DigitalReadPulseWidth(unsigned char stimChan, unsigned char stimType, unsigned char respChan, unsigned char respType, unsigned long timeout, unsigned long* width);
 		
@@ -150,6 +178,10 @@ class LinxBeagleBone : public LinxDevice
 		virtual int UartSetBaudRate(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud);
 		virtual int UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes);
 		virtual int UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead);
+		virtual int UartEnableRxThread(unsigned char channel, unsigned long bufferSize);
+		virtual int UartGetBytesBuffered(unsigned char channel, unsigned long* numBytes);
+		virtual int UartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp);
+		virtual int UartGetFileDescriptor(unsigned char channel);
 		virtual int UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer);
 		virtual int UartClose(unsigned char channel);
 		
@@ -161,9 +193,14 @@ class LinxBeagleBone : public LinxDevice
 		//General
 		virtual unsigned long GetMilliSeconds();
 		virtual unsigned long GetSeconds();
+		virtual unsigned long long GetMicroSeconds();
+		virtual unsigned long long GetNanoSeconds();
 		virtual void DelayMs(unsigned long ms);
 		virtual void NonVolatileWrite(int address, unsigned char data);
 		virtual unsigned char NonVolatileRead(int address);
+		virtual int NonVolatileWriteBlock(int address, unsigned char numBytes, const unsigned char* data);
+		virtual int NonVolatileReadBlock(int address, unsigned char numBytes, unsigned char* data);
+		virtual int NonVolatileCommit();
 		
 	protected:
 		/****************************************************************************************
@@ -174,7 +211,20 @@ class LinxBeagleBone : public LinxDevice
 		**  Functions
 		****************************************************************************************/
 		virtual int digitalSmartOpen(unsigned char numChans, unsigned char* channels);
+		void bindDigitalSlots(const LinxChannelSlots* slots);
+		void bindPwmSlots(const LinxChannelSlots* slots);
+		void bindAiSlots(const LinxChannelSlots* slots);
+		void bindUartSlots(const LinxChannelSlots* slots);
+		void bindSpiSlots(const LinxChannelSlots* slots);
+		void bindI2cSlots(const LinxChannelSlots* slots);
 		virtual int pwmSmartOpen(unsigned char numChans, unsigned char* channels);
+		virtual int aiSmartOpen(unsigned char numChans, unsigned char* channels);
+		virtual void uartPinmux(unsigned char channel);
+		virtual void spiPinmux(unsigned char channel);
+		int aiLoadDto();
+		LinxSoftPwm* softPwmOpen(unsigned char channel, unsigned long period);
+		int softPwmClose(unsigned char channel);
+		int i2cTransfer(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* buffer, bool isRead);
 		bool fileExists(const char* path);
 		bool fileExists(const char* directory, const char* fileName);
 		bool fileExists(const char* directory, const char* fileName, unsigned long timout);
@@ -0,0 +1,261 @@
+/****************************************************************************************
+**  LINX bit packing kernels.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "LinxBitPack.h"
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+	#define LINX_BITPACK_SSSE3
+	#include <tmmintrin.h>
+#elif defined(__linux__) && defined(__ARM_NEON)
+	#define LINX_BITPACK_NEON
+	#include <arm_neon.h>
+	#if !defined(__aarch64__)
+		#include <sys/auxv.h>
+		#include <asm/hwcap.h>
+	#endif
+#endif
+
+/****************************************************************************************
+**  Private Functions
+****************************************************************************************/
+//ACC Must Hold numBits + 7 Bits
+template <class ACC>
+static void packWith(unsigned long numValues, const unsigned long* values, unsigned char numBits, unsigned char* packed)
+{
+	ACC mask = ((ACC)1 << numBits) - 1;
+	ACC acc = 0;
+	unsigned char accBits = 0;
+
+	for(unsigned long i=0; i<numValues; i++)
+	{
+		acc |= ((ACC)values[i] & mask) << accBits;
+		accBits += numBits;
+		while(accBits >= 8)
+		{
+			*packed++ = (unsigned char)acc;
+			acc >>= 8;
+			accBits -= 8;
+		}
+	}
+
+	//Partial Last Byte
+	if(accBits > 0)
+	{
+		*packed = (unsigned char)acc;
+	}
+}
+
+template <class ACC>
+static void unpackWith(unsigned long numValues, const unsigned char* packed, unsigned char numBits, unsigned long* values)
+{
+	ACC mask = ((ACC)1 << numBits) - 1;
+	ACC acc = 0;
+	unsigned char accBits = 0;
+
+	for(unsigned long i=0; i<numValues; i++)
+	{
+		while(accBits < numBits)
+		{
+			acc |= (ACC)(*packed++) << accBits;
+			accBits += 8;
+		}
+		values[i] = (unsigned long)(acc & mask);
+		acc >>= numBits;
+		accBits -= numBits;
+	}
+}
+
+static void reverseScalar(unsigned long numBytes, const unsigned char* src, unsigned char* dst)
+{
+	for(unsigned long i=0; i<numBytes; i++)
+	{
+		dst[i] = LinxBitPack::ReverseBits(src[i]);
+	}
+}
+
+#if defined(LINX_BITPACK_SSSE3)
+//Reverse Each Nibble With A 16 Entry Shuffle Table And Swap Them, 16 Bytes At A Time
+__attribute__((target("ssse3")))
+static void reverseSsse3(unsigned long numBytes, const unsigned char* src, unsigned char* dst)
+{
+	const __m128i table = _mm_setr_epi8(0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF);
+	const __m128i lowNibbles = _mm_set1_epi8(0x0F);
+
+	unsigned long i = 0;
+	for(; i+16<=numBytes; i+=16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i low = _mm_shuffle_epi8(table, _mm_and_si128(bytes, lowNibbles));
+		__m128i high = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(bytes, 4), lowNibbles));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_slli_epi16(low, 4), high));
+	}
+	reverseScalar(numBytes - i, src + i, dst + i);
+}
+#endif //LINX_BITPACK_SSSE3
+
+#if defined(LINX_BITPACK_NEON)
+static void reverseNeon(unsigned long numBytes, const unsigned char* src, unsigned char* dst)
+{
+	unsigned long i = 0;
+	#if defined(__aarch64__)
+		for(; i+16<=numBytes; i+=16)
+		{
+			vst1q_u8(dst + i, vrbitq_u8(vld1q_u8(src + i)));
+		}
+	#else
+		//No Byte Bit Reverse On ARMv7, Use A Nibble Table Lookup Like SSSE3
+		static const unsigned char nibbles[16] = {0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
+		uint8x8x2_t table;
+		table.val[0] = vld1_u8(nibbles);
+		table.val[1] = vld1_u8(nibbles + 8);
+		uint8x8_t lowNibbles = vdup_n_u8(0x0F);
+
+		for(; i+8<=numBytes; i+=8)
+		{
+			uint8x8_t bytes = vld1_u8(src + i);
+			uint8x8_t low = vtbl2_u8(table, vand_u8(bytes, lowNibbles));
+			uint8x8_t high = vtbl2_u8(table, vshr_n_u8(bytes, 4));
+			vst1_u8(dst + i, vorr_u8(vshl_n_u8(low, 4), high));
+		}
+	#endif
+	reverseScalar(numBytes - i, src + i, dst + i);
+}
+#endif //LINX_BITPACK_NEON
+
+typedef void (*ReverseFunction)(unsigned long numBytes, const unsigned char* src, unsigned char* dst);
+
+static ReverseFunction selectReverse(const char** name)
+{
+	#if defined(LINX_BITPACK_SSSE3)
+		if(__builtin_cpu_supports("ssse3"))
+		{
+			*name = "ssse3";
+			return reverseSsse3;
+		}
+	#elif defined(LINX_BITPACK_NEON)
+		#if defined(__aarch64__)
+			*name = "neon";
+			return reverseNeon;
+		#else
+			if(getauxval(AT_HWCAP) & HWCAP_NEON)
+			{
+				*name = "neon";
+				return reverseNeon;
+			}
+		#endif
+	#endif
+
+	*name = "scalar";
+	return reverseScalar;
+}
+
+typedef struct ReverseChoice
+{
+	ReverseFunction function;
+	const char* name;
+}ReverseChoice;
+
+static ReverseChoice pickReverse()
+{
+	ReverseChoice choice;
+	choice.function = selectReverse(&choice.name);
+	return choice;
+}
+
+//Picked On First Use.  A Function Local Static Is Initialized Exactly Once, Even With Threads Racing Here.
+static const ReverseChoice& loadReverse()
+{
+	static const ReverseChoice choice = pickReverse();
+	return choice;
+}
+
+/****************************************************************************************
+**  Public Functions
+****************************************************************************************/
+unsigned long LinxBitPack::PackedSize(unsigned long numValues, unsigned char numBits)
+{
+	unsigned long long numPackedBits = (unsigned long long)numValues * numBits;
+	return (unsigned long)((numPackedBits + 7) / 8);
+}
+
+void LinxBitPack::Pack(unsigned long numValues, const unsigned long* values, unsigned char numBits, unsigned char* packed)
+{
+	//Stay In 32 Bit Math For The Usual 8 - 16 Bit Samples, MCUs Pay For Every 64 Bit Shift
+	if(numBits <= 24)
+	{
+		packWith<unsigned long>(numValues, values, numBits, packed);
+	}
+	else
+	{
+		packWith<unsigned long long>(numValues, values, numBits, packed);
+	}
+}
+
+void LinxBitPack::Unpack(unsigned long numValues, const unsigned char* packed, unsigned char numBits, unsigned long* values)
+{
+	if(numBits <= 24)
+	{
+		unpackWith<unsigned long>(numValues, packed, numBits, values);
+	}
+	else
+	{
+		unpackWith<unsigned long long>(numValues, packed, numBits, values);
+	}
+}
+
+void LinxBitPack::PackBits(unsigned int numBits, const unsigned char* bits, unsigned char* packed)
+{
+	unsigned int numFull = numBits / 8;
+
+	for(unsigned int i=0; i<numFull; i++)
+	{
+		const unsigned char* b = bits + 8*i;
+		packed[i] = (unsigned char)(((b[0] != 0) << 7) | ((b[1] != 0) << 6) | ((b[2] != 0) << 5) | ((b[3] != 0) << 4) | ((b[4] != 0) << 3) | ((b[5] != 0) << 2) | ((b[6] != 0) << 1) | (b[7] != 0));
+	}
+
+	//Partial Last Byte, Unused Low Bits Are 0
+	if(numBits % 8 != 0)
+	{
+		unsigned char last = 0;
+		for(unsigned int i=8*numFull; i<numBits; i++)
+		{
+			last |= (bits[i] != 0) << (7 - i%8);
+		}
+		packed[numFull] = last;
+	}
+}
+
+void LinxBitPack::UnpackBits(unsigned int numBits, const unsigned char* packed, unsigned char* bits)
+{
+	for(unsigned int i=0; i<numBits; i++)
+	{
+		bits[i] = (packed[i/8] >> i%8) & 0x01;
+	}
+}
+
+unsigned char LinxBitPack::ReverseBits(unsigned char b)
+{
+	b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+	b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+	b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+	return b;
+}
+
+void LinxBitPack::ReverseBits(unsigned long numBytes, const unsigned char* src, unsigned char* dst)
+{
+	loadReverse().function(numBytes, src, dst);
+}
+
+const char* LinxBitPack::ReverseKernel()
+{
+	return loadReverse().name;
+}
@@ -0,0 +1,42 @@
+/****************************************************************************************
+**  LINX header for bit packing kernels.
+**
+**  Packs and unpacks N bit samples and DIO bitmaps the way the LINX protocol sends them
+**  and bit reverses byte buffers for LSb first SPI.  Buffer reversal uses SSSE3 or NEON
+**  on Linux when the CPU has it and a table lookup everywhere else.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_BITPACK_H
+#define LINX_BITPACK_H
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+class LinxBitPack
+{
+	public:
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		//N Bit Samples, LSb First With No Padding Between Samples (AI Read Responses).  1 To 32 Bits.
+		static unsigned long PackedSize(unsigned long numValues, unsigned char numBits);			//Bytes
+		static void Pack(unsigned long numValues, const unsigned long* values, unsigned char numBits, unsigned char* packed);
+		static void Unpack(unsigned long numValues, const unsigned char* packed, unsigned char numBits, unsigned long* values);
+
+		//DIO Bitmaps, One 0 / 1 Byte Per Channel On The Unpacked Side
+		static void PackBits(unsigned int numBits, const unsigned char* bits, unsigned char* packed);		//First Channel In The MSb (Digital Read Responses)
+		static void UnpackBits(unsigned int numBits, const unsigned char* packed, unsigned char* bits);		//First Channel In The LSb (Digital Write / Set Direction Commands)
+
+		//Bit Reversal For SPI Hardware That Does Not Support LSb First.  src And dst May Be The Same Buffer.
+		static unsigned char ReverseBits(unsigned char b);
+		static void ReverseBits(unsigned long numBytes, const unsigned char* src, unsigned char* dst);
+
+		static const char* ReverseKernel();		//"ssse3", "neon" Or "scalar"
+};
+
+#endif //LINX_BITPACK_H
@@ -0,0 +1,162 @@
+/****************************************************************************************
+**  LINX header for flat per-channel state tables.
+**
+**  A LinxChannelSlots numbers a board's channels 1..N and is built at compile time from
+**  the board's channel list(s).  A LinxChannelTable keeps one value per slot in a plain
+**  array, so looking up a channel is two array reads - no tree walk and no insert when a
+**  channel is not on the board.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_CHANNELTABLE_H
+#define LINX_CHANNELTABLE_H
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <assert.h>
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define LINX_MAX_SLOTS 255								//Slot 0 Is Reserved For Channels Not On The Board
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+class LinxChannelSlots
+{
+	public:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		unsigned char Slot[256];								//Slot Of Each LINX Channel, 0 = Not On The Board
+		unsigned char Channels[LINX_MAX_SLOTS + 1];		//LINX Channel In Each Slot
+		unsigned char NumSlots;
+
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		constexpr LinxChannelSlots() : Slot(), Channels(), NumSlots(0)
+		{
+		}
+
+		//Channels In Both Lists Get One Slot
+		constexpr LinxChannelSlots(unsigned char numChans, const unsigned char* channels, unsigned char numExtraChans = 0, const unsigned char* extraChans = 0) : Slot(), Channels(), NumSlots(0)
+		{
+			add(numChans, channels);
+			add(numExtraChans, extraChans);
+		}
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		constexpr bool Contains(unsigned char channel) const
+		{
+			return Slot[channel] != 0;
+		}
+
+		static const LinxChannelSlots* None()
+		{
+			static const LinxChannelSlots none;
+			return &none;
+		}
+
+	private:
+		constexpr void add(unsigned char numChans, const unsigned char* channels)
+		{
+			for(int i=0; i<numChans; i++)
+			{
+				if(Slot[channels[i]] == 0)
+				{
+					NumSlots++;
+					Slot[channels[i]] = NumSlots;
+					Channels[NumSlots] = channels[i];
+				}
+			}
+		}
+};
+
+template <class T, unsigned char CAPACITY>
+class LinxChannelTable
+{
+	public:
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxChannelTable() : Slots(LinxChannelSlots::None()), Initial(), Values()
+		{
+		}
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		//Use A Board's Slots And Reset Every Value.  Fails If The Board Has More Channels Than The Table Holds.
+		bool Bind(const LinxChannelSlots* slots)
+		{
+			if(slots->NumSlots > CAPACITY)
+			{
+				return false;
+			}
+			Slots = slots;
+			Fill(Initial);
+			return true;
+		}
+
+		//Set Every Value, And The Value Reset() And Unknown Channels Read As
+		void Fill(const T& value)
+		{
+			Initial = value;
+			for(int i=0; i<=CAPACITY; i++)
+			{
+				Values[i] = value;
+			}
+		}
+
+		void Reset(unsigned char channel)
+		{
+			(*this)[channel] = Initial;
+		}
+
+		bool Contains(unsigned char channel) const
+		{
+			return Slots->Slot[channel] != 0;
+		}
+
+		unsigned char Size() const
+		{
+			return Slots->NumSlots;
+		}
+
+		unsigned char ChannelAt(unsigned char index) const
+		{
+			return Slots->Channels[index + 1];
+		}
+
+		//Channels Not On The Board Share Slot 0, Which Is Reset To The Fill Value On Each Lookup.
+		//Using A Table That Was Never Bound (Or Whose Bind() Failed) Is A Bug, Not A Missing Channel.
+		T& operator[](unsigned char channel)
+		{
+			assert(Slots != LinxChannelSlots::None());
+			unsigned char slot = Slots->Slot[channel];
+			if(slot == 0)
+			{
+				Values[0] = Initial;
+			}
+			return Values[slot];
+		}
+
+	private:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		const LinxChannelSlots* Slots;
+		T Initial;
+		T Values[CAPACITY + 1];
+};
+
+#endif //LINX_CHANNELTABLE_H
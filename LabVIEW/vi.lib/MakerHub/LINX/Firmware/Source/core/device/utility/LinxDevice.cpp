@@ -14,6 +14,8 @@
 ****************************************************************************************/
 #include <stdio.h>
 #include "LinxDevice.h"
+#include "LinxBitPack.h"
+#include "LinxLog.h"
 
 
 /****************************************************************************************
@@ -38,10 +40,7 @@ LinxDevice::~LinxDevice()
 //Reverse The Order Of Bits In A Byte.  This Is Useful For SPI Hardware That Does Not Support Bit Order
 unsigned char LinxDevice::ReverseBits(unsigned char b) 
 {
-	b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
-	b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
-	b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
-	return b;
+	return LinxBitPack::ReverseBits(b);
 }
 
 
@@ -51,6 +50,9 @@ void LinxDevice::EnableDebug(unsigned char channel)
 	
 	UartOpen(channel, 115200, &actualBaud);
 	DebugPrintln("Debugging Enabled");
+	
+	//LINX_LOG_* Messages Go Out The Same Channel
+	LinxLogger.Attach(this);
 }
 
 void LinxDevice::DelayMs(unsigned long ms)
@@ -58,6 +60,44 @@ void LinxDevice::DelayMs(unsigned long ms)
 
 }
 
+//Backends Override This, GetMilliSeconds() Wraps
+unsigned long long LinxDevice::GetMicroSeconds()
+{
+	return (unsigned long long)GetMilliSeconds() * 1000;
+}
+
+unsigned long long LinxDevice::GetNanoSeconds()
+{
+	return GetMicroSeconds() * 1000;
+}
+
+//Byte At A Time Through NonVolatileWrite(), Skipping Bytes That Already Hold The Value To Save EEPROM Write Cycles
+int LinxDevice::NonVolatileWriteBlock(int address, unsigned char numBytes, const unsigned char* data)
+{
+	for(int i=0; i<numBytes; i++)
+	{
+		if(NonVolatileRead(address + i) != data[i])
+		{
+			NonVolatileWrite(address + i, data[i]);
+		}
+	}
+	return L_OK;
+}
+
+int LinxDevice::NonVolatileReadBlock(int address, unsigned char numBytes, unsigned char* data)
+{
+	for(int i=0; i<numBytes; i++)
+	{
+		data[i] = NonVolatileRead(address + i);
+	}
+	return L_OK;
+}
+
+int LinxDevice::NonVolatileCommit()
+{
+	return L_OK;
+}
+
 void LinxDevice::DebugPrintPacket(unsigned char direction, const unsigned char* packetBuffer)
 {
 	#if DEBUG_ENABLED >= 0
@@ -93,6 +133,34 @@ int LinxDevice::AnalogReadNoPacking(unsigned char numChans, unsigned char* chann
 	return L_FUNCTION_NOT_SUPPORTED;
 }
 
+int LinxDevice::AnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize)
+{
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
+int LinxDevice::AnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned char* values, unsigned long* numScansRead)
+{
+	*numScansRead = 0;
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
+int LinxDevice::AnalogStreamReadNoPacking(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead)
+{
+	*numScansRead = 0;
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
+int LinxDevice::AnalogStreamGetScansBuffered(unsigned long* numScans)
+{
+	*numScans = 0;
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
+int LinxDevice::AnalogStreamStop()
+{
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
 
 //--------------------------------------------------------Digital-------------------------------------------------------
 int LinxDevice::DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
@@ -100,6 +168,12 @@ int LinxDevice::DigitalWriteNoPacking(unsigned char numChans, unsigned char* cha
 	return L_FUNCTION_NOT_SUPPORTED;
 }
 
+int LinxDevice::DigitalPrewarm(unsigned char numChans, unsigned char* channels)
+{
+	//Pins Are Ready From Power Up On Most Devices
+	return L_OK;
+}
+
 int LinxDevice::DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
 {
 	return L_FUNCTION_NOT_SUPPORTED;
@@ -111,7 +185,81 @@ int LinxDevice::PwmSetFrequency(unsigned char numChans, unsigned char* channels,
 	return L_FUNCTION_NOT_SUPPORTED;
 }
 
+// ---------------- SPI Functions ------------------ 
+int LinxDevice::SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments)
+{
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
+// ---------------- I2C Functions ------------------ 
+int LinxDevice::I2cWriteRead(unsigned char channel, unsigned char slaveAddress, unsigned char numWriteBytes, unsigned char* sendBuffer, unsigned char numReadBytes, unsigned int timeout, unsigned char* recBuffer)
+{
+	int status = I2cWrite(channel, slaveAddress, EOF_RESTART, numWriteBytes, sendBuffer);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	return I2cRead(channel, slaveAddress, EOF_STOP, numReadBytes, timeout, recBuffer);
+}
+
 // ---------------- UART Functions ------------------ 
+int LinxDevice::UartEnableRxThread(unsigned char channel, unsigned long bufferSize)
+{
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
+int LinxDevice::UartGetBytesBuffered(unsigned char channel, unsigned long* numBytes)
+{
+	unsigned char available = 0;
+	int status = UartGetBytesAvailable(channel, &available);
+	*numBytes = available;
+	return status;
+}
+
+int LinxDevice::UartGetFileDescriptor(unsigned char channel)
+{
+	return -1;
+}
+
+int LinxDevice::UartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp)
+{
+	*numBytesRead = 0;
+	if(timestamp != NULL)
+	{
+		*timestamp = 0;
+	}
+	if(numBytes > 255)
+	{
+		numBytes = 255;
+	}
+	
+	//Poll Until Enough Bytes Arrive Or Timeout
+	unsigned long startTime = GetMilliSeconds();
+	unsigned char available = 0;
+	while(true)
+	{
+		int status = UartGetBytesAvailable(channel, &available);
+		if(status != L_OK)
+		{
+			return status;
+		}
+		if(available >= numBytes || (GetMilliSeconds() - startTime) >= timeout)
+		{
+			break;
+		}
+	}
+	
+	if(available > numBytes)
+	{
+		available = numBytes;
+	}
+	
+	unsigned char bytesRead = 0;
+	int status = UartRead(channel, available, recBuffer, &bytesRead);
+	*numBytesRead = bytesRead;
+	return status;
+}
+
 
 void LinxDevice::UartWrite(unsigned char channel, unsigned char b)
 {
@@ -220,6 +368,12 @@ void LinxDevice::UartWriteln(unsigned char channel, long n, int base)
 	UartWriteln(channel);
 }
 
+// ---------------- Servo Functions ------------------ 
+int LinxDevice::SoftPwmGetStats(LinxSoftPwmStats* stats, unsigned char reset)
+{
+	return L_FUNCTION_NOT_SUPPORTED;
+}
+
 //----------------- WS2812 Functions -----------------------------
 int LinxDevice::Ws2812Open(unsigned short numLeds, unsigned char dataChan)
 {
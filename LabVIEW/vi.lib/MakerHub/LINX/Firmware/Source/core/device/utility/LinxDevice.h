@@ -50,6 +50,10 @@
 	#define MSBFIRST 1
 #endif
 
+#define SPI_SEGMENT_FULL_DUPLEX 0
+#define SPI_SEGMENT_TX_ONLY 1
+#define SPI_SEGMENT_RX_ONLY 2
+
 //I2C
 #define EOF_STOP 0
 #define EOF_RESTART 1
@@ -82,6 +86,7 @@
 #define NVS_WIFI_PW_SIZE 0x31
 #define NVS_WIFI_PW 0x32
 #define NVS_SERIAL_INTERFACE_MAX_BAUD 0x72
+#define NVS_SIZE 0x100							//Bytes Reserved For The Addresses Above
 
 //DEBUG
 #define TX 0
@@ -102,7 +107,9 @@ typedef enum LinxStatus
 typedef enum AioStatus
 {
 	LANALOG_REF_MODE_ERROR=129,
-	LANALOG_REF_VAL_ERROR=130
+	LANALOG_REF_VAL_ERROR=130,
+	LANALOG_STREAM_OPEN_FAIL,
+	LANALOG_STREAM_OVERRUN
 }AioStatus;
 
 typedef enum DioStatus
@@ -114,9 +121,32 @@ typedef enum DioStatus
 typedef enum SPIStatus
 {
 	LSPI_OPEN_FAIL = 128,
-	LSPI_TRANSFER_FAIL
+	LSPI_TRANSFER_FAIL,
+	LSPI_INVALID_TRANSACTION
 }SPIStatus;
 
+//One Segment Of An SPI Transaction.  All Segments In A Transaction Share One CS Assertion.
+typedef struct LinxSpiSegment
+{
+	unsigned char type;					//SPI_SEGMENT_FULL_DUPLEX, SPI_SEGMENT_TX_ONLY or SPI_SEGMENT_RX_ONLY
+	unsigned char numBytes;				//Bytes Clocked In This Segment
+	unsigned long speed;					//Clock Rate For This Segment (0 = Channel Speed)
+	unsigned short delayUs;				//Delay After This Segment Before The Next Starts (uS)
+	unsigned char* sendBuffer;			//Data To Send (NULL For Rx Only, Zeros Are Sent)
+	unsigned char* recBuffer;			//Received Data (NULL For Tx Only)
+}LinxSpiSegment;
+
+//Timing Of A Software PWM / Servo Scheduler.  Latency Is How Late Each Wakeup Was Versus Its Scheduled Edge.
+typedef struct LinxSoftPwmStats
+{
+	unsigned long numWakeups;			//Scheduler Wakeups That Wrote Edges (One GPIO Write Each)
+	unsigned long numEdges;				//Channel Edges Written
+	unsigned long latencyMin;			//nS
+	unsigned long latencyMax;			//nS
+	unsigned long latencyMean;			//nS
+	unsigned char realTime;				//1 If The Scheduler Runs SCHED_FIFO, 0 If It Fell Back To Normal Scheduling
+}LinxSoftPwmStats;
+
 typedef enum I2CStatus
 {
 	LI2C_SADDR=128, 
@@ -124,7 +154,8 @@ typedef enum I2CStatus
 	LI2C_WRITE_FAIL, 	
 	LI2C_READ_FAIL, 
 	LI2C_CLOSE_FAIL,
-	LI2C_OPEN_FAIL
+	LI2C_OPEN_FAIL,
+	LI2C_INVALID_TRANSACTION
 }I2CStatus;
 
 typedef enum UartStatus
@@ -134,7 +165,8 @@ typedef enum UartStatus
 	LUART_AVAILABLE_FAIL, 
 	LUART_READ_FAIL, 
 	LUART_WRITE_FAIL, 
-	LUART_CLOSE_FAIL
+	LUART_CLOSE_FAIL,
+	LUART_OVERRUN
 }UartStatus;
 
 class LinxDevice
@@ -237,10 +269,16 @@ class LinxDevice
 		virtual int AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values) = 0;
 		virtual int AnalogReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned long* values);		//Values Are ADC Ticks And Not Bit Packed
 		virtual int AnalogSetRef(unsigned char mode, unsigned long voltage) = 0;
+		virtual int AnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize);		//Continuous Acquisition Into Per Channel Ring Buffers (bufferSize In Scans, 0 = Default)
+		virtual int AnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned char* values, unsigned long* numScansRead);		//Channel Major, Bit Packed Like AnalogRead
+		virtual int AnalogStreamReadNoPacking(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead);		//Channel Major ADC Ticks
+		virtual int AnalogStreamGetScansBuffered(unsigned long* numScans);
+		virtual int AnalogStreamStop();
 		
 		//DIGITAL
 		virtual int DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values) = 0;				//Values Are Bit Packed
 		virtual int DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);		//Values Are Not Bit Packed
+		virtual int DigitalPrewarm(unsigned char numChans, unsigned char* channels);		//Claim Pins Up Front So Their First Use Is Fast
 		virtual int DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values) = 0;
 		virtual int DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);		//Response Not Bit Packed
 		virtual int DigitalWriteSquareWave(unsigned char channel, unsigned long freq, unsigned long duration) = 0;
@@ -256,12 +294,14 @@ class LinxDevice
 		virtual int SpiSetMode(unsigned char channel, unsigned char mode) = 0;
 		virtual int SpiSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed) = 0;
 		virtual int SpiWriteRead(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer) = 0;
+		virtual int SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments);		//Segments Run Under One CS Assertion
 		
 		//I2C
 		virtual int I2cOpenMaster(unsigned char channel) = 0;
 		virtual int I2cSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed) = 0;
 		virtual int I2cWrite(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer) = 0;
 		virtual int I2cRead(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer) = 0;		
+		virtual int I2cWriteRead(unsigned char channel, unsigned char slaveAddress, unsigned char numWriteBytes, unsigned char* sendBuffer, unsigned char numReadBytes, unsigned int timeout, unsigned char* recBuffer);		//Write (Register Pointer), Repeated Start, Read
 		virtual int I2cClose(unsigned char channel) = 0;
 		
 		//UART
@@ -270,6 +310,10 @@ class LinxDevice
 		virtual int UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes) = 0;
 		virtual int UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead) = 0;		
 		virtual int UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer) = 0;		
+		virtual int UartEnableRxThread(unsigned char channel, unsigned long bufferSize);		//Drain The Port Into A Ring Buffer In The Background (0 = Default Size)
+		virtual int UartGetBytesBuffered(unsigned char channel, unsigned long* numBytes);	//Bytes Available Without The 255 Limit
+		virtual int UartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp);		//Wait Up To timeout mS For numBytes, timestamp In nS (0 If Unsupported)
+		virtual int UartGetFileDescriptor(unsigned char channel);			//Handle To Wait On For Received Data, -1 If The Channel Must Be Polled
 		virtual void UartWrite(unsigned char channel, char c);
 		virtual void UartWrite(unsigned char channel, const char s[]);
 		virtual void UartWrite(unsigned char channel, unsigned char c);
@@ -292,6 +336,7 @@ class LinxDevice
 		virtual int ServoOpen(unsigned char numChans, unsigned char* channels) = 0;
 		virtual int ServoSetPulseWidth(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths) = 0;
 		virtual int ServoClose(unsigned char numChans, unsigned char* channels) = 0;
+		virtual int SoftPwmGetStats(LinxSoftPwmStats* stats, unsigned char reset);		//Software PWM / Servo Timing, reset Clears The Counters After Reading
 		
 		//WS2812
 		virtual int Ws2812Open(unsigned short numLeds, unsigned char dataChan);
@@ -304,9 +349,14 @@ class LinxDevice
 		unsigned char ReverseBits(unsigned char b);
 		virtual unsigned long GetMilliSeconds() = 0;
 		virtual unsigned long GetSeconds() = 0;
+		virtual unsigned long long GetMicroSeconds();		//Monotonic, 64 Bit So It Does Not Wrap
+		virtual unsigned long long GetNanoSeconds();		//Monotonic, Only As Fine As GetMicroSeconds() Where The Backend Has No Better Clock
 		virtual void DelayMs(unsigned long ms);
 		virtual void NonVolatileWrite(int address, unsigned char data) = 0;
 		virtual unsigned char NonVolatileRead(int address) = 0;
+		virtual int NonVolatileWriteBlock(int address, unsigned char numBytes, const unsigned char* data);		//Unchanged Bytes Are Not Rewritten
+		virtual int NonVolatileReadBlock(int address, unsigned char numBytes, unsigned char* data);
+		virtual int NonVolatileCommit();					//Make Block Writes Durable, Called Once At The End Of A Command
 		
 		//Debug
 		virtual void EnableDebug(unsigned char channel);
@@ -0,0 +1,529 @@
+/****************************************************************************************
+**  LINX Linux IIO buffered acquisition.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "LinxDevice.h"
+#include "LinxIioBuffer.h"
+
+#include <new>
+#include <stdio.h>
+#include <time.h>
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace std;
+
+/****************************************************************************************
+**  Constructors /  Destructor
+****************************************************************************************/
+LinxIioBuffer::LinxIioBuffer(const char* sysfsPath, const char* devPath)
+{
+	SysfsPath = sysfsPath;
+	DevPath = devPath;
+	Handle = -1;
+	WakePipe[0] = -1;
+	WakePipe[1] = -1;
+	Started = false;
+	Running = false;
+	NumChannels = 0;
+	ScanSize = 0;
+	for(int i=0; i<IIO_MAX_CHANS; i++)
+	{
+		Rings[i] = NULL;
+	}
+	RingSize = 0;
+	Head = 0;
+	Count = 0;
+	Overrun = false;
+}
+
+LinxIioBuffer::~LinxIioBuffer()
+{
+	Stop();
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+int LinxIioBuffer::Start(unsigned char numChans, const unsigned char* channels, unsigned long bufferSize)
+{
+	//Restarting Changes The Scan Layout, So Tear Down Any Running Acquisition First
+	Stop();
+
+	if(numChans == 0 || numChans > IIO_MAX_CHANS)
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	if(bufferSize == 0)
+	{
+		bufferSize = IIO_DEFAULT_BUFFER_SCANS;
+	}
+	else if(bufferSize > IIO_MAX_BUFFER_SCANS)
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+
+	//Scan Elements Can Only Change While The Kernel Buffer Is Off
+	if(writeAttribute("buffer/enable", 0) != L_OK)
+	{
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	disableScanElements();
+
+	//Enable Requested Channels And Read Back How The Kernel Packs Each One
+	int indices[IIO_MAX_CHANS];
+	NumChannels = numChans;
+	for(int i=0; i<numChans; i++)
+	{
+		char enName[48];
+		sprintf(enName, "scan_elements/in_voltage%d_en", channels[i]);
+		if(parseChannel(channels[i], &Channels[i], &indices[i]) != L_OK || writeAttribute(enName, 1) != L_OK)
+		{
+			Stop();
+			return LANALOG_STREAM_OPEN_FAIL;
+		}
+	}
+
+	//Scans Hold Enabled Channels In Scan Index Order, Each Aligned To Its Own Size
+	unsigned int offset = 0;
+	unsigned int maxBytes = 1;
+	for(int placed=0; placed<numChans; placed++)
+	{
+		//Lowest Index Not Yet Placed
+		int next = -1;
+		for(int i=0; i<numChans; i++)
+		{
+			if(Channels[i].offset == 0xFFFFFFFF && (next < 0 || indices[i] < indices[next]))
+			{
+				next = i;
+			}
+		}
+		offset = (offset + Channels[next].bytes - 1) / Channels[next].bytes * Channels[next].bytes;
+		Channels[next].offset = offset;
+		offset += Channels[next].bytes;
+		if(Channels[next].bytes > maxBytes)
+		{
+			maxBytes = Channels[next].bytes;
+		}
+	}
+	ScanSize = (offset + maxBytes - 1) / maxBytes * maxBytes;
+
+	//Watermark Is Missing On Older Kernels, The Default Of One Scan Still Works
+	if(writeAttribute("buffer/length", IIO_KERNEL_BUFFER_SCANS) != L_OK)
+	{
+		Stop();
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	writeAttribute("buffer/watermark", IIO_WATERMARK_SCANS);
+
+	Handle = open(DevPath.c_str(), O_RDONLY | O_NONBLOCK);
+	if(Handle < 0 || pipe(WakePipe) < 0)
+	{
+		Stop();
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+
+	//Timed Waits Use The Monotonic Clock So Wall Clock Changes Do Not Stretch Timeouts
+	pthread_condattr_t condAttr;
+	pthread_condattr_init(&condAttr);
+	pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+	pthread_cond_init(&DataReady, &condAttr);
+	pthread_condattr_destroy(&condAttr);
+	pthread_mutex_init(&Lock, NULL);
+
+	//Stop() Frees Any Rings Already Allocated
+	RingSize = bufferSize;
+	for(int i=0; i<numChans; i++)
+	{
+		Rings[i] = new (nothrow) unsigned long[RingSize];
+		if(Rings[i] == NULL)
+		{
+			Stop();
+			return LANALOG_STREAM_OPEN_FAIL;
+		}
+	}
+	Head = 0;
+	Count = 0;
+	Overrun = false;
+
+	if(writeAttribute("buffer/enable", 1) != L_OK)
+	{
+		Stop();
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+
+	Running = true;
+	if(pthread_create(&Thread, NULL, rxThread, this) != 0)
+	{
+		Running = false;
+		Stop();
+		return LANALOG_STREAM_OPEN_FAIL;
+	}
+	Started = true;
+
+	return L_OK;
+}
+
+void LinxIioBuffer::Stop()
+{
+	//The Thread May Already Have Exited On Its Own, It Still Needs Joining
+	if(Started)
+	{
+		unsigned char wake = 0;
+		if(write(WakePipe[1], &wake, 1) == 1)
+		{
+			pthread_join(Thread, NULL);
+		}
+		Started = false;
+		Running = false;
+	}
+
+	if(NumChannels > 0)
+	{
+		writeAttribute("buffer/enable", 0);
+		for(int i=0; i<NumChannels; i++)
+		{
+			char enName[48];
+			sprintf(enName, "scan_elements/in_voltage%d_en", Channels[i].channel);
+			writeAttribute(enName, 0);
+		}
+	}
+
+	if(Handle >= 0)
+	{
+		close(Handle);
+		Handle = -1;
+	}
+
+	if(WakePipe[0] >= 0)
+	{
+		close(WakePipe[0]);
+		close(WakePipe[1]);
+		WakePipe[0] = -1;
+		WakePipe[1] = -1;
+		pthread_cond_destroy(&DataReady);
+		pthread_mutex_destroy(&Lock);
+	}
+
+	freeRings();
+	NumChannels = 0;
+	ScanSize = 0;
+}
+
+bool LinxIioBuffer::IsRunning()
+{
+	return Started;
+}
+
+unsigned char LinxIioBuffer::NumChans()
+{
+	return NumChannels;
+}
+
+unsigned long LinxIioBuffer::Available()
+{
+	if(!Started)
+	{
+		return 0;
+	}
+
+	pthread_mutex_lock(&Lock);
+	unsigned long available = Count;
+	pthread_mutex_unlock(&Lock);
+
+	return available;
+}
+
+//Wait Up To timeout mS For numScans, Then Return Whatever Is Buffered Up To numScans
+//Channel c Of Scan s Lands In values[c * scansRead + s]
+unsigned long LinxIioBuffer::Read(unsigned long numScans, unsigned long timeout, unsigned long* values, bool* overrun)
+{
+	if(!Started)
+	{
+		return 0;
+	}
+
+	pthread_mutex_lock(&Lock);
+
+	if(Count < numScans && timeout > 0)
+	{
+		struct timespec deadline;
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += timeout / 1000;
+		deadline.tv_nsec += (timeout % 1000) * 1000000;
+		if(deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000;
+		}
+
+		while(Count < numScans && Running)
+		{
+			if(pthread_cond_timedwait(&DataReady, &Lock, &deadline) == ETIMEDOUT)
+			{
+				break;
+			}
+		}
+	}
+
+	unsigned long numRead = (Count < numScans) ? Count : numScans;
+
+	//Copy Each Channel Out Of Its Ring, Wrapping At Most Once
+	unsigned long firstPart = RingSize - Head;
+	if(firstPart > numRead)
+	{
+		firstPart = numRead;
+	}
+	for(int i=0; i<NumChannels; i++)
+	{
+		unsigned long* out = values + i * numRead;
+		memcpy(out, Rings[i] + Head, firstPart * sizeof(unsigned long));
+		memcpy(out + firstPart, Rings[i], (numRead - firstPart) * sizeof(unsigned long));
+	}
+
+	Head = (Head + numRead) % RingSize;
+	Count -= numRead;
+
+	if(overrun != NULL)
+	{
+		*overrun = Overrun;
+	}
+	Overrun = false;
+
+	pthread_mutex_unlock(&Lock);
+
+	return numRead;
+}
+
+void* LinxIioBuffer::rxThread(void* arg)
+{
+	((LinxIioBuffer*)arg)->run();
+	return NULL;
+}
+
+void LinxIioBuffer::run()
+{
+	unsigned char chunk[IIO_CHUNK_SIZE];
+	unsigned int carry = 0;								//Bytes Of A Partial Scan Left From The Last read()
+	struct pollfd fds[2];
+	fds[0].fd = Handle;
+	fds[0].events = POLLIN;
+	fds[1].fd = WakePipe[0];
+	fds[1].events = POLLIN;
+
+	while(true)
+	{
+		if(poll(fds, 2, -1) < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+
+		//Stop Requested Or Device Gone
+		if(fds[1].revents != 0 || (fds[0].revents & (POLLERR | POLLNVAL)))
+		{
+			break;
+		}
+		if(!(fds[0].revents & POLLIN))
+		{
+			if(fds[0].revents & POLLHUP)
+			{
+				break;
+			}
+			continue;
+		}
+
+		int bytesRead = read(Handle, chunk + carry, IIO_CHUNK_SIZE - carry);
+		if(bytesRead <= 0)
+		{
+			if(bytesRead < 0 && (errno == EINTR || errno == EAGAIN))
+			{
+				continue;
+			}
+			break;
+		}
+
+		unsigned long total = carry + bytesRead;
+		unsigned long numScans = total / ScanSize;
+
+		pthread_mutex_lock(&Lock);
+		deinterleave(chunk, numScans);
+		pthread_cond_broadcast(&DataReady);
+		pthread_mutex_unlock(&Lock);
+
+		carry = total - numScans * ScanSize;
+		memmove(chunk, chunk + numScans * ScanSize, carry);
+	}
+
+	//Wake Any Reader Waiting On A Thread That Has Exited
+	pthread_mutex_lock(&Lock);
+	Running = false;
+	pthread_cond_broadcast(&DataReady);
+	pthread_mutex_unlock(&Lock);
+}
+
+//Split Packed Scans Into The Channel Rings, Caller Holds Lock
+void LinxIioBuffer::deinterleave(const unsigned char* scans, unsigned long numScans)
+{
+	//Ring Full - Keep What Fits And Flag The Rest As Lost
+	if(numScans > RingSize - Count)
+	{
+		numScans = RingSize - Count;
+		Overrun = true;
+	}
+
+	unsigned long tail = (Head + Count) % RingSize;
+	for(unsigned long s=0; s<numScans; s++)
+	{
+		const unsigned char* scan = scans + s * ScanSize;
+		for(int i=0; i<NumChannels; i++)
+		{
+			Rings[i][tail] = sample(&Channels[i], scan);
+		}
+		tail = (tail + 1 == RingSize) ? 0 : tail + 1;
+	}
+	Count += numScans;
+}
+
+unsigned long LinxIioBuffer::sample(const IioChannel* channel, const unsigned char* scan)
+{
+	const unsigned char* data = scan + channel->offset;
+	unsigned long raw = 0;
+	for(unsigned int i=0; i<channel->bytes; i++)
+	{
+		unsigned int byte = channel->bigEndian ? i : (channel->bytes - 1 - i);
+		raw = (raw << 8) | data[byte];
+	}
+
+	raw >>= channel->shift;
+	if(channel->realBits < 32)
+	{
+		raw &= (1UL << channel->realBits) - 1;
+		if(channel->isSigned && (raw & (1UL << (channel->realBits - 1))))
+		{
+			raw |= ~((1UL << channel->realBits) - 1);
+		}
+	}
+
+	return raw;
+}
+
+int LinxIioBuffer::writeAttribute(const char* name, unsigned long value)
+{
+	string path = SysfsPath + "/" + name;
+	FILE* handle = fopen(path.c_str(), "w");
+	if(handle == NULL)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	int printed = fprintf(handle, "%lu", value);
+	if(fclose(handle) != 0 || printed < 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	return L_OK;
+}
+
+int LinxIioBuffer::readAttribute(const char* name, char* value, int length)
+{
+	string path = SysfsPath + "/" + name;
+	FILE* handle = fopen(path.c_str(), "r");
+	if(handle == NULL)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	char* line = fgets(value, length, handle);
+	fclose(handle);
+	if(line == NULL)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	value[strcspn(value, "\n")] = '\0';
+	return L_OK;
+}
+
+//Channels Left Enabled By Another Process Would Change The Scan Layout
+void LinxIioBuffer::disableScanElements()
+{
+	string path = SysfsPath + "/scan_elements";
+	DIR* dir = opendir(path.c_str());
+	if(dir == NULL)
+	{
+		return;
+	}
+
+	struct dirent* entry;
+	while((entry = readdir(dir)) != NULL)
+	{
+		size_t length = strlen(entry->d_name);
+		if(length > 3 && strcmp(entry->d_name + length - 3, "_en") == 0)
+		{
+			string name = string("scan_elements/") + entry->d_name;
+			writeAttribute(name.c_str(), 0);
+		}
+	}
+	closedir(dir);
+}
+
+//Type Looks Like "le:u12/16>>0" - Endianness, Sign, Real Bits, Storage Bits, Shift
+int LinxIioBuffer::parseChannel(unsigned char channel, IioChannel* parsed, int* index)
+{
+	char name[48];
+	char value[32];
+
+	sprintf(name, "scan_elements/in_voltage%d_index", channel);
+	if(readAttribute(name, value, sizeof(value)) != L_OK || sscanf(value, "%d", index) != 1)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	sprintf(name, "scan_elements/in_voltage%d_type", channel);
+	char endian = 0;
+	char sign = 0;
+	unsigned int storageBits = 0;
+	parsed->realBits = 0;
+	parsed->shift = 0;
+	if(readAttribute(name, value, sizeof(value)) != L_OK || sscanf(value, "%ce:%c%u/%u>>%u", &endian, &sign, &parsed->realBits, &storageBits, &parsed->shift) < 4)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	if((storageBits != 8 && storageBits != 16 && storageBits != 32) || parsed->realBits == 0 || parsed->realBits > storageBits)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	parsed->channel = channel;
+	parsed->offset = 0xFFFFFFFF;						//Placed Once All Indices Are Known
+	parsed->bytes = storageBits / 8;
+	parsed->bigEndian = (endian == 'b');
+	parsed->isSigned = (sign == 's');
+	return L_OK;
+}
+
+void LinxIioBuffer::freeRings()
+{
+	for(int i=0; i<IIO_MAX_CHANS; i++)
+	{
+		delete[] Rings[i];
+		Rings[i] = NULL;
+	}
+	RingSize = 0;
+	Count = 0;
+}
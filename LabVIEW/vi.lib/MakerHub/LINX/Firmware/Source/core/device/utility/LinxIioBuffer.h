@@ -0,0 +1,110 @@
+/****************************************************************************************
+**  LINX header for Linux IIO buffered acquisition.
+**
+**  Enables the scan elements and kernel buffer of an IIO device, drains packed scans
+**  from its character device in a background thread and deinterleaves them into one
+**  ring buffer per channel, so the ADC runs at its full rate instead of one sysfs read
+**  per sample.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_IIOBUFFER_H
+#define LINX_IIOBUFFER_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define IIO_DEFAULT_BUFFER_SCANS 65536				//Ring Buffer Size Used When 0 Is Requested (Scans)
+#define IIO_MAX_BUFFER_SCANS 262144					//Largest Ring Buffer A Host May Request (Scans)
+#define IIO_KERNEL_BUFFER_SCANS 4096					//Kernel Buffer Length (Scans)
+#define IIO_WATERMARK_SCANS 64							//Scans The Kernel Collects Before Waking The Thread
+#define IIO_CHUNK_SIZE 8192								//Max Bytes Taken From The Device Per read()
+#define IIO_MAX_CHANS 16
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <pthread.h>
+#include <string>
+
+using namespace std;
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+class LinxIioBuffer
+{
+	public:
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxIioBuffer(const char* sysfsPath, const char* devPath);		//ie "/sys/bus/iio/devices/iio:device0", "/dev/iio:device0"
+		~LinxIioBuffer();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		int Start(unsigned char numChans, const unsigned char* channels, unsigned long bufferSize);		//Channels Are in_voltageN Numbers
+		void Stop();
+		bool IsRunning();
+		unsigned char NumChans();
+		unsigned long Available();																						//Complete Scans Buffered
+		unsigned long Read(unsigned long numScans, unsigned long timeout, unsigned long* values, bool* overrun);		//Values Channel Major In Start() Order
+
+	private:
+		/****************************************************************************************
+		**  Types
+		****************************************************************************************/
+		typedef struct IioChannel
+		{
+			unsigned char channel;							//in_voltageN
+			unsigned int offset;								//Byte Offset In The Scan
+			unsigned int bytes;								//Storage Size (Bytes)
+			unsigned int realBits;
+			unsigned int shift;
+			bool bigEndian;
+			bool isSigned;
+		}IioChannel;
+
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		string SysfsPath;
+		string DevPath;
+		int Handle;												//Character Device Handle
+		int WakePipe[2];										//Written To Stop The Thread
+		bool Started;											//Thread Created And Not Yet Joined
+		bool Running;											//Thread Still Draining The Device
+		pthread_t Thread;
+		pthread_mutex_t Lock;
+		pthread_cond_t DataReady;
+
+		unsigned char NumChannels;
+		IioChannel Channels[IIO_MAX_CHANS];				//In Start() Order
+		unsigned int ScanSize;								//Bytes Per Scan
+
+		unsigned long* Rings[IIO_MAX_CHANS];				//One Ring Per Channel, All Share Head And Count
+		unsigned long RingSize;								//Scans
+		unsigned long Head;									//Index Of The Oldest Scan
+		unsigned long Count;									//Scans In The Rings
+		bool Overrun;											//Scans Were Dropped Since The Last Read
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		static void* rxThread(void* arg);
+		void run();
+		void deinterleave(const unsigned char* scans, unsigned long numScans);
+		unsigned long sample(const IioChannel* channel, const unsigned char* scan);
+		int writeAttribute(const char* name, unsigned long value);
+		int readAttribute(const char* name, char* value, int length);
+		void disableScanElements();
+		int parseChannel(unsigned char channel, IioChannel* parsed, int* index);
+		void freeRings();
+};
+
+#endif //LINX_IIOBUFFER_H
@@ -0,0 +1,451 @@
+/****************************************************************************************
+**  LINX deferred, leveled logging.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "LinxDevice.h"
+#include "LinxLog.h"
+
+#if defined(__linux__)
+	#include <pthread.h>
+	#include <stdlib.h>
+	#include <time.h>
+#endif
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+//Any Number Of Writers On Linux, So The Ring Indexes Are Atomic There.  MCUs Only Log From The Main Loop.
+#if defined(__linux__)
+	#define LOG_LOAD(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+	#define LOG_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+	#define LOG_CLAIM(x, expected, desired) __atomic_compare_exchange_n(&(x), &(expected), (desired), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+	#define LOG_COUNT(x) __atomic_add_fetch(&(x), 1, __ATOMIC_RELAXED)
+	typedef long long LogInt;									//avr-libc printf Has No %ll
+	typedef unsigned long long LogUnsigned;
+	#define LOG_INT_LENGTH "ll"
+#else
+	#define LOG_LOAD(x) (x)
+	#define LOG_STORE(x, v) ((x) = (v))
+	#define LOG_CLAIM(x, expected, desired) ((x) = (desired), true)
+	#define LOG_COUNT(x) (++(x))
+	typedef long LogInt;
+	typedef unsigned long LogUnsigned;
+	#define LOG_INT_LENGTH "l"
+#endif
+
+/****************************************************************************************
+**  Typedefs
+****************************************************************************************/
+typedef enum LogArgKind
+{
+	LOG_ARG_NONE = 0,
+	LOG_ARG_INT,
+	LOG_ARG_UNSIGNED,
+	LOG_ARG_DOUBLE,
+	LOG_ARG_STRING,
+	LOG_ARG_POINTER
+}LogArgKind;
+
+typedef union LogArg
+{
+	LogInt i;
+	LogUnsigned u;
+	double f;
+	unsigned int text;											//Offset Into The Record's Text
+	const void* p;
+}LogArg;
+
+typedef struct LogRecord
+{
+	uint32_t ready;												//Ring Index + 1 Once Filled
+	signed char level;
+	unsigned char numArgs;
+	const char* format;
+	unsigned long long time;									//uS
+	LogArg args[LOG_MAX_ARGS];
+	char text[LOG_TEXT_SIZE];
+}LogRecord;
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+LinxLog LinxLogger;
+
+//Outside The Class So Its Layout Does Not Depend On LINX_LOG_LEVEL, And No RAM Is Spent When Logging Is Compiled Out
+#if LINX_LOG_LEVEL >= 0
+	static LogRecord Records[LOG_NUM_RECORDS];
+#else
+	static LogRecord Records[1];
+#endif
+static uint32_t WriteIndex = 0;
+static uint32_t ReadIndex = 0;
+
+#if defined(__linux__)
+	static pthread_mutex_t ReadLock = PTHREAD_MUTEX_INITIALIZER;
+	static bool FormatterRunning = false;
+#endif
+
+/****************************************************************************************
+**  Helpers
+****************************************************************************************/
+//p Points Just Past The '%'.  Returns A Pointer To The Conversion Character, longs Is The Number Of l Modifiers.
+static const char* parseConversion(const char* p, LogArgKind* kind, int* longs)
+{
+	*longs = 0;
+	while(*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+	{
+		p++;
+	}
+	while((*p >= '0' && *p <= '9') || *p == '.')
+	{
+		p++;
+	}
+	while(*p == 'l' || *p == 'h')
+	{
+		if(*p == 'l')
+		{
+			(*longs)++;
+		}
+		p++;
+	}
+
+	switch(*p)
+	{
+		case 'd': case 'i': case 'c':
+			*kind = LOG_ARG_INT;
+			break;
+		case 'u': case 'x': case 'X': case 'o':
+			*kind = LOG_ARG_UNSIGNED;
+			break;
+		case 'f': case 'e': case 'g': case 'E': case 'G':
+			*kind = LOG_ARG_DOUBLE;
+			break;
+		case 's':
+			*kind = LOG_ARG_STRING;
+			break;
+		case 'p':
+			*kind = LOG_ARG_POINTER;
+			break;
+		default:
+			*kind = LOG_ARG_NONE;
+			break;
+	}
+	return p;
+}
+
+//Walk The Format Again, This Time Printing Each Captured Argument With Its Own Conversion
+static void formatRecord(const LogRecord* record, char* line, int size)
+{
+	static const char levelNames[] = "EWID";
+	unsigned long ms = (unsigned long)(record->time / 1000);
+	int n = snprintf(line, size, "[%c %lu.%03lu] ", levelNames[record->level & 3], ms / 1000, ms % 1000);
+
+	const char* p = record->format;
+	int arg = 0;
+	while(*p != '\0' && n < size - 1)
+	{
+		if(*p != '%')
+		{
+			line[n++] = *p++;
+			continue;
+		}
+		if(p[1] == '%')
+		{
+			line[n++] = '%';
+			p += 2;
+			continue;
+		}
+
+		//Copy Flags, Width And Precision, Then Swap The Length For The One The Argument Was Stored With
+		LogArgKind kind;
+		int longs;
+		const char* conversion = parseConversion(p + 1, &kind, &longs);
+		char spec[16];
+		int specLength = 0;
+		for(const char* s=p; s<conversion && specLength<(int)sizeof(spec) - 4; s++)
+		{
+			if(*s != 'l' && *s != 'h')
+			{
+				spec[specLength++] = *s;
+			}
+		}
+		if(kind == LOG_ARG_INT || kind == LOG_ARG_UNSIGNED)
+		{
+			if(*conversion != 'c')
+			{
+				for(const char* s=LOG_INT_LENGTH; *s!='\0'; s++)
+				{
+					spec[specLength++] = *s;
+				}
+			}
+		}
+		spec[specLength++] = *conversion;
+		spec[specLength] = '\0';
+		p = (*conversion != '\0') ? conversion + 1 : conversion;
+
+		int room = size - n;
+		if(kind == LOG_ARG_NONE || arg >= record->numArgs)
+		{
+			n += snprintf(line + n, room, "?");
+		}
+		else
+		{
+			const LogArg* value = &record->args[arg++];
+			switch(kind)
+			{
+				case LOG_ARG_INT:
+					n += (*conversion == 'c') ? snprintf(line + n, room, spec, (int)value->i) : snprintf(line + n, room, spec, value->i);
+					break;
+				case LOG_ARG_UNSIGNED:
+					n += snprintf(line + n, room, spec, value->u);
+					break;
+				case LOG_ARG_DOUBLE:
+					n += snprintf(line + n, room, spec, value->f);
+					break;
+				case LOG_ARG_STRING:
+					n += snprintf(line + n, room, spec, record->text + value->text);
+					break;
+				default:
+					n += snprintf(line + n, room, spec, value->p);
+					break;
+			}
+		}
+		if(n > size - 1)
+		{
+			n = size - 1;
+		}
+	}
+	line[n] = '\0';
+}
+
+#if defined(__linux__)
+	static void* formatterThread(void* arg)
+	{
+		struct timespec idle = {0, LOG_POLL_MS * 1000000L};
+		while(true)
+		{
+			if(LinxLogger.Poll(LOG_NUM_RECORDS) == 0)
+			{
+				nanosleep(&idle, NULL);
+			}
+		}
+		return NULL;
+	}
+
+	static void flushAtExit()
+	{
+		LinxLogger.Flush();
+	}
+#endif
+
+/****************************************************************************************
+**  Constructors
+****************************************************************************************/
+LinxLog::LinxLog()
+{
+	Level = LINX_LOG_LEVEL;
+	Dropped = 0;
+	DroppedReported = 0;
+	Device = NULL;
+	Sink = NULL;
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+//Claim A Slot, Copy The Arguments, Publish.  Never Blocks And Never Formats.
+void LinxLog::Write(int level, const char* format, ...)
+{
+	if(level > Level || level < 0 || LINX_LOG_LEVEL < 0)
+	{
+		return;
+	}
+
+	uint32_t index;
+	do
+	{
+		index = LOG_LOAD(WriteIndex);
+		if(index - LOG_LOAD(ReadIndex) >= LOG_NUM_RECORDS)
+		{
+			LOG_COUNT(Dropped);
+			return;
+		}
+	} while(!LOG_CLAIM(WriteIndex, index, index + 1));
+
+	LogRecord* record = &Records[index & (LOG_NUM_RECORDS - 1)];
+	record->level = level;
+	record->format = format;
+	record->time = (Device != NULL) ? Device->GetMicroSeconds() : 0;
+
+	va_list args;
+	va_start(args, format);
+	unsigned int numArgs = 0;
+	unsigned int textUsed = 0;
+	for(const char* p=format; *p!='\0' && numArgs<LOG_MAX_ARGS; p++)
+	{
+		if(*p != '%')
+		{
+			continue;
+		}
+		if(p[1] == '%')
+		{
+			p++;
+			continue;
+		}
+
+		LogArgKind kind;
+		int longs;
+		p = parseConversion(p + 1, &kind, &longs);
+		if(*p == '\0')
+		{
+			break;
+		}
+		LogArg* value = &record->args[numArgs];
+		switch(kind)
+		{
+			case LOG_ARG_INT:
+				value->i = (longs >= 2) ? (LogInt)va_arg(args, long long) : (longs == 1) ? (LogInt)va_arg(args, long) : (LogInt)va_arg(args, int);
+				break;
+			case LOG_ARG_UNSIGNED:
+				value->u = (longs >= 2) ? (LogUnsigned)va_arg(args, unsigned long long) : (longs == 1) ? (LogUnsigned)va_arg(args, unsigned long) : (LogUnsigned)va_arg(args, unsigned int);
+				break;
+			case LOG_ARG_DOUBLE:
+				value->f = va_arg(args, double);
+				break;
+			case LOG_ARG_STRING:
+			{
+				//Truncated To What Is Left Of The Text Area
+				const char* s = va_arg(args, const char*);
+				if(s == NULL)
+				{
+					s = "(null)";
+				}
+				value->text = textUsed;
+				while(*s != '\0' && textUsed < LOG_TEXT_SIZE - 1)
+				{
+					record->text[textUsed++] = *s++;
+				}
+				record->text[textUsed] = '\0';
+				if(textUsed < LOG_TEXT_SIZE - 1)
+				{
+					textUsed++;
+				}
+				break;
+			}
+			case LOG_ARG_POINTER:
+				value->p = va_arg(args, const void*);
+				break;
+			default:
+				continue;
+		}
+		numArgs++;
+	}
+	va_end(args);
+	record->numArgs = numArgs;
+
+	LOG_STORE(record->ready, index + 1);
+}
+
+void LinxLog::Attach(LinxDevice* device)
+{
+	Device = device;
+	startFormatter();
+}
+
+void LinxLog::SetSink(LinxLogSink sink)
+{
+	Sink = sink;
+	startFormatter();
+}
+
+//Messages Come Out In The Order Their Slots Were Claimed, A Writer Still Filling One Holds Back Those After It
+int LinxLog::Poll(int maxMessages)
+{
+	#if defined(__linux__)
+		pthread_mutex_lock(&ReadLock);
+	#endif
+
+	int numMessages = 0;
+	char line[LOG_LINE_SIZE];
+	while(numMessages < maxMessages)
+	{
+		uint32_t index = ReadIndex;
+		LogRecord* record = &Records[index & (LOG_NUM_RECORDS - 1)];
+		if(LOG_LOAD(record->ready) != index + 1)
+		{
+			break;
+		}
+		int level = record->level;
+		formatRecord(record, line, sizeof(line));
+		LOG_STORE(ReadIndex, index + 1);
+		output(level, line);
+		numMessages++;
+	}
+
+	unsigned long dropped = LOG_LOAD(Dropped);
+	if(dropped != DroppedReported)
+	{
+		snprintf(line, sizeof(line), "[W] %lu Log Message(s) Dropped", dropped - DroppedReported);
+		DroppedReported = dropped;
+		output(LOG_LEVEL_WARN, line);
+	}
+
+	#if defined(__linux__)
+		pthread_mutex_unlock(&ReadLock);
+	#endif
+	return numMessages;
+}
+
+void LinxLog::Flush()
+{
+	while(Poll(LOG_NUM_RECORDS) > 0)
+	{
+	}
+}
+
+/****************************************************************************************
+**  Private Functions
+****************************************************************************************/
+void LinxLog::output(int level, const char* line)
+{
+	if(Sink != NULL)
+	{
+		Sink(level, line);
+	}
+	else if(Device != NULL)
+	{
+		Device->DebugPrintln(line);
+	}
+}
+
+//Linux Formats On Its Own Thread, MCUs Wait For The Listener To Call Poll()
+void LinxLog::startFormatter()
+{
+	#if defined(__linux__)
+		pthread_mutex_lock(&ReadLock);
+		if(!FormatterRunning && LINX_LOG_LEVEL >= 0)
+		{
+			pthread_t thread;
+			if(pthread_create(&thread, NULL, formatterThread, NULL) == 0)
+			{
+				pthread_detach(thread);
+				atexit(flushAtExit);
+				FormatterRunning = true;
+			}
+		}
+		pthread_mutex_unlock(&ReadLock);
+	#endif
+}
@@ -0,0 +1,154 @@
+/****************************************************************************************
+**  LINX Linux file backed non-volatile storage.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "LinxDevice.h"
+#include "LinxNvs.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+/****************************************************************************************
+**  Constructors /  Destructor
+****************************************************************************************/
+LinxNvs::LinxNvs(const char* path, unsigned int size)
+{
+	Path = path;
+	Size = size;
+	Handle = -1;
+	Image = NULL;
+	DirtyStart = size;
+	DirtyEnd = 0;
+}
+
+LinxNvs::~LinxNvs()
+{
+	if(Image != NULL)
+	{
+		Commit();
+		munmap(Image, Size);
+	}
+	if(Handle >= 0)
+	{
+		close(Handle);
+	}
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+int LinxNvs::Read(unsigned int address, unsigned int numBytes, unsigned char* data)
+{
+	if(address + numBytes > Size || mapFile() != L_OK)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	for(unsigned int i=0; i<numBytes; i++)
+	{
+		data[i] = Image[address + i];
+	}
+	return L_OK;
+}
+
+int LinxNvs::Write(unsigned int address, unsigned int numBytes, const unsigned char* data)
+{
+	if(address + numBytes > Size || mapFile() != L_OK)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	for(unsigned int i=address; i<address + numBytes; i++)
+	{
+		if(Image[i] == data[i - address])
+		{
+			continue;
+		}
+		Image[i] = data[i - address];
+		if(i < DirtyStart)
+		{
+			DirtyStart = i;
+		}
+		if(i + 1 > DirtyEnd)
+		{
+			DirtyEnd = i + 1;
+		}
+	}
+	return L_OK;
+}
+
+//Flush The Pages Holding The Dirty Range.  The Default Image Is Smaller Than A Page, So This Is One Page Write.
+int LinxNvs::Commit()
+{
+	if(!IsDirty())
+	{
+		return L_OK;
+	}
+
+	unsigned long pageSize = sysconf(_SC_PAGESIZE);
+	unsigned int start = DirtyStart - (DirtyStart % pageSize);
+	int status = msync(Image + start, DirtyEnd - start, MS_SYNC);
+
+	DirtyStart = Size;
+	DirtyEnd = 0;
+	return (status == 0) ? L_OK : L_UNKNOWN_ERROR;
+}
+
+bool LinxNvs::IsDirty()
+{
+	return DirtyStart < DirtyEnd;
+}
+
+/****************************************************************************************
+**  Private Functions
+****************************************************************************************/
+//Map The Storage File On First Use, Creating It (Zero Filled) If It Does Not Exist
+int LinxNvs::mapFile()
+{
+	if(Image != NULL)
+	{
+		return L_OK;
+	}
+
+	size_t slash = Path.rfind('/');
+	if(slash != string::npos && slash > 0)
+	{
+		mkdir(Path.substr(0, slash).c_str(), 0755);
+	}
+
+	Handle = open(Path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if(Handle < 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	struct stat info;
+	if(fstat(Handle, &info) != 0 || ((unsigned long)info.st_size < Size && ftruncate(Handle, Size) != 0))
+	{
+		close(Handle);
+		Handle = -1;
+		return L_UNKNOWN_ERROR;
+	}
+
+	void* image = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Handle, 0);
+	if(image == MAP_FAILED)
+	{
+		close(Handle);
+		Handle = -1;
+		return L_UNKNOWN_ERROR;
+	}
+	Image = (unsigned char*)image;
+	return L_OK;
+}
@@ -0,0 +1,66 @@
+/****************************************************************************************
+**  LINX header for file backed non-volatile storage on Linux.
+**
+**  The storage file is mapped shared, so writes land in the page cache immediately and
+**  survive a restart of the listener.  Commit() msyncs only the pages written since the
+**  last commit, making them durable across power loss.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_NVS_H
+#define LINX_NVS_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define LINX_NVS_PATH "/var/lib/linx/nvs.bin"		//Default Storage File, Parent Directory Is Created If Needed
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <string>
+
+using namespace std;
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+class LinxNvs
+{
+	public:
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxNvs(const char* path, unsigned int size);
+		~LinxNvs();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		int Read(unsigned int address, unsigned int numBytes, unsigned char* data);
+		int Write(unsigned int address, unsigned int numBytes, const unsigned char* data);		//Unchanged Bytes Do Not Dirty The Image
+		int Commit();
+		bool IsDirty();
+
+	private:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		string Path;
+		unsigned int Size;
+		int Handle;
+		unsigned char* Image;								//Shared Mapping Of The Storage File
+		unsigned int DirtyStart;							//Bytes Written Since The Last Commit, Empty When DirtyStart >= DirtyEnd
+		unsigned int DirtyEnd;
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		int mapFile();
+};
+
+#endif //LINX_NVS_H
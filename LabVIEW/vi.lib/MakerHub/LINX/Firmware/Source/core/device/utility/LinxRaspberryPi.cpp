@@ -18,17 +18,22 @@
 ****************************************************************************************/	
 #include "LinxDevice.h"
 #include "LinxRaspberryPi.h"
+#include "LinxBitPack.h"
+#include "LinxLog.h"
 
-#include <map>
+#include <vector>
 #include <fcntl.h>
 #include <time.h>
 #include <math.h>
 #include <iostream>
 #include <unistd.h>
 #include <fstream>
+#include <string.h>
 #include <sys/stat.h>
-#include <termios.h>	
+#include <poll.h>
 #include <sys/ioctl.h>
+#include <asm/termbits.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 #include <linux/spi/spidev.h>
 
@@ -50,14 +55,45 @@ LinxRaspberryPi::LinxRaspberryPi()
 	LinxApiMinor = 0;
 	LinxApiSubminor = 0;
 	
-	// TODO Load User Config Data From Non Volatile Storage
-	//userId = NonVolatileRead(NVS_USERID) << 8 | NonVolatileRead(NVS_USERID + 1);
+	NumStartupPhases = 0;
+	StartupMark = GetMicroSeconds();
 	
+	GpioChipPath = "/dev/gpiochip0";
+	GpioChipBase = 0;
+	SoftPwm = NULL;
+	
+	//Channel State Is Flat Per Slot, Boards Bind Their Channel Lists Before Filling It In
+	PwmPeriodHandles.Fill(-1);
+	PwmDutyCycleHandles.Fill(-1);
+	SpiModes.Fill(0xFF);
+	I2cSlaveAddrs.Fill(0xFF);
+	
+	//Load User Config Data From Non Volatile Storage
+	Nvs = new LinxNvs(LINX_NVS_PATH, NVS_SIZE);
+	unsigned char config[4];
+	if(NonVolatileReadBlock(NVS_USERID, 2, config) == L_OK)
+	{
+		userId = config[0] << 8 | config[1];
+	}
+	if(NonVolatileReadBlock(NVS_ETHERNET_IP, 4, config) == L_OK)
+	{
+		ethernetIp = (unsigned long)config[0] << 24 | (unsigned long)config[1] << 16 | (unsigned long)config[2] << 8 | config[3];
+	}
+	if(NonVolatileReadBlock(NVS_ETHERNET_PORT, 2, config) == L_OK)
+	{
+		ethernetPort = config[0] << 8 | config[1];
+	}
+	if(NonVolatileReadBlock(NVS_SERIAL_INTERFACE_MAX_BAUD, 4, config) == L_OK)
+	{
+		serialInterfaceMaxBaud = (unsigned long)config[0] << 24 | (unsigned long)config[1] << 16 | (unsigned long)config[2] << 8 | config[3];
+	}
+	startupPhase("Non-Volatile Storage");
 }
 
 LinxRaspberryPi::~LinxRaspberryPi()
 {
-		
+	delete SoftPwm;
+	delete Nvs;
 }
 
 /****************************************************************************************
@@ -67,22 +103,44 @@ int LinxRaspberryPi::digitalSmartOpen(unsigned char numChans, unsigned char* cha
 {
 	for(int i=0; i<numChans; i++)
 	{		
+		//Digital I/O Cancels Any Square Wave, PWM Or Servo Running On The Pin
+		if(SoftPwm != NULL && SoftPwm->HasChannel(channels[i]))
+		{
+			softPwmClose(channels[i]);
+		}
+		
 		//Open Direction Handle If It Is Not Already		
 		if(DigitalDirHandles[channels[i]] == NULL)
 		{
-			DebugPrint("Opening Digital Direction Handle For LINX DIO ");
-			DebugPrint(channels[i], DEC);
-			DebugPrint("(GPIO ");
-			DebugPrint(DigitalChannels[channels[i]], DEC);
-			DebugPrintln(")");
+			LINX_LOG_DEBUG("Opening Digital Direction Handle For LINX DIO %ld (GPIO %ld)", (long)channels[i], (long)DigitalChannels[channels[i]]);
+			
+			//Export The GPIO On First Use
+			char gpioPath[64];
+			sprintf(gpioPath, "/sys/class/gpio/gpio%d", DigitalChannels[channels[i]]);
+			if(!fileExists(gpioPath))
+			{
+				FILE* exportHandle = fopen("/sys/class/gpio/export", "w");
+				if(exportHandle == NULL)
+				{
+					LINX_LOG_ERROR("Digital Fail - Unable To Open GPIO Export");
+					return L_UNKNOWN_ERROR;
+				}
+				fprintf(exportHandle, "%d", DigitalChannels[channels[i]]);
+				fclose(exportHandle);
+			}
 			
+			//udev Sets Permissions On A New Export Shortly After It Appears
 			char dirPath[64];
 			sprintf(dirPath, "/sys/class/gpio/gpio%d/direction", DigitalChannels[channels[i]]);
-			DigitalDirHandles[channels[i]] = fopen(dirPath, "r+w+");
+			unsigned long startTime = GetMilliSeconds();
+			while((DigitalDirHandles[channels[i]] = fopen(dirPath, "r+w+")) == NULL && GetMilliSeconds() - startTime < GPIO_EXPORT_TIMEOUT)
+			{
+				usleep(1000);
+			}
 			
 			if(DigitalDirHandles[channels[i]] == NULL)
 			{
-				DebugPrintln("Digital Fail - Unable To Open Direction File Handles");
+				LINX_LOG_ERROR("Digital Fail - Unable To Open Direction File Handles");
 				return L_UNKNOWN_ERROR;
 			}
 		}
@@ -90,14 +148,14 @@ int LinxRaspberryPi::digitalSmartOpen(unsigned char numChans, unsigned char* cha
 		//Open Value Handle If It Is Not Already		
 		if(DigitalValueHandles[channels[i]] == NULL)
 		{
-			DebugPrintln("Opening Digital Value Handle");
+			LINX_LOG_DEBUG("Opening Digital Value Handle");
 			char valuePath[64];
 			sprintf(valuePath, "/sys/class/gpio/gpio%d/value", DigitalChannels[channels[i]]);
 			DigitalValueHandles[channels[i]] = fopen(valuePath, "r+w+");
 			
 			if(DigitalValueHandles[channels[i]] == NULL)
 			{
-				DebugPrintln("Digital Fail - Unable To Open Value File Handles");
+				LINX_LOG_ERROR("Digital Fail - Unable To Open Value File Handles");
 				return L_UNKNOWN_ERROR;
 			}
 		}
@@ -106,8 +164,282 @@ int LinxRaspberryPi::digitalSmartOpen(unsigned char numChans, unsigned char* cha
 }
 int LinxRaspberryPi::pwmSmartOpen(unsigned char numChans, unsigned char* channels)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
-}	
+	for(int i=0; i<numChans; i++)
+	{
+		//No Hardware PWM On This Pin - Digital Channels Fall Back To The Software Scheduler
+		if(!PwmChipChans.Contains(channels[i]))
+		{
+			if(!DigitalChannels.Contains(channels[i]))
+			{
+				LINX_LOG_ERROR("PWM Fail - Not A PWM Channel");
+				return L_FUNCTION_NOT_SUPPORTED;
+			}
+			if(PwmPeriods[channels[i]] == 0)
+			{
+				PwmFrequencies[channels[i]] = PwmDefaultFrequency;
+				PwmPeriods[channels[i]] = 1000000000UL / PwmDefaultFrequency;
+				PwmDutyCycles[channels[i]] = 0;
+			}
+			int status = softPwmOpen(channels[i], PwmPeriods[channels[i]]);
+			if(status != L_OK)
+			{
+				return status;
+			}
+			continue;
+		}
+		
+		//Already Open
+		if(PwmDutyCycleHandles[channels[i]] >= 0)
+		{
+			continue;
+		}
+		
+		char dirPath[128];
+		sprintf(dirPath, "%spwm%d/", PwmChipPath.c_str(), PwmChipChans[channels[i]]);
+		PwmDirPaths[channels[i]] = dirPath;
+		
+		//Export The Output If It Is Not Already
+		if(!fileExists(dirPath))
+		{
+			char exportPath[128];
+			sprintf(exportPath, "%sexport", PwmChipPath.c_str());
+			FILE* exportHandle = fopen(exportPath, "w");
+			if(exportHandle == NULL)
+			{
+				LINX_LOG_ERROR("PWM Fail - Unable To Open Export File");
+				return L_UNKNOWN_ERROR;
+			}
+			fprintf(exportHandle, "%d", PwmChipChans[channels[i]]);
+			fclose(exportHandle);
+			
+			if(!fileExists(dirPath, "duty_cycle", 1000))
+			{
+				LINX_LOG_ERROR("PWM Fail - Output Not Exported");
+				return L_UNKNOWN_ERROR;
+			}
+		}
+		
+		char filePath[160];
+		sprintf(filePath, "%speriod", dirPath);
+		int periodHandle = open(filePath, O_RDWR);
+		sprintf(filePath, "%sduty_cycle", dirPath);
+		int dutyCycleHandle = open(filePath, O_RDWR);
+		if(periodHandle < 0 || dutyCycleHandle < 0)
+		{
+			LINX_LOG_ERROR("PWM Fail - Unable To Open Period / Duty Cycle Handles");
+			if(periodHandle >= 0)
+			{
+				close(periodHandle);
+			}
+			if(dutyCycleHandle >= 0)
+			{
+				close(dutyCycleHandle);
+			}
+			return L_UNKNOWN_ERROR;
+		}
+		PwmPeriodHandles[channels[i]] = periodHandle;
+		PwmDutyCycleHandles[channels[i]] = dutyCycleHandle;
+		
+		//Start At The Default Frequency With The Output Low, Duty Cycle First So It Never Exceeds The Period
+		PwmFrequencies[channels[i]] = PwmDefaultFrequency;
+		PwmPeriods[channels[i]] = 1000000000UL / PwmDefaultFrequency;
+		PwmDutyCycles[channels[i]] = 0;
+		pwmWrite(dutyCycleHandle, 0);
+		pwmWrite(periodHandle, PwmPeriods[channels[i]]);
+		
+		sprintf(filePath, "%senable", dirPath);
+		int enableHandle = open(filePath, O_WRONLY);
+		if(enableHandle < 0 || pwmWrite(enableHandle, 1) != L_OK)
+		{
+			LINX_LOG_ERROR("PWM Fail - Unable To Enable Output");
+		}
+		if(enableHandle >= 0)
+		{
+			close(enableHandle);
+		}
+	}
+	return L_OK;
+}
+
+//Write A Value To An Open PWM Attribute In One Syscall
+int LinxRaspberryPi::pwmWrite(int handle, unsigned long value)
+{
+	char text[16];
+	int length = sprintf(text, "%lu\n", value);
+	
+	if(pwrite(handle, text, length, 0) != length)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	return L_OK;
+}
+
+//Hand A Digital Channel To The Software PWM Scheduler, Which Drives It Through The GPIO Character Device
+int LinxRaspberryPi::softPwmOpen(unsigned char channel, unsigned long period)
+{
+	if(!DigitalChannels.Contains(channel))
+	{
+		LINX_LOG_ERROR("Soft PWM Fail - Not A Digital Channel");
+		return L_FUNCTION_NOT_SUPPORTED;
+	}
+	
+	if(SoftPwm == NULL)
+	{
+		SoftPwm = new LinxSoftPwm(GpioChipPath.c_str());
+	}
+	if(SoftPwm->HasChannel(channel))
+	{
+		return L_OK;
+	}
+	
+	digitalRelease(channel);
+	if(SoftPwm->AddChannel(channel, DigitalChannels[channel] - GpioChipBase, period) != L_OK)
+	{
+		LINX_LOG_ERROR("Soft PWM Fail - Unable To Request GPIO Line");
+		return L_UNKNOWN_ERROR;
+	}
+	return L_OK;
+}
+
+//Take A Channel Off The Software PWM Scheduler And Give It Back For Digital I/O
+int LinxRaspberryPi::softPwmClose(unsigned char channel)
+{
+	if(SoftPwm == NULL || !SoftPwm->HasChannel(channel))
+	{
+		return L_OK;
+	}
+	
+	int status = SoftPwm->RemoveChannel(channel);
+	digitalRestore(channel);
+	
+	return status;
+}
+
+//Free A Digital Channel's Line So The GPIO Character Device Can Request It.  A Line Exported Through sysfs Is Busy.
+void LinxRaspberryPi::digitalRelease(unsigned char channel)
+{
+	if(DigitalDirHandles[channel] != NULL)
+	{
+		fclose(DigitalDirHandles[channel]);
+		DigitalDirHandles[channel] = NULL;
+	}
+	if(DigitalValueHandles[channel] != NULL)
+	{
+		fclose(DigitalValueHandles[channel]);
+		DigitalValueHandles[channel] = NULL;
+	}
+	FILE* unexportHandle = fopen("/sys/class/gpio/unexport", "w");
+	if(unexportHandle != NULL)
+	{
+		fprintf(unexportHandle, "%d", DigitalChannels[channel]);
+		fclose(unexportHandle);
+	}
+}
+
+//Give A Line Back For Digital I/O After digitalRelease()
+void LinxRaspberryPi::digitalRestore(unsigned char channel)
+{
+	FILE* exportHandle = fopen("/sys/class/gpio/export", "w");
+	if(exportHandle != NULL)
+	{
+		fprintf(exportHandle, "%d", DigitalChannels[channel]);
+		fclose(exportHandle);
+	}
+	DigitalDirs[channel] = 0xFF;		//Unknown, Set Again On Next Digital Use
+}
+
+//Write SPI Mode Bits To The Controller, Skipping The ioctl If They Are Already Set
+int LinxRaspberryPi::spiWriteMode(unsigned char channel, unsigned char mode)
+{
+	if(SpiModes[channel] == mode)
+	{
+		return L_OK;
+	}
+
+	if(spiIoctl(channel, SPI_IOC_WR_MODE, &mode) < 0)
+	{
+		LINX_LOG_ERROR("SPI Fail - Failed To Set SPI Mode - 0x%lX", (unsigned long)mode);
+		return L_UNKNOWN_ERROR;
+	}
+	SpiModes[channel] = mode;
+
+	return L_OK;
+}
+
+int LinxRaspberryPi::spiIoctl(unsigned char channel, unsigned long request, void* arg)
+{
+	return ioctl(SpiHandles[channel], request, arg);
+}
+
+void LinxRaspberryPi::bindDigitalSlots(const LinxChannelSlots* slots)
+{
+	bool bound = DigitalChannels.Bind(slots)
+		&& DigitalDirs.Bind(slots)
+		&& DigitalDirHandles.Bind(slots)
+		&& DigitalValueHandles.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("Digital Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxRaspberryPi::bindPwmSlots(const LinxChannelSlots* pwmSlots, const LinxChannelSlots* outputSlots)
+{
+	bool bound = PwmChipChans.Bind(pwmSlots)
+		&& PwmDirPaths.Bind(pwmSlots)
+		&& PwmDtoNames.Bind(pwmSlots)
+		&& PwmPeriodHandles.Bind(pwmSlots)
+		&& PwmDutyCycleHandles.Bind(pwmSlots)
+		&& PwmFrequencies.Bind(outputSlots)
+		&& PwmPeriods.Bind(outputSlots)
+		&& PwmDutyCycles.Bind(outputSlots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("PWM Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxRaspberryPi::bindUartSlots(const LinxChannelSlots* slots)
+{
+	bool bound = UartPaths.Bind(slots)
+		&& UartHandles.Bind(slots)
+		&& UartDtoNames.Bind(slots)
+		&& UartRxThreads.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("UART Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxRaspberryPi::bindSpiSlots(const LinxChannelSlots* slots)
+{
+	bool bound = SpiDtoNames.Bind(slots)
+		&& SpiPaths.Bind(slots)
+		&& SpiHandles.Bind(slots)
+		&& SpiBitOrders.Bind(slots)
+		&& SpiSetSpeeds.Bind(slots)
+		&& SpiModes.Bind(slots)
+		&& SpiLsbFirstHw.Bind(slots)
+		&& SpiHwCsChans.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("SPI Channels Do Not Fit The Slot Tables");
+	}
+}
+
+void LinxRaspberryPi::bindI2cSlots(const LinxChannelSlots* slots)
+{
+	bool bound = I2cPaths.Bind(slots)
+		&& I2cHandles.Bind(slots)
+		&& I2cDtoNames.Bind(slots)
+		&& I2cSlaveAddrs.Bind(slots)
+		&& I2cPendingMsgs.Bind(slots)
+		&& I2cPendingData.Bind(slots);
+	if(!bound)
+	{
+		LINX_LOG_ERROR("I2C Channels Do Not Fit The Slot Tables");
+	}
+}
 
 //Return True If File Specified By path Exists.
 bool LinxRaspberryPi::fileExists(const char* path)
@@ -135,15 +467,154 @@ bool LinxRaspberryPi::fileExists(const char* directory, const char* fileName, un
 	{
 		if(stat(fullPath, &buffer) == 0)
 		{
-			DebugPrint("DTO Took ");
-			DebugPrintln(GetMilliSeconds()-startTime < timeout, DEC);
+			LINX_LOG_DEBUG("DTO Took %ld", (long)(GetMilliSeconds()-startTime));
 			return true;
 		}
+		usleep(1000);
 	}
-	DebugPrintln("Timeout");
+	LINX_LOG_ERROR("Timeout");
 	return false;
 }
 
+//Charge The Time Since The Last Mark To A Construction Step
+void LinxRaspberryPi::startupPhase(const char* name)
+{
+	unsigned long long now = GetMicroSeconds();
+	if(NumStartupPhases < STARTUP_MAX_PHASES)
+	{
+		StartupPhaseNames[NumStartupPhases] = name;
+		StartupPhaseTimes[NumStartupPhases] = (unsigned long)(now - StartupMark);
+		NumStartupPhases++;
+	}
+	StartupMark = now;
+}
+
+//Writes That Do Not End With A Stop (EOF_RESTART, EOF_NOSTOP...) Are Held Back And Sent With The Next Transfer
+//As One I2C_RDWR Message Array, So The Slave Sees A Repeated Start Instead Of Stop / Start.
+//Plain Transfers Use read() / write() And Only Set I2C_SLAVE When The Slave Address Changes.
+int LinxRaspberryPi::i2cTransfer(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* buffer, bool isRead)
+{
+	vector<unsigned char>& pendingMsgs = I2cPendingMsgs[channel];		//(Address, Length, EOF) For Each Held Back Write
+	vector<unsigned char>& pendingData = I2cPendingData[channel];
+	
+	if(eofConfig > EOF_NOSTOP)
+	{
+		LINX_LOG_ERROR("I2C Fail - EOF Not Supported");
+		return LI2C_EOF;
+	}
+	
+	if(!isRead)
+	{
+		//No Start Condition After EOF_NOSTOP - Continue The Previous Write To The Same Slave
+		unsigned int numMsgs = pendingMsgs.size() / 3;
+		if(numMsgs > 0 && pendingMsgs[3*numMsgs-3] == slaveAddress && pendingMsgs[3*numMsgs-1] >= EOF_RESTART_NOSTOP && pendingMsgs[3*numMsgs-2] + numBytes <= 0xFF)
+		{
+			pendingMsgs[3*numMsgs-2] += numBytes;
+			pendingMsgs[3*numMsgs-1] = eofConfig;
+		}
+		else
+		{
+			if(numMsgs >= I2C_RDWR_IOCTL_MAX_MSGS - 1)
+			{
+				LINX_LOG_ERROR("I2C Fail - Too Many Messages Without A Stop");
+				pendingMsgs.clear();
+				pendingData.clear();
+				return LI2C_WRITE_FAIL;
+			}
+			pendingMsgs.push_back(slaveAddress);
+			pendingMsgs.push_back(numBytes);
+			pendingMsgs.push_back(eofConfig);
+		}
+		pendingData.insert(pendingData.end(), buffer, buffer + numBytes);
+		
+		if(eofConfig != EOF_STOP)
+		{
+			return L_OK;
+		}
+		
+		//Single Write - No Need For A Message Array
+		if(pendingMsgs.size() == 3)
+		{
+			pendingMsgs.clear();
+			pendingData.clear();
+			
+			if(I2cSlaveAddrs[channel] != slaveAddress)
+			{
+				if(ioctl(I2cHandles[channel], I2C_SLAVE, slaveAddress) < 0)
+				{
+					LINX_LOG_ERROR("I2C Fail - Failed To Set Slave Address");
+					I2cSlaveAddrs.Reset(channel);
+					return LI2C_SADDR;
+				}
+				I2cSlaveAddrs[channel] = slaveAddress;
+			}
+			
+			if(write(I2cHandles[channel], buffer, numBytes) != numBytes)
+			{
+				LINX_LOG_ERROR("I2C Fail - Failed To Write All Data");
+				return LI2C_WRITE_FAIL;
+			}
+			return L_OK;
+		}
+	}
+	else if(pendingMsgs.empty())
+	{
+		//Single Read.  Linux Always Ends An I2C Transfer With A Stop
+		if(I2cSlaveAddrs[channel] != slaveAddress)
+		{
+			if(ioctl(I2cHandles[channel], I2C_SLAVE, slaveAddress) < 0)
+			{
+				I2cSlaveAddrs.Reset(channel);
+				return LI2C_SADDR;
+			}
+			I2cSlaveAddrs[channel] = slaveAddress;
+		}
+		
+		if(read(I2cHandles[channel], buffer, numBytes) < numBytes)
+		{
+			return LI2C_READ_FAIL;
+		}
+		return L_OK;
+	}
+	
+	//Held Back Writes (Plus This Read) Go Out As One Combined Transaction
+	unsigned int numMsgs = pendingMsgs.size() / 3;
+	struct i2c_msg msgs[numMsgs + 1];
+	unsigned int dataOffset = 0;
+	for(unsigned int i=0; i<numMsgs; i++)
+	{
+		msgs[i].addr = pendingMsgs[3*i];
+		msgs[i].flags = 0;
+		msgs[i].len = pendingMsgs[3*i+1];
+		msgs[i].buf = &pendingData[0] + dataOffset;
+		dataOffset += msgs[i].len;
+	}
+	if(isRead)
+	{
+		msgs[numMsgs].addr = slaveAddress;
+		msgs[numMsgs].flags = I2C_M_RD;
+		msgs[numMsgs].len = numBytes;
+		msgs[numMsgs].buf = buffer;
+		numMsgs++;
+	}
+	
+	struct i2c_rdwr_ioctl_data transaction;
+	transaction.msgs = msgs;
+	transaction.nmsgs = numMsgs;
+	int retVal = ioctl(I2cHandles[channel], I2C_RDWR, &transaction);
+	
+	pendingMsgs.clear();
+	pendingData.clear();
+	
+	if(retVal < 0)
+	{
+		LINX_LOG_ERROR("I2C Fail - Combined Transfer Failed");
+		return isRead ? LI2C_READ_FAIL : LI2C_WRITE_FAIL;
+	}
+	
+	return L_OK;
+}
+
 /****************************************************************************************
 **  Public Functions
 ****************************************************************************************/
@@ -165,38 +636,24 @@ int LinxRaspberryPi::DigitalSetDirection(unsigned char numChans, unsigned char*
 {
 	if(digitalSmartOpen(numChans, channels) != L_OK)
 	{
-		DebugPrintln("Smart Open Failed");
+		LINX_LOG_ERROR("Smart Open Failed");
 		return L_UNKNOWN_ERROR;			
 	}
 	
+	unsigned char directions[numChans];
+	LinxBitPack::UnpackBits(numChans, values, directions);
+	
 	//Set Direction Only If Necessary
-	//Avoid Divide By Zero By Doing First Iteration
-	if( (values[0] & 0x01) == OUTPUT && DigitalDirs[channels[0]] != OUTPUT)
-	{
-		//Set As Output
-		fprintf(DigitalDirHandles[channels[0]], "out");		
-		fflush(DigitalDirHandles[channels[0]]);
-		DigitalDirs[channels[0]] = OUTPUT;		
-	}
-	else if((values[0] & 0x01) == INPUT && DigitalDirs[channels[0]] != INPUT)
-	{
-		//Set As Input
-		fprintf(DigitalDirHandles[channels[0]], "in");	
-		fflush(DigitalDirHandles[channels[0]]);
-		DigitalDirs[channels[0]] = INPUT;
-	}
-		
-	//Set Directions
-	for(int i=1; i<numChans; i++)
+	for(int i=0; i<numChans; i++)
 	{		
-		if( ((values[i/8] >> i%8) & 0x01) == OUTPUT && DigitalDirs[channels[i]] != OUTPUT)
+		if(directions[i] == OUTPUT && DigitalDirs[channels[i]] != OUTPUT)
 		{
 			//Set As Output
 			fprintf(DigitalDirHandles[channels[i]], "out");		
 			fflush(DigitalDirHandles[channels[i]]);
 			DigitalDirs[channels[i]] = OUTPUT;				
 		}
-		else if( (values[i] & 0x01) == INPUT && DigitalDirs[channels[i]] != INPUT)
+		else if(directions[i] == INPUT && DigitalDirs[channels[i]] != INPUT)
 		{
 			//Set As Input
 			fprintf(DigitalDirHandles[channels[i]], "in");	
@@ -220,13 +677,16 @@ int LinxRaspberryPi::DigitalWrite(unsigned char numChans, unsigned char* channel
 	
 	if(DigitalSetDirection(numChans, channels, directions) != L_OK)
 	{
-		DebugPrintln("Digital Write Fail - Set Direction Failed");
+		LINX_LOG_ERROR("Digital Write Fail - Set Direction Failed");
 	}
+	
+	unsigned char bits[numChans];
+	LinxBitPack::UnpackBits(numChans, values, bits);
 			
 	for(int i=0; i<numChans; i++)
 	{
 		//Set Value
-		if( ((values[i/8] >> i%8) & 0x01) == LOW)
+		if(bits[i] == LOW)
 		{
 			fprintf(DigitalValueHandles[channels[i]], "0");
 			fflush(DigitalValueHandles[channels[i]]);
@@ -246,6 +706,19 @@ int LinxRaspberryPi::DigitalWrite(unsigned char channel, unsigned char value)
 	return DigitalWrite(1, &channel, &value);
 }
 
+//Export Or Request Declared Pins Now Instead Of On Their First Digital Call
+int LinxRaspberryPi::DigitalPrewarm(unsigned char numChans, unsigned char* channels)
+{
+	for(int i=0; i<numChans; i++)
+	{
+		if(!DigitalChannels.Contains(channels[i]))
+		{
+			return LDIGITAL_PIN_DNE;
+		}
+	}
+	return digitalSmartOpen(numChans, channels);
+}
+
 int LinxRaspberryPi::DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values)
 {
 	//Generate Directions Array (waste some memory, save some CPU)
@@ -258,7 +731,7 @@ int LinxRaspberryPi::DigitalWriteNoPacking(unsigned char numChans, unsigned char
 	
 	if(DigitalSetDirection(numChans, channels, directions) != L_OK)
 	{
-		DebugPrintln("Digital Write Fail - Set Direction Failed");
+		LINX_LOG_ERROR("Digital Write Fail - Set Direction Failed");
 	}
 			
 	for(int i=0; i<numChans; i++)
@@ -292,32 +765,15 @@ int LinxRaspberryPi::DigitalRead(unsigned char numChans, unsigned char* channels
 	//Set Directions To Inputs		
 	if(DigitalSetDirection(numChans, channels, directions) != L_OK)
 	{
-		DebugPrintln("Digital Write Fail - Set Direction Failed");
+		LINX_LOG_ERROR("Digital Write Fail - Set Direction Failed");
 	}
 	
-	unsigned char bitOffset = 8;
-	unsigned char byteOffset = 0;
-	unsigned char retVal = 0;
+	unsigned char bits[numChans];
 	int diVal = 0;
 	
 	//Loop Over channels To Read
 	for(int i=0; i<numChans; i++)
 	{
-		
-		//If bitOffset Is 0 We Have To Start A New Byte, Store Old Byte And Increment OFfsets
-		if(bitOffset == 0)
-		{
-			//Insert retVal Into Response Buffer
-			values[byteOffset] = retVal;
-			retVal = 0x00;
-			byteOffset++;
-			bitOffset = 7;      
-		}
-		else
-		{
-			bitOffset--;
-		}
-		
 		//Reopen Value Handle
 		char valPath[64];
 		sprintf(valPath, "/sys/class/gpio/gpio%d/value", DigitalChannels[channels[i]]);
@@ -325,12 +781,10 @@ int LinxRaspberryPi::DigitalRead(unsigned char numChans, unsigned char* channels
 		
 		//Read From Next Pin
 		fscanf(DigitalValueHandles[channels[i]], "%u", &diVal);		
-					
-		retVal = retVal | ((unsigned char)diVal << bitOffset);	//Read Pin And Insert Value Into retVal
+		bits[i] = (unsigned char)diVal;
 	}
 
-	//Store Last Byte
-	values[byteOffset] = retVal;
+	LinxBitPack::PackBits(numChans, bits, values);
 		
 	return L_OK;
 }
@@ -353,7 +807,7 @@ int LinxRaspberryPi::DigitalReadNoPacking(unsigned char numChans, unsigned char*
 	//Set Directions To Inputs		
 	if(DigitalSetDirection(numChans, channels, directions) != L_OK)
 	{
-		DebugPrintln("Digital Write Fail - Set Direction Failed");
+		LINX_LOG_ERROR("Digital Write Fail - Set Direction Failed");
 	}
 	
 	//Loop Over channels To Read
@@ -370,9 +824,31 @@ int LinxRaspberryPi::DigitalReadNoPacking(unsigned char numChans, unsigned char*
 	return L_OK;
 }
 
+//Runs On The Software PWM Scheduler So The Listener Is Not Blocked.  A New Wave On The Same Channel Replaces The Old One.
 int LinxRaspberryPi::DigitalWriteSquareWave(unsigned char channel, unsigned long freq, unsigned long duration)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
+	//0 Hz Stops The Wave And Returns The Pin To Digital I/O
+	if(freq == 0)
+	{
+		return softPwmClose(channel);
+	}
+	
+	//The Scheduler Sleeps Between Edges, Faster Waves Would Not Come Out As Asked
+	unsigned long period = 1000000000UL / freq;
+	if(period < SOFT_PWM_MIN_PERIOD_NS)
+	{
+		LINX_LOG_ERROR("Square Wave Fail - Frequency Too High");
+		return L_UNKNOWN_ERROR;
+	}
+	
+	int status = softPwmOpen(channel, period);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	
+	//Duration Is In mS, 0 Runs Until Stopped
+	return SoftPwm->Restart(channel, period, period / 2, (unsigned long long)duration * 1000000ULL);
 }
 
 int LinxRaspberryPi::DigitalReadPulseWidth(unsigned char stimChan, unsigned char stimType, unsigned char respChan, unsigned char respType, unsigned long timeout, unsigned long* width)
@@ -384,43 +860,115 @@ int LinxRaspberryPi::DigitalReadPulseWidth(unsigned char stimChan, unsigned char
 //------------------------------------- PWM -------------------------------------
 int LinxRaspberryPi::PwmSetDutyCycle(unsigned char numChans, unsigned char* channels, unsigned char* values)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
-}
-
-		
-//------------------------------------- SPI -------------------------------------
-int LinxRaspberryPi::SpiOpenMaster(unsigned char channel)
-{
-	//fprintf(stdout, "SpiOpen(%d)\n", channel);
-	SpiHandles[channel]= open(SpiPaths[channel].c_str(), O_RDWR);
-	
-	if(SpiHandles[channel] == 0)
+	//Smart Open PWM Channels
+	int status = pwmSmartOpen(numChans, channels);
+	if(status != L_OK)
 	{
-		//fprintf(stdout, "SPI OPEN FAIL");
-		return LSPI_OPEN_FAIL;		
+		return status;
 	}
-	else
+	
+	for(int i=0; i<numChans; i++)
 	{
-		//Default To Mode 0 With No CS (LINX Uses GPIO When Performing Write)
-		unsigned long spi_Mode = SPI_MODE_0;			
-		if(ioctl(SpiHandles[channel], SPI_IOC_WR_MODE, &spi_Mode) < 0)					
+		unsigned long dutyCycle = (unsigned long)((unsigned long long)PwmPeriods[channels[i]] * values[i] / 255);
+		if(!PwmChipChans.Contains(channels[i]))
 		{
-			DebugPrint("SPI Fail - Failed To Set SPI Mode - ");
-			DebugPrintln(spi_Mode, BIN);
-			
-			//fprintf(stdout, "SPI OPEN FAIL");
-			return LSPI_OPEN_FAIL;			
+			status = SoftPwm->SetPulse(channels[i], PwmPeriods[channels[i]], dutyCycle);
+		}
+		else
+		{
+			status = pwmWrite(PwmDutyCycleHandles[channels[i]], dutyCycle);
 		}
 		
-		//Open With Default Clock Speed
-		if (ioctl(SpiHandles[channel], SPI_IOC_WR_MAX_SPEED_HZ, &SpiDefaultSpeed) < 0)
-		{			
-			DebugPrint("SPI Fail - Failed To Set SPI Max Speed - ");
-			DebugPrintln(SpiDefaultSpeed, DEC);
-			
-			//fprintf(stdout, "SPI OPEN FAIL");
-			return LSPI_OPEN_FAIL;			
+		if(status != L_OK)
+		{
+			LINX_LOG_ERROR("PWM Fail - Unable To Set Duty Cycle");
+			return L_UNKNOWN_ERROR;
 		}
+		PwmDutyCycles[channels[i]] = values[i];
+	}
+	
+	return L_OK;
+}
+
+int LinxRaspberryPi::PwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned long* values)
+{
+	//Smart Open PWM Channels
+	int status = pwmSmartOpen(numChans, channels);
+	if(status != L_OK)
+	{
+		return status;
+	}
+	
+	for(int i=0; i<numChans; i++)
+	{
+		if(values[i] == 0)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+		
+		//Keep The Duty Cycle Ratio At The New Period
+		unsigned long period = 1000000000UL / values[i];
+		unsigned long dutyCycle = (unsigned long)((unsigned long long)period * PwmDutyCycles[channels[i]] / 255);
+		
+		//The Kernel Rejects A Duty Cycle Longer Than The Period, So Shrink Whichever Must Go First
+		int periodStatus = L_OK;
+		int dutyCycleStatus = L_OK;
+		if(!PwmChipChans.Contains(channels[i]))
+		{
+			periodStatus = SoftPwm->SetPulse(channels[i], period, dutyCycle);
+		}
+		else if(period < PwmPeriods[channels[i]])
+		{
+			dutyCycleStatus = pwmWrite(PwmDutyCycleHandles[channels[i]], dutyCycle);
+			periodStatus = pwmWrite(PwmPeriodHandles[channels[i]], period);
+		}
+		else
+		{
+			periodStatus = pwmWrite(PwmPeriodHandles[channels[i]], period);
+			dutyCycleStatus = pwmWrite(PwmDutyCycleHandles[channels[i]], dutyCycle);
+		}
+		
+		if(periodStatus != L_OK || dutyCycleStatus != L_OK)
+		{
+			LINX_LOG_ERROR("PWM Fail - Unable To Set Frequency");
+			return L_UNKNOWN_ERROR;
+		}
+		PwmPeriods[channels[i]] = period;
+		PwmFrequencies[channels[i]] = values[i];
+	}
+	
+	return L_OK;
+}
+
+		
+//------------------------------------- SPI -------------------------------------
+int LinxRaspberryPi::SpiOpenMaster(unsigned char channel)
+{
+	SpiHandles[channel]= open(SpiPaths[channel].c_str(), O_RDWR);
+	
+	if(SpiHandles[channel] < 0)
+	{
+		LINX_LOG_ERROR("SPI Fail - Failed To Open SPI Channel");
+		return LSPI_OPEN_FAIL;		
+	}
+	else
+	{
+		//Default To Mode 0, CS Active Low (LINX Uses GPIO CS Unless csChan Is The Native CS)
+		SpiModes.Reset(channel);
+		if(spiWriteMode(channel, SPI_MODE_0) != L_OK)
+		{
+			return LSPI_OPEN_FAIL;			
+		}
+		
+		//Open With Default Clock Speed
+		if (spiIoctl(channel, SPI_IOC_WR_MAX_SPEED_HZ, &SpiDefaultSpeed) < 0)
+		{			
+			LINX_LOG_ERROR("SPI Fail - Failed To Set SPI Max Speed - %ld", (long)SpiDefaultSpeed);
+			return LSPI_OPEN_FAIL;			
+		}
+		
+		//Re-Apply Bit Order In Case It Was Set Before The Channel Was Opened
+		SpiSetBitOrder(channel, SpiBitOrders[channel]);
 	}
 	return L_OK;
 }
@@ -428,15 +976,33 @@ int LinxRaspberryPi::SpiOpenMaster(unsigned char channel)
 int LinxRaspberryPi::SpiSetBitOrder(unsigned char channel, unsigned char bitOrder)
 {
 	SpiBitOrders[channel] = bitOrder;
+	SpiLsbFirstHw[channel] = false;
+	
+	if(SpiHandles[channel] <= 0)
+	{
+		//Applied When The Channel Is Opened
+		return L_OK;
+	}
+	
+	unsigned char mode = SpiModes[channel] & ~SPI_LSB_FIRST;
+	if(bitOrder == LSBFIRST && spiWriteMode(channel, mode | SPI_LSB_FIRST) == L_OK)
+	{
+		SpiLsbFirstHw[channel] = true;
+		return L_OK;
+	}
+	
+	//Controller Only Shifts MSb First (BCM2835), Bits Are Reversed In Software During Transfers
+	spiWriteMode(channel, mode);
 	return L_OK;
 }
 
 int LinxRaspberryPi::SpiSetMode(unsigned char channel, unsigned char mode)
 {
-	unsigned long spi_Mode = (unsigned long) mode;
-	if(ioctl(SpiHandles[channel], SPI_IOC_WR_MODE, &spi_Mode) < 0)
+	//Replace CPOL / CPHA, Keep CS Polarity And Bit Order
+	unsigned char modeBits = (SpiModes[channel] & ~(SPI_CPHA | SPI_CPOL)) | (mode & (SPI_CPHA | SPI_CPOL));
+	if(spiWriteMode(channel, modeBits) != L_OK)
 	{
-		DebugPrintln("Failed To Set SPI Mode");
+		LINX_LOG_ERROR("Failed To Set SPI Mode");
 		return  L_UNKNOWN_ERROR;
 	}
 		
@@ -468,54 +1034,168 @@ int LinxRaspberryPi::SpiSetSpeed(unsigned char channel, unsigned long speed, uns
 
 int LinxRaspberryPi::SpiWriteRead(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer)
 {
-		unsigned char nextByte = 0;	//First Byte Of Next SPI Frame	
+	unsigned int numBytes = frameSize * numFrames;
+	bool nativeCs = (SpiHwCsChans[channel] != 0 && SpiHwCsChans[channel] == csChan);
+	bool reverseBits = (SpiBitOrders[channel] == LSBFIRST && !SpiLsbFirstHw[channel]);
 	
-		//SPI Hardware Only Supports MSb First Transfer.  If  Configured for LSb First Reverse Bits In Software
-		if( SpiBitOrders[channel] == LSBFIRST )
+	if(numFrames == 0)
+	{
+		return L_OK;
+	}
+	
+	//SPI Hardware Only Supports MSb First Transfer.  Reverse Bits Into A Scratch Buffer So The Caller's Data Is Left Untouched
+	unsigned char reversed[reverseBits ? numBytes : 1];
+	unsigned char* txBuffer = sendBuffer;
+	if(reverseBits)
+	{
+		LinxBitPack::ReverseBits(numBytes, sendBuffer, reversed);
+		txBuffer = reversed;
+	}
+	
+	//One Transfer Per Frame, CS Released Between Frames By The Driver (cs_change)
+	struct spi_ioc_transfer transfers[numFrames];
+	memset(transfers, 0, sizeof(transfers));
+	for(int i=0; i<numFrames; i++)
+	{
+		transfers[i].tx_buf = (unsigned long)(txBuffer + i*frameSize);
+		transfers[i].rx_buf = (unsigned long)(recBuffer + i*frameSize);
+		transfers[i].len = frameSize;
+		transfers[i].speed_hz = SpiSetSpeeds[channel];
+		transfers[i].bits_per_word = 8;
+		transfers[i].cs_change = (i < numFrames-1) ? 1 : 0;
+	}
+	
+	int retVal = 0;
+	if(nativeCs)
+	{
+		//Native CS - Whole Transfer Is A Single SPI Message
+		unsigned char mode = SpiModes[channel] & ~SPI_CS_HIGH;
+		if(csLL)
 		{
-			for(int i=0; i< frameSize*numFrames; i++)
-			{			
-				sendBuffer[i] = ReverseBits(sendBuffer[i]);
-			}
+			mode |= SPI_CS_HIGH;
+		}
+		if(spiWriteMode(channel, mode) != L_OK)
+		{
+			return LSPI_TRANSFER_FAIL;
 		}
 		
-		struct spi_ioc_transfer transfer = {};
-		
-		//Set CS As Output And Make Sure CS Starts Idle	
+		retVal = spiIoctl(channel, SPI_IOC_MESSAGE(numFrames), transfers);
+	}
+	else
+	{
+		//GPIO CS - Set CS As Output And Make Sure CS Starts Idle, Then Toggle It Around Each Frame
 		DigitalWrite(csChan, (~csLL & 0x01) );
 		
-		for(int i=0; i< numFrames; i++)
+		for(int i=0; i<numFrames && retVal >= 0; i++)
 		{
-			//Setup Transfer
-			transfer.tx_buf = (unsigned long)(sendBuffer+nextByte);
-			transfer.rx_buf = (unsigned long)(recBuffer+nextByte);
-			transfer.len = frameSize;
-			transfer.delay_usecs = 0;
-			transfer.speed_hz = SpiSetSpeeds[channel];
-			//transfer.speed_hz = 25000;
-			transfer.bits_per_word = 8;
-			transfer.pad = 0;
-		
-			//CS Active
-			DigitalWrite(csChan, csLL);			
-			
-			//Transfer Data
-			int retVal = ioctl(SpiHandles[channel], SPI_IOC_MESSAGE(1), &transfer);
+			transfers[i].cs_change = 0;
 			
-			//CS Idle
+			DigitalWrite(csChan, csLL);			
+			retVal = spiIoctl(channel, SPI_IOC_MESSAGE(1), &transfers[i]);
 			DigitalWrite(csChan, (~csLL & 0x01) );
-			
-			if (retVal < 0)
-			{
-				DebugPrintln("SPI Fail - Failed To Transfer Data");
-				return  LSPI_TRANSFER_FAIL;
-			}
-			
-			nextByte += frameSize;			
 		}
+	}
 	
+	if (retVal < 0)
+	{
+		LINX_LOG_ERROR("SPI Fail - Failed To Transfer Data");
+		return  LSPI_TRANSFER_FAIL;
+	}
+	
+	if(reverseBits)
+	{
+		LinxBitPack::ReverseBits(numBytes, recBuffer, recBuffer);
+	}
+	
+	return L_OK;
+}
+int LinxRaspberryPi::SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments)
+{
+	bool nativeCs = (SpiHwCsChans[channel] != 0 && SpiHwCsChans[channel] == csChan);
+	bool reverseBits = (SpiBitOrders[channel] == LSBFIRST && !SpiLsbFirstHw[channel]);
+	
+	if(numSegments == 0)
+	{
 		return L_OK;
 	}
+	
+	unsigned int numBytes = 0;
+	for(int i=0; i<numSegments; i++)
+	{
+		numBytes += segments[i].numBytes;
+	}
+	
+	//Software LSb First - Reverse Tx Data Into A Scratch Buffer
+	unsigned char reversed[reverseBits ? numBytes : 1];
+	unsigned int offset = 0;
+	
+	//One Transfer Per Segment, CS Held Across The Whole Message
+	struct spi_ioc_transfer transfers[numSegments];
+	memset(transfers, 0, sizeof(transfers));
+	for(int i=0; i<numSegments; i++)
+	{
+		unsigned char* txBuffer = (segments[i].type == SPI_SEGMENT_RX_ONLY) ? NULL : segments[i].sendBuffer;
+		unsigned char* rxBuffer = (segments[i].type == SPI_SEGMENT_TX_ONLY) ? NULL : segments[i].recBuffer;
+		
+		if(txBuffer != NULL && reverseBits)
+		{
+			LinxBitPack::ReverseBits(segments[i].numBytes, txBuffer, reversed + offset);
+			txBuffer = reversed + offset;
+		}
+		offset += segments[i].numBytes;
+		
+		transfers[i].tx_buf = (unsigned long)txBuffer;
+		transfers[i].rx_buf = (unsigned long)rxBuffer;
+		transfers[i].len = segments[i].numBytes;
+		transfers[i].speed_hz = (segments[i].speed != 0) ? segments[i].speed : SpiSetSpeeds[channel];
+		transfers[i].delay_usecs = segments[i].delayUs;
+		transfers[i].bits_per_word = 8;
+		transfers[i].cs_change = 0;
+	}
+	
+	int retVal = 0;
+	if(nativeCs)
+	{
+		unsigned char mode = SpiModes[channel] & ~SPI_CS_HIGH;
+		if(csLL)
+		{
+			mode |= SPI_CS_HIGH;
+		}
+		if(spiWriteMode(channel, mode) != L_OK)
+		{
+			return LSPI_TRANSFER_FAIL;
+		}
+		
+		retVal = spiIoctl(channel, SPI_IOC_MESSAGE(numSegments), transfers);
+	}
+	else
+	{
+		//GPIO CS - Asserted Once Around The Whole Message
+		DigitalWrite(csChan, (~csLL & 0x01) );
+		DigitalWrite(csChan, csLL);
+		retVal = spiIoctl(channel, SPI_IOC_MESSAGE(numSegments), transfers);
+		DigitalWrite(csChan, (~csLL & 0x01) );
+	}
+	
+	if (retVal < 0)
+	{
+		LINX_LOG_ERROR("SPI Fail - Failed To Transfer Data");
+		return  LSPI_TRANSFER_FAIL;
+	}
+	
+	if(reverseBits)
+	{
+		for(int i=0; i<numSegments; i++)
+		{
+			if(segments[i].type != SPI_SEGMENT_TX_ONLY && segments[i].recBuffer != NULL)
+			{
+				LinxBitPack::ReverseBits(segments[i].numBytes, segments[i].recBuffer, segments[i].recBuffer);
+			}
+		}
+	}
+	
+	return L_OK;
+}
 		
 //------------------------------------- I2C -------------------------------------
 int LinxRaspberryPi::I2cOpenMaster(unsigned char channel)
@@ -523,12 +1203,13 @@ int LinxRaspberryPi::I2cOpenMaster(unsigned char channel)
 	int handle = open(I2cPaths[channel].c_str(), O_RDWR);
 	if (handle < 0)
 	{
-		DebugPrintln("I2C Fail - Failed To Open I2C Channel");
+		LINX_LOG_ERROR("I2C Fail - Failed To Open I2C Channel");
 		return  LI2C_OPEN_FAIL;
 	}
 	else
 	{
 		I2cHandles[channel] = handle;
+		I2cSlaveAddrs.Reset(channel);
 	}
 	return L_OK;
 }
@@ -540,56 +1221,20 @@ int LinxRaspberryPi::I2cSetSpeed(unsigned char channel, unsigned long speed, uns
 
 int LinxRaspberryPi::I2cWrite(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer)
 {
-	//Check EOF - Currently Only Support 0x00
-	if(eofConfig != EOF_STOP)
-	{
-		DebugPrintln("I2C Fail - EOF Not Supported");
-		return LI2C_EOF;	
-	}
-	
-	//Set Slave Address
-	if(ioctl(I2cHandles[channel], I2C_SLAVE, slaveAddress) < 0) 
-	{			
-		//Failed To Set Slave Address
-		DebugPrintln("I2C Fail - Failed To Set Slave Address");
-		return LI2C_SADDR;
-	}
-		
-	//Write Data
-	if(write(I2cHandles[channel], sendBuffer, numBytes) != numBytes)
-	{
-		DebugPrintln("I2C Fail - Failed To Write All Data");
-		return LI2C_WRITE_FAIL;
-	}
-	
-	return L_OK;
+	return i2cTransfer(channel, slaveAddress, eofConfig, numBytes, sendBuffer, false);
 }
 
 int LinxRaspberryPi::I2cRead(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer)
 {
-	//Check EOF - Currently Only Support 0x00
-	if(eofConfig != EOF_STOP)
-	{
-		return LI2C_EOF;	
-	}
-	
-	//Set Slave Address
-	if (ioctl(I2cHandles[channel], I2C_SLAVE, slaveAddress) < 0) 
-	{
-		//Failed To Set Slave Address
-		return LI2C_SADDR;
-	}
-	
-	if(read(I2cHandles[channel], recBuffer, numBytes) < numBytes)
-	{
-		return LI2C_READ_FAIL;	
-	}
-	
-	return L_OK;
+	return i2cTransfer(channel, slaveAddress, eofConfig, numBytes, recBuffer, true);
 }
-	
+
 int LinxRaspberryPi::I2cClose(unsigned char channel)
 {
+	I2cSlaveAddrs.Reset(channel);
+	I2cPendingMsgs.Reset(channel);
+	I2cPendingData.Reset(channel);
+	
 	//Close I2C Channel
 	if(close(I2cHandles[channel]) < 0)
 	{
@@ -610,8 +1255,7 @@ int LinxRaspberryPi::UartOpen(unsigned char channel, unsigned long baudRate, uns
 			
 		if(handle <= 0)
 		{
-			DebugPrint("UART Fail - Failed To Open UART Handle -  ");
-			DebugPrintln(UartPaths[channel].c_str());
+			LINX_LOG_ERROR("UART Fail - Failed To Open UART Handle -  %s", UartPaths[channel].c_str());
 			return  LUART_OPEN_FAIL;
 		}
 		else
@@ -622,7 +1266,7 @@ int LinxRaspberryPi::UartOpen(unsigned char channel, unsigned long baudRate, uns
 	
 	if(UartSetBaudRate(channel, baudRate, actualBaud) != L_OK)
 	{
-		DebugPrintln("Failed to set baud rate");
+		LINX_LOG_ERROR("Failed to set baud rate");
 	}
 	
 	return L_OK;
@@ -630,82 +1274,207 @@ int LinxRaspberryPi::UartOpen(unsigned char channel, unsigned long baudRate, uns
 
 int LinxRaspberryPi::UartSetBaudRate(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud)
 {
-	//Get Closest Support Baud Rate Without Going Over
-
-	//Loop Over All Supported SPI Speeds
-	int index = 0;
-	for(index=0; index < NumUartSpeeds; index++)
-	{				
-		if(baudRate < *(UartSupportedSpeeds+index))
-		{		
-			//Previous Index Was Closest Supported Baud Without Going Over, Index Will Be Decremented Accordingly Below.
-			break;
-		}	
+	//Any Rate Up To The Controller Limit Is Allowed, The B* Constants Are Bypassed Using termios2 / BOTHER
+	if(baudRate > UartMaxBaud)
+	{
+		baudRate = UartMaxBaud;
 	}
 	
-	//Once Loop Completes Index Is One Higher Than The Correct Baud, But Could Be Zero So Check And Decrement Accordingly
-	//If The Entire Loop Runs Then index == NumUartSpeeds So Decrement It To Get Max Baud
-	if(index != 0)
+	struct termios2 options;
+	if(ioctl(UartHandles[channel], TCGETS2, &options) < 0)
 	{
-		index = index -1;
+		LINX_LOG_ERROR("UART Fail - Failed To Get Port Settings");
+		return LUART_SET_BAUD_FAIL;
 	}
 	
-	//Store Actual Baud Used
-	*actualBaud = (unsigned long) *(UartSupportedSpeeds+index);
-	
-	//Set Baud Rate
-	struct termios options;	
-	tcgetattr(UartHandles[channel], &options);
-	
-	options.c_cflag = *(UartSupportedSpeedsCodes+index) | CS8 | CLOCAL | CREAD;
+	options.c_cflag = BOTHER | CS8 | CLOCAL | CREAD;
 	options.c_iflag = IGNPAR;
 	options.c_oflag = 0;
 	options.c_lflag = 0;
+	options.c_ispeed = baudRate;
+	options.c_ospeed = baudRate;
 	
-	tcflush(UartHandles[channel], TCIFLUSH);	
-	tcsetattr(UartHandles[channel], TCSANOW, &options);
+	ioctl(UartHandles[channel], TCFLSH, TCIFLUSH);
+	if(ioctl(UartHandles[channel], TCSETS2, &options) < 0)
+	{
+		LINX_LOG_ERROR("UART Fail - Failed To Set Baud Rate");
+		return LUART_SET_BAUD_FAIL;
+	}
+	
+	//Read Back The Rate The Driver Actually Achieved (Limited By The UART Clock Divider)
+	*actualBaud = baudRate;
+	if(ioctl(UartHandles[channel], TCGETS2, &options) == 0)
+	{
+		*actualBaud = options.c_ospeed;
+	}
 	
 	return  L_OK;
 }
 
 int LinxRaspberryPi::UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes)
 {
+	unsigned long available = 0;
+	int status = UartGetBytesBuffered(channel, &available);
+	
+	//Clamp Rather Than Truncate - 300 Bytes Pending Must Not Read As 44
+	*numBytes = (available > 255) ? 255 : (unsigned char)available;
+	
+	return status;
+}
+
+int LinxRaspberryPi::UartGetBytesBuffered(unsigned char channel, unsigned long* numBytes)
+{
+	LinxUartRx* rx = UartRxThreads[channel];
+	if(rx != NULL)
+	{
+		*numBytes = rx->Available();
+		return L_OK;
+	}
+	
 	int bytesAtPort = -1;
-	ioctl(UartHandles[channel], FIONREAD, &bytesAtPort);	
+	ioctl(UartHandles[channel], FIONREAD, &bytesAtPort);
 	
 	if(bytesAtPort < 0)
 	{
+		*numBytes = 0;
 		return LUART_AVAILABLE_FAIL;
 	}
-	else
-	{
-		*numBytes = (unsigned char) bytesAtPort;
-	}
+	*numBytes = (unsigned long)bytesAtPort;
 	
 	return  L_OK;
 }
 
 int LinxRaspberryPi::UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead)
 {
+	*numBytesRead = 0;
+	
 	//Check If Enough Bytes Are Available
-	unsigned char bytesAvailable = -1;
-	UartGetBytesAvailable(channel, &bytesAvailable);
+	unsigned long bytesAvailable = 0;
+	UartGetBytesBuffered(channel, &bytesAvailable);
 	
 	if(bytesAvailable >= numBytes)
 	{
+		LinxUartRx* rx = UartRxThreads[channel];
+		if(rx != NULL)
+		{
+			bool overrun = false;
+			*numBytesRead = (unsigned char)rx->Read(recBuffer, numBytes, 0, NULL, &overrun);
+			if(overrun)
+			{
+				return LUART_OVERRUN;
+			}
+			return L_OK;
+		}
+		
 		//Read Bytes From Input Buffer
 		int bytesRead = read(UartHandles[channel], recBuffer, numBytes);
-		*numBytesRead = (unsigned char) bytesRead;
-		
 		if(bytesRead != numBytes)
 		{
 			return LUART_READ_FAIL;
-		}		
+		}
+		*numBytesRead = (unsigned char) bytesRead;
 	}
 	
 	return  L_OK;
 }
 
+int LinxRaspberryPi::UartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp)
+{
+	*numBytesRead = 0;
+	if(timestamp != NULL)
+	{
+		*timestamp = 0;
+	}
+	
+	LinxUartRx* rx = UartRxThreads[channel];
+	if(rx != NULL)
+	{
+		bool overrun = false;
+		*numBytesRead = rx->Read(recBuffer, numBytes, timeout, timestamp, &overrun);
+		if(overrun)
+		{
+			return LUART_OVERRUN;
+		}
+		return L_OK;
+	}
+	
+	//No RX Thread - Wait On The tty Directly
+	unsigned long startTime = GetMilliSeconds();
+	while(*numBytesRead < numBytes)
+	{
+		unsigned long elapsed = GetMilliSeconds() - startTime;
+		struct pollfd port;
+		port.fd = UartHandles[channel];
+		port.events = POLLIN;
+		
+		int ready = poll(&port, 1, (elapsed >= timeout) ? 0 : (int)(timeout - elapsed));
+		if(ready < 0 && errno != EINTR)
+		{
+			return LUART_READ_FAIL;
+		}
+		if(ready == 0)
+		{
+			break;
+		}
+		if(ready < 0)
+		{
+			continue;
+		}
+		
+		int bytesRead = read(UartHandles[channel], recBuffer + *numBytesRead, numBytes - *numBytesRead);
+		if(bytesRead < 0 && errno != EINTR && errno != EAGAIN)
+		{
+			return LUART_READ_FAIL;
+		}
+		if(bytesRead > 0)
+		{
+			if(*numBytesRead == 0 && timestamp != NULL)
+			{
+				struct timespec now;
+				clock_gettime(CLOCK_MONOTONIC, &now);
+				*timestamp = (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+			}
+			*numBytesRead += bytesRead;
+		}
+	}
+	
+	return L_OK;
+}
+
+//The tty Handle Is Only Handed Out While Nothing Else Reads From It
+int LinxRaspberryPi::UartGetFileDescriptor(unsigned char channel)
+{
+	if(UartHandles[channel] <= 0 || UartRxThreads[channel] != NULL)
+	{
+		return -1;
+	}
+	
+	return UartHandles[channel];
+}
+
+int LinxRaspberryPi::UartEnableRxThread(unsigned char channel, unsigned long bufferSize)
+{
+	if(UartHandles[channel] <= 0)
+	{
+		return LUART_OPEN_FAIL;
+	}
+	if(UartRxThreads[channel] != NULL)
+	{
+		return L_OK;
+	}
+	
+	LinxUartRx* rx = new LinxUartRx();
+	int status = rx->Start(UartHandles[channel], bufferSize);
+	if(status != L_OK)
+	{
+		delete rx;
+		return status;
+	}
+	UartRxThreads[channel] = rx;
+	
+	return L_OK;
+}
+
 int LinxRaspberryPi::UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer)
 {
 	int bytesSent = write(UartHandles[channel], sendBuffer, numBytes);	
@@ -719,6 +1488,14 @@ int LinxRaspberryPi::UartWrite(unsigned char channel, unsigned char numBytes, un
 
 int LinxRaspberryPi::UartClose(unsigned char channel)
 {
+	//Stop The RX Thread Before Its Handle Goes Away
+	LinxUartRx* rx = UartRxThreads[channel];
+	if(rx != NULL)
+	{
+		delete rx;
+		UartRxThreads[channel] = NULL;
+	}
+	
 	//Close UART Channel, Return OK or Error
 	if (close(UartHandles[channel]) < 0)
 	{
@@ -734,20 +1511,62 @@ int LinxRaspberryPi::UartClose(unsigned char channel)
 //------------------------------------- Servo -------------------------------------
 int LinxRaspberryPi::ServoOpen(unsigned char numChans, unsigned char* channels)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
+	for(int i=0; i<numChans; i++)
+	{
+		int status = softPwmOpen(channels[i], SERVO_PERIOD_NS);
+		if(status != L_OK)
+		{
+			return status;
+		}
+	}
+	return L_OK;
 }
 
 int LinxRaspberryPi::ServoSetPulseWidth(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
+	for(int i=0; i<numChans; i++)
+	{
+		//Smart Open Like The Other Peripherals
+		int status = softPwmOpen(channels[i], SERVO_PERIOD_NS);
+		if(status != L_OK)
+		{
+			return status;
+		}
+		
+		//Pulse Widths Are In uS
+		if(SoftPwm->SetPulse(channels[i], SERVO_PERIOD_NS, pulseWidths[i] * 1000UL) != L_OK)
+		{
+			LINX_LOG_ERROR("Servo Fail - Unable To Set Pulse Width");
+			return L_UNKNOWN_ERROR;
+		}
+	}
+	return L_OK;
 }
 
 int LinxRaspberryPi::ServoClose(unsigned char numChans, unsigned char* channels)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
+	for(int i=0; i<numChans; i++)
+	{
+		if(softPwmClose(channels[i]) != L_OK)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+	}
+	return L_OK;
+}
+
+int LinxRaspberryPi::SoftPwmGetStats(LinxSoftPwmStats* stats, unsigned char reset)
+{
+	if(SoftPwm == NULL)
+	{
+		memset(stats, 0, sizeof(LinxSoftPwmStats));
+		return L_OK;
+	}
+	
+	SoftPwm->GetStats(stats, reset != 0);
+	return L_OK;
 }
 
-				
 //------------------------------------- General -------------------------------------
 unsigned long LinxRaspberryPi::GetMilliSeconds()
 {
@@ -764,6 +1583,18 @@ unsigned long LinxRaspberryPi::GetSeconds()
 	return mTime.tv_sec;
 }
 
+unsigned long long LinxRaspberryPi::GetMicroSeconds()
+{
+	return GetNanoSeconds() / 1000;
+}
+
+unsigned long long LinxRaspberryPi::GetNanoSeconds()
+{
+	timespec mTime;
+	clock_gettime(CLOCK_MONOTONIC, &mTime);
+	return (unsigned long long)mTime.tv_sec * 1000000000ULL + mTime.tv_nsec;
+}
+
 void LinxRaspberryPi::DelayMs(unsigned long ms)
 {
 	usleep(ms * 1000);
@@ -771,12 +1602,44 @@ void LinxRaspberryPi::DelayMs(unsigned long ms)
 
 void LinxRaspberryPi::NonVolatileWrite(int address, unsigned char data)
 {
-	
+	Nvs->Write(address, 1, &data);
 }
 
 unsigned char LinxRaspberryPi::NonVolatileRead(int address)
 {
-	return L_FUNCTION_NOT_SUPPORTED;
+	unsigned char data = 0;
+	if(Nvs->Read(address, 1, &data) != L_OK)
+	{
+		return L_FUNCTION_NOT_SUPPORTED;
+	}
+	return data;
+}
+
+int LinxRaspberryPi::NonVolatileWriteBlock(int address, unsigned char numBytes, const unsigned char* data)
+{
+	return Nvs->Write(address, numBytes, data);
+}
+
+int LinxRaspberryPi::NonVolatileReadBlock(int address, unsigned char numBytes, unsigned char* data)
+{
+	return Nvs->Read(address, numBytes, data);
+}
+
+int LinxRaspberryPi::NonVolatileCommit()
+{
+	return Nvs->Commit();
+}
+
+void LinxRaspberryPi::PrintStartupTiming()
+{
+	unsigned long total = 0;
+	fprintf(stdout, "Startup timing:\n");
+	for(int i=0; i<NumStartupPhases; i++)
+	{
+		fprintf(stdout, "  %-24s %8lu uS\n", StartupPhaseNames[i], StartupPhaseTimes[i]);
+		total += StartupPhaseTimes[i];
+	}
+	fprintf(stdout, "  %-24s %8lu uS\n", "Total", total);
 }
 
 
@@ -15,13 +15,22 @@
 /****************************************************************************************
 **  Defines
 ****************************************************************************************/		
+#define SERVO_PERIOD_NS 20000000						//Servo Frame (nS)
+#define GPIO_EXPORT_TIMEOUT 1000						//Max Wait For udev To Hand Over An Exported GPIO (mS)
+#define STARTUP_MAX_PHASES 8							//Construction Steps Timed By startupPhase()
+#define RPI_MAX_PIN_SLOTS 32							//Header Pins Usable As Digital / PWM Channels
+#define RPI_MAX_BUS_SLOTS 4								//UART / SPI / I2C Masters
 
 /****************************************************************************************
 **  Includes
 ****************************************************************************************/		
 #include "LinxDevice.h"
+#include "LinxUartRx.h"
+#include "LinxSoftPwm.h"
+#include "LinxNvs.h"
+#include "LinxChannelTable.h"
 #include <stdio.h>
-#include <map>
+#include <vector>
 #include <string>
 
 using namespace std;
@@ -36,18 +45,25 @@ class LinxRaspberryPi : public LinxDevice
 		**  Variables
 		****************************************************************************************/
 		//DIO
-		map<unsigned char, unsigned int> DigitalChannels;				//Maps LINX DIO Channel Numbers To BB GPIO Channels
-		map<unsigned char, unsigned char> DigitalDirs;						//Current DIO Direction Values
-		map<unsigned char, FILE*> DigitalDirHandles;							//File Handles For Digital Pin Directions
-		map<unsigned char, FILE*> DigitalValueHandles;						//File Handles For Digital Pin Values
+		LinxChannelTable<unsigned int, RPI_MAX_PIN_SLOTS> DigitalChannels;				//Maps LINX DIO Channel Numbers To BB GPIO Channels
+		LinxChannelTable<unsigned char, RPI_MAX_PIN_SLOTS> DigitalDirs;						//Current DIO Direction Values
+		LinxChannelTable<FILE*, RPI_MAX_PIN_SLOTS> DigitalDirHandles;							//File Handles For Digital Pin Directions
+		LinxChannelTable<FILE*, RPI_MAX_PIN_SLOTS> DigitalValueHandles;						//File Handles For Digital Pin Values
+		string GpioChipPath;															//GPIO Character Device The Digital Channels Belong To
+		unsigned int GpioChipBase;													//sysfs GPIO Number Of The Chip's First Line
 		
 		//PWM
-		map<unsigned char, string> PwmDirPaths;								//PWM Device Tree Overlay Names	
-		map<unsigned char, string> PwmDtoNames;							//PWM Device Tree Overlay Names	
-		map<unsigned char, FILE*> PwmPeriodHandles;						//File Handles For PWM Period Values
-		map<unsigned char, FILE*> PwmDutyCycleHandles;				//File Handles For PWM Duty Cycle Values		
-		map<unsigned char, unsigned long> PwmFrequencies;				//Current PWM Period Values
+		string PwmChipPath;															//Kernel PWM Class Chip Directory, With Trailing Slash
+		LinxChannelTable<unsigned char, RPI_MAX_PIN_SLOTS> PwmChipChans;					//Maps LINX PWM Channel Numbers To pwmchip Outputs
+		LinxChannelTable<string, RPI_MAX_PIN_SLOTS> PwmDirPaths;								//Exported PWM Output Directories
+		LinxChannelTable<string, RPI_MAX_PIN_SLOTS> PwmDtoNames;							//PWM Device Tree Overlay Names	
+		LinxChannelTable<int, RPI_MAX_PIN_SLOTS> PwmPeriodHandles;							//File Handles For PWM Period Values (Kept Open, -1 = Not Open)
+		LinxChannelTable<int, RPI_MAX_PIN_SLOTS> PwmDutyCycleHandles;						//File Handles For PWM Duty Cycle Values (Kept Open, -1 = Not Open)
+		LinxChannelTable<unsigned long, RPI_MAX_PIN_SLOTS> PwmFrequencies;				//Current PWM Frequency Values (Hz)
+		LinxChannelTable<unsigned long, RPI_MAX_PIN_SLOTS> PwmPeriods;					//Current PWM Period Values (nS, 0 = Not Set Yet)
+		LinxChannelTable<unsigned char, RPI_MAX_PIN_SLOTS> PwmDutyCycles;				//Last Duty Cycle Set (0 - 255), Kept Across Frequency Changes
 		unsigned long PwmDefaultFrequency;										//Default Frequency For PWM Channels (Hz)
+		LinxSoftPwm* SoftPwm;															//Software PWM / Servo Scheduler For Digital Channels (Created On First Use)
 		//const char (*PwmDirPaths)[PWM_PATH_LEN];						//Path To PWM Directories
 		//const char (*PwmDtoNames)[PWM_DTO_NAME_LEN];				//PWM Device Tree Overlay Names
 		
@@ -61,29 +77,41 @@ class LinxRaspberryPi : public LinxDevice
 		//const char (*AiPaths)[AI_PATH_LEN];										//AI Channel File Paths
 		
 		//UART		
-		map<unsigned char, string> UartPaths;									//UART Channel File Paths
-		map<unsigned char, int> UartHandles;									//File Handles For UARTs - Must Be Int For Termios Functions
-		map<unsigned char, string> UartDtoNames;							//UART Device Tree Overlay Names	
-		unsigned char NumUartSpeeds;												//Number Of Support UART Buads
-		unsigned long* UartSupportedSpeeds;										//Supported UART Bauds Frequencies
-		unsigned long* UartSupportedSpeedsCodes;							//Supported UART Baud Divider Codes
+		LinxChannelTable<string, RPI_MAX_BUS_SLOTS> UartPaths;									//UART Channel File Paths
+		LinxChannelTable<int, RPI_MAX_BUS_SLOTS> UartHandles;									//File Handles For UARTs - Must Be Int For Termios Functions
+		LinxChannelTable<string, RPI_MAX_BUS_SLOTS> UartDtoNames;							//UART Device Tree Overlay Names	
+		LinxChannelTable<LinxUartRx*, RPI_MAX_BUS_SLOTS> UartRxThreads;					//Background Receive Threads, NULL For Channels That Have Not Enabled One
 		
 		//SPI
-		map<unsigned char, string> SpiDtoNames;  							//Device Tree Overlay Names For SPI Master(s)
-		map<unsigned char, string> SpiPaths;  									//File Paths For SPI Master(s)		
-		map<unsigned char, int> SpiHandles;										//File Handles For SPI Master(s)
+		LinxChannelTable<string, RPI_MAX_BUS_SLOTS> SpiDtoNames;  							//Device Tree Overlay Names For SPI Master(s)
+		LinxChannelTable<string, RPI_MAX_BUS_SLOTS> SpiPaths;  									//File Paths For SPI Master(s)		
+		LinxChannelTable<int, RPI_MAX_BUS_SLOTS> SpiHandles;										//File Handles For SPI Master(s)
 		unsigned char NumSpiSpeeds;												//Number Of Supported SPI Speeds
 		unsigned long* SpiSupportedSpeeds;										//Supported SPI Clock Frequencies
 		int* SpiSpeedCodes;																//SPI Speed Values (Clock Divider Macros In Wiring Case)
-		map<unsigned char, unsigned char> SpiBitOrders;					//Stores Bit Orders For SPI Channels (LSBFIRST / MSBFIRST)
-		map<unsigned char, unsigned long> SpiSetSpeeds; 				//Stores The Set Clock Rate Of Each SPI Channel
+		LinxChannelTable<unsigned char, RPI_MAX_BUS_SLOTS> SpiBitOrders;					//Stores Bit Orders For SPI Channels (LSBFIRST / MSBFIRST)
+		LinxChannelTable<unsigned long, RPI_MAX_BUS_SLOTS> SpiSetSpeeds; 				//Stores The Set Clock Rate Of Each SPI Channel
 		unsigned long SpiDefaultSpeed; 												//Stores The Default Clock Rate Used When Opening An SPI Channel
+		LinxChannelTable<unsigned char, RPI_MAX_BUS_SLOTS> SpiModes;							//Mode Bits Currently Written To Each SPI Master (SPI_MODE_x, SPI_CS_HIGH, SPI_LSB_FIRST), 0xFF = Unknown
+		LinxChannelTable<bool, RPI_MAX_BUS_SLOTS> SpiLsbFirstHw;								//True If The SPI Master Shifts LSb First In Hardware
+		LinxChannelTable<unsigned char, RPI_MAX_BUS_SLOTS> SpiHwCsChans;					//LINX DIO Channel Wired To Each SPI Master's Native Chip Select (0 = None)
 		
 		//I2C
-		map<unsigned char, string> I2cPaths;										//File Paths For I2C Master(s)
-		map<unsigned char, int> I2cHandles;										//File Handles For I2C Master(s)
-		map<unsigned char, string> I2cDtoNames;								//Device Tree Overlay Names For I2C Master(s)
+		LinxChannelTable<string, RPI_MAX_BUS_SLOTS> I2cPaths;										//File Paths For I2C Master(s)
+		LinxChannelTable<int, RPI_MAX_BUS_SLOTS> I2cHandles;										//File Handles For I2C Master(s)
+		LinxChannelTable<string, RPI_MAX_BUS_SLOTS> I2cDtoNames;								//Device Tree Overlay Names For I2C Master(s)
 		unsigned char* I2cRefCount;													//Number Opens - Closes On I2C Channel
+		LinxChannelTable<unsigned char, RPI_MAX_BUS_SLOTS> I2cSlaveAddrs;					//Slave Address Currently Set With I2C_SLAVE On Each I2C Master, 0xFF = None
+		LinxChannelTable<vector<unsigned char>, RPI_MAX_BUS_SLOTS> I2cPendingMsgs;		//Writes Held Back For A Repeated Start - (Address, Length, EOF) Per Message
+		LinxChannelTable<vector<unsigned char>, RPI_MAX_BUS_SLOTS> I2cPendingData;		//Data For Held Back Writes
+		
+		//NVS
+		LinxNvs* Nvs;																	//Non-Volatile Storage File (Mapped On First Use)
+		
+		//Startup Timing
+		const char* StartupPhaseNames[STARTUP_MAX_PHASES];
+		unsigned long StartupPhaseTimes[STARTUP_MAX_PHASES];					//uS Spent In Each Construction Step
+		unsigned char NumStartupPhases;
 		
 		
 		/****************************************************************************************
@@ -105,6 +133,7 @@ class LinxRaspberryPi : public LinxDevice
 		virtual int DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values);
 		virtual int DigitalWrite(unsigned char channel, unsigned char value);
 		virtual int DigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);											//Values Not Bit Packed
+		virtual int DigitalPrewarm(unsigned char numChans, unsigned char* channels);
 		virtual int DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
 		virtual int DigitalRead(unsigned char channel, unsigned char* value);
 		virtual int DigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);											//Response Not Bit Packed
@@ -113,6 +142,7 @@ class LinxRaspberryPi : public LinxDevice
 		
 		//PWM		
 		virtual int PwmSetDutyCycle(unsigned char numChans, unsigned char* channels, unsigned char* values);
+		virtual int PwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned long* values);
 		
 		//SPI
 		virtual int SpiOpenMaster(unsigned char channel);
@@ -120,6 +150,7 @@ class LinxRaspberryPi : public LinxDevice
 		virtual int SpiSetMode(unsigned char channel, unsigned char mode);
 		virtual int SpiSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed);
 		virtual int SpiWriteRead(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer);
+		virtual int SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments);
 		
 		//I2C
 		virtual int I2cOpenMaster(unsigned char channel);
@@ -133,6 +164,10 @@ class LinxRaspberryPi : public LinxDevice
 		virtual int UartSetBaudRate(unsigned char channel, unsigned long baudRate, unsigned long* actualBaud);
 		virtual int UartGetBytesAvailable(unsigned char channel, unsigned char *numBytes);
 		virtual int UartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead);
+		virtual int UartEnableRxThread(unsigned char channel, unsigned long bufferSize);
+		virtual int UartGetBytesBuffered(unsigned char channel, unsigned long* numBytes);
+		virtual int UartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp);
+		virtual int UartGetFileDescriptor(unsigned char channel);
 		virtual int UartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer);
 		virtual int UartClose(unsigned char channel);
 		
@@ -140,24 +175,46 @@ class LinxRaspberryPi : public LinxDevice
 		virtual int ServoOpen(unsigned char numChans, unsigned char* chans);
 		virtual int ServoSetPulseWidth(unsigned char numChans, unsigned char* chans, unsigned short* pulseWidths);
 		virtual int ServoClose(unsigned char numChans, unsigned char* chans);		
+		virtual int SoftPwmGetStats(LinxSoftPwmStats* stats, unsigned char reset);
 		
 		//General - 
 		virtual unsigned long GetMilliSeconds();
 		virtual unsigned long GetSeconds();
+		virtual unsigned long long GetMicroSeconds();
+		virtual unsigned long long GetNanoSeconds();
 		virtual void DelayMs(unsigned long ms);
 		virtual void NonVolatileWrite(int address, unsigned char data);
 		virtual unsigned char NonVolatileRead(int address);
+		virtual int NonVolatileWriteBlock(int address, unsigned char numBytes, const unsigned char* data);
+		virtual int NonVolatileReadBlock(int address, unsigned char numBytes, unsigned char* data);
+		virtual int NonVolatileCommit();
+		void PrintStartupTiming();
 		
 	protected:
 		/****************************************************************************************
 		**  Variables
 		****************************************************************************************/		
+		unsigned long long StartupMark;												//End Of The Last Timed Construction Step (uS)
 				
 		/****************************************************************************************
 		**  Functions
 		****************************************************************************************/
 		virtual int digitalSmartOpen(unsigned char numChans, unsigned char* channels);
+		void startupPhase(const char* name);
+		void bindDigitalSlots(const LinxChannelSlots* slots);
+		void bindPwmSlots(const LinxChannelSlots* pwmSlots, const LinxChannelSlots* outputSlots);		//outputSlots Also Covers Digital Channels Run By The Software Scheduler
+		void bindUartSlots(const LinxChannelSlots* slots);
+		void bindSpiSlots(const LinxChannelSlots* slots);
+		void bindI2cSlots(const LinxChannelSlots* slots);
 		virtual int pwmSmartOpen(unsigned char numChans, unsigned char* channels);
+		int pwmWrite(int handle, unsigned long value);
+		int softPwmOpen(unsigned char channel, unsigned long period);
+		int softPwmClose(unsigned char channel);
+		virtual void digitalRelease(unsigned char channel);
+		virtual void digitalRestore(unsigned char channel);
+		int spiWriteMode(unsigned char channel, unsigned char mode);
+		virtual int spiIoctl(unsigned char channel, unsigned long request, void* arg);		//All spidev ioctls Go Through Here
+		int i2cTransfer(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* buffer, bool isRead);
 		bool fileExists(const char* path);
 		bool fileExists(const char* directory, const char* fileName);
 		bool fileExists(const char* directory, const char* fileName, unsigned long timout);
@@ -0,0 +1,237 @@
+/****************************************************************************************
+**  LINX Linux real-time execution profile.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#ifndef _GNU_SOURCE
+	#define _GNU_SOURCE
+#endif
+
+#include "LinxDevice.h"
+#include "LinxRealTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <malloc.h>
+#include <sys/mman.h>
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+int LinxRealTime::SetPriority(int priority)
+{
+	struct sched_param param;
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = priority;
+
+	if(sched_setscheduler(0, SCHED_FIFO, &param) != 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	return L_OK;
+}
+
+int LinxRealTime::SetAffinity(const char* cpuList)
+{
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+
+	const char* next = cpuList;
+	while(*next != '\0')
+	{
+		char* end;
+		long first = strtol(next, &end, 10);
+		long last = first;
+		if(end == next || first < 0 || first >= CPU_SETSIZE)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+		if(*end == '-')
+		{
+			next = end + 1;
+			last = strtol(next, &end, 10);
+			if(end == next || last < first || last >= CPU_SETSIZE)
+			{
+				return L_UNKNOWN_ERROR;
+			}
+		}
+		for(long cpu=first; cpu<=last; cpu++)
+		{
+			CPU_SET(cpu, &cpus);
+		}
+
+		if(*end == ',')
+		{
+			end++;
+		}
+		else if(*end != '\0')
+		{
+			return L_UNKNOWN_ERROR;
+		}
+		next = end;
+	}
+
+	if(CPU_COUNT(&cpus) == 0 || sched_setaffinity(0, sizeof(cpus), &cpus) != 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	return L_OK;
+}
+
+//Lock Current And Future Pages, Then Touch Stack And Heap So Command Handling Never Page Faults
+int LinxRealTime::LockMemory()
+{
+	if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	//Keep Freed Heap Memory In The Process Instead Of Returning It To The Kernel
+	mallopt(M_TRIM_THRESHOLD, -1);
+	mallopt(M_MMAP_MAX, 0);
+
+	volatile unsigned char stack[RT_PREFAULT_STACK];
+	for(int i=0; i<RT_PREFAULT_STACK; i+=4096)
+	{
+		stack[i] = 0;
+	}
+	(void)stack;
+
+	unsigned char* heap = (unsigned char*)malloc(RT_PREFAULT_HEAP);
+	if(heap != NULL)
+	{
+		memset(heap, 0, RT_PREFAULT_HEAP);
+		free(heap);
+	}
+	return L_OK;
+}
+
+//Sleep To Absolute Deadlines And Record How Late Each Wake Up Is
+void LinxRealTime::MeasureLatency(unsigned long numLoops, unsigned long interval, LinxLatencyStats* stats)
+{
+	memset(stats, 0, sizeof(LinxLatencyStats));
+	stats->latencyMin = 0xFFFFFFFF;
+	unsigned long long latencySum = 0;
+
+	struct timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	for(unsigned long i=0; i<numLoops; i++)
+	{
+		deadline.tv_nsec += interval;
+		while(deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_nsec -= 1000000000;
+			deadline.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		long long late = (long long)(now.tv_sec - deadline.tv_sec) * 1000000000LL + (now.tv_nsec - deadline.tv_nsec);
+		unsigned long latency = (late > 0) ? (unsigned long)late : 0;
+
+		if(latency < stats->latencyMin)
+		{
+			stats->latencyMin = latency;
+		}
+		if(latency > stats->latencyMax)
+		{
+			stats->latencyMax = latency;
+		}
+		latencySum += latency;
+
+		int bucket = 0;
+		while(bucket < RT_HIST_BUCKETS - 1 && latency >= (1000UL << bucket))
+		{
+			bucket++;
+		}
+		stats->histogram[bucket]++;
+		stats->numSamples++;
+	}
+
+	if(stats->numSamples > 0)
+	{
+		stats->latencyMean = latencySum / stats->numSamples;
+	}
+	else
+	{
+		stats->latencyMin = 0;
+	}
+}
+
+void LinxRealTime::PrintLatency(const LinxLatencyStats* stats)
+{
+	fprintf(stdout, "Latency over %lu wake ups: min %lu uS, mean %lu uS, max %lu uS\n", stats->numSamples, stats->latencyMin / 1000, stats->latencyMean / 1000, stats->latencyMax / 1000);
+	for(int i=0; i<RT_HIST_BUCKETS; i++)
+	{
+		if(stats->histogram[i] == 0)
+		{
+			continue;
+		}
+		if(i < RT_HIST_BUCKETS - 1)
+		{
+			fprintf(stdout, "  < %5lu uS: %lu\n", 1UL << i, stats->histogram[i]);
+		}
+		else
+		{
+			fprintf(stdout, "  >=%5lu uS: %lu\n", 1UL << (i - 1), stats->histogram[i]);
+		}
+	}
+}
+
+int LinxRealTime::Start(int priority, const char* cpuList)
+{
+	int status = L_OK;
+
+	if(cpuList != NULL)
+	{
+		if(SetAffinity(cpuList) == L_OK)
+		{
+			fprintf(stdout, "Pinned to CPU %s\n", cpuList);
+		}
+		else
+		{
+			fprintf(stdout, "Unable to pin to CPU %s\n", cpuList);
+			status = L_UNKNOWN_ERROR;
+		}
+	}
+
+	if(priority > 0)
+	{
+		if(SetPriority(priority) == L_OK)
+		{
+			fprintf(stdout, "Running SCHED_FIFO priority %d\n", priority);
+		}
+		else
+		{
+			fprintf(stdout, "Unable to set SCHED_FIFO priority %d (needs CAP_SYS_NICE)\n", priority);
+			status = L_UNKNOWN_ERROR;
+		}
+
+		if(LockMemory() == L_OK)
+		{
+			fprintf(stdout, "Memory locked\n");
+		}
+		else
+		{
+			fprintf(stdout, "Unable to lock memory (needs CAP_IPC_LOCK)\n");
+			status = L_UNKNOWN_ERROR;
+		}
+	}
+
+	LinxLatencyStats stats;
+	MeasureLatency(RT_TEST_LOOPS, RT_TEST_INTERVAL_NS, &stats);
+	PrintLatency(&stats);
+
+	return status;
+}
@@ -0,0 +1,56 @@
+/****************************************************************************************
+**  LINX header for the Linux real-time execution profile.
+**
+**  Moves the listener to SCHED_FIFO, pins it to chosen cores, locks and pre-faults its
+**  memory, then measures timer wake up latency the way cyclictest does.  Threads created
+**  afterwards inherit the CPU affinity.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_REALTIME_H
+#define LINX_REALTIME_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define RT_DEFAULT_PRIORITY 70							//Below The Software PWM Scheduler
+#define RT_PREFAULT_STACK 262144						//Stack Touched Before Locking (Bytes)
+#define RT_PREFAULT_HEAP 1048576						//Heap Touched And Kept After Locking (Bytes)
+#define RT_TEST_LOOPS 1000									//Wake Ups Measured By The Self Test
+#define RT_TEST_INTERVAL_NS 1000000						//Sleep Between Wake Ups (nS)
+#define RT_HIST_BUCKETS 13									//Powers Of Two From 1 uS, Last Bucket Holds The Rest
+
+/****************************************************************************************
+**  Typedefs
+****************************************************************************************/
+typedef struct LinxLatencyStats
+{
+	unsigned long numSamples;
+	unsigned long latencyMin;							//nS
+	unsigned long latencyMax;							//nS
+	unsigned long latencyMean;							//nS
+	unsigned long histogram[RT_HIST_BUCKETS];		//Bucket n Counts Latencies Under 2^n uS
+}LinxLatencyStats;
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+class LinxRealTime
+{
+	public:
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		static int SetPriority(int priority);											//SCHED_FIFO For The Calling Thread
+		static int SetAffinity(const char* cpuList);									//ie "3", "2,3" Or "1-3"
+		static int LockMemory();
+		static void MeasureLatency(unsigned long numLoops, unsigned long interval, LinxLatencyStats* stats);
+		static void PrintLatency(const LinxLatencyStats* stats);
+		static int Start(int priority, const char* cpuList);						//All Of The Above, priority 0 Keeps SCHED_OTHER, cpuList NULL Keeps All Cores
+};
+
+#endif //LINX_REALTIME_H
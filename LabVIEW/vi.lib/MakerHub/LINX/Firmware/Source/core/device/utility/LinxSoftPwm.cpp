@@ -0,0 +1,517 @@
+/****************************************************************************************
+**  LINX Linux software PWM / servo scheduler.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "LinxDevice.h"
+#include "LinxSoftPwm.h"
+
+#include <time.h>
+#include <sched.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+using namespace std;
+
+/****************************************************************************************
+**  Constructors /  Destructor
+****************************************************************************************/
+LinxSoftPwm::LinxSoftPwm(const char* chipPath)
+{
+	ChipPath = chipPath;
+	LineHandle = -1;
+	Started = false;
+	Running = false;
+	pthread_mutex_init(&Lock, NULL);
+	Stats.realTime = 0;
+	resetStats();
+}
+
+//Subclasses Overriding The Line Functions Must Call Close() In Their Own Destructor
+LinxSoftPwm::~LinxSoftPwm()
+{
+	Close();
+	pthread_mutex_destroy(&Lock);
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+int LinxSoftPwm::AddChannel(unsigned char channel, unsigned int line, unsigned long period)
+{
+	if(HasChannel(channel))
+	{
+		return L_OK;
+	}
+	if(period == 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	pthread_mutex_lock(&Lock);
+
+	if(Chans.size() >= SOFT_PWM_MAX_CHANS)
+	{
+		pthread_mutex_unlock(&Lock);
+		return L_UNKNOWN_ERROR;
+	}
+
+	SoftPwmChan chan;
+	chan.channel = channel;
+	chan.line = line;
+	chan.period = period;
+	chan.highTime = 0;
+	chan.newPeriod = period;
+	chan.newHighTime = 0;
+	chan.falling = false;
+	chan.level = 0;
+	chan.endTime = 0;
+
+	//Share Cycle Starts With A Channel Of The Same Period So Their Rising Edges Go Out In One Write.
+	//That Start Is Never Before The Edge The Thread Is Sleeping Towards.
+	chan.cycleStart = monotonicNs() + SOFT_PWM_START_NS;
+	for(unsigned int i=0; i<Chans.size(); i++)
+	{
+		if(Chans[i].period == period && Chans[i].nextEdge != SOFT_PWM_PARKED)
+		{
+			chan.cycleStart = Chans[i].falling ? Chans[i].cycleStart + Chans[i].period : Chans[i].cycleStart;
+			break;
+		}
+	}
+	chan.nextEdge = chan.cycleStart;
+
+	Chans.push_back(chan);
+	int status = updateLines();
+	if(status != L_OK)
+	{
+		Chans.pop_back();
+		updateLines();
+	}
+
+	pthread_mutex_unlock(&Lock);
+
+	if(status != L_OK)
+	{
+		return status;
+	}
+	return start();
+}
+
+int LinxSoftPwm::RemoveChannel(unsigned char channel)
+{
+	pthread_mutex_lock(&Lock);
+
+	for(unsigned int i=0; i<Chans.size(); i++)
+	{
+		if(Chans[i].channel == channel)
+		{
+			Chans.erase(Chans.begin() + i);
+			break;
+		}
+	}
+	int status = updateLines();
+	bool empty = Chans.empty();
+
+	pthread_mutex_unlock(&Lock);
+
+	if(empty)
+	{
+		stop();
+	}
+	return status;
+}
+
+bool LinxSoftPwm::HasChannel(unsigned char channel)
+{
+	bool found = false;
+
+	pthread_mutex_lock(&Lock);
+	for(unsigned int i=0; i<Chans.size(); i++)
+	{
+		if(Chans[i].channel == channel)
+		{
+			found = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&Lock);
+
+	return found;
+}
+
+//Takes Effect At The Channel's Next Cycle Start
+int LinxSoftPwm::SetPulse(unsigned char channel, unsigned long period, unsigned long highTime)
+{
+	if(period == 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	int status = L_UNKNOWN_ERROR;
+
+	pthread_mutex_lock(&Lock);
+	for(unsigned int i=0; i<Chans.size(); i++)
+	{
+		if(Chans[i].channel == channel)
+		{
+			Chans[i].newPeriod = period;
+			Chans[i].newHighTime = highTime;
+			Chans[i].endTime = 0;
+			
+			//A Timed Waveform Ended On This Channel, Start Cycling Again
+			if(Chans[i].nextEdge == SOFT_PWM_PARKED)
+			{
+				Chans[i].cycleStart = monotonicNs() + SOFT_PWM_START_NS;
+				Chans[i].nextEdge = Chans[i].cycleStart;
+			}
+			status = L_OK;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&Lock);
+
+	return status;
+}
+
+//Drop The Rest Of The Current Cycle And Start A New Waveform.  duration Is In nS, 0 Runs Until Changed.
+int LinxSoftPwm::Restart(unsigned char channel, unsigned long period, unsigned long highTime, unsigned long long duration)
+{
+	if(period == 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	int status = L_UNKNOWN_ERROR;
+
+	pthread_mutex_lock(&Lock);
+	for(unsigned int i=0; i<Chans.size(); i++)
+	{
+		if(Chans[i].channel == channel)
+		{
+			SoftPwmChan& chan = Chans[i];
+
+			//Low Until The New Waveform Starts
+			if(chan.level)
+			{
+				writeLines(1ULL << i, 0);
+				chan.level = 0;
+			}
+
+			chan.period = period;
+			chan.highTime = highTime;
+			chan.newPeriod = period;
+			chan.newHighTime = highTime;
+			chan.falling = false;
+			chan.cycleStart = monotonicNs() + SOFT_PWM_START_NS;
+			chan.nextEdge = chan.cycleStart;
+			chan.endTime = (duration == 0) ? 0 : chan.cycleStart + duration;
+			status = L_OK;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&Lock);
+
+	return status;
+}
+
+void LinxSoftPwm::GetStats(LinxSoftPwmStats* stats, bool reset)
+{
+	pthread_mutex_lock(&Lock);
+	*stats = Stats;
+	if(reset)
+	{
+		resetStats();
+	}
+	pthread_mutex_unlock(&Lock);
+}
+
+//Stop The Thread And Release All Lines
+void LinxSoftPwm::Close()
+{
+	stop();
+
+	pthread_mutex_lock(&Lock);
+	Chans.clear();
+	releaseLines();
+	pthread_mutex_unlock(&Lock);
+}
+
+//Request All Lines As Outputs In One Line Request, Starting At The Given Levels
+int LinxSoftPwm::requestLines(const unsigned int* lines, const unsigned char* levels, int numLines)
+{
+	releaseLines();
+	if(numLines == 0)
+	{
+		return L_OK;
+	}
+
+	int chipHandle = open(ChipPath.c_str(), O_RDWR | O_CLOEXEC);
+	if(chipHandle < 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+
+	struct gpio_v2_line_request request;
+	memset(&request, 0, sizeof(request));
+	unsigned long long values = 0;
+	for(int i=0; i<numLines; i++)
+	{
+		request.offsets[i] = lines[i];
+		if(levels[i])
+		{
+			values |= 1ULL << i;
+		}
+	}
+	strcpy(request.consumer, "linx-soft-pwm");
+	request.num_lines = numLines;
+	request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+	request.config.num_attrs = 1;
+	request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+	request.config.attrs[0].attr.values = values;
+	request.config.attrs[0].mask = (numLines == SOFT_PWM_MAX_CHANS) ? ~0ULL : (1ULL << numLines) - 1;
+
+	int status = ioctl(chipHandle, GPIO_V2_GET_LINE_IOCTL, &request);
+	close(chipHandle);
+	if(status < 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	LineHandle = request.fd;
+
+	return L_OK;
+}
+
+void LinxSoftPwm::releaseLines()
+{
+	if(LineHandle >= 0)
+	{
+		close(LineHandle);
+		LineHandle = -1;
+	}
+}
+
+int LinxSoftPwm::writeLines(unsigned long long mask, unsigned long long bits)
+{
+	struct gpio_v2_line_values values;
+	values.bits = bits;
+	values.mask = mask;
+	if(LineHandle < 0 || ioctl(LineHandle, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0)
+	{
+		return L_UNKNOWN_ERROR;
+	}
+	return L_OK;
+}
+
+unsigned long long LinxSoftPwm::monotonicNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+void* LinxSoftPwm::pwmThread(void* arg)
+{
+	((LinxSoftPwm*)arg)->run();
+	return NULL;
+}
+
+void LinxSoftPwm::run()
+{
+	pthread_mutex_lock(&Lock);
+
+	while(Running)
+	{
+		//Sleep Until The Earliest Edge, Or Briefly If None Is Close
+		unsigned long long target = monotonicNs() + SOFT_PWM_IDLE_NS;
+		for(unsigned int i=0; i<Chans.size(); i++)
+		{
+			if(Chans[i].nextEdge < target)
+			{
+				target = Chans[i].nextEdge;
+			}
+		}
+
+		pthread_mutex_unlock(&Lock);
+
+		struct timespec deadline;
+		deadline.tv_sec = target / 1000000000ULL;
+		deadline.tv_nsec = target % 1000000000ULL;
+		while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+		{
+		}
+		unsigned long long now = monotonicNs();
+
+		pthread_mutex_lock(&Lock);
+
+		//Every Edge Due By The End Of This Tick Goes Out In One Write
+		unsigned long long due = ((now > target) ? now : target) + SOFT_PWM_TICK_NS;
+		unsigned long long mask = 0;
+		unsigned long long bits = 0;
+		unsigned long numEdges = 0;
+		for(unsigned int i=0; i<Chans.size(); i++)
+		{
+			if(Chans[i].nextEdge <= due)
+			{
+				unsigned char previous = Chans[i].level;
+				if(nextEdge(Chans[i], now) != previous)
+				{
+					mask |= 1ULL << i;
+					if(Chans[i].level)
+					{
+						bits |= 1ULL << i;
+					}
+					numEdges++;
+				}
+			}
+		}
+
+		if(mask != 0)
+		{
+			writeLines(mask, bits);
+
+			unsigned long latency = (now > target) ? (unsigned long)(now - target) : 0;
+			if(Stats.numWakeups == 0 || latency < Stats.latencyMin)
+			{
+				Stats.latencyMin = latency;
+			}
+			if(latency > Stats.latencyMax)
+			{
+				Stats.latencyMax = latency;
+			}
+			Stats.numWakeups++;
+			Stats.numEdges += numEdges;
+			LatencySum += latency;
+			Stats.latencyMean = (unsigned long)(LatencySum / Stats.numWakeups);
+		}
+	}
+
+	pthread_mutex_unlock(&Lock);
+}
+
+//Advance A Channel Past Its Due Edge And Return The Level It Now Drives
+unsigned char LinxSoftPwm::nextEdge(SoftPwmChan& chan, unsigned long long now)
+{
+	if(chan.falling)
+	{
+		chan.level = 0;
+		chan.falling = false;
+		chan.cycleStart += chan.period;
+		chan.nextEdge = chan.cycleStart;
+		return chan.level;
+	}
+
+	//Cycle Start - Pick Up New Settings
+	chan.period = chan.newPeriod;
+	chan.highTime = chan.newHighTime;
+
+	//Stalled For More Than A Cycle, Restart From Now Rather Than Bursting To Catch Up
+	if(chan.cycleStart + chan.period < now)
+	{
+		chan.cycleStart = now;
+	}
+
+	//Timed Waveform Finished - Park Low Until Restarted
+	if(chan.endTime != 0 && chan.cycleStart >= chan.endTime)
+	{
+		chan.level = 0;
+		chan.nextEdge = SOFT_PWM_PARKED;
+		return chan.level;
+	}
+
+	if(chan.highTime == 0 || chan.highTime >= chan.period)
+	{
+		//0% Or 100% - No Falling Edge This Cycle
+		chan.level = (chan.highTime == 0) ? 0 : 1;
+		chan.cycleStart += chan.period;
+		chan.nextEdge = chan.cycleStart;
+	}
+	else
+	{
+		chan.level = 1;
+		chan.falling = true;
+		chan.nextEdge = chan.cycleStart + chan.highTime;
+	}
+	return chan.level;
+}
+
+//Re-request The Lines After The Channel Set Changed, Keeping Each Line At Its Current Level
+int LinxSoftPwm::updateLines()
+{
+	unsigned int lines[SOFT_PWM_MAX_CHANS];
+	unsigned char levels[SOFT_PWM_MAX_CHANS];
+	for(unsigned int i=0; i<Chans.size(); i++)
+	{
+		lines[i] = Chans[i].line;
+		levels[i] = Chans[i].level;
+	}
+
+	return requestLines(lines, levels, Chans.size());
+}
+
+int LinxSoftPwm::start()
+{
+	if(Started)
+	{
+		return L_OK;
+	}
+
+	Running = true;
+
+	//Real Time Priority Needs CAP_SYS_NICE, Otherwise Fall Back To Normal Scheduling
+	pthread_attr_t attr;
+	struct sched_param param;
+	pthread_attr_init(&attr);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+	param.sched_priority = SOFT_PWM_PRIORITY;
+	pthread_attr_setschedparam(&attr, &param);
+
+	int status = pthread_create(&Thread, &attr, pwmThread, this);
+	pthread_attr_destroy(&attr);
+	Stats.realTime = (status == 0) ? 1 : 0;
+	if(status != 0 && pthread_create(&Thread, NULL, pwmThread, this) != 0)
+	{
+		Running = false;
+		return L_UNKNOWN_ERROR;
+	}
+	Started = true;
+
+	return L_OK;
+}
+
+void LinxSoftPwm::stop()
+{
+	if(!Started)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&Lock);
+	Running = false;
+	pthread_mutex_unlock(&Lock);
+
+	pthread_join(Thread, NULL);
+	Started = false;
+}
+
+void LinxSoftPwm::resetStats()
+{
+	Stats.numWakeups = 0;
+	Stats.numEdges = 0;
+	Stats.latencyMin = 0;
+	Stats.latencyMax = 0;
+	Stats.latencyMean = 0;
+	LatencySum = 0;
+}
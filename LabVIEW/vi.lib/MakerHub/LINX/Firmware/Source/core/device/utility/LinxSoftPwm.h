@@ -0,0 +1,114 @@
+/****************************************************************************************
+**  LINX header for the Linux software PWM / servo scheduler.
+**
+**  Generates PWM on any GPIO line from a SCHED_FIFO thread.  The thread sleeps on
+**  absolute CLOCK_MONOTONIC deadlines and every channel edge due in the same tick is
+**  written with one multi-line GPIO character device write.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_SOFTPWM_H
+#define LINX_SOFTPWM_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define SOFT_PWM_MAX_CHANS 64							//Lines In One GPIO Line Request
+#define SOFT_PWM_PRIORITY 80								//SCHED_FIFO Priority Of The Scheduler Thread
+#define SOFT_PWM_TICK_NS 20000							//Edges Due Within This Of Each Other Are Written Together (nS)
+#define SOFT_PWM_MIN_PERIOD_NS (2 * SOFT_PWM_TICK_NS)	//Shortest Period Whose High And Low Edges Are Not Merged (nS)
+#define SOFT_PWM_IDLE_NS 5000000						//Longest Sleep, So Channel Changes And Stop Are Noticed (nS)
+#define SOFT_PWM_START_NS 10000000						//Delay Before A New Channel's First Cycle (nS)
+#define SOFT_PWM_PARKED 0xFFFFFFFFFFFFFFFFULL			//nextEdge Of A Channel With Nothing Scheduled
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "LinxDevice.h"
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+class LinxSoftPwm
+{
+	public:
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxSoftPwm(const char* chipPath);
+		virtual ~LinxSoftPwm();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		int AddChannel(unsigned char channel, unsigned int line, unsigned long period);
+		int RemoveChannel(unsigned char channel);
+		bool HasChannel(unsigned char channel);
+		int SetPulse(unsigned char channel, unsigned long period, unsigned long highTime);
+		int Restart(unsigned char channel, unsigned long period, unsigned long highTime, unsigned long long duration);
+		void GetStats(LinxSoftPwmStats* stats, bool reset);
+		void Close();
+
+	protected:
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		virtual int requestLines(const unsigned int* lines, const unsigned char* levels, int numLines);
+		virtual void releaseLines();
+		virtual int writeLines(unsigned long long mask, unsigned long long bits);		//Bit n Is The nth Requested Line
+		static unsigned long long monotonicNs();
+
+	private:
+		/****************************************************************************************
+		**  Types
+		****************************************************************************************/
+		typedef struct SoftPwmChan
+		{
+			unsigned char channel;							//LINX Channel Number
+			unsigned int line;								//Offset On The GPIO Chip
+			unsigned long period;							//Current Cycle (nS)
+			unsigned long highTime;							//Current Cycle (nS)
+			unsigned long newPeriod;						//Applied At The Next Cycle Start So Pulses Are Never Cut Short
+			unsigned long newHighTime;
+			unsigned long long cycleStart;				//CLOCK_MONOTONIC Start Of The Current Or Next Cycle (nS)
+			unsigned long long nextEdge;					//SOFT_PWM_PARKED Once A Timed Waveform Has Ended
+			unsigned long long endTime;					//No Cycle Starts At Or After This (0 = Run Until Changed)
+			bool falling;										//nextEdge Ends The Pulse, Otherwise It Starts A Cycle
+			unsigned char level;
+		}SoftPwmChan;
+
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		string ChipPath;										//GPIO Character Device, ie /dev/gpiochip0
+		int LineHandle;										//Line Request For All Channels
+		vector<SoftPwmChan> Chans;							//In Line Request Order
+		bool Started;											//Thread Created And Not Yet Joined
+		bool Running;
+		pthread_t Thread;
+		pthread_mutex_t Lock;
+		LinxSoftPwmStats Stats;
+		unsigned long long LatencySum;
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		static void* pwmThread(void* arg);
+		void run();
+		unsigned char nextEdge(SoftPwmChan& chan, unsigned long long now);
+		int updateLines();
+		int start();
+		void stop();
+		void resetStats();
+};
+
+#endif //LINX_SOFTPWM_H
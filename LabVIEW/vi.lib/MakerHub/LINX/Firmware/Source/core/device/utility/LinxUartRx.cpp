@@ -0,0 +1,331 @@
+/****************************************************************************************
+**  LINX Linux UART receive thread.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "LinxDevice.h"
+#include "LinxUartRx.h"
+
+#include <new>
+#include <time.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+
+using namespace std;
+
+/****************************************************************************************
+**  Constructors /  Destructor
+****************************************************************************************/
+LinxUartRx::LinxUartRx()
+{
+	Handle = -1;
+	WakePipe[0] = -1;
+	WakePipe[1] = -1;
+	Started = false;
+	Running = false;
+	Buffer = NULL;
+	BufferSize = 0;
+	Head = 0;
+	Count = 0;
+	PositionOut = 0;
+	Overrun = false;
+	KernelOverruns = -1;
+}
+
+LinxUartRx::~LinxUartRx()
+{
+	Stop();
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+int LinxUartRx::Start(int handle, unsigned long bufferSize)
+{
+	if(Started)
+	{
+		return L_OK;
+	}
+
+	if(bufferSize == 0)
+	{
+		bufferSize = UART_RX_DEFAULT_BUFFER_SIZE;
+	}
+	else if(bufferSize > UART_RX_MAX_BUFFER_SIZE)
+	{
+		return LUART_OPEN_FAIL;
+	}
+
+	if(pipe(WakePipe) < 0)
+	{
+		return LUART_OPEN_FAIL;
+	}
+
+	//Lock And DataReady Are Not Initialized Yet So Stop() Cannot Clean Up Here
+	Buffer = new (nothrow) unsigned char[bufferSize];
+	if(Buffer == NULL)
+	{
+		close(WakePipe[0]);
+		close(WakePipe[1]);
+		WakePipe[0] = -1;
+		WakePipe[1] = -1;
+		return LUART_OPEN_FAIL;
+	}
+
+	Handle = handle;
+	BufferSize = bufferSize;
+	Head = 0;
+	Count = 0;
+	PositionOut = 0;
+	Chunks.clear();
+	Overrun = false;
+	KernelOverruns = kernelOverruns();
+
+	//Timed Waits Use The Monotonic Clock So Wall Clock Changes Do Not Stretch Timeouts
+	pthread_condattr_t condAttr;
+	pthread_condattr_init(&condAttr);
+	pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+	pthread_cond_init(&DataReady, &condAttr);
+	pthread_condattr_destroy(&condAttr);
+	pthread_mutex_init(&Lock, NULL);
+
+	Running = true;
+	if(pthread_create(&Thread, NULL, rxThread, this) != 0)
+	{
+		Running = false;
+		Stop();
+		return LUART_OPEN_FAIL;
+	}
+	Started = true;
+
+	return L_OK;
+}
+
+void LinxUartRx::Stop()
+{
+	//The Thread May Already Have Exited On Its Own, It Still Needs Joining
+	if(Started)
+	{
+		unsigned char wake = 0;
+		if(write(WakePipe[1], &wake, 1) == 1)
+		{
+			pthread_join(Thread, NULL);
+		}
+		Started = false;
+		Running = false;
+	}
+
+	if(WakePipe[0] >= 0)
+	{
+		close(WakePipe[0]);
+		close(WakePipe[1]);
+		WakePipe[0] = -1;
+		WakePipe[1] = -1;
+		pthread_cond_destroy(&DataReady);
+		pthread_mutex_destroy(&Lock);
+	}
+
+	delete[] Buffer;
+	Buffer = NULL;
+	BufferSize = 0;
+	Count = 0;
+	Chunks.clear();
+}
+
+unsigned long LinxUartRx::Available()
+{
+	pthread_mutex_lock(&Lock);
+	unsigned long available = Count;
+	pthread_mutex_unlock(&Lock);
+
+	return available;
+}
+
+//Wait Up To timeout mS For numBytes, Then Return Whatever Is Buffered Up To numBytes
+unsigned long LinxUartRx::Read(unsigned char* recBuffer, unsigned long numBytes, unsigned long timeout, unsigned long long* timestamp, bool* overrun)
+{
+	pthread_mutex_lock(&Lock);
+
+	if(Count < numBytes && timeout > 0)
+	{
+		struct timespec deadline;
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += timeout / 1000;
+		deadline.tv_nsec += (timeout % 1000) * 1000000;
+		if(deadline.tv_nsec >= 1000000000)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000;
+		}
+
+		while(Count < numBytes && Running)
+		{
+			if(pthread_cond_timedwait(&DataReady, &Lock, &deadline) == ETIMEDOUT)
+			{
+				break;
+			}
+		}
+	}
+
+	unsigned long numRead = (Count < numBytes) ? Count : numBytes;
+
+	//Timestamp Of The Chunk Holding The First Byte Returned
+	while(Chunks.size() > 1 && Chunks[1].position <= PositionOut)
+	{
+		Chunks.pop_front();
+	}
+	if(timestamp != NULL)
+	{
+		*timestamp = (numRead > 0 && !Chunks.empty()) ? Chunks.front().timestamp : 0;
+	}
+
+	//Copy Out Of The Ring, Wrapping At Most Once
+	unsigned long firstPart = BufferSize - Head;
+	if(firstPart > numRead)
+	{
+		firstPart = numRead;
+	}
+	memcpy(recBuffer, Buffer + Head, firstPart);
+	memcpy(recBuffer + firstPart, Buffer, numRead - firstPart);
+
+	Head = (Head + numRead) % BufferSize;
+	Count -= numRead;
+	PositionOut += numRead;
+
+	if(overrun != NULL)
+	{
+		*overrun = Overrun;
+	}
+	Overrun = false;
+
+	pthread_mutex_unlock(&Lock);
+
+	return numRead;
+}
+
+void* LinxUartRx::rxThread(void* arg)
+{
+	((LinxUartRx*)arg)->run();
+	return NULL;
+}
+
+void LinxUartRx::run()
+{
+	unsigned char chunk[UART_RX_CHUNK_SIZE];
+	struct pollfd fds[2];
+	fds[0].fd = Handle;
+	fds[0].events = POLLIN;
+	fds[1].fd = WakePipe[0];
+	fds[1].events = POLLIN;
+
+	while(true)
+	{
+		if(poll(fds, 2, -1) < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+
+		//Stop Requested Or tty Gone
+		if(fds[1].revents != 0 || (fds[0].revents & (POLLERR | POLLNVAL)))
+		{
+			break;
+		}
+		if(!(fds[0].revents & POLLIN))
+		{
+			continue;
+		}
+
+		int bytesRead = read(Handle, chunk, UART_RX_CHUNK_SIZE);
+		if(bytesRead <= 0)
+		{
+			if(bytesRead < 0 && (errno == EINTR || errno == EAGAIN))
+			{
+				continue;
+			}
+			break;
+		}
+
+		unsigned long long now = monotonicNs();
+		long kernelCount = kernelOverruns();
+
+		pthread_mutex_lock(&Lock);
+
+		//Ring Full - Keep What Fits And Flag The Rest As Lost
+		unsigned long accepted = (unsigned long)bytesRead;
+		if(accepted > BufferSize - Count)
+		{
+			accepted = BufferSize - Count;
+			Overrun = true;
+		}
+
+		//Driver Or Hardware FIFO Overran Before We Got To It
+		if(KernelOverruns >= 0 && kernelCount > KernelOverruns)
+		{
+			Overrun = true;
+		}
+		KernelOverruns = kernelCount;
+
+		if(accepted > 0)
+		{
+			unsigned long tail = (Head + Count) % BufferSize;
+			unsigned long firstPart = BufferSize - tail;
+			if(firstPart > accepted)
+			{
+				firstPart = accepted;
+			}
+			memcpy(Buffer + tail, chunk, firstPart);
+			memcpy(Buffer, chunk + firstPart, accepted - firstPart);
+
+			RxChunk rxChunk;
+			rxChunk.position = PositionOut + Count;
+			rxChunk.timestamp = now;
+			Chunks.push_back(rxChunk);
+
+			Count += accepted;
+		}
+
+		pthread_cond_broadcast(&DataReady);
+		pthread_mutex_unlock(&Lock);
+	}
+
+	//Wake Any Reader Waiting On A Thread That Has Exited
+	pthread_mutex_lock(&Lock);
+	Running = false;
+	pthread_cond_broadcast(&DataReady);
+	pthread_mutex_unlock(&Lock);
+}
+
+//Total Overruns Counted By The Serial Driver, -1 If The Driver Does Not Report Them (ptys, USB Adapters)
+long LinxUartRx::kernelOverruns()
+{
+	struct serial_icounter_struct counters;
+	if(ioctl(Handle, TIOCGICOUNT, &counters) < 0)
+	{
+		return -1;
+	}
+
+	return (long)counters.overrun + (long)counters.buf_overrun;
+}
+
+unsigned long long LinxUartRx::monotonicNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
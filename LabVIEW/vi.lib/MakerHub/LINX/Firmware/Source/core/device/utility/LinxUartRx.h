@@ -0,0 +1,90 @@
+/****************************************************************************************
+**  LINX header for the Linux UART receive thread.
+**
+**  Drains a tty into a ring buffer from a background thread so data is not lost in the
+**  kernel buffer between host polls.  Each chunk read from the tty is timestamped.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_UARTRX_H
+#define LINX_UARTRX_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define UART_RX_DEFAULT_BUFFER_SIZE 65536			//Ring Buffer Size Used When 0 Is Requested (Bytes)
+#define UART_RX_MAX_BUFFER_SIZE 4194304				//Largest Ring Buffer A Host May Request (Bytes)
+#define UART_RX_CHUNK_SIZE 4096						//Max Bytes Taken From The tty Per read()
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <pthread.h>
+#include <deque>
+
+using namespace std;
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+class LinxUartRx
+{
+	public:
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxUartRx();
+		~LinxUartRx();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		int Start(int handle, unsigned long bufferSize);
+		void Stop();
+		unsigned long Available();
+		unsigned long Read(unsigned char* recBuffer, unsigned long numBytes, unsigned long timeout, unsigned long long* timestamp, bool* overrun);
+
+	private:
+		/****************************************************************************************
+		**  Types
+		****************************************************************************************/
+		typedef struct RxChunk
+		{
+			unsigned long long position;					//Stream Position Of The First Byte In This Chunk
+			unsigned long long timestamp;				//CLOCK_MONOTONIC Time The Chunk Was Read (nS)
+		}RxChunk;
+
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		int Handle;												//tty File Handle (Owned By The Device)
+		int WakePipe[2];										//Written To Stop The Thread
+		bool Started;											//Thread Created And Not Yet Joined
+		bool Running;											//Thread Still Draining The tty
+		pthread_t Thread;
+		pthread_mutex_t Lock;
+		pthread_cond_t DataReady;
+
+		unsigned char* Buffer;								//Ring Buffer
+		unsigned long BufferSize;
+		unsigned long Head;									//Index Of The Oldest Byte
+		unsigned long Count;									//Bytes In The Ring
+		unsigned long long PositionOut;					//Stream Position Of The Oldest Byte
+		deque<RxChunk> Chunks;								//Timestamps Of The Chunks Still In The Ring
+		bool Overrun;											//Data Was Dropped Since The Last Read
+		long KernelOverruns;									//Last Driver Overrun Count (-1 If Unsupported)
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		static void* rxThread(void* arg);
+		void run();
+		long kernelOverruns();
+		static unsigned long long monotonicNs();
+};
+
+#endif //LINX_UARTRX_H
@@ -18,6 +18,8 @@
 ****************************************************************************************/	
 #include "LinxDevice.h"
 #include "LinxWiringDevice.h"
+#include "LinxBitPack.h"
+#include "LinxLog.h"
 
 #if ARDUINO_VERSION >= 100
 	#include <Arduino.h>
@@ -52,6 +54,10 @@ LinxWiringDevice::LinxWiringDevice()
 	LinxApiMinor = 0;
 	LinxApiSubminor = 0;
 	
+	SpiSpeed = 0;
+	MicrosLast = 0;
+	MicrosHigh = 0;
+	
 	//Load User Config Data From Non Volatile Storage
 	userId = NonVolatileRead(NVS_USERID) << 8 | NonVolatileRead(NVS_USERID + 1);
 	
@@ -77,46 +83,32 @@ unsigned long LinxWiringDevice::GetSeconds()
 	return (millis() / 1000);
 }
 
+//Extend micros() To 64 Bits By Counting Wraps.  Must Run At Least Once Per Wrap (~71 Minutes), The Listeners Call It Every Loop
+unsigned long long LinxWiringDevice::GetMicroSeconds()
+{
+	unsigned long now = micros();
+	if(now < MicrosLast)
+	{
+		MicrosHigh++;
+	}
+	MicrosLast = now;
+	return ((unsigned long long)MicrosHigh << 32) | now;
+}
+
 //--------------------------------------------------------ANALOG-------------------------------------------------------
 
 int LinxWiringDevice::AnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
 {
-	unsigned int analogValue = 0;
-	unsigned char responseByteOffset = 0;
-	unsigned char responseBitsRemaining = 8; 
-	unsigned char dataBitsRemaining = AiResolution;
-  
-	values[responseByteOffset] = 0x00;    //Clear First	Response Byte   
+	unsigned long analogValues[numChans];
 
 	//Loop Over All AI channels In Command Packet
 	for(int i=0; i<numChans; i++)
 	{
-		analogValue = analogRead(channels[i]);	
-		
-		dataBitsRemaining = AiResolution;
-
-		//Byte Packet AI Values In Response Packet
-		while(dataBitsRemaining > 0)
-		{
-			*(values+responseByteOffset) |= ( (analogValue>>(AiResolution - dataBitsRemaining)) << (8 - responseBitsRemaining) );
-			//*(values+responseByteOffset) = 69;
-
-			if(responseBitsRemaining > dataBitsRemaining)
-			{
-				//Current Byte Still Has Empty Bits
-				responseBitsRemaining -= dataBitsRemaining;
-				dataBitsRemaining = 0;
-			}
-			else
-			{
-				//Current Byte Full
-				dataBitsRemaining = dataBitsRemaining - responseBitsRemaining;
-				responseByteOffset++;
-				responseBitsRemaining = 8;
-				values[responseByteOffset] = 0x00;    //Clear Next Response Byte     
-			}
-		}
+		analogValues[i] = analogRead(channels[i]);
 	}
+
+	//Byte Packet AI Values In Response Packet
+	LinxBitPack::Pack(numChans, analogValues, AiResolution, values);
 	
 	return L_OK;
 }
@@ -179,10 +171,13 @@ int LinxWiringDevice::AnalogSetRef(unsigned char mode, unsigned long voltage)
 
 int LinxWiringDevice::DigitalWrite(unsigned char numChans, unsigned char* channels, unsigned char* values)
 {
+	unsigned char bits[numChans];
+	LinxBitPack::UnpackBits(numChans, values, bits);
+	
 	for(int i=0; i<numChans; i++)
 	{		
 		pinMode(channels[i], OUTPUT);
-		digitalWrite( channels[i], (values[i/8] >> i%8) & 0x01);
+		digitalWrite( channels[i], bits[i]);
 	}
 	
 	return L_OK;
@@ -190,36 +185,19 @@ int LinxWiringDevice::DigitalWrite(unsigned char numChans, unsigned char* channe
 
 int LinxWiringDevice::DigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values)
 {
-	unsigned char bitOffset = 8;
-	unsigned char byteOffset = 0;
-	unsigned char retVal = 0;
+	unsigned char bits[numChans];
  
 	//Loop Over channels To Read
 	for(int i=0; i<numChans; i++)
 	{
-		//If bitOffset Is 0 We Have To Start A New Byte, Store Old Byte And Increment OFfsets
-		if(bitOffset == 0)
-		{
-			//Insert retVal Into Response Buffer
-			values[byteOffset] = retVal;
-			retVal = 0x00;
-			byteOffset++;
-			bitOffset = 7;      
-		}
-		else
-		{
-			bitOffset--;
-		}
-		
 		//Read From Next Pin
 		unsigned char pinNumber = channels[i];
 			
 		pinMode(pinNumber, INPUT);											//Set Pin As Input (Might Make This Configurable)    		
-		retVal = retVal | (digitalRead(pinNumber) << bitOffset);	//Read Pin And Insert Value Into retVal
+		bits[i] = digitalRead(pinNumber);
 	}
 	
-	//Store Last Byte
-	values[byteOffset] = retVal;
+	LinxBitPack::PackBits(numChans, bits, values);
 	
 	return L_OK;
 }
@@ -338,6 +316,8 @@ int LinxWiringDevice::SpiSetMode(unsigned char channel, unsigned char mode)
 
 int LinxWiringDevice::SpiSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed)
 {
+	SpiSpeed = speed;
+	
 	//Loop Over All Supported SPI Speeds (SPI Speeds Should Be Fastest -> Slowest)
 	for(int index=0; index < NumSpiSpeeds; index++)
 	{
@@ -386,6 +366,63 @@ int LinxWiringDevice::SpiWriteRead(unsigned char channel, unsigned char frameSiz
 	return 0;
 }
 
+int LinxWiringDevice::SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments)
+{
+	unsigned long channelSpeed = SpiSpeed;
+	unsigned long actualSpeed = 0;
+	bool speedChanged = false;
+	
+	//Set CS Pin As DO And Idle
+	pinMode(csChan, OUTPUT);
+	digitalWrite(csChan, (~csLL & 0x01) );
+	
+	//CS Active For All Segments
+	digitalWrite(csChan, (csLL & 0x01) );
+	
+	for(int i=0; i<numSegments; i++)
+	{
+		if(segments[i].speed != 0)
+		{
+			SpiSetSpeed(channel, segments[i].speed, &actualSpeed);
+			speedChanged = true;
+		}
+		
+		for(int j=0; j<segments[i].numBytes; j++)
+		{
+			unsigned char txByte = (segments[i].type == SPI_SEGMENT_RX_ONLY) ? 0x00 : segments[i].sendBuffer[j];
+			unsigned char rxByte = SPI.transfer(txByte);
+			
+			if(segments[i].type != SPI_SEGMENT_TX_ONLY)
+			{
+				segments[i].recBuffer[j] = rxByte;
+			}
+		}
+		
+		if(segments[i].delayUs != 0)
+		{
+			delayMicroseconds(segments[i].delayUs);
+		}
+	}
+	
+	digitalWrite(csChan, (~csLL & 0x01) );
+	
+	//Restore Channel Clock Rate, Or The SPI.begin() Default If None Was Ever Set
+	if(speedChanged)
+	{
+		if(channelSpeed != 0)
+		{
+			SpiSetSpeed(channel, channelSpeed, &actualSpeed);
+		}
+		else
+		{
+			SPI.setClockDivider(SPI_CLOCK_DIV4);
+			SpiSpeed = 0;
+		}
+	}
+	
+	return L_OK;
+}
+
 //--------------------------------------------------------I2C-----------------------------------------------------------
 
 //Helper To Deal With Arduino API Changes
@@ -754,8 +791,7 @@ int LinxWiringDevice::ServoOpen(unsigned char numChans, unsigned char* chans)
 			Servos[pin] = new Servo();
 			Servos[pin]->attach(pin);
 			
-			DebugPrint("Created New Servo On Channel ");
-			DebugPrintln(pin, DEC);
+			LINX_LOG_DEBUG("Created New Servo On Channel %ld", (long)pin);
 		}
 	}
 	return L_OK;
@@ -767,10 +803,7 @@ int LinxWiringDevice::ServoSetPulseWidth(unsigned char numChans, unsigned char*
 	for(int i=0; i<numChans; i++)
 	{	
 		
-		DebugPrint("Servo ");
-		DebugPrint((unsigned long)Servos[chans[i]], DEC);
-		DebugPrint(" : ");
-		DebugPrintln(pulseWidths[i], DEC);
+		LINX_LOG_DEBUG("Servo %u : %u", chans[i], pulseWidths[i]);
 		Servos[chans[i]]->writeMicroseconds(pulseWidths[i]);		
 	}
 	
@@ -42,6 +42,7 @@ class LinxWiringDevice : public LinxDevice
 		unsigned char NumSpiSpeeds;					//Number Of Supported SPI Speeds
 		unsigned long* SpiSupportedSpeeds;			//Supported SPI Clock Frequencies
 		int* SpiSpeedCodes;									//SPI Speed Values (Clock Divider Macros In Wiring Case)
+		unsigned long SpiSpeed;								//Clock Rate Last Requested With SpiSetSpeed (0 = Not Set)
 		
 		unsigned char* I2cRefCount;						//Number Opens - Closes On I2C Channel
 		
@@ -74,6 +75,7 @@ class LinxWiringDevice : public LinxDevice
 		virtual int SpiSetMode(unsigned char channel, unsigned char mode);
 		virtual int SpiSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed);
 		virtual int SpiWriteRead(unsigned char channel, unsigned char frameSize, unsigned char numFrames, unsigned char csChan, unsigned char csLL, unsigned char* sendBuffer, unsigned char* recBuffer);
+		virtual int SpiTransaction(unsigned char channel, unsigned char csChan, unsigned char csLL, unsigned char numSegments, LinxSpiSegment* segments);
 		
 		//I2C
 		virtual int I2cOpenMaster(unsigned char channel);
@@ -98,6 +100,7 @@ class LinxWiringDevice : public LinxDevice
 		//General - 
 		virtual unsigned long GetMilliSeconds();
 		virtual unsigned long GetSeconds();
+		virtual unsigned long long GetMicroSeconds();		//Must Be Called At Least Once Every 71 Minutes To Catch micros() Wrapping
 		virtual void DelayMs(unsigned long ms);
 		virtual void NonVolatileWrite(int address, unsigned char data);
 		virtual unsigned char NonVolatileRead(int address);
@@ -115,6 +118,12 @@ class LinxWiringDevice : public LinxDevice
 		****************************************************************************************/
 		
 	private:
+	/****************************************************************************************
+	**  Variables
+	****************************************************************************************/
+	unsigned long MicrosLast;				//micros() At The Previous GetMicroSeconds() Call
+	unsigned long MicrosHigh;				//Number Of Times micros() Has Wrapped
+	
 	/****************************************************************************************
 	**  Functions
 	****************************************************************************************/
@@ -19,16 +19,19 @@
 #include "LinxBeagleBoneBlack.h"
 #include "LinxSerialListener.h"
 #include "LinxLinuxTcpListener.h"
+#include "LinxRealTime.h"
 
 //Helper Functions
 int parseInputTokens(LinxDevice* linxDev, int argc, char* argv[]);
 void printUsage(char* argv[], LinxDevice* linxDev);
 
-#define NUMTOKENS 10
-string tokens[NUMTOKENS] = {"-h", "-H", "--help", "--Help", "-v", "-V", "--version", "--Version", "-serial", "-tcp"};
+#define NUMTOKENS 12
+string tokens[NUMTOKENS] = {"-h", "-H", "--help", "--Help", "-v", "-V", "--version", "--Version", "-serial", "-tcp", "-rt", "-cpu"};
 
 int uartListenerPort = -1;
 int tcpListenerPort = -1;
+int rtPriority = 0;
+char* rtCpus = NULL;
 
 LinxBeagleBoneBlack* LinxDev;
 
@@ -39,6 +42,12 @@ int main(int argc, char* argv[])
 	
 	if(parseInputTokens(LinxDev, argc, argv) >= 0)
 	{	
+		//Real-Time Profile Is Opt In
+		if(rtPriority > 0 || rtCpus != NULL)
+		{
+			LinxRealTime::Start(rtPriority, rtCpus);
+		}
+		
 		if(uartListenerPort > -1 && tcpListenerPort > -1)
 		{
 			while(1)
@@ -153,6 +162,22 @@ int parseInputTokens(LinxDevice* linxDev, int argc, char* argv[])
 							LinxTcpConnection.Start(LinxDev, tcpListenerPort);
 						}
 						break;
+					case 10:	//-rt
+						rtPriority = RT_DEFAULT_PRIORITY;
+						if(i+1 < argc && atoi(argv[i+1]) > 0)
+						{
+							rtPriority = atoi(argv[i+1]);
+						}
+						break;
+					case 11:	//-cpu
+						if(i+1 >= argc)
+						{
+							cout << "\n"<< "Missing CPU list\n";
+							printUsage(argv, linxDev);
+							return -1;
+						}
+						rtCpus = argv[i+1];
+						break;
 					default:
 						break;
 				}
@@ -172,7 +197,8 @@ void printUsage(char* argv[], LinxDevice* linxDev)
 {
 	cout << "\nusage: " << argv[0] << " -serial [port]\n";
 	cout << "   or: " << argv[0] << " -serial [port] -tcp [port]\n";
-	cout << "   or: " << argv[0] << " -tcp [port]\n\n";
+	cout << "   or: " << argv[0] << " -tcp [port]\n";
+	cout << "   any of the above with: -rt [priority] -cpu [list]\n\n";
 	cout << "Available options are:\n";
 	cout << "  -serial\t " << (int)linxDev->UartChans[0];
 	for(int i = 1; i<linxDev->NumUartChans; i++)
@@ -180,5 +206,7 @@ void printUsage(char* argv[], LinxDevice* linxDev)
 		cout << ", " << (int)linxDev->UartChans[i];
 	}	
 	cout << "\n";
-	cout << "  -tcp  \t Any valid, unused TCP port. (ex 44300)\n\n";
+	cout << "  -tcp  \t Any valid, unused TCP port. (ex 44300)\n";
+	cout << "  -rt   \t Optional SCHED_FIFO priority, 1 - 99 (default " << RT_DEFAULT_PRIORITY << "). Locks memory and prints a latency self test.\n";
+	cout << "  -cpu  \t CPUs to pin the listener to. (ex 3 or 2-3)\n\n";
 }
\ No newline at end of file
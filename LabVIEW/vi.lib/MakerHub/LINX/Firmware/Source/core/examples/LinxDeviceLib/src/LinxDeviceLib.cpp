@@ -33,6 +33,12 @@
 			#include "LinxBeagleBone.h"
 			#include "LinxBeagleBoneBlack.h"
 	#endif
+//------------------------------------- Simulated -------------------------------------
+#elif LINX_DEVICE_FAMILY == 254
+	#if LINX_DEVICE_ID == 1
+			#define LINXDEVICETYPE LinxSimDevice
+			#include "LinxSimDevice.h"
+	#endif
 #endif
 
 LINXDEVICETYPE* LinxDev;
@@ -81,6 +87,16 @@ extern "C" unsigned long LinxGetMilliSeconds()
 	return LinxDev->GetMilliSeconds();
 }
 
+extern "C" unsigned long long LinxGetMicroSeconds()
+{
+	return LinxDev->GetMicroSeconds();
+}
+
+extern "C" unsigned long long LinxGetNanoSeconds()
+{
+	return LinxDev->GetNanoSeconds();
+}
+
 
 //------------------------------------- Analog -------------------------------------
 extern "C" unsigned long LinxAiGetRefSetVoltage()
@@ -155,6 +171,26 @@ extern "C" int LinxAnalogReadNoPacking(unsigned char numChans, unsigned char* ch
 	return LinxDev->AnalogReadNoPacking(numChans, channels, values);
 }	
 
+extern "C" int LinxAnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize)
+{
+	return LinxDev->AnalogStreamStart(numChans, channels, bufferSize);
+}
+
+extern "C" int LinxAnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead)
+{
+	return LinxDev->AnalogStreamReadNoPacking(numScans, timeout, values, numScansRead);
+}
+
+extern "C" int LinxAnalogStreamGetScansBuffered(unsigned long* numScans)
+{
+	return LinxDev->AnalogStreamGetScansBuffered(numScans);
+}
+
+extern "C" int LinxAnalogStreamStop()
+{
+	return LinxDev->AnalogStreamStop();
+}
+
 
 //------------------------------------- CAN -------------------------------------
 extern "C" unsigned char LinxCanGetNumChans()
@@ -220,6 +256,11 @@ extern "C" int LinxDigitalWriteNoPacking(unsigned char numChans, unsigned char*
 	return LinxDev->DigitalWriteNoPacking(numChans, channels, values);
 }
 
+extern "C" int LinxDigitalPrewarm(unsigned char numChans, unsigned char* channels)
+{
+	return LinxDev->DigitalPrewarm(numChans, channels);
+}
+
 
 
 //------------------------------------- I2C -------------------------------------
@@ -264,6 +305,11 @@ extern "C" int LinxI2cRead(unsigned char channel, unsigned char slaveAddress, un
 	return LinxDev->I2cRead(channel, slaveAddress, eofConfig, numBytes, timeout, recBuffer);
 }
 
+extern "C" int LinxI2cWriteRead(unsigned char channel, unsigned char slaveAddress, unsigned char numWriteBytes, unsigned char* sendBuffer, unsigned char numReadBytes, unsigned int timeout, unsigned char* recBuffer)
+{
+	return LinxDev->I2cWriteRead(channel, slaveAddress, numWriteBytes, sendBuffer, numReadBytes, timeout, recBuffer);
+}
+
 extern "C" int LinxI2cClose(unsigned char channel)
 {
 	return LinxDev->I2cClose(channel);
@@ -297,6 +343,11 @@ extern "C" int LinxPwmSetDutyCycle(unsigned char numChans, unsigned char* channe
 	return LinxDev->PwmSetDutyCycle(numChans, channels, values);
 }
 
+extern "C" int LinxPwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned long* values)
+{
+	return LinxDev->PwmSetFrequency(numChans, channels, values);
+}
+
 
 //------------------------------------- QE -------------------------------------
 extern "C" unsigned char LinxQeGetNumChans()
@@ -341,6 +392,37 @@ extern "C" int LinxServoGetChans(unsigned char numChans, unsigned char* channels
 	}
 }
 
+extern "C" int LinxServoOpen(unsigned char numChans, unsigned char* channels)
+{
+	return LinxDev->ServoOpen(numChans, channels);
+}
+
+extern "C" int LinxServoSetPulseWidth(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths)
+{
+	return LinxDev->ServoSetPulseWidth(numChans, channels, pulseWidths);
+}
+
+extern "C" int LinxServoClose(unsigned char numChans, unsigned char* channels)
+{
+	return LinxDev->ServoClose(numChans, channels);
+}
+
+extern "C" int LinxSoftPwmGetStats(unsigned long* numWakeups, unsigned long* numEdges, unsigned long* latencyMin, unsigned long* latencyMax, unsigned long* latencyMean, unsigned char* realTime, unsigned char reset)
+{
+	LinxSoftPwmStats stats;
+	int status = LinxDev->SoftPwmGetStats(&stats, reset);
+	if(status == L_OK)
+	{
+		*numWakeups = stats.numWakeups;
+		*numEdges = stats.numEdges;
+		*latencyMin = stats.latencyMin;
+		*latencyMax = stats.latencyMax;
+		*latencyMean = stats.latencyMean;
+		*realTime = stats.realTime;
+	}
+	return status;
+}
+
 
 //------------------------------------- SPI -------------------------------------
 extern "C" unsigned char LinxSpiGetNumChans()
@@ -436,6 +518,21 @@ extern "C" int LinxUartWrite(unsigned char channel, unsigned char numBytes, unsi
 	return LinxDev->UartWrite(channel, numBytes, sendBuffer);
 }
 
+extern "C" int LinxUartEnableRxThread(unsigned char channel, unsigned long bufferSize)
+{
+	return LinxDev->UartEnableRxThread(channel, bufferSize);
+}
+
+extern "C" int LinxUartGetBytesBuffered(unsigned char channel, unsigned long* numBytes)
+{
+	return LinxDev->UartGetBytesBuffered(channel, numBytes);
+}
+
+extern "C" int LinxUartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp)
+{
+	return LinxDev->UartReadTimeout(channel, numBytes, timeout, recBuffer, numBytesRead, timestamp);
+}
+
 extern "C" int LinxUartClose(unsigned char channel)
 {
 	return LinxDev->UartClose(channel);
@@ -28,6 +28,8 @@ extern "C" int LinxGetDeviceName(string* name);
 
 //------------------------------------- General -------------------------------------
 extern "C" unsigned long LinxGetMilliSeconds();
+extern "C" unsigned long long LinxGetMicroSeconds();
+extern "C" unsigned long long LinxGetNanoSeconds();
 
 
 //------------------------------------- Analog -------------------------------------
@@ -42,6 +44,10 @@ extern "C" int LinxAiGetChans(unsigned char numChans, unsigned char* channels);
 extern "C" int LinxAoGetChans(unsigned char numChans, unsigned char* channels);
 extern "C" int LinxAnalogRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
 extern "C" int LinxAnalogReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned long* values);
+extern "C" int LinxAnalogStreamStart(unsigned char numChans, unsigned char* channels, unsigned long bufferSize);
+extern "C" int LinxAnalogStreamRead(unsigned long numScans, unsigned long timeout, unsigned long* values, unsigned long* numScansRead);		//Channel Major ADC Ticks
+extern "C" int LinxAnalogStreamGetScansBuffered(unsigned long* numScans);
+extern "C" int LinxAnalogStreamStop();
 
 
 //------------------------------------- CAN -------------------------------------
@@ -56,6 +62,7 @@ extern "C" int LinxDigitalWrite(unsigned char numChans, unsigned char* channels,
 extern "C" int LinxDigitalWriteNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);
 extern "C" int LinxDigitalRead(unsigned char numChans, unsigned char* channels, unsigned char* values);
 extern "C" int LinxDigitalReadNoPacking(unsigned char numChans, unsigned char* channels, unsigned char* values);
+extern "C" int LinxDigitalPrewarm(unsigned char numChans, unsigned char* channels);
 
 
 //------------------------------------- I2C -------------------------------------
@@ -65,6 +72,7 @@ extern "C" int LinxI2cOpenMaster(unsigned char channel);
 extern "C" int LinxI2cSetSpeed(unsigned char channel, unsigned long speed, unsigned long* actualSpeed);
 extern "C" int LinxI2cWrite(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned char* sendBuffer);
 extern "C" int LinxI2cRead(unsigned char channel, unsigned char slaveAddress, unsigned char eofConfig, unsigned char numBytes, unsigned int timeout, unsigned char* recBuffer);		
+extern "C" int LinxI2cWriteRead(unsigned char channel, unsigned char slaveAddress, unsigned char numWriteBytes, unsigned char* sendBuffer, unsigned char numReadBytes, unsigned int timeout, unsigned char* recBuffer);
 extern "C" int LinxI2cClose(unsigned char channel);
 		
 		
@@ -72,6 +80,7 @@ extern "C" int LinxI2cClose(unsigned char channel);
 extern "C" unsigned char LinxPwmGetNumChans();
 extern "C" int LinxPwmGetChans(unsigned char numChans, unsigned char* channels);
 extern "C" int LinxPwmSetDutyCycle(unsigned char numChans, unsigned char* channels, unsigned char* values);
+extern "C" int LinxPwmSetFrequency(unsigned char numChans, unsigned char* channels, unsigned long* values);
 
 //------------------------------------- QE -------------------------------------
 extern "C" unsigned char LinxQeGetNumChans();
@@ -81,6 +90,10 @@ extern "C" int LinxQeGetChans(unsigned char numChans, unsigned char* channels);
 //------------------------------------- Servo -------------------------------------
 extern "C" unsigned char LinxServoGetNumChans();
 extern "C" int LinxServoGetChans(unsigned char numChans, unsigned char* channels);
+extern "C" int LinxServoOpen(unsigned char numChans, unsigned char* channels);
+extern "C" int LinxServoSetPulseWidth(unsigned char numChans, unsigned char* channels, unsigned short* pulseWidths);
+extern "C" int LinxServoClose(unsigned char numChans, unsigned char* channels);
+extern "C" int LinxSoftPwmGetStats(unsigned long* numWakeups, unsigned long* numEdges, unsigned long* latencyMin, unsigned long* latencyMax, unsigned long* latencyMean, unsigned char* realTime, unsigned char reset);
 
 
 //------------------------------------- SPI -------------------------------------
@@ -100,6 +113,9 @@ extern "C" int LinxUartSetBaudRate(unsigned char channel, unsigned long baudRate
 extern "C" int LinxUartGetBytesAvailable(unsigned char channel, unsigned char *numBytes);
 extern "C" int LinxUartRead(unsigned char channel, unsigned char numBytes, unsigned char* recBuffer, unsigned char* numBytesRead);
 extern "C" int LinxUartWrite(unsigned char channel, unsigned char numBytes, unsigned char* sendBuffer);
+extern "C" int LinxUartEnableRxThread(unsigned char channel, unsigned long bufferSize);
+extern "C" int LinxUartGetBytesBuffered(unsigned char channel, unsigned long* numBytes);
+extern "C" int LinxUartReadTimeout(unsigned char channel, unsigned long numBytes, unsigned long timeout, unsigned char* recBuffer, unsigned long* numBytesRead, unsigned long long* timestamp);
 extern "C" int LinxUartClose(unsigned char channel);
 
 #endif //LINX_DEVICELIB_H
\ No newline at end of file
@@ -19,16 +19,19 @@
 #include "LinxRaspberryPi5.h"
 #include "LinxSerialListener.h"
 #include "LinxLinuxTcpListener.h"
+#include "LinxRealTime.h"
 
 //Helper Functions
 int parseInputTokens(LinxDevice* linxDev, int argc, char* argv[]);
 void printUsage(char* argv[], LinxDevice* linxDev);
 
-#define NUMTOKENS 10
-string tokens[NUMTOKENS] = {"-h", "-H", "--help", "--Help", "-v", "-V", "--version", "--Version", "-serial", "-tcp"};
+#define NUMTOKENS 14
+string tokens[NUMTOKENS] = {"-h", "-H", "--help", "--Help", "-v", "-V", "--version", "--Version", "-serial", "-tcp", "-rt", "-cpu", "-prewarm", "-timing"};
 
 int uartListenerPort = -1;
 int tcpListenerPort = -1;
+int rtPriority = 0;
+char* rtCpus = NULL;
 
 LinxRaspberryPi5* LinxDev;
 
@@ -41,6 +44,12 @@ int main(int argc, char* argv[])
 	
 	if(parseInputTokens(LinxDev, argc, argv) >= 0)
 	{	
+		//Real-Time Profile Is Opt In
+		if(rtPriority > 0 || rtCpus != NULL)
+		{
+			LinxRealTime::Start(rtPriority, rtCpus);
+		}
+		
 		if(uartListenerPort > -1 && tcpListenerPort > -1)
 		{
 			while(1)
@@ -155,6 +164,57 @@ int parseInputTokens(LinxDevice* linxDev, int argc, char* argv[])
 							LinxTcpConnection.Start(LinxDev, tcpListenerPort);
 						}
 						break;
+					case 10:	//-rt
+						rtPriority = RT_DEFAULT_PRIORITY;
+						if(i+1 < argc && atoi(argv[i+1]) > 0)
+						{
+							rtPriority = atoi(argv[i+1]);
+						}
+						break;
+					case 11:	//-cpu
+						if(i+1 >= argc)
+						{
+							cout << "\n"<< "Missing CPU list\n";
+							printUsage(argv, linxDev);
+							return -1;
+						}
+						rtCpus = argv[i+1];
+						break;
+					case 12:	//-prewarm
+						if(i+1 >= argc)
+						{
+							cout << "\n"<< "Missing channel list\n";
+							printUsage(argv, linxDev);
+							return -1;
+						}
+						else
+						{
+							unsigned char prewarmChans[NUM_DIGITAL_CHANS];
+							unsigned char numPrewarm = 0;
+							char* next = argv[i+1];
+							while(*next != '\0' && numPrewarm < NUM_DIGITAL_CHANS)
+							{
+								prewarmChans[numPrewarm++] = (unsigned char)strtol(next, &next, 10);
+								if(*next == ',')
+								{
+									next++;
+								}
+								else if(*next != '\0')
+								{
+									break;
+								}
+							}
+							if(*next != '\0' || numPrewarm == 0 || LinxDev->DigitalPrewarm(numPrewarm, prewarmChans) != L_OK)
+							{
+								cout << "Unable to prewarm digital channels " << argv[i+1] << "\n";
+								return -1;
+							}
+							cout << "Prewarmed " << (int)numPrewarm << " digital channel(s)\n";
+						}
+						break;
+					case 13:	//-timing
+						LinxDev->PrintStartupTiming();
+						break;
 					default:
 						break;
 				}
@@ -174,7 +234,8 @@ void printUsage(char* argv[], LinxDevice* linxDev)
 {
 	cout << "\nusage: " << argv[0] << " -serial [port]\n";
 	cout << "   or: " << argv[0] << " -serial [port] -tcp [port]\n";
-	cout << "   or: " << argv[0] << " -tcp [port]\n\n";
+	cout << "   or: " << argv[0] << " -tcp [port]\n";
+	cout << "   any of the above with: -rt [priority] -cpu [list] -prewarm [list] -timing\n\n";
 	cout << "Available options are:\n";
 	cout << "  -serial\t " << (int)linxDev->UartChans[0];
 	for(int i = 1; i<linxDev->NumUartChans; i++)
@@ -182,5 +243,9 @@ void printUsage(char* argv[], LinxDevice* linxDev)
 		cout << ", " << (int)linxDev->UartChans[i];
 	}	
 	cout << "\n";
-	cout << "  -tcp  \t Any valid, unused TCP port. (ex 44300)\n\n";
+	cout << "  -tcp  \t Any valid, unused TCP port. (ex 44300)\n";
+	cout << "  -rt   \t Optional SCHED_FIFO priority, 1 - 99 (default " << RT_DEFAULT_PRIORITY << "). Locks memory and prints a latency self test.\n";
+	cout << "  -cpu  \t CPUs to pin the listener to. (ex 3 or 2-3)\n";
+	cout << "  -prewarm\t Digital channels to claim at start up instead of on first use. (ex 7,11,40)\n";
+	cout << "  -timing\t Print how long each step of device construction took.\n\n";
 }
\ No newline at end of file
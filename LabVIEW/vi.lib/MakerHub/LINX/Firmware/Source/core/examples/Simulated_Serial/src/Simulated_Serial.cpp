@@ -0,0 +1,59 @@
+/****************************************************************************************
+**  LINX Serial Listener For The Simulated Device
+**
+**  Listens on a pseudo terminal instead of a real UART.  Point the host at the printed
+**  /dev/pts path.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <termios.h>
+
+#include "LinxDevice.h"
+#include "LinxSimDevice.h"
+#include "LinxSerialListener.h"
+
+#define LISTENER_UART_PORT 0
+
+LinxSimDevice* LinxDev;
+
+int main()
+{
+	fprintf(stdout, "\n\n ..:: LINX ::..\n\n");
+
+	//Instantiate The LINX Device
+	LinxDev = new LinxSimDevice();
+
+	//Open A Raw Pseudo Terminal And Carry The Listener UART Over It
+	int masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+	if(masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0)
+	{
+		fprintf(stderr, "Unable To Open A Pseudo Terminal.\n");
+		return -1;
+	}
+	struct termios options;
+	tcgetattr(masterFd, &options);
+	cfmakeraw(&options);
+	tcsetattr(masterFd, TCSANOW, &options);
+	fcntl(masterFd, F_SETFL, O_NONBLOCK);
+	LinxDev->UartAttach(LISTENER_UART_PORT, masterFd);
+
+	//The LINXT Listener Is Pre Instantiated, Call Start And Pass A Pointer To The LINX Device And The UART Channel To Listen On
+	LinxSerialConnection.Start(LinxDev, LISTENER_UART_PORT);
+
+	fprintf(stdout, "Listening On %s.\n", ptsname(masterFd));
+
+	//Check for and process commands
+	while(1)
+	{
+		LinxSerialConnection.CheckForCommands();
+	}
+
+	return 0;
+}
@@ -18,6 +18,7 @@
 
 #include "utility\LinxDevice.h"
 #include "utility\LinxListener.h"
+#include "utility\LinxLog.h"
 #include "utility\LinxDnetckListener.h"
 #include "LinxChipkitNetworkShieldListener.h"
 
@@ -308,8 +309,10 @@ int LinxChipkitNetworkShieldListener::CheckForCommands()
 			break;				
 	}
 	
-	//Every Iteration Run Periodic Network Tasks
+	//Every Iteration Run Periodic Network Tasks, Format One Deferred Log Message And Keep The Clock's Wrap Count Current
 	 DNETcK::periodicTasks(); 
+	 LinxLogger.Poll(1);
+	 LinxDev->GetMicroSeconds();
 	
 	return 0;
 }
@@ -18,6 +18,7 @@
 
 #include "utility\LinxDevice.h"
 #include "utility\LinxListener.h"
+#include "utility\LinxLog.h"
 #include "utility\LinxDEIPcKListener.h"
 #include "LinxChipkitWifiListener.h"
 
@@ -299,7 +300,7 @@ int LinxChipkitWifiListener::Available()
 {
 	if((LinxTcpServer.availableClients() > 0))
 	{
-		LinxDev->DebugPrintln("Available Client");
+		LINX_LOG_DEBUG("Available Client");
 		State = ACCEPT;
 	}
 	return L_OK;
@@ -309,7 +310,7 @@ int LinxChipkitWifiListener::Accept()
 {
 	if((LinxTcpClientPtr = LinxTcpServer.acceptClient()) != NULL && LinxTcpClientPtr->isConnected())
 	{
-		LinxDev->DebugPrintln("Client Connected");
+		LINX_LOG_DEBUG("Client Connected");
 		State = CONNECTED;
 		LinxTcpStartTime = (unsigned)millis();
 	}
@@ -343,7 +344,7 @@ int LinxChipkitWifiListener::Connected()
 				if( ((unsigned)millis() - LinxTcpStartTime) > LinxTcpTimeout)
 				{
 					State = CLOSE;
-					LinxDev->DebugPrintln("Network Stack :: Rx Timeout (0)");
+					LINX_LOG_WARN("Network Stack :: Rx Timeout (0)");
 					break;
 				}				
 			}
@@ -359,7 +360,7 @@ int LinxChipkitWifiListener::Connected()
 				if( ((unsigned)millis() - LinxTcpStartTime) > LinxTcpTimeout)
 				{
 					State = CLOSE;
-					LinxDev->DebugPrintln("Network Stack :: Rx Timeout (1)");
+					LINX_LOG_WARN("Network Stack :: Rx Timeout (1)");
 					break;
 				}				
 			}
@@ -368,15 +369,7 @@ int LinxChipkitWifiListener::Connected()
 			LinxTcpClientPtr->readStream(&recBuffer[2],  recBuffer[1]-2);
 			
 			
-			//DEBUG PRINT PACKET			
-			LinxDev->DebugPrint("RX <= ");
-			for(int i=0; i<recBuffer[1]; i++)
-			{
-				LinxDev->DebugPrint("[");
-				LinxDev->DebugPrint(recBuffer[i], HEX);
-				LinxDev->DebugPrint("] ");
-			}
-			LinxDev->DebugPrintln("");
+			LINX_LOG_DEBUG("RX <= Command 0x%02X%02X, %u Bytes", recBuffer[4], recBuffer[5], recBuffer[1]);
 			
 
 			//Checksum
@@ -396,13 +389,13 @@ int LinxChipkitWifiListener::Connected()
 			}
 			else
 			{
-				LinxDev->DebugPrintln("Network Stack :: Checksum Failed");       
+				LINX_LOG_ERROR("Network Stack :: Checksum Failed");
 			}         
 		}
 		else
 		{
 			State = CLOSE;
-			LinxDev->DebugPrintln("Network Stack :: SoF Failed");       
+			LINX_LOG_ERROR("Network Stack :: SoF Failed");
 		}
 
 		//Data Received, Reset Timeout
@@ -413,7 +406,7 @@ int LinxChipkitWifiListener::Connected()
 	else if( ((unsigned)millis() - LinxTcpStartTime) > LinxTcpTimeout)
 	{
 		//Time Out		
-		LinxDev->DebugPrintln("Network Stack :: Wifi Timeout");             
+		LINX_LOG_WARN("Network Stack :: Wifi Timeout");
 		
 		State = CLOSE;
 		
@@ -503,31 +496,33 @@ int LinxChipkitWifiListener::CheckForCommands()
 			break;
 		case LISTENING:    
 			Listen();
-			LinxDev->DebugPrintln("..........LISTENING..........");
+			LINX_LOG_DEBUG("State - Listening");
 			break;
 		case AVAILABLE:    
 			Available();
-			LinxDev->DebugPrintln("..........AVAILABLE..........");
+			LINX_LOG_DEBUG("State - Available");
 			break;
 		case ACCEPT:    
 			Accept();
-			LinxDev->DebugPrintln("..........ACCEPT..........");
+			LINX_LOG_DEBUG("State - Accept");
 			break;
 		case CONNECTED:    
 			Connected();
-			LinxDev->DebugPrintln("..........CONNECTED..........");
+			LINX_LOG_DEBUG("State - Connected");
 			break;
 		case CLOSE:    			
 			Close();
-			LinxDev->DebugPrintln("..........CLOSE..........");
+			LINX_LOG_DEBUG("State - Close");
 			break;	
 		case EXIT:
 			Exit();
 			break;				
 	}
 	
-	//Every Iteration Run Periodic Network Tasks
+	//Every Iteration Run Periodic Network Tasks, Format One Deferred Log Message And Keep The Clock's Wrap Count Current
 	DEIPcK::periodicTasks(); 
+	LinxLogger.Poll(1);
+	LinxDev->GetMicroSeconds();
 	return L_OK;
 }
 
@@ -19,6 +19,7 @@
 
 #include "utility/LinxDevice.h"
 #include "utility/LinxListener.h"
+#include "utility/LinxLog.h"
 #include "LinxESP8266WifiListener.h"
 
 /****************************************************************************************
@@ -255,7 +256,7 @@ int LinxESP8266WifiListener::Available()
 	m_WifiClient = m_pWifiSvr->available();
 	if(m_WifiClient)
 	{
-		LinxDev->DebugPrintln("Available Client");
+		LINX_LOG_DEBUG("Available Client");
 		State = ACCEPT;
 	}
 	return L_OK;
@@ -266,7 +267,7 @@ int LinxESP8266WifiListener::Accept()
 
 	if(m_WifiClient.connected())
 	{
-		LinxDev->DebugPrintln("Client Connected");
+		LINX_LOG_DEBUG("Client Connected");
 		State = CONNECTED;
 		LinxWifiStartTime = (unsigned)millis();
 	}
@@ -299,7 +300,7 @@ int LinxESP8266WifiListener::Connected()
 				if( ((unsigned)millis() - LinxWifiStartTime) > LinxWifiTimeout)
 				{
 					State = CLOSE;
-					LinxDev->DebugPrintln("Network Stack :: Rx Timeout (0)");
+					LINX_LOG_WARN("Network Stack :: Rx Timeout (0)");
 					break;
 				}				
 			}
@@ -315,7 +316,7 @@ int LinxESP8266WifiListener::Connected()
 				if( ((unsigned)millis() - LinxWifiStartTime) > LinxWifiTimeout)
 				{
 					State = CLOSE;
-					LinxDev->DebugPrintln("Network Stack :: Rx Timeout (1)");
+					LINX_LOG_WARN("Network Stack :: Rx Timeout (1)");
 					break;
 				}				
 			}
@@ -324,15 +325,7 @@ int LinxESP8266WifiListener::Connected()
 			m_WifiClient.read(&recBuffer[2],  recBuffer[1]-2);
 			
 			
-			//DEBUG PRINT PACKET			
-			LinxDev->DebugPrint("RX <= ");
-			for(int i=0; i<recBuffer[1]; i++)
-			{
-				LinxDev->DebugPrint("[");
-				LinxDev->DebugPrint(recBuffer[i], HEX);
-				LinxDev->DebugPrint("] ");
-			}
-			LinxDev->DebugPrintln("");
+			LINX_LOG_DEBUG("RX <= Command 0x%02X%02X, %u Bytes", recBuffer[4], recBuffer[5], recBuffer[1]);
 			
 
 			//Checksum
@@ -350,13 +343,13 @@ int LinxESP8266WifiListener::Connected()
 			}
 			else
 			{
-				LinxDev->DebugPrintln("Network Stack :: Checksum Failed");       
+				LINX_LOG_ERROR("Network Stack :: Checksum Failed");
 			}         
 		}
 		else
 		{
 			State = CLOSE;
-			LinxDev->DebugPrintln("Network Stack :: SoF Failed");       
+			LINX_LOG_ERROR("Network Stack :: SoF Failed");
 		}
 
 		//Data Received, Reset Timeout
@@ -365,8 +358,7 @@ int LinxESP8266WifiListener::Connected()
 	else if( ((unsigned)millis() - LinxWifiStartTime) > LinxWifiTimeout)
 	{
 		//Time Out		
-		LinxDev->DebugPrintln("Network Stack :: Wifi Timeout");             
-		LinxDev->DebugPrintln(LinxWifiTimeout, DEC);
+		LINX_LOG_WARN("Network Stack :: Wifi Timeout After %u mS", LinxWifiTimeout);
 		State = CLOSE;
 		
 	}
@@ -433,8 +425,10 @@ int LinxESP8266WifiListener::CheckForCommands()
 			break;				
 	}
 	
-	//Every Iteration Run Periodic Network Tasks
+	//Every Iteration Run Periodic Network Tasks, Format One Deferred Log Message And Keep The Clock's Wrap Count Current
 	delay(0);
+	LinxLogger.Poll(1);
+	LinxDev->GetMicroSeconds();
 	
 	return L_OK;
 }
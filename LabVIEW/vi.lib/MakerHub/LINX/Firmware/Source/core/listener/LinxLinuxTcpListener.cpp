@@ -14,16 +14,20 @@
 ****************************************************************************************/
 #include "utility/LinxDevice.h"
 #include "utility/LinxListener.h"
+#include "utility/LinxLog.h"
 #include "LinxLinuxTcpListener.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <signal.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <string.h>
 #include <unistd.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
 
 /****************************************************************************************
 **  Constructors
@@ -34,6 +38,9 @@ LinxLinuxTcpListener::LinxLinuxTcpListener()
 	Interface = TCP;
 	TcpPort = 44300;
 	TcpTimeout.tv_sec = 10;		//Set Socket Time-out To Default Value
+	EpollHandle = -1;
+	EpollClient = -1;
+	EpollPollUarts = false;
 }
 
 /****************************************************************************************
@@ -47,18 +54,18 @@ int LinxLinuxTcpListener::Start(LinxDevice* linxDev, unsigned short port)
 	recBuffer = (unsigned char*) malloc(LinxDev->ListenerBufferSize);
 	sendBuffer = (unsigned char*) malloc(LinxDev->ListenerBufferSize);
 
-	LinxDev->DebugPrintln("Starting Linux TCP Listener...");
+	LINX_LOG_DEBUG("Starting Linux TCP Listener...");
 	
 	//Create the TCP socket
 	if((ServerSocket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP)) < 0) 
 	{
-		LinxDev->DebugPrintln("Failed To Create Socket");
+		LINX_LOG_ERROR("Failed To Create Socket");
 		State = EXIT;
 		return -1;
 	}
 	else
 	{
-		LinxDev->DebugPrintln("Successfully Created Socket");
+		LINX_LOG_DEBUG("Successfully Created Socket");
 	}
 
 	//Construct the server sockaddr_in structure
@@ -71,25 +78,26 @@ int LinxLinuxTcpListener::Start(LinxDevice* linxDev, unsigned short port)
 	//Bind the server socket
 	if( bind(ServerSocket, (struct sockaddr *) &TcpServer, sizeof(TcpServer)) < 0)
 	{
-		LinxDev->DebugPrintln("Failed To Bind Sever Socket");
+		LINX_LOG_ERROR("Failed To Bind Sever Socket");
 		State = EXIT;
 		return -1;
 	}
 	else
 	{
-		LinxDev->DebugPrintln("Successfully Bound Sever Socket");
+		LINX_LOG_DEBUG("Successfully Bound Sever Socket");
 	}
 	
 	//Listen on the server socket
 	if(listen(ServerSocket, MAX_PENDING_CONS) < 0)
 	{
-		LinxDev->DebugPrintln("Failed To Start Listening On Sever Socket");
+		LINX_LOG_ERROR("Failed To Start Listening On Sever Socket");
 		State = EXIT;
 		return -1;
 	}
 	else
 	{
-		LinxDev->DebugPrintln("Successfully Started Listening On Sever Socket");
+		LINX_LOG_DEBUG("Successfully Started Listening On Sever Socket");
+		Trace.DumpOnSignal(SIGUSR2, TRACE_DUMP_PATH);
 		State = LISTENING;
 	}
 	
@@ -98,7 +106,7 @@ int LinxLinuxTcpListener::Start(LinxDevice* linxDev, unsigned short port)
 
 int LinxLinuxTcpListener::Listen()
 {
-	LinxDev->DebugPrintln("Waiting For Client Connection\n");
+	LINX_LOG_DEBUG("Waiting For Client Connection");
 	
 	unsigned int clientlen = sizeof(TcpClient);
 	
@@ -112,15 +120,25 @@ int LinxLinuxTcpListener::Listen()
 	{		
 		if ( setsockopt (ClientSocket, SOL_SOCKET, SO_RCVTIMEO, (char *)&TcpTimeout, sizeof(TcpTimeout)) < 0)
 		{
-			LinxDev->DebugPrintln("Failed To Set Socket Receive Time-out\n");
+			LINX_LOG_ERROR("Failed To Set Socket Receive Time-out");
 			return -1;
 		}
 		else
 		{	
+			//Responses Are Small, Send Each At Once Even When The Client Has Several Requests In Flight
+			int noDelay = 1;
+			setsockopt(ClientSocket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+			
 			TcpUpdateTime = LinxDev->GetSeconds();
 			State = CONNECTED;
-			LinxDev->DebugPrintln(inet_ntoa(TcpClient.sin_addr));
-			LinxDev->DebugPrintln("Successfully Connected\n");
+			
+			//A New Client Starts With No Passthrough Channels
+			for(int i=0; i<PASSTHROUGH_MAX_CHANS; i++)
+			{
+				PassthroughChans[i] = false;
+			}
+			PassthroughChanged = true;
+			LINX_LOG_DEBUG("Successfully Connected To %s", inet_ntoa(TcpClient.sin_addr));
 		}		
 	}
 	return 0;	
@@ -132,6 +150,12 @@ int LinxLinuxTcpListener::Connected()
 	unsigned char packetSize = 0;
 	errno = 0;
 	
+	//Only Block On The Socket When It Has Data So Passthrough Data Keeps Flowing
+	if(PassthroughActive() && !waitForClient())
+	{
+		return 0;
+	}
+	
 	//Clear SoF
 	recBuffer[0] = 0;
 	
@@ -142,16 +166,17 @@ int LinxLinuxTcpListener::Connected()
 	if(received >= 2)
 	{
 		//Check SoF and Packet Size
-		if(recBuffer[0] == 0xFF)
+		if(recBuffer[0] == 0xFF || recBuffer[0] == PASSTHROUGH_SOF)
 		{
 			//Valid SoF, Check Packet Size
+			PacketReceived();
 			packetSize = recBuffer[1];
-			if(packetSize < received )
+			if(received < packetSize)
 			{
 				//Partial Packet, Make Sure Packet Size Will Fit In Buffer, If It Will Loop To Wait For Remainder Of Packet
 				if(packetSize > LinxDev->ListenerBufferSize)
 				{
-					LinxDev->DebugPrintln("Packet Size Too Large For Buffer");
+					LINX_LOG_ERROR("Packet Size Too Large For Buffer");
 					State = EXIT;
 					return -1;
 				}
@@ -160,46 +185,51 @@ int LinxLinuxTcpListener::Connected()
 			else
 			{
 				//Full Packet In Receive Buffer
-				if( received = read(ClientSocket, recBuffer, packetSize) < 0 )
+				if( (received = read(ClientSocket, recBuffer, packetSize)) < 0 )
 				{
 					//Failed To Read Packet From Buffer
-					LinxDev->DebugPrintln("Failed To Read Packet From Buffer");
+					LINX_LOG_ERROR("Failed To Read Packet From Buffer");
 					State = EXIT;
 					return -1;				
 				}
+				else if(recBuffer[0] == PASSTHROUGH_SOF)
+				{
+					//UART Passthrough Data, No Response
+					ProcessPassthroughFrame(recBuffer);
+					PacketRxTime = 0;
+				}
 				else
 				{
 					//Check Checksum
 					if(ChecksumPassed(recBuffer))
 					{				
-						LinxDev->DebugPrintPacket(RX, recBuffer);
-						
 						//Process Packet Handle Any Networking Packets
 						int status = ProcessCommand(recBuffer, sendBuffer);
 						if(status == L_DISCONNECT)
 						{
 							//Host Disconnected.  Listen For New Connection														
-							LinxDev->DebugPrintln("Disconnect");
+							LINX_LOG_DEBUG("Disconnect");
 							State = LISTENING;							
 						}
 										
 						
 						//Send Response Packet
-						LinxDev->DebugPrintPacket(TX, sendBuffer);
 						unsigned char bytesToSend = sendBuffer[1];
 						if( send(ClientSocket, sendBuffer, bytesToSend, 0) != bytesToSend)
 						{
-							LinxDev->DebugPrintln("Failed To Send Response Packet");
+							LINX_LOG_ERROR("Failed To Send Response Packet");
 							State = EXIT;
 							return -1;
 						}
+						ResponseSent();
 						return 0;
 					}
 					else
 					{
 						//Checksum Failed
-						LinxDev->DebugPrintln("Checksum Failed");
+						LINX_LOG_ERROR("Checksum Failed");
 						recv(ClientSocket, recBuffer, LinxDev->ListenerBufferSize, MSG_DONTWAIT);
+						PacketDropped(TRACE_DROP_CHECKSUM);
 					}
 				}
 			}
@@ -207,9 +237,10 @@ int LinxLinuxTcpListener::Connected()
 		else
 		{
 			//Bad SoF, Flush Socket
-			LinxDev->DebugPrintln("Bad SoF");
+			LINX_LOG_WARN("Bad SoF");
 			recv(ClientSocket, recBuffer, LinxDev->ListenerBufferSize, MSG_DONTWAIT);
 			printf("Got %s\n", recBuffer);
+			PacketDropped(TRACE_DROP_SOF);
 		}
 	}
     return 0;
@@ -220,6 +251,11 @@ int LinxLinuxTcpListener::Exit()
 {
 	close(ServerSocket);
 	close(ClientSocket);
+	if(EpollHandle >= 0)
+	{
+		close(EpollHandle);
+		EpollHandle = -1;
+	}
 	State = LISTENING;
 	
 	return 0;
@@ -240,11 +276,11 @@ int LinxLinuxTcpListener::peek(unsigned char * recBuffer, int bufferSize)
 	
 	if( (peekReceived = recv(ClientSocket, recBuffer, bufferSize, MSG_PEEK)) < 0)
 	{
-		//Time-out Or Error
-		if(errno == EWOULDBLOCK)
+		//Time-out Or Error, A Trace Dump Signal Interrupts A Timed recv() Even With SA_RESTART
+		if(errno == EWOULDBLOCK || errno == EINTR)
 		{
 			//Time-out Waiting For Data
-			LinxDev->DebugPrintln("Time-out Waiting For Data");			
+			LINX_LOG_WARN("Time-out Waiting For Data");
 		}			
 		else
 		{
@@ -255,7 +291,7 @@ int LinxLinuxTcpListener::peek(unsigned char * recBuffer, int bufferSize)
 	else	 if(peekReceived == 0)
 	{		
 		//Client Disconnected
-		LinxDev->DebugPrintln("Client Disconnected");			
+		LINX_LOG_DEBUG("Client Disconnected");
 		State = LISTENING;		
 		return peekReceived;		
 	}
@@ -263,16 +299,96 @@ int LinxLinuxTcpListener::peek(unsigned char * recBuffer, int bufferSize)
 	return peekReceived;		
 }
 
+//Wait For Client Data While Forwarding Passthrough UART Data, Returns true If The Client Socket Has Data
+bool LinxLinuxTcpListener::waitForClient()
+{
+	//Rebuild The Wait Set When The Client Or The Passthrough Channels Change
+	if(PassthroughChanged || EpollClient != ClientSocket)
+	{
+		if(EpollHandle >= 0)
+		{
+			close(EpollHandle);
+		}
+		EpollHandle = epoll_create(PASSTHROUGH_MAX_CHANS + 1);
+		
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = ClientSocket;
+		epoll_ctl(EpollHandle, EPOLL_CTL_ADD, ClientSocket, &event);
+		
+		EpollPollUarts = false;
+		for(unsigned char channel=0; channel<PASSTHROUGH_MAX_CHANS; channel++)
+		{
+			if(PassthroughChans[channel])
+			{
+				event.data.fd = LinxDev->UartGetFileDescriptor(channel);
+				if(event.data.fd < 0 || epoll_ctl(EpollHandle, EPOLL_CTL_ADD, event.data.fd, &event) < 0)
+				{
+					EpollPollUarts = true;
+				}
+			}
+		}
+		
+		EpollClient = ClientSocket;
+		PassthroughChanged = false;
+	}
+	
+	struct epoll_event events[PASSTHROUGH_MAX_CHANS + 1];
+	int numEvents = epoll_wait(EpollHandle, events, PASSTHROUGH_MAX_CHANS + 1, EpollPollUarts ? 1 : 100);
+	
+	bool clientReady = false;
+	for(int i=0; i<numEvents; i++)
+	{
+		if(events[i].data.fd == ClientSocket)
+		{
+			clientReady = true;
+		}
+	}
+	
+	if(forwardPassthrough() < 0)
+	{
+		LINX_LOG_ERROR("Failed To Send Passthrough Data");
+		State = EXIT;
+		return false;
+	}
+	
+	return clientReady;
+}
+
+//Send Everything The Passthrough UARTs Have Buffered, Several Frames Per send()
+int LinxLinuxTcpListener::forwardPassthrough()
+{
+	unsigned char frames[PASSTHROUGH_SEND_SIZE];
+	
+	for(unsigned char channel=0; channel<PASSTHROUGH_MAX_CHANS; channel++)
+	{
+		unsigned int numBytes = 0;
+		unsigned int frameSize = 0;
+		while(numBytes + 255 <= PASSTHROUGH_SEND_SIZE && (frameSize = BuildPassthroughFrame(channel, frames + numBytes, 255)) > 0)
+		{
+			numBytes += frameSize;
+		}
+		
+		if(numBytes > 0 && send(ClientSocket, frames, numBytes, MSG_NOSIGNAL) != (int)numBytes)
+		{
+			return -1;
+		}
+	}
+	
+	return 0;
+}
+
 int LinxLinuxTcpListener::CheckForCommands()
 {	
+	LinxListenerState previous = State;
 	switch(State)
 	{				
 		case START:
-			LinxDev->DebugPrintln("State - Start");
+			LINX_LOG_DEBUG("State - Start");
 			Start(LinxDev, TcpPort);			
 			break;
 		case LISTENING:  
-			LinxDev->DebugPrintln("State - Listening");
+			LINX_LOG_DEBUG("State - Listening");
 			Listen();
 			break;
 		case CONNECTED:  
@@ -280,15 +396,16 @@ int LinxLinuxTcpListener::CheckForCommands()
 			Connected();
 			break;
 		case CLOSE:    			
-			LinxDev->DebugPrintln("State - Close");
+			LINX_LOG_DEBUG("State - Close");
 			Close();
 			break;	
 		case EXIT:
-			LinxDev->DebugPrintln("State - Exit");
+			LINX_LOG_DEBUG("State - Exit");
 			Exit();
 			exit(-1);
 			break;				
 	}
+	StateChanged(previous);
 	return L_OK;
 }
 
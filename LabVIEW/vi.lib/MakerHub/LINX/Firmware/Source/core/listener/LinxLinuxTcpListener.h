@@ -17,6 +17,8 @@
 	#define MAX_PENDING_CONS 2
 #endif
 
+#define PASSTHROUGH_SEND_SIZE 4096		//Passthrough Frames Are Batched Into One send() Up To This Size
+
 /****************************************************************************************
 **  Includes
 ****************************************************************************************/		
@@ -69,11 +71,16 @@ class LinxLinuxTcpListener : public LinxListener
 		/****************************************************************************************
 		**  Variables
 		****************************************************************************************/		
+		int EpollHandle;						//Waits On The Client Socket And Passthrough UARTs
+		int EpollClient;						//Client Socket Registered With EpollHandle
+		bool EpollPollUarts;					//A Passthrough UART Has No Handle To Wait On And Must Be Polled
 				
 		/****************************************************************************************
 		**  Functions
 		****************************************************************************************/
 		int peek(unsigned char * recBuffer, int bufferSize);
+		bool waitForClient();
+		int forwardPassthrough();
 };
 
 extern LinxLinuxTcpListener LinxTcpConnection;
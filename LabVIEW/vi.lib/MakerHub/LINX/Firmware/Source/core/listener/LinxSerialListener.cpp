@@ -15,10 +15,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__linux__)
+	#include <signal.h>
+#endif
 
 #include "utility/LinxDevice.h"
 
 #include "utility/LinxListener.h"
+#include "utility/LinxLog.h"
 #include "LinxSerialListener.h"
 
 /****************************************************************************************
@@ -40,13 +44,17 @@ int LinxSerialListener::Start(LinxDevice* linxDev, unsigned char uartChan)
 	recBuffer = (unsigned char*) malloc(LinxDev->ListenerBufferSize);
 	sendBuffer = (unsigned char*) malloc(LinxDev->ListenerBufferSize);
 	
-	LinxDev->DebugPrintln("Starting Listener...\n");
+	LINX_LOG_DEBUG("Starting Listener...");
 	
 	ListenerChan = uartChan;
 	unsigned long acutalBaud = 0;
 	ListenerChan = uartChan;
 	LinxDev->UartOpen(ListenerChan, 9600, &acutalBaud);
 	
+	#if defined(__linux__)
+		Trace.DumpOnSignal(SIGUSR2, TRACE_DUMP_PATH);
+	#endif
+	
 	State = CONNECTED;
 	return 0;
 }
@@ -55,6 +63,12 @@ int LinxSerialListener::Connected()
 {
 	unsigned char bytesAvailable = 0;	
 	
+	//Forward Passthrough UART Data Between Commands
+	if(PassthroughActive())
+	{
+		forwardPassthrough();
+	}
+	
 	//Check How Many Bytes Received, Need At Least 2 To Get SoF And Packet Size
 	LinxDev->UartGetBytesAvailable(ListenerChan, &bytesAvailable);
 	
@@ -68,8 +82,10 @@ int LinxSerialListener::Connected()
 		unsigned char bytesRead = 0;
 		LinxDev->UartRead(ListenerChan, 2, recBuffer, &bytesRead);	
 		
-		if(recBuffer[0] == 0xFF)
+		if(recBuffer[0] == 0xFF || recBuffer[0] == PASSTHROUGH_SOF)
 		{
+			PacketReceived();
+			
 			//SoF is valid. Check If Entire Packet Has Been Received
 			LinxDev->UartGetBytesAvailable(ListenerChan, &bytesAvailable);
 		   
@@ -86,6 +102,7 @@ int LinxSerialListener::Connected()
 						//Flush
 						LinxDev->UartGetBytesAvailable(ListenerChan, &bytesAvailable);
 						LinxDev->UartRead(ListenerChan, bytesAvailable, recBuffer, &bytesRead);
+						PacketDropped(TRACE_DROP_TIMEOUT);
 						return -1;
 					}
 					LinxDev->DelayMs(1);
@@ -96,11 +113,17 @@ int LinxSerialListener::Connected()
 			//Full Packet Received			
 			LinxDev->UartRead(ListenerChan, (recBuffer[1] - 2), (recBuffer+2), &bytesRead);			
 									
+			//UART Passthrough Data, No Response
+			if(recBuffer[0] == PASSTHROUGH_SOF)
+			{
+				ProcessPassthroughFrame(recBuffer);
+				PacketRxTime = 0;
+				return 0;
+			}
+			
 			//Full Packet Received - Compute Checksum - Process Packet If Checksum Passes
 			if(ChecksumPassed(recBuffer))
 			{		
-				LinxDev->DebugPrintPacket(RX, recBuffer);
-				
 				//Process Packet
 				int status = ProcessCommand(recBuffer, sendBuffer);
 				if(status == L_DISCONNECT)
@@ -109,14 +132,15 @@ int LinxSerialListener::Connected()
 				}
 			
 				//Send Response Packet 
-				LinxDev->DebugPrintPacket(TX, sendBuffer);
 				LinxDev->UartWrite(ListenerChan, sendBuffer[1], sendBuffer);		
+				ResponseSent();
 			}
 			else
 			{
 				//Flush
 				LinxDev->UartGetBytesAvailable(ListenerChan, &bytesAvailable);
 				LinxDev->UartRead(ListenerChan, bytesAvailable, recBuffer, &bytesRead);
+				PacketDropped(TRACE_DROP_CHECKSUM);
 			}
 		}
 		else
@@ -124,11 +148,14 @@ int LinxSerialListener::Connected()
 			//Flush
 			LinxDev->UartGetBytesAvailable(ListenerChan, &bytesAvailable);
 			LinxDev->UartRead(ListenerChan, bytesAvailable, recBuffer, &bytesRead); 
+			PacketDropped(TRACE_DROP_SOF);
 		}
 	}
 	else
 	{
-		//No New Packet
+		//No New Packet, Format Deferred Log Messages And Keep The Clock's Wrap Count Current While Idle
+		LinxLogger.Poll(1);
+		LinxDev->GetMicroSeconds();
 		if (periodicTasks[0] != NULL)
 		{
 			periodicTasks[0](0,0);
@@ -136,7 +163,7 @@ int LinxSerialListener::Connected()
 		else
 		{
 			#if LINX_DEVICE_FAMILY==4 || LINX_DEVICE_FAMILY==6
-			LinxDev->DelayMs(30);
+			LinxDev->DelayMs(PassthroughActive() ? 1 : 30);
 			#endif
 		}
 	}
@@ -144,6 +171,24 @@ int LinxSerialListener::Connected()
 	return 0;
 }
 
+void LinxSerialListener::forwardPassthrough()
+{
+	for(unsigned char channel=0; channel<PASSTHROUGH_MAX_CHANS; channel++)
+	{
+		//The Listener's Own UART Can Not Be Passed Through
+		if(channel == ListenerChan)
+		{
+			continue;
+		}
+		
+		unsigned int frameSize = BuildPassthroughFrame(channel, sendBuffer, LinxDev->ListenerBufferSize);
+		if(frameSize > 0)
+		{
+			LinxDev->UartWrite(ListenerChan, frameSize, sendBuffer);
+		}
+	}
+}
+
 int LinxSerialListener::Close()
 {
 	LinxDev->UartClose(ListenerChan);
@@ -158,6 +203,7 @@ int LinxSerialListener::Exit()
 
 int LinxSerialListener::CheckForCommands()
 {
+	LinxListenerState previous = State;
 	switch(State)
 	{				
 		case START:  
@@ -168,14 +214,15 @@ int LinxSerialListener::CheckForCommands()
 			Connected();
 			break;
 		case CLOSE:    			
-			LinxDev->DebugPrintln("State - Close");
+			LINX_LOG_DEBUG("State - Close");
 			Close();
 			break;	
 		case EXIT:
-			LinxDev->DebugPrintln("State - Exit");
+			LINX_LOG_DEBUG("State - Exit");
 			Exit();
 			break;				
 	}
+	StateChanged(previous);
 	return L_OK;
 }
 
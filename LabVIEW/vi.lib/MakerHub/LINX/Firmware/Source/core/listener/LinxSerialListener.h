@@ -62,7 +62,7 @@ class LinxSerialListener : public LinxListener
 		/****************************************************************************************
 		**  Functions
 		****************************************************************************************/
-	
+		void forwardPassthrough();
 };
 
 extern LinxSerialListener LinxSerialConnection;
@@ -0,0 +1,182 @@
+/****************************************************************************************
+**  LINX per command timing statistics.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <string.h>
+#include "LinxCommandStats.h"
+
+/****************************************************************************************
+**  Constructors
+****************************************************************************************/
+LinxCommandStats::LinxCommandStats()
+{
+	Reset();
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+//Two Compares And A Few Adds, Cheap Enough To Leave On For Every Command
+void LinxCommandStats::Record(unsigned short command, unsigned char kind, unsigned long long ns)
+{
+	LinxTimeStats* stats = &Times[slotFor(command)][kind];
+	unsigned long clamped = (ns > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (unsigned long)ns;
+
+	stats->count++;
+	#if defined(STATS_HISTOGRAMS)
+		stats->sum += ns;
+	#else
+		stats->sum += clamped / 1000;
+	#endif
+	if(clamped < stats->min)
+	{
+		stats->min = clamped;
+	}
+	if(clamped > stats->max)
+	{
+		stats->max = clamped;
+	}
+	#if defined(STATS_HISTOGRAMS)
+		stats->buckets[BucketOf(ns)]++;
+	#endif
+}
+
+void LinxCommandStats::Reset()
+{
+	memset(Times, 0, sizeof(Times));
+	for(int i=0; i<STATS_MAX_COMMANDS; i++)
+	{
+		Commands[i] = STATS_OTHER_COMMAND;
+		for(int k=0; k<STATS_NUM_KINDS; k++)
+		{
+			Times[i][k].min = 0xFFFFFFFFUL;
+		}
+	}
+	NumSlots = 0;
+	LastSlot = 0;
+}
+
+unsigned long LinxCommandStats::Mean(const LinxTimeStats* stats)
+{
+	if(stats->count == 0)
+	{
+		return 0;
+	}
+	#if defined(STATS_HISTOGRAMS)
+		unsigned long long mean = stats->sum / stats->count;
+		return (mean > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (unsigned long)mean;
+	#else
+		unsigned long mean = stats->sum / stats->count;
+		return (mean > 0xFFFFFFFFUL / 1000) ? 0xFFFFFFFFUL : mean * 1000;
+	#endif
+}
+
+unsigned long LinxCommandStats::Percentile(const LinxTimeStats* stats, unsigned long perMille)
+{
+	#if defined(STATS_HISTOGRAMS)
+		if(stats->count == 0)
+		{
+			return 0;
+		}
+
+		//Smallest Bucket With At Least perMille / 1000 Of The Samples At Or Below It
+		unsigned long long target = ((unsigned long long)stats->count * perMille + 999) / 1000;
+		unsigned long long seen = 0;
+		for(unsigned int i=0; i<STATS_NUM_BUCKETS; i++)
+		{
+			seen += stats->buckets[i];
+			if(seen >= target && seen > 0)
+			{
+				//Never Report More Than The Largest Time Actually Seen
+				unsigned long long edge = BucketUpperEdge(i);
+				return (edge > stats->max) ? stats->max : (unsigned long)edge;
+			}
+		}
+		return stats->max;
+	#else
+		return 0;
+	#endif
+}
+
+int LinxCommandStats::Find(unsigned short command)
+{
+	for(int i=0; i<NumSlots; i++)
+	{
+		if(Commands[i] == command)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+//Below 2^STATS_SUB_BITS nS Each nS Has A Bucket, Above That Each Power Of Two Is Split Into 2^STATS_SUB_BITS Equal Buckets
+unsigned int LinxCommandStats::BucketOf(unsigned long long ns)
+{
+	if(ns < (1ULL << STATS_SUB_BITS))
+	{
+		return (unsigned int)ns;
+	}
+	if(ns >= (1ULL << STATS_MAX_SHIFT))
+	{
+		return STATS_NUM_BUCKETS - 1;
+	}
+
+	unsigned int shift = 63 - __builtin_clzll(ns);
+	unsigned int sub = (unsigned int)(ns >> (shift - STATS_SUB_BITS)) & ((1 << STATS_SUB_BITS) - 1);
+	return ((shift - STATS_SUB_BITS + 1) << STATS_SUB_BITS) + sub;
+}
+
+unsigned long long LinxCommandStats::BucketUpperEdge(unsigned int bucket)
+{
+	if(bucket < (1 << STATS_SUB_BITS))
+	{
+		return bucket;
+	}
+
+	unsigned int shift = (bucket >> STATS_SUB_BITS) + STATS_SUB_BITS - 1;
+	unsigned long long sub = bucket & ((1 << STATS_SUB_BITS) - 1);
+	unsigned long long width = 1ULL << (shift - STATS_SUB_BITS);
+	return ((1ULL << shift) + (sub + 1) * width) - 1;
+}
+
+/****************************************************************************************
+**  Private Functions
+****************************************************************************************/
+//Opcodes Get Slots In The Order They Are First Seen, Once Full The Last Slot Takes The Rest
+int LinxCommandStats::slotFor(unsigned short command)
+{
+	if(Commands[LastSlot] == command && LastSlot < NumSlots)
+	{
+		return LastSlot;
+	}
+
+	int slot = Find(command);
+	if(slot < 0)
+	{
+		if(NumSlots < STATS_MAX_COMMANDS - 1)
+		{
+			slot = NumSlots++;
+			Commands[slot] = command;
+		}
+		else
+		{
+			slot = STATS_MAX_COMMANDS - 1;
+			if(NumSlots < STATS_MAX_COMMANDS)
+			{
+				NumSlots = STATS_MAX_COMMANDS;
+				Commands[slot] = STATS_OTHER_COMMAND;
+			}
+		}
+	}
+	LastSlot = slot;
+	return slot;
+}
@@ -0,0 +1,109 @@
+/****************************************************************************************
+**  LINX header for per command timing statistics.
+**
+**  Records how long each command's handler ran and how long it took from the packet
+**  arriving to the response going out, per opcode, in fixed memory.  Linux keeps a log
+**  linear histogram per opcode, MCUs only min / max / mean.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_COMMAND_STATS_H
+#define LINX_COMMAND_STATS_H
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#if defined(__linux__)
+	#define STATS_HISTOGRAMS									//Log Linear Histograms, Otherwise Min / Max / Mean Only
+	#ifndef STATS_MAX_COMMANDS
+		#define STATS_MAX_COMMANDS 64						//Distinct Opcodes Tracked, Later Ones Share The Last Slot
+	#endif
+#else
+	#ifndef STATS_MAX_COMMANDS
+		#define STATS_MAX_COMMANDS 4						//About 140 Bytes Of RAM
+	#endif
+#endif
+
+//Values Per Kind Reported By Get Command Stats, p50 / p99 / p999 Only With Histograms
+#if defined(STATS_HISTOGRAMS)
+	#define STATS_NUM_VALUES 7
+#else
+	#define STATS_NUM_VALUES 4
+#endif
+
+#define STATS_SUB_BITS 2										//2^STATS_SUB_BITS Linear Buckets Per Power Of Two, 25% Resolution
+#define STATS_MAX_SHIFT 36										//Times From 2^36 nS (About 69 S) Up Share The Last Bucket
+#define STATS_NUM_BUCKETS ((STATS_MAX_SHIFT - STATS_SUB_BITS + 1) << STATS_SUB_BITS)
+#define STATS_OTHER_COMMAND 0xFFFF								//Opcode Reported For The Shared Overflow Slot
+
+/****************************************************************************************
+**  Typedefs
+****************************************************************************************/
+typedef enum LinxStatsKind
+{
+	STATS_HANDLER = 0,											//ProcessCommand() Only
+	STATS_END_TO_END,											//Packet Received To Response Sent
+	STATS_NUM_KINDS
+}LinxStatsKind;
+
+typedef struct LinxTimeStats
+{
+	unsigned long count;
+	unsigned long min;											//nS, Saturates At 2^32 - 1
+	unsigned long max;											//nS
+	#if defined(STATS_HISTOGRAMS)
+		unsigned long long sum;									//nS
+		unsigned long buckets[STATS_NUM_BUCKETS];
+	#else
+		unsigned long sum;										//uS, MCU Clocks Tick In Whole uS.  Wraps After About 71 Minutes Total
+	#endif
+}LinxTimeStats;
+
+/****************************************************************************************
+**  Classes
+****************************************************************************************/
+class LinxCommandStats
+{
+	public:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		unsigned short Commands[STATS_MAX_COMMANDS];			//Opcode Per Slot, Kept Apart From Times So The Lookup Stays In Cache
+		LinxTimeStats Times[STATS_MAX_COMMANDS][STATS_NUM_KINDS];
+		unsigned char NumSlots;
+
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxCommandStats();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		void Record(unsigned short command, unsigned char kind, unsigned long long ns);
+		void Reset();
+
+		unsigned long Mean(const LinxTimeStats* stats);
+		unsigned long Percentile(const LinxTimeStats* stats, unsigned long perMille);		//Upper Edge Of The Bucket, 0 Without Histograms
+		int Find(unsigned short command);														//Slot Index, -1 If Never Recorded
+
+		static unsigned int BucketOf(unsigned long long ns);
+		static unsigned long long BucketUpperEdge(unsigned int bucket);						//nS
+
+	private:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		int LastSlot;											//Repeated Commands Skip The Search
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		int slotFor(unsigned short command);
+};
+
+#endif //LINX_COMMAND_STATS_H
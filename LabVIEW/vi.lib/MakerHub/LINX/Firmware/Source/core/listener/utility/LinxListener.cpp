@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include "LinxListener.h"
 #include "LinxDevice.h"
+#include "LinxLog.h"
 
 /****************************************************************************************
 **  Constructors
@@ -24,6 +25,15 @@
 LinxListener::LinxListener()
 {
 	State = START;
+	
+	for(int i=0; i<PASSTHROUGH_MAX_CHANS; i++)
+	{
+		PassthroughChans[i] = false;
+	}
+	PassthroughChanged = false;
+	AiStreamNumChans = 0;
+	PacketRxTime = 0;
+	LastCommand = 0;
 }
 
 /****************************************************************************************
@@ -100,6 +110,41 @@ unsigned char LinxListener::ComputeChecksum(unsigned char* packetBuffer)
 }
 
 
+void LinxListener::PacketReceived()
+{
+	if(PacketRxTime == 0)
+	{
+		PacketRxTime = LinxDev->GetNanoSeconds();
+	}
+}
+
+//Record The End To End Time Of The Packet Just Answered
+void LinxListener::ResponseSent()
+{
+	unsigned long long now = LinxDev->GetNanoSeconds();
+	unsigned long long endToEnd = (PacketRxTime != 0) ? now - PacketRxTime : 0;
+	if(PacketRxTime != 0)
+	{
+		CommandStats.Record(LastCommand, STATS_END_TO_END, endToEnd);
+		PacketRxTime = 0;
+	}
+	Trace.Record(now, TRACE_PACKET_TX, LastCommand, 0, (endToEnd > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (unsigned long)endToEnd);
+}
+
+void LinxListener::PacketDropped(unsigned char reason)
+{
+	Trace.Record(LinxDev->GetNanoSeconds(), TRACE_DROP, 0, reason, 0);
+	PacketRxTime = 0;
+}
+
+void LinxListener::StateChanged(LinxListenerState previous)
+{
+	if(State != previous)
+	{
+		Trace.Record(LinxDev->GetNanoSeconds(), TRACE_STATE, 0, State, previous);
+	}
+}
+
 bool LinxListener::ChecksumPassed(unsigned char* packetBuffer)
 {
   return (ComputeChecksum(packetBuffer) == packetBuffer[packetBuffer[1]-1]);
@@ -119,6 +164,16 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 	
 	int status = L_OK;
 	
+	//Time The Handler, End To End Starts Here Too If The Listener Did Not Mark The Packet
+	unsigned long long handlerStart = LinxDev->GetNanoSeconds();
+	if(PacketRxTime == 0)
+	{
+		PacketRxTime = handlerStart;
+	}
+	unsigned int packetNumber = commandPacketBuffer[2] << 8 | commandPacketBuffer[3];
+	Trace.Record(PacketRxTime, TRACE_PACKET_RX, command, 0, (unsigned long)commandPacketBuffer[1] << 16 | packetNumber);
+	Trace.Record(handlerStart, TRACE_HANDLER_START, command, 0, packetNumber);
+	
 	/****************************************************************************************
 	** User Commands
 	****************************************************************************************/	
@@ -214,15 +269,20 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 		   break;
 			
 		case 0x0011: // Disconnect
-			LinxDev->DebugPrintln("Close Command");
+			LINX_LOG_INFO("Close Command");
+			for(int i=0; i<PASSTHROUGH_MAX_CHANS; i++)
+			{
+				PassthroughChans[i] = false;
+			}
+			PassthroughChanged = true;
 			status = L_DISCONNECT;
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 			
 		case 0x0012: //Set Device User Id	
 			LinxDev->userId = commandPacketBuffer[6] << 8 | commandPacketBuffer[7];		
-			LinxDev->NonVolatileWrite(NVS_USERID, commandPacketBuffer[6]);
-			LinxDev->NonVolatileWrite(NVS_USERID+1, commandPacketBuffer[7]);
+			LinxDev->NonVolatileWriteBlock(NVS_USERID, 2, &commandPacketBuffer[6]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 			
@@ -235,10 +295,8 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 		
 		case 0x0014: //Set Device Ethernet IP
 			LinxDev->ethernetIp = (commandPacketBuffer[6]<<24) | (commandPacketBuffer[7]<<16) | (commandPacketBuffer[8]<<8) | (commandPacketBuffer[9]);
-			LinxDev->NonVolatileWrite(NVS_ETHERNET_IP, commandPacketBuffer[6]);
-			LinxDev->NonVolatileWrite(NVS_ETHERNET_IP+1, commandPacketBuffer[7]);
-			LinxDev->NonVolatileWrite(NVS_ETHERNET_IP+2, commandPacketBuffer[8]);
-			LinxDev->NonVolatileWrite(NVS_ETHERNET_IP+3, commandPacketBuffer[9]);
+			LinxDev->NonVolatileWriteBlock(NVS_ETHERNET_IP, 4, &commandPacketBuffer[6]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 			
@@ -252,8 +310,8 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			
 		case 0x0016: //Set Device Ethernet Port
 			LinxDev->ethernetPort = ((commandPacketBuffer[6]<<8) | (commandPacketBuffer[7]));
-			LinxDev->NonVolatileWrite(NVS_ETHERNET_PORT, commandPacketBuffer[6]);
-			LinxDev->NonVolatileWrite(NVS_ETHERNET_PORT+1, commandPacketBuffer[7]);
+			LinxDev->NonVolatileWriteBlock(NVS_ETHERNET_PORT, 2, &commandPacketBuffer[6]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 			
@@ -265,10 +323,8 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 		
 		case 0x0018: //Set Device WIFI IP
 			LinxDev->WifiIp = (commandPacketBuffer[6]<<24) | (commandPacketBuffer[7]<<16) | (commandPacketBuffer[8]<<8) | (commandPacketBuffer[9]);
-			LinxDev->NonVolatileWrite(NVS_WIFI_IP, commandPacketBuffer[6]);
-			LinxDev->NonVolatileWrite(NVS_WIFI_IP+1, commandPacketBuffer[7]);
-			LinxDev->NonVolatileWrite(NVS_WIFI_IP+2, commandPacketBuffer[8]);
-			LinxDev->NonVolatileWrite(NVS_WIFI_IP+3, commandPacketBuffer[9]);
+			LinxDev->NonVolatileWriteBlock(NVS_WIFI_IP, 4, &commandPacketBuffer[6]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 			
@@ -282,8 +338,8 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			
 		case 0x001A: //Set Device WIFI Port
 			LinxDev->WifiPort = ((commandPacketBuffer[6]<<8) | (commandPacketBuffer[7]));
-			LinxDev->NonVolatileWrite(NVS_WIFI_PORT, commandPacketBuffer[6]);
-			LinxDev->NonVolatileWrite(NVS_WIFI_PORT+1, commandPacketBuffer[7]);
+			LinxDev->NonVolatileWriteBlock(NVS_WIFI_PORT, 2, &commandPacketBuffer[6]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 			
@@ -294,24 +350,24 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			break;
 			
 		case 0x001C: //Set Device WIFI SSID
-			 //Update Ssid Size In RAM And NVS
+			 //Update Ssid Size In RAM
 			if(commandPacketBuffer[6] > 32)
 			{
 				LinxDev->WifiSsidSize = 32;
-				LinxDev->NonVolatileWrite(NVS_WIFI_SSID_SIZE, 32);
 			}
 			else
 			{
 				LinxDev->WifiSsidSize = commandPacketBuffer[6];
-				LinxDev->NonVolatileWrite(NVS_WIFI_SSID_SIZE, commandPacketBuffer[6]);
 			}
 
-			//Update SSID Value In RAM And NVS
+			//Update SSID Value In RAM, Then Commit Size And Value To NVS Together
 			for(int i=0; i<LinxDev->WifiSsidSize; i++)
 			{
 				LinxDev->WifiSsid[i] = commandPacketBuffer[7+i];
-				LinxDev->NonVolatileWrite(NVS_WIFI_SSID+i, commandPacketBuffer[7+i]);    
 			}
+			LinxDev->NonVolatileWriteBlock(NVS_WIFI_SSID_SIZE, 1, &LinxDev->WifiSsidSize);
+			LinxDev->NonVolatileWriteBlock(NVS_WIFI_SSID, LinxDev->WifiSsidSize, &commandPacketBuffer[7]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 			
@@ -327,7 +383,8 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			
 		case 0x001E: //Set Device WIFI Security Type
 			LinxDev->WifiSecurity = commandPacketBuffer[6];
-			LinxDev->NonVolatileWrite(NVS_WIFI_SECURITY_TYPE, commandPacketBuffer[6]);
+			LinxDev->NonVolatileWriteBlock(NVS_WIFI_SECURITY_TYPE, 1, &commandPacketBuffer[6]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 		
@@ -337,24 +394,24 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			break;
 			
 		case 0x0020: //Set Device WIFI Password
-			//Update PW Size In RAM And NVS
+			//Update PW Size In RAM
 			if(commandPacketBuffer[6] > 64)
 			{
 				LinxDev->WifiPwSize = 64;
-				LinxDev->NonVolatileWrite(NVS_WIFI_PW_SIZE, 64);
 			}
 			else
 			{
 				LinxDev->WifiPwSize = commandPacketBuffer[6];
-				LinxDev->NonVolatileWrite(NVS_WIFI_PW_SIZE, commandPacketBuffer[6]);
 			}  
 
-			//Update PW Value In RAM And NVS
+			//Update PW Value In RAM, Then Commit Size And Value To NVS Together
 			for(int i=0; i<LinxDev->WifiPwSize; i++)
 			{
 				LinxDev->WifiPw[i] = commandPacketBuffer[7+i];
-				LinxDev->NonVolatileWrite(NVS_WIFI_PW+i, commandPacketBuffer[i+7]);    
 			}
+			LinxDev->NonVolatileWriteBlock(NVS_WIFI_PW_SIZE, 1, &LinxDev->WifiPwSize);
+			LinxDev->NonVolatileWriteBlock(NVS_WIFI_PW, LinxDev->WifiPwSize, &commandPacketBuffer[7]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 			
@@ -362,10 +419,8 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			
 		case 0x0022: //Set Device Max Baud
 			LinxDev->serialInterfaceMaxBaud = (unsigned long)(((unsigned long)commandPacketBuffer[6]<<24) | ((unsigned long)commandPacketBuffer[7]<<16) | ((unsigned long)commandPacketBuffer[8]<<8) | ((unsigned long)commandPacketBuffer[9]));
-			LinxDev->NonVolatileWrite(NVS_SERIAL_INTERFACE_MAX_BAUD, commandPacketBuffer[6]);
-			LinxDev->NonVolatileWrite(NVS_SERIAL_INTERFACE_MAX_BAUD+1, commandPacketBuffer[7]);
-			LinxDev->NonVolatileWrite(NVS_SERIAL_INTERFACE_MAX_BAUD+2, commandPacketBuffer[8]);
-			LinxDev->NonVolatileWrite(NVS_SERIAL_INTERFACE_MAX_BAUD+3, commandPacketBuffer[9]);
+			LinxDev->NonVolatileWriteBlock(NVS_SERIAL_INTERFACE_MAX_BAUD, 4, &commandPacketBuffer[6]);
+			LinxDev->NonVolatileCommit();
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
 			break;
 		case 0x0023: //Get Device Max Baud
@@ -385,7 +440,162 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			DataBufferResponse(commandPacketBuffer, responsePacketBuffer, LinxDev->ServoChans, LinxDev->NumServoChans, L_OK);
 			break;
 		
-		//---0x0026 to 0x003F Reserved---
+		case 0x0026: // Get Device Time - 64 Bit Monotonic uS, Or nS If [6] Is 1
+		{
+			unsigned long long deviceTime = (commandPacketBuffer[1] > 7 && commandPacketBuffer[6] == 1) ? LinxDev->GetNanoSeconds() : LinxDev->GetMicroSeconds();
+			for(int i=0; i<8; i++)
+			{
+				responsePacketBuffer[5+i] = (deviceTime >> (56 - 8*i)) & 0xFF;		//MSB First
+			}
+			PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, 8, L_OK);
+			break;
+		}
+		
+		case 0x0027: // Get Command Stats - [6] First Slot
+		{
+			//Slot Count, Histogram Flag, Entries In This Packet, Then Per Entry The Opcode And For Handler Then End To End:
+			//Count, Min, Mean, Max (nS), Then p50, p99, p999 (nS) Only If The Histogram Flag Is Set, All Big Endian.
+			unsigned char first = commandPacketBuffer[6];
+			unsigned int maxEntries = (((LinxDev->ListenerBufferSize < 255) ? LinxDev->ListenerBufferSize : 255) - 9) / (2 + STATS_NUM_KINDS*STATS_NUM_VALUES*4);
+			unsigned char numEntries = 0;
+			unsigned char* entry = &responsePacketBuffer[8];
+			
+			for(unsigned int slot=first; slot<CommandStats.NumSlots && numEntries<maxEntries; slot++)
+			{
+				entry[0] = (CommandStats.Commands[slot]>>8) & 0xFF;
+				entry[1] = CommandStats.Commands[slot] & 0xFF;
+				entry += 2;
+				for(int kind=0; kind<STATS_NUM_KINDS; kind++)
+				{
+					const LinxTimeStats* stats = &CommandStats.Times[slot][kind];
+					#if defined(STATS_HISTOGRAMS)
+						unsigned long values[STATS_NUM_VALUES] = {stats->count, (stats->count > 0) ? stats->min : 0, CommandStats.Mean(stats), stats->max, CommandStats.Percentile(stats, 500), CommandStats.Percentile(stats, 990), CommandStats.Percentile(stats, 999)};
+					#else
+						unsigned long values[STATS_NUM_VALUES] = {stats->count, (stats->count > 0) ? stats->min : 0, CommandStats.Mean(stats), stats->max};
+					#endif
+					for(int i=0; i<STATS_NUM_VALUES; i++)
+					{
+						entry[i*4] = (values[i]>>24) & 0xFF;
+						entry[i*4+1] = (values[i]>>16) & 0xFF;
+						entry[i*4+2] = (values[i]>>8) & 0xFF;
+						entry[i*4+3] = values[i] & 0xFF;
+					}
+					entry += STATS_NUM_VALUES*4;
+				}
+				numEntries++;
+			}
+			
+			responsePacketBuffer[5] = CommandStats.NumSlots;
+			#if defined(STATS_HISTOGRAMS)
+				responsePacketBuffer[6] = 1;
+			#else
+				responsePacketBuffer[6] = 0;
+			#endif
+			responsePacketBuffer[7] = numEntries;
+			PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, entry - &responsePacketBuffer[5], L_OK);
+			break;
+		}
+		
+		case 0x0028: // Get Command Histogram - [6..7] Opcode, [8] 0 Handler / 1 End To End, [9] First Bucket
+		{
+			#if defined(STATS_HISTOGRAMS)
+				//Sub Bucket Bits, Total Buckets, First Bucket, Buckets In This Packet, Then The Counts Big Endian
+				int slot = CommandStats.Find(commandPacketBuffer[6]<<8 | commandPacketBuffer[7]);
+				unsigned char kind = commandPacketBuffer[8];
+				unsigned char first = commandPacketBuffer[9];
+				if(kind >= STATS_NUM_KINDS)
+				{
+					StatusResponse(commandPacketBuffer, responsePacketBuffer, L_UNKNOWN_ERROR);
+					break;
+				}
+				
+				unsigned int maxBuckets = (((LinxDev->ListenerBufferSize < 255) ? LinxDev->ListenerBufferSize : 255) - 10) / 4;
+				unsigned char numBuckets = 0;
+				for(unsigned int bucket=first; bucket<STATS_NUM_BUCKETS && numBuckets<maxBuckets; bucket++)
+				{
+					unsigned long count = (slot < 0) ? 0 : CommandStats.Times[slot][kind].buckets[bucket];
+					responsePacketBuffer[9+numBuckets*4] = (count>>24) & 0xFF;
+					responsePacketBuffer[10+numBuckets*4] = (count>>16) & 0xFF;
+					responsePacketBuffer[11+numBuckets*4] = (count>>8) & 0xFF;
+					responsePacketBuffer[12+numBuckets*4] = count & 0xFF;
+					numBuckets++;
+				}
+				responsePacketBuffer[5] = STATS_SUB_BITS;
+				responsePacketBuffer[6] = STATS_NUM_BUCKETS;
+				responsePacketBuffer[7] = first;
+				responsePacketBuffer[8] = numBuckets;
+				PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, 4 + numBuckets*4, L_OK);
+			#else
+				StatusResponse(commandPacketBuffer, responsePacketBuffer, L_FUNCTION_NOT_SUPPORTED);
+			#endif
+			break;
+		}
+		
+		case 0x0029: // Reset Command Stats
+			CommandStats.Reset();
+			StatusResponse(commandPacketBuffer, responsePacketBuffer, L_OK);
+			break;
+		
+		case 0x002A: // Get Trace - [6..9] First Sequence Number
+		{
+			#if defined(TRACE_ENABLED)
+				//Next Sequence Number, First Sequence Number Returned, Events In This Packet, Then The Events As In The Dump File.
+				//The First Returned Is Later Than Asked For When Those Events Were Overwritten Or Cleared.
+				uint32_t first = (uint32_t)commandPacketBuffer[6]<<24 | (uint32_t)commandPacketBuffer[7]<<16 | commandPacketBuffer[8]<<8 | commandPacketBuffer[9];
+				LinxTraceEvent events[(255 - 15) / TRACE_EVENT_SIZE];
+				unsigned int maxEvents = (LinxDev->ListenerBufferSize - 15) / TRACE_EVENT_SIZE;
+				if(maxEvents > sizeof(events) / sizeof(events[0]))
+				{
+					maxEvents = sizeof(events) / sizeof(events[0]);
+				}
+			
+				unsigned char numEvents = Trace.Read(&first, events, maxEvents);
+				uint32_t next = Trace.Next();
+				for(int i=0; i<4; i++)
+				{
+					responsePacketBuffer[5+i] = (next >> (24 - 8*i)) & 0xFF;
+					responsePacketBuffer[9+i] = (first >> (24 - 8*i)) & 0xFF;
+				}
+				responsePacketBuffer[13] = numEvents;
+				for(int i=0; i<numEvents; i++)
+				{
+					LinxTrace::EncodeEvent(&events[i], &responsePacketBuffer[14 + i*TRACE_EVENT_SIZE]);
+				}
+				PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, 9 + numEvents*TRACE_EVENT_SIZE, L_OK);
+			#else
+				StatusResponse(commandPacketBuffer, responsePacketBuffer, L_FUNCTION_NOT_SUPPORTED);
+			#endif
+			break;
+		}
+		
+		case 0x002B: // Configure Trace - [6..7] Event Type Mask, [8] 1 To Clear
+			Trace.Mask = commandPacketBuffer[6]<<8 | commandPacketBuffer[7];
+			if(commandPacketBuffer[8] == 1)
+			{
+				Trace.Clear();
+			}
+			StatusResponse(commandPacketBuffer, responsePacketBuffer, (Trace.Capacity() > 0) ? L_OK : L_FUNCTION_NOT_SUPPORTED);
+			break;
+		
+		case 0x002C: // Get / Set Log Level - [6] New Runtime Level (Optional, Signed)
+		{
+			//Compile Time Level, Runtime Level, Then Messages Dropped To A Full Ring Big Endian
+			if(commandPacketBuffer[1] > 7)
+			{
+				LinxLogger.Level = (signed char)commandPacketBuffer[6];
+			}
+			unsigned long dropped = LinxLogger.Dropped;
+			responsePacketBuffer[5] = (unsigned char)LINX_LOG_LEVEL;
+			responsePacketBuffer[6] = (unsigned char)LinxLogger.Level;
+			responsePacketBuffer[7] = (dropped>>24) & 0xFF;
+			responsePacketBuffer[8] = (dropped>>16) & 0xFF;
+			responsePacketBuffer[9] = (dropped>>8) & 0xFF;
+			responsePacketBuffer[10] = dropped & 0xFF;
+			PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, 6, L_OK);
+			break;
+		}
+		
+		//---0x002D to 0x003F Reserved---
 		
 		/****************************************************************************************
 		**  Digital I/O
@@ -476,7 +686,58 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 		
 		//case 0x0065: //TODO Analog Write
 		
-		//---0x0066 to 0x007F Reserved---
+		case 0x0066: // AI Stream Start
+		{
+			unsigned char numChans = commandPacketBuffer[6];
+			unsigned char* sizeBytes = &commandPacketBuffer[7 + numChans];
+			unsigned long bufferSize = (unsigned long)(((unsigned long)sizeBytes[0] << 24) | ((unsigned long)sizeBytes[1] << 16) | ((unsigned long)sizeBytes[2] << 8) | (unsigned long)sizeBytes[3]);
+			status = LinxDev->AnalogStreamStart(numChans, &commandPacketBuffer[7], bufferSize);
+			AiStreamNumChans = (status == L_OK) ? numChans : 0;
+			StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
+			break;
+		}
+		
+		case 0x0067: // AI Stream Read
+		{
+			//Response Is Resolution, Scans Read, Scans Still Buffered, Then Packed Channel Major Values - Clamp So It Fits In One Packet
+			unsigned long numScans = (unsigned long)((commandPacketBuffer[6] << 8) | commandPacketBuffer[7]);
+			unsigned long timeout = (unsigned long)((commandPacketBuffer[8] << 8) | commandPacketBuffer[9]);
+			unsigned long maxBytes = ((LinxDev->ListenerBufferSize < 255) ? LinxDev->ListenerBufferSize : 255) - 6 - 7 - 1;
+			if(AiStreamNumChans > 0 && LinxDev->AiResolution > 0)
+			{
+				unsigned long maxScans = (maxBytes * 8) / ((unsigned long)AiStreamNumChans * LinxDev->AiResolution);
+				if(numScans > maxScans)
+				{
+					numScans = maxScans;
+				}
+			}
+			
+			unsigned long numScansRead = 0;
+			unsigned long numBuffered = 0;
+			status = LinxDev->AnalogStreamRead(numScans, timeout, &responsePacketBuffer[12], &numScansRead);
+			LinxDev->AnalogStreamGetScansBuffered(&numBuffered);
+			
+			unsigned long numDataBits = numScansRead * AiStreamNumChans * LinxDev->AiResolution;
+			unsigned long numResponseDataBytes = (numDataBits + 7) / 8;
+			
+			responsePacketBuffer[5] = LinxDev->AiResolution;
+			responsePacketBuffer[6] = (numScansRead >> 8) & 0xFF;
+			responsePacketBuffer[7] = numScansRead & 0xFF;
+			responsePacketBuffer[8] = (numBuffered >> 24) & 0xFF;
+			responsePacketBuffer[9] = (numBuffered >> 16) & 0xFF;
+			responsePacketBuffer[10] = (numBuffered >> 8) & 0xFF;
+			responsePacketBuffer[11] = numBuffered & 0xFF;
+			PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, 7 + numResponseDataBytes, status);
+			break;
+		}
+		
+		case 0x0068: // AI Stream Stop
+			status = LinxDev->AnalogStreamStop();
+			AiStreamNumChans = 0;
+			StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
+			break;
+		
+		//---0x0069 to 0x007F Reserved---
 		
 		/****************************************************************************************
 		** PWM
@@ -484,7 +745,26 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 		
 		//case 0x0080: //TODO PWM Open
 		//case 0x0081: //TODO PWM Set Mode
-		//case 0x0082: //TODO PWM Set Frequency
+		case 0x0082: //PWM Set Frequency
+		{
+			//Channels Followed By One 32 Bit Frequency (Hz) Per Channel
+			unsigned char numChans = commandPacketBuffer[6];
+			if(commandPacketBuffer[1] != 7 + 5*numChans + 1)
+			{
+				status = L_UNKNOWN_ERROR;
+				StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
+				break;
+			}
+			unsigned long frequencies[numChans];
+			for(int i=0; i<numChans; i++)
+			{
+				unsigned char* frequency = &commandPacketBuffer[7 + numChans + 4*i];
+				frequencies[i] = (unsigned long)((unsigned long)(frequency[0] << 24) | (unsigned long)(frequency[1] << 16) | (unsigned long)(frequency[2] << 8) | (unsigned long)frequency[3]);
+			}
+			status = LinxDev->PwmSetFrequency(numChans, &commandPacketBuffer[7], frequencies);
+			StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
+			break;
+		}
 		
 		case 0x0083: //PWM Set Duty Cycle	
 			status = LinxDev->PwmSetDutyCycle(commandPacketBuffer[6], &commandPacketBuffer[7], &commandPacketBuffer[commandPacketBuffer[6] + 7] );
@@ -556,7 +836,52 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			break;
 		}
 		
-		//---0x00C6 to 0x00DF Reserved---
+		case 0x00C6: // UART Enable RX Thread
+		{
+			unsigned long bufferSize = (unsigned long)((unsigned long)(commandPacketBuffer[7] << 24) | (unsigned long)(commandPacketBuffer[8] << 16) | (unsigned long)(commandPacketBuffer[9] << 8) | (unsigned long)commandPacketBuffer[10]);
+			status = LinxDev->UartEnableRxThread(commandPacketBuffer[6], bufferSize);
+			StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
+			break;
+		}
+		case 0x00C7: // UART Read With Timeout
+		{
+			//Response Is An 8 Byte Timestamp (nS) Followed By The Data, Clamp So It Fits In One Packet
+			unsigned long numBytes = commandPacketBuffer[7];
+			unsigned long timeout = (unsigned long)((commandPacketBuffer[8] << 8) | commandPacketBuffer[9]);
+			unsigned long maxBytes = ((LinxDev->ListenerBufferSize < 255) ? LinxDev->ListenerBufferSize : 255) - 6 - 8;
+			if(numBytes > maxBytes)
+			{
+				numBytes = maxBytes;
+			}
+
+			unsigned long numBytesRead = 0;
+			unsigned long long timestamp = 0;
+			status = LinxDev->UartReadTimeout(commandPacketBuffer[6], numBytes, timeout, &responsePacketBuffer[13], &numBytesRead, &timestamp);
+			for(int i=0; i<8; i++)
+			{
+				responsePacketBuffer[5+i] = (timestamp >> (56 - 8*i)) & 0xFF;						//Timestamp MSB First
+			}
+			PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, 8 + numBytesRead, status);
+			break;
+		}
+
+		case 0x00C8: // UART Passthrough Start
+		case 0x00C9: // UART Passthrough Stop
+		{
+			if(commandPacketBuffer[6] >= PASSTHROUGH_MAX_CHANS)
+			{
+				status = L_FUNCTION_NOT_SUPPORTED;
+			}
+			else
+			{
+				PassthroughChans[commandPacketBuffer[6]] = (command == 0x00C8);
+				PassthroughChanged = true;
+			}
+			StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
+			break;
+		}
+		
+		//---0x00CA to 0x00DF Reserved---
 		
 		/****************************************************************************************
 		** I2C
@@ -592,7 +917,20 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
 			break;
 			
-		//---0x00E5 to 0x00FF Reserved---
+		case 0x00E5: // I2C Write Read
+			//[6] Channel, [7] Slave Address, [8] Number Of Bytes To Read, [9..10] Timeout, [11...] Bytes To Write (Register Pointer)
+			//Reject Packets Too Short To Hold The Header And Reads Whose Response Would Not Fit The Buffer
+			if(commandPacketBuffer[1] < 12 || commandPacketBuffer[8] + 6 > 255 || commandPacketBuffer[8] + 6 > LinxDev->ListenerBufferSize)
+			{
+				status = LI2C_INVALID_TRANSACTION;
+				StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
+				break;
+			}
+			status = LinxDev->I2cWriteRead(commandPacketBuffer[6], commandPacketBuffer[7], (commandPacketBuffer[1]-12), &commandPacketBuffer[11], commandPacketBuffer[8], ((commandPacketBuffer[9]<<8) | commandPacketBuffer[10]), &responsePacketBuffer[5]);
+			PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, commandPacketBuffer[8], status); 		
+			break;
+			
+		//---0x00E6 to 0x00FF Reserved---
 			
 		/****************************************************************************************
 		** SPI
@@ -642,6 +980,68 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			break;
 		}
 		
+		case 0x0108: // SPI Transaction
+		{
+			//[6] Channel, [7] CS Channel, [8] CS Logic Level, [9] Number Of Segments, Then For Each Segment:
+			//[Type][Num Bytes][Speed (4 Bytes, 0 = Channel Speed)][Delay uS (2 Bytes)][Tx Data (Omitted For Rx Only)]
+			//Response Is The Rx Data Of Every Full Duplex And Rx Only Segment, In Order
+			unsigned char numSegments = commandPacketBuffer[9];
+			LinxSpiSegment segments[numSegments > 0 ? numSegments : 1];
+			unsigned int packetEnd = commandPacketBuffer[1] - 1;		//Checksum Position
+			unsigned int offset = 10;
+			unsigned int dataSize = 0;
+			
+			status = L_OK;
+			for(int i=0; i<numSegments && status == L_OK; i++)
+			{
+				if(offset + 8 > packetEnd)
+				{
+					status = LSPI_INVALID_TRANSACTION;
+					break;
+				}
+				
+				segments[i].type = commandPacketBuffer[offset];
+				segments[i].numBytes = commandPacketBuffer[offset+1];
+				segments[i].speed = (unsigned long)commandPacketBuffer[offset+2] << 24 | (unsigned long)commandPacketBuffer[offset+3] << 16 | (unsigned long)commandPacketBuffer[offset+4] << 8 | (unsigned long)commandPacketBuffer[offset+5];
+				segments[i].delayUs = commandPacketBuffer[offset+6] << 8 | commandPacketBuffer[offset+7];
+				segments[i].sendBuffer = NULL;
+				segments[i].recBuffer = NULL;
+				offset += 8;
+				
+				if(segments[i].type > SPI_SEGMENT_RX_ONLY)
+				{
+					status = LSPI_INVALID_TRANSACTION;
+				}
+				if(segments[i].type != SPI_SEGMENT_RX_ONLY)
+				{
+					segments[i].sendBuffer = &commandPacketBuffer[offset];
+					offset += segments[i].numBytes;
+				}
+				if(segments[i].type != SPI_SEGMENT_TX_ONLY)
+				{
+					segments[i].recBuffer = &responsePacketBuffer[5+dataSize];
+					dataSize += segments[i].numBytes;
+				}
+			}
+			
+			//Tx Data Must Fit In The Command And Rx Data Must Fit In The Response
+			if(offset != packetEnd || dataSize + 6 > 255 || dataSize + 6 > LinxDev->ListenerBufferSize)
+			{
+				status = LSPI_INVALID_TRANSACTION;
+			}
+			
+			if(status == L_OK)
+			{
+				status = LinxDev->SpiTransaction(commandPacketBuffer[6], commandPacketBuffer[7], commandPacketBuffer[8], numSegments, segments);
+			}
+			else
+			{
+				dataSize = 0;
+			}
+			PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, dataSize, status); 
+			break;
+		}
+		
 		//---0x0085 to 0x009F Reserved---
 		
 		/****************************************************************************************
@@ -674,12 +1074,9 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 				tempVals[i] = *(valPtr + (i*2))<<8  | *(valPtr + (i*2) + 1);								//Create Unsigned Short From Bytes (Swap To Fix Endianess)							
 			}
 			
-			//TODO REMOVE DEBUG PRINT
-			//LinxDev->DebugPrintln("::tempVals::");
-			
 			for(int i=0; i<commandPacketBuffer[6]; i++)
 			{
-				LinxDev->DebugPrintln(tempVals[i], DEC);
+				LINX_LOG_DEBUG("Servo %u Pulse Width %u", commandPacketBuffer[7+i], tempVals[i]);
 			}
 			
 			status = LinxDev->ServoSetPulseWidth(commandPacketBuffer[6], &commandPacketBuffer[7], tempVals);
@@ -690,6 +1087,31 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 			status = LinxDev->ServoClose((commandPacketBuffer[1]-7), &commandPacketBuffer[6]);
 			StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
 			break;
+		case 0x0143: // Soft PWM / Servo Get Timing Stats
+		{
+			//[6] Reset Counters After Reading (Optional)
+			LinxSoftPwmStats stats;
+			unsigned char reset = (commandPacketBuffer[1] > 7) ? commandPacketBuffer[6] : 0;
+			status = LinxDev->SoftPwmGetStats(&stats, reset);
+			if(status != L_OK)
+			{
+				StatusResponse(commandPacketBuffer, responsePacketBuffer, status);
+				break;
+			}
+			
+			//Real Time Flag Then Wakeups, Edges, Min, Max, Mean Latency (nS) Big Endian
+			unsigned long values[5] = {stats.numWakeups, stats.numEdges, stats.latencyMin, stats.latencyMax, stats.latencyMean};
+			responsePacketBuffer[5] = stats.realTime;
+			for(int i=0; i<5; i++)
+			{
+				responsePacketBuffer[6+i*4] = (values[i]>>24) & 0xFF;
+				responsePacketBuffer[7+i*4] = (values[i]>>16) & 0xFF;
+				responsePacketBuffer[8+i*4] = (values[i]>>8) & 0xFF;
+				responsePacketBuffer[9+i*4] = values[i] & 0xFF;
+			}
+			PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, 21, L_OK);
+			break;
+		}
 		
 		/****************************************************************************************
 		** WS2812
@@ -724,6 +1146,10 @@ int LinxListener::ProcessCommand(unsigned char* commandPacketBuffer, unsigned ch
 		}
 	}
 	
+	unsigned long long handlerEnd = LinxDev->GetNanoSeconds();
+	CommandStats.Record(command, STATS_HANDLER, handlerEnd - handlerStart);
+	Trace.Record(handlerEnd, TRACE_HANDLER_END, command, responsePacketBuffer[4], responsePacketBuffer[1]);
+	LastCommand = command;
 	return status;
 }
 
@@ -761,6 +1187,60 @@ void LinxListener::DataBufferResponse(unsigned char* commandPacketBuffer, unsign
 	PacketizeAndSend(commandPacketBuffer, responsePacketBuffer, dataSize, status);
 }
 
+bool LinxListener::PassthroughActive()
+{
+	for(int i=0; i<PASSTHROUGH_MAX_CHANS; i++)
+	{
+		if(PassthroughChans[i])
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//Frame Whatever The UART Has Buffered As [0xFE][Size][Channel][Data...][Checksum], Returns The Frame Size (0 If No Data)
+unsigned int LinxListener::BuildPassthroughFrame(unsigned char channel, unsigned char* frameBuffer, unsigned int maxFrameSize)
+{
+	if(channel >= PASSTHROUGH_MAX_CHANS || !PassthroughChans[channel])
+	{
+		return 0;
+	}
+	if(maxFrameSize > 255)
+	{
+		maxFrameSize = 255;
+	}
+	
+	unsigned long numBytesRead = 0;
+	LinxDev->UartReadTimeout(channel, maxFrameSize - 4, 0, &frameBuffer[3], &numBytesRead, NULL);
+	if(numBytesRead == 0)
+	{
+		return 0;
+	}
+	
+	frameBuffer[0] = PASSTHROUGH_SOF;
+	frameBuffer[1] = numBytesRead + 4;
+	frameBuffer[2] = channel;
+	frameBuffer[numBytesRead + 3] = ComputeChecksum(frameBuffer);
+	Trace.Record(LinxDev->GetNanoSeconds(), TRACE_PASSTHROUGH_TX, channel, 0, numBytesRead + 4);
+	
+	return numBytesRead + 4;
+}
+
+//Write A Passthrough Frame From The Client To Its UART, No Response Is Sent
+int LinxListener::ProcessPassthroughFrame(unsigned char* frameBuffer)
+{
+	unsigned char channel = frameBuffer[2];
+	if(frameBuffer[1] < 4 || !ChecksumPassed(frameBuffer) || channel >= PASSTHROUGH_MAX_CHANS || !PassthroughChans[channel])
+	{
+		Trace.Record(LinxDev->GetNanoSeconds(), TRACE_PASSTHROUGH_RX, channel, 1, frameBuffer[1]);
+		return L_UNKNOWN_ERROR;
+	}
+	
+	Trace.Record(LinxDev->GetNanoSeconds(), TRACE_PASSTHROUGH_RX, channel, 0, frameBuffer[1] - 4);
+	return LinxDev->UartWrite(channel, frameBuffer[1] - 4, &frameBuffer[3]);
+}
+
 void LinxListener::AttachCustomCommand(unsigned short commandNumber, int (*function)(unsigned char, unsigned char*, unsigned char*, unsigned char*) )
 {
 	customCommands[commandNumber] = function;
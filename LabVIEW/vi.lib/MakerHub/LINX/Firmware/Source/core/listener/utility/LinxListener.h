@@ -15,11 +15,15 @@
 /****************************************************************************************
 ** Defines
 ****************************************************************************************/
+#define PASSTHROUGH_SOF 0xFE							//Start Of Frame For UART Passthrough Data (Commands Use 0xFF)
+#define PASSTHROUGH_MAX_CHANS 8						//Highest UART Channel Number + 1 That Can Be Passed Through
 
 /****************************************************************************************
 ** Includes
 ****************************************************************************************/
 #include "LinxDevice.h"
+#include "LinxCommandStats.h"
+#include "LinxTrace.h"
 
 /****************************************************************************************
 ** Enums
@@ -61,6 +65,15 @@ class LinxListener
 		unsigned char* recBuffer;
 		unsigned char* sendBuffer;
 		
+		bool PassthroughChans[PASSTHROUGH_MAX_CHANS];	//UART Channels Forwarded Directly To The Client
+		bool PassthroughChanged;									//Set When A Channel Starts Or Stops Passthrough
+		unsigned char AiStreamNumChans;							//Channels In The Running AI Stream, 0 When Stopped
+		
+		LinxCommandStats CommandStats;							//Handler And End To End Times Per Opcode
+		unsigned long long PacketRxTime;						//nS, When The Packet Being Handled Started Arriving, 0 When Idle
+		unsigned short LastCommand;								//Opcode Of The Last Packet Processed
+		LinxTrace Trace;											//Recent Listener Events, Cheap Enough To Leave On
+		
 		int (*customCommands[16])(unsigned char, unsigned char*, unsigned char*, unsigned char*);
 		int (*periodicTasks[1])(unsigned char*, unsigned char*);
 		
@@ -90,8 +103,15 @@ class LinxListener
 		void PacketizeAndSend(unsigned char* commandPacketBuffer, unsigned char* responsePacketBuffer, unsigned int dataSize, int status);
 		void StatusResponse(unsigned char* commandPacketBuffer, unsigned char* responsePacketBuffer, int status);
 		void DataBufferResponse(unsigned char* commandPacketBuffer, unsigned char* responsePacketBuffer, const unsigned char* dataBuffer, unsigned char dataSize, int status);
+		bool PassthroughActive();
+		unsigned int BuildPassthroughFrame(unsigned char channel, unsigned char* frameBuffer, unsigned int maxFrameSize);
+		int ProcessPassthroughFrame(unsigned char* frameBuffer);
 		unsigned char ComputeChecksum(unsigned char* packetBuffer);
 		bool ChecksumPassed(unsigned char* packetBuffer);		
+		void PacketReceived();									//Listeners Call When The Start Of A Packet Arrives
+		void ResponseSent();									//And Once The Response Has Gone Out
+		void PacketDropped(unsigned char reason);				//Or When Its Bytes Are Flushed, reason Is A LinxTraceDrop
+		void StateChanged(LinxListenerState previous);			//CheckForCommands() Calls After Running The State Machine
 };
 
 #endif //LINX_LISTENER_H
\ No newline at end of file
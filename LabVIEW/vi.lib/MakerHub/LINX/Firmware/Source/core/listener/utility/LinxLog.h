@@ -0,0 +1,119 @@
+/****************************************************************************************
+**  LINX header for deferred, leveled logging.
+**
+**  LINX_LOG_ERROR() / WARN() / INFO() / DEBUG() take a printf style format and its
+**  arguments but do not format anything.  The format pointer and the raw arguments are
+**  copied into a ring buffer and turned into text later, by a background thread on Linux
+**  or by Poll() from the listener's idle loop on MCUs, then written to the debug channel.
+**  A full ring drops the message rather than waiting.
+**
+**  Formats must outlive the message, so pass string literals.  %s arguments are copied.
+**  Supported conversions are d i u x X o c with h / l / ll, f e g E G, s, p and %%.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_LOG_H
+#define LINX_LOG_H
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include "LinxDevice.h"
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+#define LOG_LEVEL_NONE -1
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+
+//Messages Above LINX_LOG_LEVEL Compile To Nothing.  By Default Everything Is Kept When There Is A Debug Channel And Nothing When There Is Not.
+#ifndef LINX_LOG_LEVEL
+	#if defined(DEBUG_ENABLED) && DEBUG_ENABLED >= 0
+		#define LINX_LOG_LEVEL LOG_LEVEL_DEBUG
+	#else
+		#define LINX_LOG_LEVEL LOG_LEVEL_NONE
+	#endif
+#endif
+
+#if defined(__linux__)
+	#define LOG_NUM_RECORDS 256									//Messages Waiting To Be Formatted, Must Be A Power Of Two
+	#define LOG_MAX_ARGS 6										//Later Arguments Print As ?
+	#define LOG_TEXT_SIZE 64									//Bytes Of %s Arguments Per Message
+	#define LOG_LINE_SIZE 256
+	#define LOG_POLL_MS 5										//Formatter Thread Sleep When The Ring Is Empty
+#else
+	#define LOG_NUM_RECORDS 4
+	#define LOG_MAX_ARGS 4
+	#define LOG_TEXT_SIZE 16
+	#define LOG_LINE_SIZE 96
+#endif
+
+//Arguments Are Captured By The Type The Format Says, So Let The Compiler Check Them
+#if defined(__GNUC__)
+	#define LOG_FORMAT_CHECK __attribute__((format(printf, 3, 4)))
+#else
+	#define LOG_FORMAT_CHECK
+#endif
+
+#define LINX_LOG(level, ...) do { if((level) <= LINX_LOG_LEVEL && (level) <= LinxLogger.Level) { LinxLogger.Write((level), __VA_ARGS__); } } while(0)
+#define LINX_LOG_ERROR(...) LINX_LOG(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LINX_LOG_WARN(...) LINX_LOG(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LINX_LOG_INFO(...) LINX_LOG(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LINX_LOG_DEBUG(...) LINX_LOG(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+/****************************************************************************************
+**  Typedefs
+****************************************************************************************/
+typedef void (*LinxLogSink)(int level, const char* line);
+
+/****************************************************************************************
+**  Classes
+****************************************************************************************/
+class LinxLog
+{
+	public:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		int Level;												//Runtime Level, Messages Above It Are Not Captured
+		unsigned long Dropped;									//Messages Lost To A Full Ring
+
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxLog();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		void Write(int level, const char* format, ...) LOG_FORMAT_CHECK;	//Use The LINX_LOG_* Macros So Disabled Levels Cost Nothing
+		void Attach(LinxDevice* device);						//Time Stamps From device, Lines To Its Debug Channel Unless A Sink Is Set
+		void SetSink(LinxLogSink sink);
+		int Poll(int maxMessages);								//Format And Output Up To maxMessages, Returns How Many Were
+		void Flush();
+
+	private:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		LinxDevice* Device;
+		LinxLogSink Sink;
+		unsigned long DroppedReported;
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		void output(int level, const char* line);
+		void startFormatter();
+};
+
+extern LinxLog LinxLogger;
+
+#endif //LINX_LOG_H
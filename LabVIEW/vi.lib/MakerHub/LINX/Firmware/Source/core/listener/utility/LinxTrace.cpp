@@ -0,0 +1,231 @@
+/****************************************************************************************
+**  LINX binary event tracer.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <string.h>
+#include "LinxDevice.h"
+#include "LinxTrace.h"
+
+#if defined(__linux__)
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <unistd.h>
+#endif
+
+/****************************************************************************************
+**  Variables
+****************************************************************************************/
+#if defined(__linux__) && defined(TRACE_ENABLED)
+	static LinxTrace* SignalTrace = NULL;
+	static char SignalPath[256];
+
+	//Only Async Signal Safe Calls From Here Down
+	static void dumpSignalHandler(int signalNumber)
+	{
+		int savedErrno = errno;
+		int fd = open(SignalPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if(fd >= 0)
+		{
+			SignalTrace->Dump(fd);
+			close(fd);
+		}
+		errno = savedErrno;
+	}
+#endif
+
+/****************************************************************************************
+**  Constructors
+****************************************************************************************/
+LinxTrace::LinxTrace()
+{
+	Mask = 0xFFFF;
+	Head = 0;
+	ClearedAt = 0;
+}
+
+/****************************************************************************************
+**  Functions
+****************************************************************************************/
+//Sequence Numbers Keep Counting Across A Clear So A Host Paging Through The Ring Never Sees Them Go Back
+void LinxTrace::Clear()
+{
+	ClearedAt = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+}
+
+uint32_t LinxTrace::Next()
+{
+	return __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+}
+
+//The Slot At Head Is Also The Oldest Once The Ring Has Wrapped, And May Be Half Written, So It Is Never Reported
+uint32_t LinxTrace::Oldest()
+{
+	uint32_t head = Next();
+	uint32_t available = head - ClearedAt;
+	if(Capacity() == 0)
+	{
+		return head;
+	}
+	return (available > Capacity() - 1) ? head - (Capacity() - 1) : ClearedAt;
+}
+
+unsigned int LinxTrace::Read(uint32_t* first, LinxTraceEvent* events, unsigned int maxEvents)
+{
+	#if defined(TRACE_ENABLED)
+		uint32_t head = Next();
+		uint32_t oldest = Oldest();
+		if((int32_t)(*first - oldest) < 0)
+		{
+			*first = oldest;
+		}
+		else if((int32_t)(head - *first) < 0)
+		{
+			*first = head;
+		}
+
+		unsigned int numEvents = head - *first;
+		if(numEvents > maxEvents)
+		{
+			numEvents = maxEvents;
+		}
+		for(unsigned int i=0; i<numEvents; i++)
+		{
+			events[i] = Events[(*first + i) & (TRACE_NUM_EVENTS - 1)];
+		}
+
+		//Drop Any The Writer Lapped While They Were Being Copied
+		uint32_t safe = Next() - (TRACE_NUM_EVENTS - 1);
+		if((int32_t)(safe - *first) > 0)
+		{
+			unsigned int lost = safe - *first;
+			if(lost >= numEvents)
+			{
+				*first = safe;
+				return 0;
+			}
+			memmove(events, events + lost, (numEvents - lost) * sizeof(LinxTraceEvent));
+			numEvents -= lost;
+			*first = safe;
+		}
+		return numEvents;
+	#else
+		*first = Head;
+		return 0;
+	#endif
+}
+
+unsigned int LinxTrace::Capacity()
+{
+	#if defined(TRACE_ENABLED)
+		return TRACE_NUM_EVENTS;
+	#else
+		return 0;
+	#endif
+}
+
+//Header Is Magic, Version, Event Size, First Sequence Number And Event Count, Then The Events Oldest First, All Big Endian
+int LinxTrace::Dump(int fd)
+{
+	#if defined(__linux__) && defined(TRACE_ENABLED)
+		LinxTraceEvent events[64];
+		unsigned char buffer[64 * TRACE_EVENT_SIZE];
+		uint32_t first = Oldest();
+		uint32_t count = Next() - first;
+
+		uint32_t header[4] = {TRACE_FILE_MAGIC, (TRACE_FILE_VERSION << 16) | TRACE_EVENT_SIZE, first, count};
+		for(int i=0; i<4; i++)
+		{
+			buffer[i*4] = (header[i] >> 24) & 0xFF;
+			buffer[i*4+1] = (header[i] >> 16) & 0xFF;
+			buffer[i*4+2] = (header[i] >> 8) & 0xFF;
+			buffer[i*4+3] = header[i] & 0xFF;
+		}
+		if(write(fd, buffer, TRACE_FILE_HEADER_SIZE) != TRACE_FILE_HEADER_SIZE)
+		{
+			return L_UNKNOWN_ERROR;
+		}
+
+		//Events Lost To The Writer Mid Dump Leave The File Short Of The Header Count, The Decoder Stops At The End
+		uint32_t end = first + count;
+		while((int32_t)(end - first) > 0)
+		{
+			unsigned int numEvents = Read(&first, events, ((end - first) < 64) ? (end - first) : 64);
+			if(numEvents == 0)
+			{
+				break;
+			}
+			for(unsigned int i=0; i<numEvents; i++)
+			{
+				EncodeEvent(&events[i], buffer + i*TRACE_EVENT_SIZE);
+			}
+			if(write(fd, buffer, numEvents * TRACE_EVENT_SIZE) != (ssize_t)(numEvents * TRACE_EVENT_SIZE))
+			{
+				return L_UNKNOWN_ERROR;
+			}
+			first += numEvents;
+		}
+		return L_OK;
+	#else
+		return L_FUNCTION_NOT_SUPPORTED;
+	#endif
+}
+
+//SA_RESTART So Blocking Listener Calls Carry On After A Dump
+int LinxTrace::DumpOnSignal(int signalNumber, const char* path)
+{
+	#if defined(__linux__) && defined(TRACE_ENABLED)
+		if(strlen(path) >= sizeof(SignalPath))
+		{
+			return L_UNKNOWN_ERROR;
+		}
+		strcpy(SignalPath, path);
+		SignalTrace = this;
+
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler = dumpSignalHandler;
+		action.sa_flags = SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		return (sigaction(signalNumber, &action, NULL) == 0) ? L_OK : L_UNKNOWN_ERROR;
+	#else
+		return L_FUNCTION_NOT_SUPPORTED;
+	#endif
+}
+
+void LinxTrace::EncodeEvent(const LinxTraceEvent* event, unsigned char* buffer)
+{
+	for(int i=0; i<8; i++)
+	{
+		buffer[i] = (event->time >> (56 - 8*i)) & 0xFF;
+	}
+	buffer[8] = event->type;
+	buffer[9] = event->status;
+	buffer[10] = (event->command >> 8) & 0xFF;
+	buffer[11] = event->command & 0xFF;
+	buffer[12] = (event->arg >> 24) & 0xFF;
+	buffer[13] = (event->arg >> 16) & 0xFF;
+	buffer[14] = (event->arg >> 8) & 0xFF;
+	buffer[15] = event->arg & 0xFF;
+}
+
+void LinxTrace::DecodeEvent(const unsigned char* buffer, LinxTraceEvent* event)
+{
+	event->time = 0;
+	for(int i=0; i<8; i++)
+	{
+		event->time = (event->time << 8) | buffer[i];
+	}
+	event->type = buffer[8];
+	event->status = buffer[9];
+	event->command = (buffer[10] << 8) | buffer[11];
+	event->arg = ((uint32_t)buffer[12] << 24) | ((uint32_t)buffer[13] << 16) | ((uint32_t)buffer[14] << 8) | buffer[15];
+}
@@ -0,0 +1,142 @@
+/****************************************************************************************
+**  LINX header for the binary event tracer.
+**
+**  Keeps the last TRACE_NUM_EVENTS listener events (packets in and out, handler start
+**  and end, drops, passthrough frames and state changes) as fixed size records with a
+**  nS time stamp in a ring buffer.  Recording is a few stores, so it can stay on under
+**  full load where formatting packets as text through DebugPrint would not.  The ring
+**  is read back with the Get Trace command, or on Linux written to a file on a signal,
+**  and turned into text by utils/src/traceDecode.cpp.
+**
+**  For more information see:           www.labviewmakerhub.com/linx
+**  For support visit the forums at:    www.labviewmakerhub.com/forums/linx
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_TRACE_H
+#define LINX_TRACE_H
+
+/****************************************************************************************
+**  Includes
+****************************************************************************************/
+#include <stdint.h>
+
+/****************************************************************************************
+**  Defines
+****************************************************************************************/
+//Always On For Linux, MCUs Opt In With LINX_TRACE Since The Ring Costs RAM
+#if defined(__linux__) || defined(LINX_TRACE)
+	#define TRACE_ENABLED
+	#ifndef TRACE_NUM_EVENTS
+		#if defined(__linux__)
+			#define TRACE_NUM_EVENTS 4096							//Must Be A Power Of Two
+		#else
+			#define TRACE_NUM_EVENTS 32
+		#endif
+	#endif
+#endif
+
+#ifndef TRACE_DUMP_PATH
+	#define TRACE_DUMP_PATH "/tmp/linx_trace.bin"				//Where The Ring Is Written On The Dump Signal
+#endif
+
+#define TRACE_EVENT_SIZE 16										//Bytes Per Encoded Event
+#define TRACE_FILE_MAGIC 0x4C585452UL							//"LXTR"
+#define TRACE_FILE_VERSION 1
+#define TRACE_FILE_HEADER_SIZE 16
+
+/****************************************************************************************
+**  Typedefs
+****************************************************************************************/
+typedef enum LinxTraceType
+{
+	TRACE_PACKET_RX = 0,										//Command Packet Accepted, Time Is When It Started Arriving.  Arg = Size << 16 | Packet Number
+	TRACE_HANDLER_START,										//Arg = Packet Number
+	TRACE_HANDLER_END,											//Status = Response Status, Arg = Response Size
+	TRACE_PACKET_TX,											//Response Sent.  Arg = nS Since TRACE_PACKET_RX, Saturating
+	TRACE_DROP,													//Status = LinxTraceDrop
+	TRACE_STATE,												//Status = New State, Arg = Old State
+	TRACE_PASSTHROUGH_RX,										//Command = Channel, Status = 0 Written / 1 Rejected, Arg = Data Bytes
+	TRACE_PASSTHROUGH_TX,										//Command = Channel, Arg = Frame Bytes
+	TRACE_USER,													//Free For Custom Commands And Examples
+	TRACE_NUM_TYPES
+}LinxTraceType;
+
+typedef enum LinxTraceDrop
+{
+	TRACE_DROP_SOF = 0,											//Bad Start Of Frame, Input Flushed
+	TRACE_DROP_CHECKSUM,
+	TRACE_DROP_TIMEOUT											//Rest Of The Packet Never Arrived
+}LinxTraceDrop;
+
+typedef struct LinxTraceEvent
+{
+	uint64_t time;												//nS, LinxDevice::GetNanoSeconds()
+	uint8_t type;
+	uint8_t status;
+	uint16_t command;
+	uint32_t arg;
+}LinxTraceEvent;
+
+/****************************************************************************************
+**  Classes
+****************************************************************************************/
+class LinxTrace
+{
+	public:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		uint16_t Mask;											//Bit Per LinxTraceType, Cleared Bits Are Not Recorded
+
+		/****************************************************************************************
+		**  Constructors
+		****************************************************************************************/
+		LinxTrace();
+
+		/****************************************************************************************
+		**  Functions
+		****************************************************************************************/
+		//Single Writer, Called From The Listener Loop Only.  The Slot Is Filled Before Head Moves Past It.
+		inline void Record(uint64_t time, uint8_t type, uint16_t command, uint8_t status, uint32_t arg)
+		{
+			#if defined(TRACE_ENABLED)
+				if((Mask & (1 << type)) == 0)
+				{
+					return;
+				}
+				LinxTraceEvent* event = &Events[Head & (TRACE_NUM_EVENTS - 1)];
+				event->time = time;
+				event->type = type;
+				event->status = status;
+				event->command = command;
+				event->arg = arg;
+				__atomic_store_n(&Head, Head + 1, __ATOMIC_RELEASE);
+			#endif
+		}
+
+		void Clear();
+		uint32_t Next();										//Sequence Number The Next Event Will Get
+		uint32_t Oldest();										//Sequence Number Of The Oldest Event Still In The Ring
+		unsigned int Read(uint32_t* first, LinxTraceEvent* events, unsigned int maxEvents);	//Events From *first On, *first Moves Up If They Were Overwritten
+		unsigned int Capacity();								//0 When Tracing Is Compiled Out
+
+		int Dump(int fd);										//Write The Ring In The File Format, Safe In A Signal Handler
+		int DumpOnSignal(int signalNumber, const char* path);	//Linux Only, Otherwise L_FUNCTION_NOT_SUPPORTED
+
+		static void EncodeEvent(const LinxTraceEvent* event, unsigned char* buffer);			//TRACE_EVENT_SIZE Bytes, Big Endian
+		static void DecodeEvent(const unsigned char* buffer, LinxTraceEvent* event);
+
+	private:
+		/****************************************************************************************
+		**  Variables
+		****************************************************************************************/
+		#if defined(TRACE_ENABLED)
+			LinxTraceEvent Events[TRACE_NUM_EVENTS];
+		#endif
+		uint32_t Head;											//Total Events Recorded, Wraps
+		uint32_t ClearedAt;										//Head When Last Cleared
+};
+
+#endif //LINX_TRACE_H
@@ -0,0 +1,41 @@
+/****************************************************************************************
+**  Shared pass / fail bookkeeping for the host side tests.
+**
+**  Each test is a single translation unit, so the counter lives in this header.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef LINX_TEST_CHECK_H
+#define LINX_TEST_CHECK_H
+
+#include <stdio.h>
+#include <time.h>
+
+static int numFailed = 0;
+
+//Print One PASS / FAIL Line And Count Failures
+static inline void check(bool passed, const char* name)
+{
+	fprintf(stdout, "%s  %s\n", passed ? "PASS" : "FAIL", name);
+	if(!passed)
+	{
+		numFailed++;
+	}
+}
+
+//Print The Summary Banner, Returns The Number Of Failed Checks For main()
+static inline int checkSummary()
+{
+	fprintf(stdout, "\r\n%d check(s) failed\r\n", numFailed);
+	return numFailed;
+}
+
+static inline unsigned long long monotonicUs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+#endif //LINX_TEST_CHECK_H
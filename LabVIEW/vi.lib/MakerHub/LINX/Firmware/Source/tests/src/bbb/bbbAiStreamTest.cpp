@@ -0,0 +1,239 @@
+/****************************************************************************************
+**  Host side test for IIO buffered AI acquisition on the BeagleBone family.
+**
+**  The IIO sysfs directory is mocked with plain files and the character device with a
+**  FIFO, so scan element setup, deinterleaving and the listener stream commands can be
+**  checked without an ADC.  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "LinxDevice.h"
+#include "LinxBeagleBone.h"
+#include "LinxIioBuffer.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+const unsigned char aiChans[7] = {0, 1, 2, 3, 4, 5, 6};
+constexpr LinxChannelSlots aiSlots(7, aiChans);
+
+//BeagleBone With The ADC IIO Device Replaced
+class FakeIioBeagleBone : public LinxBeagleBone
+{
+	public:
+		FakeIioBeagleBone(const char* sysfsPath, const char* devPath)
+		{
+			AiIioPath = sysfsPath;
+			AiIioDevPath = devPath;
+			AiResolution = 12;
+			bindAiSlots(&aiSlots);
+			for(int i=0; i<7; i++)
+			{
+				AiValuePaths[i] = "";
+			}
+		}
+};
+
+char sysfsDir[] = "/tmp/linxiioXXXXXX";
+char devPath[64];
+
+void writeFile(const char* name, const char* value)
+{
+	char path[128];
+	sprintf(path, "%s/%s", sysfsDir, name);
+	FILE* handle = fopen(path, "w");
+	fputs(value, handle);
+	fclose(handle);
+}
+
+int readFile(const char* name)
+{
+	char path[128];
+	sprintf(path, "%s/%s", sysfsDir, name);
+	int value = -1;
+	FILE* handle = fopen(path, "r");
+	if(handle != NULL)
+	{
+		if(fscanf(handle, "%d", &value) != 1)
+		{
+			value = -1;
+		}
+		fclose(handle);
+	}
+	return value;
+}
+
+int enabled(int channel)
+{
+	char name[48];
+	sprintf(name, "scan_elements/in_voltage%d_en", channel);
+	return readFile(name);
+}
+
+//Two Channel Scans Of Little Endian 16 Bit Samples
+void writeScans(int handle, const unsigned short* samples, int numSamples)
+{
+	unsigned char bytes[64];
+	for(int i=0; i<numSamples; i++)
+	{
+		bytes[2*i] = samples[i] & 0xFF;
+		bytes[2*i + 1] = samples[i] >> 8;
+	}
+	if(write(handle, bytes, 2 * numSamples) != 2 * numSamples)
+	{
+		fprintf(stdout, "fifo write failed\n");
+	}
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: IIO Buffered AI Test :.\r\n\r\n");
+
+	if(mkdtemp(sysfsDir) == NULL)
+	{
+		return 1;
+	}
+
+	//Mock Scan Elements Like The AM335x ADC Driver Exposes Them
+	char path[128];
+	sprintf(path, "%s/scan_elements", sysfsDir);
+	mkdir(path, 0755);
+	sprintf(path, "%s/buffer", sysfsDir);
+	mkdir(path, 0755);
+	for(int i=0; i<7; i++)
+	{
+		char name[48];
+		char value[16];
+		sprintf(name, "scan_elements/in_voltage%d_en", i);
+		writeFile(name, "0");
+		sprintf(name, "scan_elements/in_voltage%d_index", i);
+		sprintf(value, "%d", i);
+		writeFile(name, value);
+		sprintf(name, "scan_elements/in_voltage%d_type", i);
+		writeFile(name, "le:u12/16>>0\n");
+	}
+	writeFile("scan_elements/in_voltage2_type", "be:s12/16>>4\n");
+	writeFile("scan_elements/in_voltage5_en", "1");
+	writeFile("buffer/enable", "0");
+	writeFile("buffer/length", "0");
+	writeFile("buffer/watermark", "0");
+
+	sprintf(devPath, "%s/dev", sysfsDir);
+	mkfifo(devPath, 0644);
+	int fifo = open(devPath, O_RDWR);
+
+	//------------------------------------- Scan Layout -------------------------------------
+	{
+		LinxIioBuffer iio(sysfsDir, devPath);
+		unsigned char channels[2] = {3, 1};
+		check(iio.Start(2, channels, 0) == L_OK && iio.IsRunning() && iio.NumChans() == 2, "stream starts");
+		check(enabled(1) == 1 && enabled(3) == 1 && enabled(0) == 0 && enabled(5) == 0, "only requested scan elements enabled");
+		check(readFile("buffer/enable") == 1 && readFile("buffer/length") == IIO_KERNEL_BUFFER_SCANS, "kernel buffer enabled");
+
+		//Scans Are In Index Order (Channel 1 Then 3), Second Scan Split Across Two Writes
+		unsigned short samples[6] = {0x101, 0x303, 0x102, 0x304, 0x103, 0x305};
+		writeScans(fifo, samples, 3);
+		usleep(20000);
+		writeScans(fifo, samples + 3, 3);
+
+		unsigned long values[6] = {0};
+		bool overrun = true;
+		check(iio.Read(3, 1000, values, &overrun) == 3 && !overrun, "three scans read");
+		check(values[0] == 0x303 && values[1] == 0x304 && values[2] == 0x305, "first channel deinterleaved");
+		check(values[3] == 0x101 && values[4] == 0x102 && values[5] == 0x103, "second channel deinterleaved");
+
+		iio.Stop();
+		check(!iio.IsRunning() && readFile("buffer/enable") == 0 && enabled(1) == 0 && enabled(3) == 0, "stop disables buffer and scan elements");
+	}
+
+	//------------------------------------- Sample Format And Overrun -------------------------------------
+	{
+		LinxIioBuffer iio(sysfsDir, devPath);
+		unsigned char channels[2] = {0, 2};
+		check(iio.Start(2, channels, IIO_MAX_BUFFER_SCANS + 1) == LANALOG_STREAM_OPEN_FAIL && !iio.IsRunning() && enabled(0) == 0, "oversized ring rejected");
+		check(iio.Start(2, channels, 4) == L_OK, "small ring starts");
+
+		//Channel 2 Is Big Endian, Signed And Shifted
+		unsigned short negative = (unsigned short)(((-5) & 0xFFF) << 4);
+		unsigned short swapped = (unsigned short)((negative >> 8) | (negative << 8));
+		unsigned short samples[12];
+		for(int i=0; i<6; i++)
+		{
+			samples[2*i] = 0x010 + i;
+			samples[2*i + 1] = swapped;
+		}
+		writeScans(fifo, samples, 12);
+
+		unsigned long values[20] = {0};
+		bool overrun = false;
+		check(iio.Read(10, 200, values, &overrun) == 4 && overrun, "full ring flags overrun");
+		check(values[0] == 0x010 && values[3] == 0x013, "oldest scans kept");
+		check((long)values[4] == -5, "big endian signed shifted sample");
+		check(iio.Available() == 0, "ring drained");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		FakeIioBeagleBone dev(sysfsDir, devPath);
+		LinxListener listener;
+		listener.LinxDev = &dev;
+		unsigned char resp[300];
+
+		unsigned char start[] = {0xFF, 14, 0x00, 0x01, 0x00, 0x66, 2, 0, 1, 0x00, 0x00, 0x01, 0x00, 0};
+		start[13] = listener.ComputeChecksum(start);
+		listener.ProcessCommand(start, resp);
+		check(resp[4] == L_OK && enabled(0) == 1 && enabled(1) == 1, "listener stream start");
+
+		unsigned short samples[4] = {0xABC, 0x123, 0x456, 0xFFF};
+		writeScans(fifo, samples, 4);
+
+		unsigned char read[] = {0xFF, 11, 0x00, 0x02, 0x00, 0x67, 0x00, 0x02, 0x01, 0xF4, 0};
+		read[10] = listener.ComputeChecksum(read);
+		listener.ProcessCommand(read, resp);
+		check(resp[4] == L_OK && resp[1] == 6 + 7 + 6 && listener.ChecksumPassed(resp), "listener stream read response");
+		check(resp[5] == 12 && resp[6] == 0 && resp[7] == 2 && resp[11] == 0, "resolution, scans read and scans left");
+
+		//Unpack LSb First 12 Bit Values, Channel Major
+		unsigned long unpacked[4] = {0};
+		for(int bit=0; bit<48; bit++)
+		{
+			unpacked[bit / 12] |= (unsigned long)((resp[12 + bit / 8] >> (bit % 8)) & 1) << (bit % 12);
+		}
+		check(unpacked[0] == 0xABC && unpacked[1] == 0x456 && unpacked[2] == 0x123 && unpacked[3] == 0xFFF, "listener values packed channel major");
+
+		unsigned char big[] = {0xFF, 11, 0x00, 0x03, 0x00, 0x67, 0xFF, 0xFF, 0x00, 0x00, 0};
+		big[10] = listener.ComputeChecksum(big);
+		listener.ProcessCommand(big, resp);
+		check(resp[4] == L_OK && resp[1] <= 255 && resp[7] == 0, "large request clamped to one packet");
+
+		unsigned char stop[] = {0xFF, 7, 0x00, 0x04, 0x00, 0x68, 0};
+		stop[6] = listener.ComputeChecksum(stop);
+		listener.ProcessCommand(stop, resp);
+		check(resp[4] == L_OK && readFile("buffer/enable") == 0 && enabled(0) == 0, "listener stream stop");
+
+		read[3] = 0x05;
+		read[10] = listener.ComputeChecksum(read);
+		listener.ProcessCommand(read, resp);
+		check(resp[4] == LANALOG_STREAM_OPEN_FAIL && resp[7] == 0, "read without a stream rejected");
+
+		unsigned char badChans[1] = {9};
+		check(dev.AnalogStreamStart(1, badChans, 0) == LANALOG_STREAM_OPEN_FAIL, "unknown channel rejected");
+	}
+
+	close(fifo);
+	char command[96];
+	sprintf(command, "rm -rf %s", sysfsDir);
+	if(system(command) != 0)
+	{
+		fprintf(stdout, "cleanup failed\n");
+	}
+
+	return checkSummary();
+}
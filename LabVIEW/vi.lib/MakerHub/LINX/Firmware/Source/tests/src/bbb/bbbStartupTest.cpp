@@ -0,0 +1,122 @@
+/****************************************************************************************
+**  Host side test for lazy BeagleBone Black start up.
+**
+**  Checks that construction does not touch peripherals and that waiting for overlay
+**  files sleeps instead of spinning.  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "LinxDevice.h"
+#include "LinxBeagleBoneBlack.h"
+#include "../LinxTestCheck.h"
+
+//BeagleBone Black With The File Wait Exposed
+class WaitBeagleBoneBlack : public LinxBeagleBoneBlack
+{
+	public:
+		bool WaitForFile(const char* directory, const char* fileName, unsigned long timeout)
+		{
+			return fileExists(directory, fileName, timeout);
+		}
+};
+
+char tempDir[] = "/tmp/linxbbbXXXXXX";
+
+unsigned long long cpuUs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+	return (unsigned long long)now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+//Create overlay/slot/ready After 50 mS, One Path Component At A Time
+void* createLater(void* arg)
+{
+	char path[96];
+	usleep(50000);
+	sprintf(path, "%s/overlay", tempDir);
+	mkdir(path, 0755);
+	sprintf(path, "%s/overlay/slot", tempDir);
+	mkdir(path, 0755);
+	sprintf(path, "%s/overlay/slot/ready", tempDir);
+	FILE* handle = fopen(path, "w");
+	fclose(handle);
+	return NULL;
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: BeagleBone Start Up Test :.\r\n\r\n");
+
+	if(mkdtemp(tempDir) == NULL)
+	{
+		return 1;
+	}
+
+	//------------------------------------- Construction -------------------------------------
+	{
+		unsigned long long start = monotonicUs();
+		WaitBeagleBoneBlack* dev = new WaitBeagleBoneBlack();
+		unsigned long long elapsed = monotonicUs() - start;
+		fprintf(stdout, "      constructed in %llu uS\n", elapsed);
+		check(elapsed < 200000, "construction well under a second");
+
+		bool untouched = true;
+		for(int i=0; i<NUM_AI_CHANS; i++)
+		{
+			untouched &= (dev->AiValueHandles[dev->AiChans[i]] == NULL);
+		}
+		for(int i=0; i<NUM_DIGITAL_CHANS; i++)
+		{
+			untouched &= (dev->DigitalDirHandles[dev->DigitalChans[i]] == NULL && dev->DigitalValueHandles[dev->DigitalChans[i]] == NULL);
+		}
+		check(untouched, "no AI or DIO handles opened at construction");
+		check(dev->DigitalChannels.Size() == NUM_DIGITAL_CHANS && dev->PwmDirPaths.Size() == NUM_PWM_CHANS && dev->AiValuePaths.Size() == NUM_AI_CHANS, "channel maps still filled");
+		check(dev->AiStream == NULL, "no AI stream until started");
+
+		//------------------------------------- File Wait -------------------------------------
+		char slotDir[96];
+		sprintf(slotDir, "%s/overlay/slot/", tempDir);
+
+		pthread_t creator;
+		pthread_create(&creator, NULL, createLater, NULL);
+		start = monotonicUs();
+		unsigned long long cpuStart = cpuUs();
+		bool found = dev->WaitForFile(slotDir, "ready", 2000);
+		elapsed = monotonicUs() - start;
+		unsigned long long cpuUsed = cpuUs() - cpuStart;
+		pthread_join(creator, NULL);
+		fprintf(stdout, "      file appeared after %llu uS using %llu uS of CPU\n", elapsed, cpuUsed);
+		check(found && elapsed >= 40000 && elapsed < 500000, "wait returns once the file appears");
+		check(cpuUsed < 20000, "wait sleeps instead of spinning");
+
+		start = monotonicUs();
+		cpuStart = cpuUs();
+		found = dev->WaitForFile(slotDir, "missing", 100);
+		elapsed = monotonicUs() - start;
+		cpuUsed = cpuUs() - cpuStart;
+		check(!found && elapsed >= 100000 && elapsed < 300000, "missing file times out");
+		check(cpuUsed < 20000, "timeout sleeps instead of spinning");
+
+		check(dev->WaitForFile(slotDir, "ready", 0), "existing file found without waiting");
+
+		delete dev;
+	}
+
+	char command[96];
+	sprintf(command, "rm -rf %s", tempDir);
+	if(system(command) != 0)
+	{
+		fprintf(stdout, "cleanup failed\n");
+	}
+
+	return checkSummary();
+}
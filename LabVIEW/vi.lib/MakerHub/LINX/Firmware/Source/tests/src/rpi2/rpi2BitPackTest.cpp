@@ -0,0 +1,157 @@
+/****************************************************************************************
+**  Host side test for the LINX bit packing kernels.
+**
+**  Checks N bit sample packing against the bit by bit packing the backends used to do,
+**  DIO bitmap byte order and buffer bit reversal against the single byte reversal on
+**  every length around the vector width.  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "LinxBitPack.h"
+#include "../LinxTestCheck.h"
+
+//Reference Packing, One Bit At A Time
+void packReference(unsigned long numValues, const unsigned long* values, unsigned char numBits, unsigned char* packed)
+{
+	memset(packed, 0, LinxBitPack::PackedSize(numValues, numBits));
+	for(unsigned long i=0; i<numValues; i++)
+	{
+		for(int bit=0; bit<numBits; bit++)
+		{
+			unsigned long long position = (unsigned long long)i * numBits + bit;
+			packed[position / 8] |= ((values[i] >> bit) & 1) << (position % 8);
+		}
+	}
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Bit Pack Test :.\r\n\r\n");
+	srand(42);
+
+	//------------------------------------- N Bit Samples -------------------------------------
+	{
+		unsigned long values[67];
+		unsigned long unpacked[67];
+		unsigned char packed[300];
+		unsigned char expected[300];
+		bool matches = true;
+		bool roundTrips = true;
+		bool inBounds = true;
+
+		for(int numBits=1; numBits<=32; numBits++)
+		{
+			unsigned long mask = (numBits == 32) ? 0xFFFFFFFFUL : ((1UL << numBits) - 1);
+			for(int i=0; i<67; i++)
+			{
+				values[i] = ((unsigned long)rand() << 16 ^ rand()) & mask;
+			}
+
+			unsigned long size = LinxBitPack::PackedSize(67, numBits);
+			memset(packed, 0xA5, sizeof(packed));
+			packReference(67, values, numBits, expected);
+			LinxBitPack::Pack(67, values, numBits, packed);
+			LinxBitPack::Unpack(67, packed, numBits, unpacked);
+
+			matches &= (memcmp(packed, expected, size) == 0);
+			roundTrips &= (memcmp(values, unpacked, sizeof(values)) == 0);
+			inBounds &= (packed[size] == 0xA5);
+		}
+		check(matches, "1 to 32 bit samples packed LSb first");
+		check(roundTrips, "unpack inverts pack");
+		check(inBounds, "nothing written past the packed size");
+
+		//Bits Above The Sample Width Must Not Leak Into The Next Sample
+		unsigned long wide[2] = {0xF123, 0x456};
+		LinxBitPack::Pack(2, wide, 12, packed);
+		check(packed[0] == 0x23 && packed[1] == 0x61 && packed[2] == 0x45, "samples masked to width");
+		check(LinxBitPack::PackedSize(3, 12) == 5 && LinxBitPack::PackedSize(0, 12) == 0, "packed size rounds up");
+	}
+
+	//------------------------------------- DIO Bitmaps -------------------------------------
+	{
+		unsigned char bits[11] = {1, 0, 0, 0, 0, 0, 1, 1, 0, 1, 1};
+		unsigned char packed[2] = {0xFF, 0xFF};
+		LinxBitPack::PackBits(11, bits, packed);
+		check(packed[0] == 0x83 && packed[1] == 0x60, "read bitmap first channel in MSb");
+
+		unsigned char high[3] = {0, 7, 0xFF};
+		LinxBitPack::PackBits(3, high, packed);
+		check(packed[0] == 0x60, "any non-zero value reads as high");
+
+		unsigned char command[2] = {0x41, 0x05};
+		unsigned char unpacked[11];
+		LinxBitPack::UnpackBits(11, command, unpacked);
+		unsigned char expected[11] = {1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 1};
+		check(memcmp(unpacked, expected, 11) == 0, "write bitmap first channel in LSb");
+	}
+
+	//------------------------------------- Bit Reversal -------------------------------------
+	{
+		fprintf(stdout, "      reverse kernel %s\n", LinxBitPack::ReverseKernel());
+
+		bool single = true;
+		for(int b=0; b<256; b++)
+		{
+			unsigned char reversed = 0;
+			for(int bit=0; bit<8; bit++)
+			{
+				reversed |= ((b >> bit) & 1) << (7 - bit);
+			}
+			single &= (LinxBitPack::ReverseBits((unsigned char)b) == reversed);
+		}
+		check(single, "single byte reversal");
+
+		unsigned char src[80];
+		unsigned char dst[81];
+		bool buffers = true;
+		bool inPlace = true;
+		for(int length=0; length<=64; length++)
+		{
+			//Unaligned Start To Exercise The Unaligned Loads
+			for(int i=0; i<length; i++)
+			{
+				src[i + 1] = (unsigned char)rand();
+			}
+			memset(dst, 0xA5, sizeof(dst));
+			LinxBitPack::ReverseBits(length, src + 1, dst + 1);
+			for(int i=0; i<length; i++)
+			{
+				buffers &= (dst[i + 1] == LinxBitPack::ReverseBits(src[i + 1]));
+			}
+			buffers &= (dst[0] == 0xA5 && dst[length + 1] == 0xA5);
+
+			LinxBitPack::ReverseBits(length, dst + 1, dst + 1);
+			inPlace &= (memcmp(dst + 1, src + 1, length) == 0);
+		}
+		check(buffers, "buffer reversal matches byte reversal at every length");
+		check(inPlace, "in place reversal");
+
+		//Large LSb First SPI Transfer, Reported Only
+		static unsigned char big[1 << 20];
+		unsigned long long start = monotonicUs();
+		for(int i=0; i<16; i++)
+		{
+			LinxBitPack::ReverseBits(sizeof(big), big, big);
+		}
+		unsigned long long vectorUs = monotonicUs() - start;
+		start = monotonicUs();
+		for(int i=0; i<16; i++)
+		{
+			for(unsigned long j=0; j<sizeof(big); j++)
+			{
+				big[j] = LinxBitPack::ReverseBits(big[j]);
+			}
+		}
+		unsigned long long scalarUs = monotonicUs() - start;
+		fprintf(stdout, "      16 MiB reversed in %llu uS (%llu uS one byte at a time)\n", vectorUs, scalarUs);
+	}
+
+	return checkSummary();
+}
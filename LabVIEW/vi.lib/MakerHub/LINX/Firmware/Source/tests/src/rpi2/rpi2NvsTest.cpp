@@ -0,0 +1,110 @@
+/****************************************************************************************
+**  Host side test for file backed non-volatile storage on Linux devices.
+**
+**  Storage is mapped from a temporary file, so persistence and the listener's block
+**  writes can be checked without touching the device's real storage file.  Returns the
+**  number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "LinxNvs.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+//Raspberry Pi With Its Storage File Replaced
+class TempNvsRaspberryPi : public LinxRaspberryPi
+{
+	public:
+		TempNvsRaspberryPi(const char* path)
+		{
+			delete Nvs;
+			Nvs = new LinxNvs(path, NVS_SIZE);
+		}
+};
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Non-Volatile Storage Test :.\r\n\r\n");
+
+	char dirTemplate[] = "/tmp/linxnvsXXXXXX";
+	if(mkdtemp(dirTemplate) == NULL)
+	{
+		return 1;
+	}
+	char path[64];
+	sprintf(path, "%s/config/nvs.bin", dirTemplate);
+
+	//------------------------------------- Storage File -------------------------------------
+	{
+		LinxNvs nvs(path, NVS_SIZE);
+		unsigned char data[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+		check(nvs.Read(0, 4, data) == L_OK && data[0] == 0 && data[3] == 0, "new file created zero filled");
+
+		struct stat info;
+		check(stat(path, &info) == 0 && info.st_size == NVS_SIZE, "file sized to the image");
+
+		unsigned char baud[4] = {0x00, 0x01, 0xC2, 0x00};
+		check(nvs.Write(NVS_SERIAL_INTERFACE_MAX_BAUD, 4, baud) == L_OK && nvs.IsDirty(), "block write dirties the image");
+		check(nvs.Commit() == L_OK && !nvs.IsDirty(), "commit cleans the image");
+		check(nvs.Write(NVS_SERIAL_INTERFACE_MAX_BAUD, 4, baud) == L_OK && !nvs.IsDirty(), "unchanged bytes are not rewritten");
+		check(nvs.Write(NVS_SIZE - 2, 4, baud) != L_OK, "write past the end rejected");
+	}
+	{
+		LinxNvs nvs(path, NVS_SIZE);
+		unsigned char data[4] = {0};
+		check(nvs.Read(NVS_SERIAL_INTERFACE_MAX_BAUD, 4, data) == L_OK && data[1] == 0x01 && data[2] == 0xC2, "data survives reopening");
+	}
+
+	//------------------------------------- Device -------------------------------------
+	{
+		TempNvsRaspberryPi dev(path);
+		dev.NonVolatileWrite(NVS_USERID, 0x12);
+		check(dev.NonVolatileRead(NVS_USERID) == 0x12, "single byte read back");
+
+		unsigned char ip[4] = {192, 168, 1, 20};
+		unsigned char readIp[4] = {0};
+		check(dev.NonVolatileWriteBlock(NVS_ETHERNET_IP, 4, ip) == L_OK && dev.NonVolatileCommit() == L_OK, "device block write and commit");
+		check(dev.NonVolatileReadBlock(NVS_ETHERNET_IP, 4, readIp) == L_OK && memcmp(ip, readIp, 4) == 0, "device block read");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		TempNvsRaspberryPi dev(path);
+		LinxListener listener;
+		listener.LinxDev = &dev;
+		unsigned char resp[64];
+
+		unsigned char userId[] = {0xFF, 9, 0x00, 0x01, 0x00, 0x12, 0xAB, 0xCD, 0};
+		userId[8] = listener.ComputeChecksum(userId);
+		listener.ProcessCommand(userId, resp);
+		check(resp[4] == L_OK && dev.userId == 0xABCD && !dev.Nvs->IsDirty(), "listener user id committed");
+
+		unsigned char ssid[] = {0xFF, 12, 0x00, 0x02, 0x00, 0x1C, 4, 'l', 'i', 'n', 'x', 0};
+		ssid[11] = listener.ComputeChecksum(ssid);
+		listener.ProcessCommand(ssid, resp);
+		check(resp[4] == L_OK && !dev.Nvs->IsDirty(), "listener ssid committed");
+
+		LinxNvs nvs(path, NVS_SIZE);
+		unsigned char data[5] = {0};
+		check(nvs.Read(NVS_WIFI_SSID_SIZE, 5, data) == L_OK && data[0] == 4 && memcmp(data + 1, "linx", 4) == 0, "ssid size and value stored");
+		check(nvs.Read(NVS_USERID, 2, data) == L_OK && data[0] == 0xAB && data[1] == 0xCD, "user id stored");
+	}
+
+	char command[96];
+	sprintf(command, "rm -rf %s", dirTemplate);
+	if(system(command) != 0)
+	{
+		fprintf(stdout, "cleanup failed\n");
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,145 @@
+/****************************************************************************************
+**  Host side test for hardware PWM on the Raspberry Pi family.
+**
+**  The kernel PWM class is replaced with a fake pwmchip directory so the test runs
+**  without PWM hardware.  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+char chipPath[64];
+
+const unsigned char pwmChans[2] = {12, 35};
+constexpr LinxChannelSlots pwmSlots(2, pwmChans);
+
+//Raspberry Pi With pwmchip0 Replaced By A Directory Tree
+class FakeSysfsRaspberryPi : public LinxRaspberryPi
+{
+	public:
+		FakeSysfsRaspberryPi(const char* chip)
+		{
+			PwmChipPath = chip;
+			PwmDefaultFrequency = 2000;
+			bindPwmSlots(&pwmSlots, &pwmSlots);
+			PwmChipChans[12] = 0;
+			PwmChipChans[35] = 1;
+		}
+};
+
+void writeFile(const char* name, const char* text)
+{
+	char path[128];
+	sprintf(path, "%s%s", chipPath, name);
+	FILE* handle = fopen(path, "w");
+	fputs(text, handle);
+	fclose(handle);
+}
+
+//First Line Of A Fake Attribute As A Number
+unsigned long readFile(const char* name)
+{
+	char path[128];
+	char text[32] = {0};
+	sprintf(path, "%s%s", chipPath, name);
+	FILE* handle = fopen(path, "r");
+	if(handle == NULL || fgets(text, sizeof(text), handle) == NULL)
+	{
+		return 0xFFFFFFFF;
+	}
+	fclose(handle);
+	return strtoul(text, NULL, 10);
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: PWM Test :.\r\n\r\n");
+
+	//Fake pwmchip With Output 0 Already Exported
+	char dirTemplate[] = "/tmp/linxpwmXXXXXX";
+	if(mkdtemp(dirTemplate) == NULL)
+	{
+		return 1;
+	}
+	sprintf(chipPath, "%s/", dirTemplate);
+	char path[128];
+	sprintf(path, "%spwm0", chipPath);
+	mkdir(path, 0755);
+	writeFile("export", "");
+	writeFile("pwm0/period", "0\n");
+	writeFile("pwm0/duty_cycle", "0\n");
+	writeFile("pwm0/enable", "0\n");
+
+	FakeSysfsRaspberryPi dev(chipPath);
+	unsigned char chan = 12;
+	unsigned char value = 128;
+
+	//------------------------------------- Duty Cycle -------------------------------------
+	check(dev.PwmSetDutyCycle(1, &chan, &value) == L_OK, "set duty cycle");
+	check(readFile("pwm0/period") == 500000, "default period");
+	check(readFile("pwm0/duty_cycle") == 250980, "duty cycle");
+	check(readFile("pwm0/enable") == 1, "output enabled");
+
+	int dutyCycleHandle = dev.PwmDutyCycleHandles[12];
+	value = 255;
+	check(dev.PwmSetDutyCycle(1, &chan, &value) == L_OK && readFile("pwm0/duty_cycle") == 500000, "full duty cycle");
+	check(dev.PwmDutyCycleHandles[12] == dutyCycleHandle, "handles stay open");
+
+	//------------------------------------- Frequency -------------------------------------
+	value = 64;
+	dev.PwmSetDutyCycle(1, &chan, &value);
+	unsigned long frequency = 1000;
+	check(dev.PwmSetFrequency(1, &chan, &frequency) == L_OK, "set frequency");
+	check(readFile("pwm0/period") == 1000000 && readFile("pwm0/duty_cycle") == 250980, "duty ratio kept at lower frequency");
+	frequency = 20000;
+	check(dev.PwmSetFrequency(1, &chan, &frequency) == L_OK && readFile("pwm0/period") == 50000 && readFile("pwm0/duty_cycle") == 12549, "duty ratio kept at higher frequency");
+
+	//------------------------------------- Errors -------------------------------------
+	unsigned char notPwm = 7;
+	check(dev.PwmSetDutyCycle(1, &notPwm, &value) == L_FUNCTION_NOT_SUPPORTED, "non PWM channel rejected");
+
+	unsigned char unexported = 35;
+	check(dev.PwmSetDutyCycle(1, &unexported, &value) == L_UNKNOWN_ERROR && readFile("export") == 1, "missing output exported");
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		LinxListener listener;
+		listener.LinxDev = &dev;
+
+		unsigned char cmd[] = {0xFF, 13, 0x00, 0x01, 0x00, 0x82, 1, 12, 0x00, 0x00, 0x27, 0x10, 0};
+		unsigned char resp[32];
+		cmd[12] = listener.ComputeChecksum(cmd);
+		listener.ProcessCommand(cmd, resp);
+		check(resp[4] == L_OK && readFile("pwm0/period") == 100000, "listener set frequency");
+
+		//Claims Two Channels But Only Carries One Frequency
+		cmd[6] = 2;
+		cmd[12] = listener.ComputeChecksum(cmd);
+		listener.ProcessCommand(cmd, resp);
+		check(resp[4] == L_UNKNOWN_ERROR && readFile("pwm0/period") == 100000, "listener short frequency packet rejected");
+
+		unsigned char duty[] = {0xFF, 10, 0x00, 0x02, 0x00, 0x83, 1, 12, 255, 0};
+		duty[9] = listener.ComputeChecksum(duty);
+		listener.ProcessCommand(duty, resp);
+		check(resp[4] == L_OK && readFile("pwm0/duty_cycle") == 100000, "listener set duty cycle");
+	}
+
+	char command[160];
+	sprintf(command, "rm -rf %s", dirTemplate);
+	if(system(command) != 0)
+	{
+		fprintf(stdout, "cleanup failed\n");
+	}
+
+	return checkSummary();
+}
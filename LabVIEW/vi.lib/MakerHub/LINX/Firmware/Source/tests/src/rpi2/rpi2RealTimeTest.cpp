@@ -0,0 +1,57 @@
+/****************************************************************************************
+**  Host side test for the Linux real-time execution profile.
+**
+**  Checks CPU list parsing and the latency self test.  Priority and memory locking need
+**  privileges, so their results are printed rather than checked.  Returns the number of
+**  failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#ifndef _GNU_SOURCE
+	#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <sched.h>
+
+#include "LinxDevice.h"
+#include "LinxRealTime.h"
+#include "../LinxTestCheck.h"
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Real-Time Profile Test :.\r\n\r\n");
+
+	cpu_set_t original;
+	sched_getaffinity(0, sizeof(original), &original);
+
+	//------------------------------------- Affinity -------------------------------------
+	{
+		cpu_set_t cpus;
+		check(LinxRealTime::SetAffinity("0") == L_OK && sched_getaffinity(0, sizeof(cpus), &cpus) == 0 && CPU_COUNT(&cpus) == 1 && CPU_ISSET(0, &cpus), "pin to one CPU");
+		check(LinxRealTime::SetAffinity("x") != L_OK, "bad CPU list rejected");
+		check(LinxRealTime::SetAffinity("0,") == L_OK && LinxRealTime::SetAffinity("2-1") != L_OK, "list and range syntax");
+		check(LinxRealTime::SetAffinity("4095") != L_OK, "missing CPU rejected");
+		sched_setaffinity(0, sizeof(original), &original);
+	}
+
+	//------------------------------------- Latency Self Test -------------------------------------
+	{
+		LinxLatencyStats stats;
+		LinxRealTime::MeasureLatency(200, 200000, &stats);
+		unsigned long total = 0;
+		for(int i=0; i<RT_HIST_BUCKETS; i++)
+		{
+			total += stats.histogram[i];
+		}
+		check(stats.numSamples == 200 && total == 200, "every wake up lands in the histogram");
+		check(stats.latencyMin <= stats.latencyMean && stats.latencyMean <= stats.latencyMax, "latency min <= mean <= max");
+		LinxRealTime::PrintLatency(&stats);
+	}
+
+	//------------------------------------- Privileged Steps -------------------------------------
+	fprintf(stdout, "      SCHED_FIFO %s, mlockall %s\n", LinxRealTime::SetPriority(RT_DEFAULT_PRIORITY) == L_OK ? "set" : "not permitted", LinxRealTime::LockMemory() == L_OK ? "locked" : "not permitted");
+
+	return checkSummary();
+}
@@ -0,0 +1,215 @@
+/****************************************************************************************
+**  Host side test for the software PWM / servo scheduler on the Raspberry Pi family.
+**
+**  The GPIO character device is replaced with a scheduler that records each multi-line
+**  write with its time, so pulse widths and batching can be checked without hardware.
+**  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "LinxSoftPwm.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+#define MAX_WRITES 4096
+
+//Scheduler That Records Line Requests And Writes Instead Of Driving A gpiochip
+class RecordingSoftPwm : public LinxSoftPwm
+{
+	public:
+		unsigned int Lines[SOFT_PWM_MAX_CHANS];
+		int NumLines;
+		unsigned long long Times[MAX_WRITES];
+		unsigned long long Masks[MAX_WRITES];
+		unsigned long long Bits[MAX_WRITES];
+		int NumWrites;
+
+		RecordingSoftPwm() : LinxSoftPwm("/dev/null")
+		{
+			NumLines = 0;
+			NumWrites = 0;
+		}
+
+		~RecordingSoftPwm()
+		{
+			Close();
+		}
+
+	protected:
+		int requestLines(const unsigned int* lines, const unsigned char* levels, int numLines)
+		{
+			memcpy(Lines, lines, numLines * sizeof(unsigned int));
+			NumLines = numLines;
+			return L_OK;
+		}
+
+		void releaseLines()
+		{
+			NumLines = 0;
+		}
+
+		int writeLines(unsigned long long mask, unsigned long long bits)
+		{
+			if(NumWrites < MAX_WRITES)
+			{
+				Times[NumWrites] = monotonicNs();
+				Masks[NumWrites] = mask;
+				Bits[NumWrites] = bits;
+				NumWrites++;
+			}
+			return L_OK;
+		}
+};
+
+const unsigned char digitalChans[3] = {7, 11, 12};
+constexpr LinxChannelSlots digitalSlots(3, digitalChans);
+
+//Raspberry Pi With Three Digital Channels And No Hardware PWM
+class SoftPwmRaspberryPi : public LinxRaspberryPi
+{
+	public:
+		RecordingSoftPwm* Recorder;
+
+		SoftPwmRaspberryPi()
+		{
+			PwmDefaultFrequency = 100;
+			bindDigitalSlots(&digitalSlots);
+			bindPwmSlots(LinxChannelSlots::None(), &digitalSlots);
+			DigitalChannels[7] = 4;
+			DigitalChannels[11] = 17;
+			DigitalChannels[12] = 18;
+			Recorder = new RecordingSoftPwm();
+			SoftPwm = Recorder;
+		}
+};
+
+//Mean High Time And Period Of One Line From The Recorded Writes (nS)
+void measure(RecordingSoftPwm* recorder, int bit, unsigned long long* highTime, unsigned long long* period)
+{
+	unsigned long long lastRise = 0;
+	unsigned long long highSum = 0;
+	unsigned long long periodSum = 0;
+	int numHigh = 0;
+	int numPeriods = 0;
+
+	for(int i=0; i<recorder->NumWrites; i++)
+	{
+		if(!((recorder->Masks[i] >> bit) & 1))
+		{
+			continue;
+		}
+		if((recorder->Bits[i] >> bit) & 1)
+		{
+			if(lastRise != 0)
+			{
+				periodSum += recorder->Times[i] - lastRise;
+				numPeriods++;
+			}
+			lastRise = recorder->Times[i];
+		}
+		else if(lastRise != 0)
+		{
+			highSum += recorder->Times[i] - lastRise;
+			numHigh++;
+		}
+	}
+
+	*highTime = (numHigh > 0) ? highSum / numHigh : 0;
+	*period = (numPeriods > 0) ? periodSum / numPeriods : 0;
+}
+
+bool near(unsigned long long value, unsigned long long expected, unsigned long long tolerance)
+{
+	return value + tolerance >= expected && value <= expected + tolerance;
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Software PWM / Servo Test :.\r\n\r\n");
+
+	SoftPwmRaspberryPi dev;
+	RecordingSoftPwm* recorder = dev.Recorder;
+
+	//------------------------------------- Servo -------------------------------------
+	{
+		unsigned char chans[2] = {7, 11};
+		unsigned short widths[2] = {1500, 1000};
+		check(dev.ServoOpen(2, chans) == L_OK, "servo open");
+		check(recorder->NumLines == 2 && recorder->Lines[0] == 4 && recorder->Lines[1] == 17, "lines requested together");
+		check(dev.ServoSetPulseWidth(2, chans, widths) == L_OK, "set pulse widths");
+
+		usleep(300000);
+		check(dev.ServoClose(2, chans) == L_OK && recorder->NumLines == 0, "servo close releases lines");
+
+		unsigned long long highTime = 0;
+		unsigned long long period = 0;
+		measure(recorder, 0, &highTime, &period);
+		check(near(highTime, 1500000, 300000) && near(period, SERVO_PERIOD_NS, 300000), "channel 7 pulse width and frame");
+		measure(recorder, 1, &highTime, &period);
+		check(near(highTime, 1000000, 300000) && near(period, SERVO_PERIOD_NS, 300000), "channel 11 pulse width and frame");
+
+		//Both Rising Edges Share A Write, The Falling Edges Do Not
+		int numBoth = 0;
+		for(int i=0; i<recorder->NumWrites; i++)
+		{
+			if(recorder->Masks[i] == 3 && recorder->Bits[i] == 3)
+			{
+				numBoth++;
+			}
+		}
+		check(numBoth >= 5, "rising edges batched into one write");
+	}
+
+	//------------------------------------- Stats -------------------------------------
+	{
+		LinxSoftPwmStats stats;
+		check(dev.SoftPwmGetStats(&stats, 1) == L_OK && stats.numWakeups > 0 && stats.numEdges > stats.numWakeups, "stats count wakeups and edges");
+		check(stats.latencyMin <= stats.latencyMean && stats.latencyMean <= stats.latencyMax, "latency min <= mean <= max");
+		fprintf(stdout, "      %lu wakeups, %lu edges, latency %lu / %lu / %lu nS, real time %d\n", stats.numWakeups, stats.numEdges, stats.latencyMin, stats.latencyMean, stats.latencyMax, stats.realTime);
+		check(dev.SoftPwmGetStats(&stats, 0) == L_OK && stats.numWakeups == 0, "stats reset");
+	}
+
+	//------------------------------------- PWM On A Digital Channel -------------------------------------
+	{
+		unsigned char chan = 12;
+		unsigned char value = 64;
+		recorder->NumWrites = 0;
+		check(dev.PwmSetDutyCycle(1, &chan, &value) == L_OK && recorder->NumLines == 1 && recorder->Lines[0] == 18, "PWM falls back to scheduler");
+		unsigned long frequency = 200;
+		check(dev.PwmSetFrequency(1, &chan, &frequency) == L_OK, "set software PWM frequency");
+
+		usleep(200000);
+		check(dev.ServoClose(1, &chan) == L_OK, "close stops the scheduler");
+		unsigned long long highTime = 0;
+		unsigned long long period = 0;
+		measure(recorder, 0, &highTime, &period);
+		check(near(period, 5000000, 300000) && near(highTime, 1254901, 300000), "software PWM period and duty cycle");
+
+		unsigned char notDigital = 40;
+		check(dev.PwmSetDutyCycle(1, &notDigital, &value) == L_FUNCTION_NOT_SUPPORTED, "non digital channel rejected");
+		check(dev.ServoOpen(1, &notDigital) == L_FUNCTION_NOT_SUPPORTED, "non digital servo rejected");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		LinxListener listener;
+		listener.LinxDev = &dev;
+
+		unsigned char cmd[] = {0xFF, 8, 0x00, 0x01, 0x01, 0x43, 0, 0};
+		unsigned char resp[64];
+		cmd[7] = listener.ComputeChecksum(cmd);
+		listener.ProcessCommand(cmd, resp);
+		unsigned long numWakeups = (unsigned long)resp[6]<<24 | resp[7]<<16 | resp[8]<<8 | resp[9];
+		check(resp[4] == L_OK && resp[1] == 27 && numWakeups > 0, "listener timing stats");
+		check(listener.ChecksumPassed(resp), "listener response checksum");
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,212 @@
+/****************************************************************************************
+**  Host side test for SPI transactions on the Raspberry Pi family.
+**
+**  spidev is replaced with a loopback stand-in (MOSI wired to MISO) so the test runs
+**  without SPI hardware.  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+#define MAX_TRANSFERS 32
+
+const unsigned char spiChans[1] = {0};
+constexpr LinxChannelSlots spiSlots(1, spiChans);
+
+//Raspberry Pi With spidev Replaced By A Loopback Stand-In
+class LoopbackRaspberryPi : public LinxRaspberryPi
+{
+	public:
+		int NumMessages;											//SPI_IOC_MESSAGE Calls
+		int NumTransfers;											//Transfers In Last Message
+		struct spi_ioc_transfer Transfers[MAX_TRANSFERS];		//Copy Of Last Message
+		unsigned char FirstTxByte;								//First Byte On The Wire In Last Message
+		unsigned char Mode;
+		bool LsbFirstSupported;
+
+		LoopbackRaspberryPi()
+		{
+			NumMessages = 0;
+			NumTransfers = 0;
+			FirstTxByte = 0;
+			Mode = 0;
+			LsbFirstSupported = false;
+
+			SpiDefaultSpeed = 3900000;
+			bindSpiSlots(&spiSlots);
+			SpiPaths[0] = "/dev/null";
+			SpiBitOrders[0] = MSBFIRST;
+			SpiSetSpeeds[0] = SpiDefaultSpeed;
+			SpiHwCsChans[0] = 26;
+		}
+
+	protected:
+		virtual int spiIoctl(unsigned char channel, unsigned long request, void* arg)
+		{
+			if(request == SPI_IOC_WR_MODE)
+			{
+				unsigned char mode = *(unsigned char*)arg;
+				if((mode & SPI_LSB_FIRST) && !LsbFirstSupported)
+				{
+					return -1;
+				}
+				Mode = mode;
+				return 0;
+			}
+			if(request == SPI_IOC_WR_MAX_SPEED_HZ)
+			{
+				return 0;
+			}
+			if(_IOC_TYPE(request) == SPI_IOC_MAGIC && _IOC_NR(request) == 0)
+			{
+				struct spi_ioc_transfer* transfers = (struct spi_ioc_transfer*)arg;
+				NumMessages++;
+				NumTransfers = _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer);
+
+				int numBytes = 0;
+				FirstTxByte = (transfers[0].tx_buf != 0) ? *(unsigned char*)(unsigned long)transfers[0].tx_buf : 0x00;
+				for(int i=0; i<NumTransfers; i++)
+				{
+					if(i < MAX_TRANSFERS)
+					{
+						Transfers[i] = transfers[i];
+					}
+
+					//Loopback - Rx Sees Tx, Or Zeros When No Tx Buffer Is Given
+					unsigned char* tx = (unsigned char*)(unsigned long)transfers[i].tx_buf;
+					unsigned char* rx = (unsigned char*)(unsigned long)transfers[i].rx_buf;
+					for(unsigned int j=0; j<transfers[i].len && rx != NULL; j++)
+					{
+						rx[j] = (tx != NULL) ? tx[j] : 0x00;
+					}
+					numBytes += transfers[i].len;
+				}
+				return numBytes;
+			}
+			return -1;
+		}
+};
+
+int main()
+{
+	fprintf(stdout, "\r\n.: SPI Transaction Test :.\r\n\r\n");
+
+	LoopbackRaspberryPi dev;
+	check(dev.SpiOpenMaster(0) == L_OK, "open master");
+
+	//------------------------------------- Write Then Read -------------------------------------
+	{
+		unsigned char command[2] = {0x0B, 0x80};
+		unsigned char duplexTx[3] = {0x01, 0x02, 0x03};
+		unsigned char readBack[4] = {0xAA, 0xAA, 0xAA, 0xAA};
+		unsigned char duplexRx[3] = {0};
+
+		LinxSpiSegment segments[3];
+		segments[0].type = SPI_SEGMENT_TX_ONLY;
+		segments[0].numBytes = 2;
+		segments[0].speed = 1000000;
+		segments[0].delayUs = 10;
+		segments[0].sendBuffer = command;
+		segments[0].recBuffer = NULL;
+
+		segments[1].type = SPI_SEGMENT_RX_ONLY;
+		segments[1].numBytes = 4;
+		segments[1].speed = 0;
+		segments[1].delayUs = 0;
+		segments[1].sendBuffer = NULL;
+		segments[1].recBuffer = readBack;
+
+		segments[2].type = SPI_SEGMENT_FULL_DUPLEX;
+		segments[2].numBytes = 3;
+		segments[2].speed = 0;
+		segments[2].delayUs = 0;
+		segments[2].sendBuffer = duplexTx;
+		segments[2].recBuffer = duplexRx;
+
+		dev.NumMessages = 0;
+		check(dev.SpiTransaction(0, 26, 0, 3, segments) == L_OK, "transaction status");
+		check(dev.NumMessages == 1 && dev.NumTransfers == 3, "one ioctl, one transfer per segment");
+		check(dev.Transfers[0].speed_hz == 1000000 && dev.Transfers[1].speed_hz == 3900000, "per segment speed");
+		check(dev.Transfers[0].delay_usecs == 10, "per segment delay");
+		check(dev.Transfers[0].cs_change == 0 && dev.Transfers[1].cs_change == 0 && dev.Transfers[2].cs_change == 0, "CS held across segments");
+		check(dev.Transfers[0].rx_buf == 0 && dev.Transfers[1].tx_buf == 0, "no dummy buffers for tx / rx only");
+		check(readBack[0] == 0 && readBack[3] == 0, "rx only segment clocks zeros");
+		check(memcmp(duplexRx, duplexTx, 3) == 0, "full duplex loopback");
+	}
+
+	//------------------------------------- Multi-Frame Write Read -------------------------------------
+	{
+		unsigned char tx[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+		unsigned char rx[8] = {0};
+
+		dev.NumMessages = 0;
+		check(dev.SpiWriteRead(0, 2, 4, 26, 0, tx, rx) == L_OK, "write read status");
+		check(dev.NumMessages == 1 && dev.NumTransfers == 4, "native CS frames in one ioctl");
+		check(dev.Transfers[0].cs_change == 1 && dev.Transfers[2].cs_change == 1 && dev.Transfers[3].cs_change == 0, "CS released between frames");
+		check(memcmp(rx, tx, 8) == 0, "frame loopback");
+
+		check(dev.SpiWriteRead(0, 1, 1, 26, 1, tx, rx) == L_OK && (dev.Mode & SPI_CS_HIGH), "active high native CS");
+		dev.SpiWriteRead(0, 1, 1, 26, 0, tx, rx);
+	}
+
+	//------------------------------------- LSb First -------------------------------------
+	{
+		unsigned char tx[2] = {0x01, 0xF0};
+		unsigned char rx[2] = {0};
+
+		dev.SpiSetBitOrder(0, LSBFIRST);
+		check(!dev.SpiLsbFirstHw[0], "LSb first falls back to software");
+		check(dev.SpiWriteRead(0, 2, 1, 26, 0, tx, rx) == L_OK, "software LSb first status");
+		check(tx[0] == 0x01 && tx[1] == 0xF0, "caller's buffer not modified");
+		check(dev.FirstTxByte == 0x80, "bits reversed on the wire");
+		check(rx[0] == 0x01 && rx[1] == 0xF0, "received bits reversed back");
+
+		dev.LsbFirstSupported = true;
+		dev.SpiSetBitOrder(0, LSBFIRST);
+		check(dev.SpiLsbFirstHw[0] && (dev.Mode & SPI_LSB_FIRST), "SPI_LSB_FIRST used when supported");
+		dev.SpiSetBitOrder(0, MSBFIRST);
+		check(!(dev.Mode & SPI_LSB_FIRST), "MSb first clears SPI_LSB_FIRST");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		LinxListener listener;
+		listener.LinxDev = &dev;
+
+		unsigned char cmd[64];
+		unsigned char resp[64];
+		unsigned char packet[] = {0xFF, 0, 0x00, 0x01, 0x01, 0x08, 0, 26, 0, 2,
+			SPI_SEGMENT_TX_ONLY, 1, 0, 0, 0, 0, 0, 0, 0x9F,
+			SPI_SEGMENT_FULL_DUPLEX, 2, 0, 0x0F, 0x42, 0x40, 0, 5, 0x12, 0x34};
+		int size = sizeof(packet) + 1;
+
+		memcpy(cmd, packet, sizeof(packet));
+		cmd[1] = size;
+		cmd[size-1] = listener.ComputeChecksum(cmd);
+
+		dev.NumMessages = 0;
+		listener.ProcessCommand(cmd, resp);
+		check(resp[4] == L_OK && resp[1] == 8, "listener response status and size");
+		check(resp[5] == 0x12 && resp[6] == 0x34, "listener response data");
+		check(dev.NumMessages == 1 && dev.Transfers[1].speed_hz == 1000000 && dev.Transfers[1].delay_usecs == 5, "listener segment decode");
+		check(listener.ChecksumPassed(resp), "listener response checksum");
+
+		//Truncated Tx Data
+		cmd[20] = 3;
+		cmd[size-1] = listener.ComputeChecksum(cmd);
+		dev.NumMessages = 0;
+		listener.ProcessCommand(cmd, resp);
+		check(resp[4] == LSPI_INVALID_TRANSACTION && dev.NumMessages == 0, "malformed transaction rejected");
+	}
+
+	return checkSummary();
+}
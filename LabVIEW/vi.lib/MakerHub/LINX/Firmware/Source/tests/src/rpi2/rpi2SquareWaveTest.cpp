@@ -0,0 +1,234 @@
+/****************************************************************************************
+**  Host side test for timer driven square waves on the Raspberry Pi family.
+**
+**  The GPIO character device is replaced with a scheduler that records each multi-line
+**  write with its time, so frequency, duration and cancellation can be checked without
+**  hardware.  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "LinxSoftPwm.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+#define MAX_WRITES 4096
+
+//Scheduler That Records Line Requests And Writes Instead Of Driving A gpiochip
+class RecordingSoftPwm : public LinxSoftPwm
+{
+	public:
+		unsigned int Lines[SOFT_PWM_MAX_CHANS];
+		int NumLines;
+		unsigned long long Times[MAX_WRITES];
+		unsigned long long Masks[MAX_WRITES];
+		unsigned long long Bits[MAX_WRITES];
+		int NumWrites;
+		pthread_mutex_t RecordLock;
+
+		RecordingSoftPwm() : LinxSoftPwm("/dev/null")
+		{
+			NumLines = 0;
+			NumWrites = 0;
+			pthread_mutex_init(&RecordLock, NULL);
+		}
+
+		~RecordingSoftPwm()
+		{
+			Close();
+			pthread_mutex_destroy(&RecordLock);
+		}
+
+		void Clear()
+		{
+			pthread_mutex_lock(&RecordLock);
+			NumWrites = 0;
+			pthread_mutex_unlock(&RecordLock);
+		}
+
+		//Rising Edges, Mean Period And Mean High Time Of One Line (nS)
+		void Measure(int bit, int* numRising, unsigned long long* period, unsigned long long* highTime, unsigned long long* lastWrite)
+		{
+			unsigned long long firstRise = 0;
+			unsigned long long lastRise = 0;
+			unsigned long long highSum = 0;
+			int numHigh = 0;
+
+			pthread_mutex_lock(&RecordLock);
+			*numRising = 0;
+			*lastWrite = 0;
+			for(int i=0; i<NumWrites; i++)
+			{
+				if(!((Masks[i] >> bit) & 1))
+				{
+					continue;
+				}
+				*lastWrite = Times[i];
+				if((Bits[i] >> bit) & 1)
+				{
+					if(*numRising == 0)
+					{
+						firstRise = Times[i];
+					}
+					lastRise = Times[i];
+					(*numRising)++;
+				}
+				else if(lastRise != 0)
+				{
+					highSum += Times[i] - lastRise;
+					numHigh++;
+				}
+			}
+			pthread_mutex_unlock(&RecordLock);
+
+			*period = (*numRising > 1) ? (lastRise - firstRise) / (*numRising - 1) : 0;
+			*highTime = (numHigh > 0) ? highSum / numHigh : 0;
+		}
+
+		unsigned long long Now()
+		{
+			return monotonicNs();
+		}
+
+	protected:
+		int requestLines(const unsigned int* lines, const unsigned char* levels, int numLines)
+		{
+			memcpy(Lines, lines, numLines * sizeof(unsigned int));
+			NumLines = numLines;
+			return L_OK;
+		}
+
+		void releaseLines()
+		{
+			NumLines = 0;
+		}
+
+		int writeLines(unsigned long long mask, unsigned long long bits)
+		{
+			pthread_mutex_lock(&RecordLock);
+			if(NumWrites < MAX_WRITES)
+			{
+				Times[NumWrites] = monotonicNs();
+				Masks[NumWrites] = mask;
+				Bits[NumWrites] = bits;
+				NumWrites++;
+			}
+			pthread_mutex_unlock(&RecordLock);
+			return L_OK;
+		}
+};
+
+const unsigned char digitalChans[2] = {7, 11};
+constexpr LinxChannelSlots digitalSlots(2, digitalChans);
+
+//Raspberry Pi With Two Digital Channels, sysfs Unavailable
+class SoftPwmRaspberryPi : public LinxRaspberryPi
+{
+	public:
+		RecordingSoftPwm* Recorder;
+
+		SoftPwmRaspberryPi()
+		{
+			bindDigitalSlots(&digitalSlots);
+			bindPwmSlots(LinxChannelSlots::None(), &digitalSlots);
+			DigitalChannels[7] = 4;
+			DigitalChannels[11] = 17;
+			DigitalDirHandles[7] = NULL;
+			DigitalDirHandles[11] = NULL;
+			DigitalValueHandles[7] = NULL;
+			DigitalValueHandles[11] = NULL;
+			Recorder = new RecordingSoftPwm();
+			SoftPwm = Recorder;
+		}
+
+		int OpenDigital(unsigned char channel)
+		{
+			return digitalSmartOpen(1, &channel);
+		}
+};
+
+bool near(unsigned long long value, unsigned long long expected, unsigned long long tolerance)
+{
+	return value + tolerance >= expected && value <= expected + tolerance;
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Square Wave Test :.\r\n\r\n");
+
+	SoftPwmRaspberryPi dev;
+	RecordingSoftPwm* recorder = dev.Recorder;
+	int numRising = 0;
+	unsigned long long period = 0;
+	unsigned long long highTime = 0;
+	unsigned long long lastWrite = 0;
+
+	//------------------------------------- Concurrent Waves -------------------------------------
+	{
+		check(dev.DigitalWriteSquareWave(7, 1000, 50) == L_OK, "start 1 kHz for 50 mS");
+		check(dev.DigitalWriteSquareWave(11, 500, 0) == L_OK, "start 500 Hz until stopped");
+		check(recorder->NumLines == 2 && recorder->Lines[0] == 4 && recorder->Lines[1] == 17, "both lines requested");
+
+		usleep(150000);
+		unsigned long long now = recorder->Now();
+
+		recorder->Measure(0, &numRising, &period, &highTime, &lastWrite);
+		check(numRising >= 48 && numRising <= 51, "1 kHz wave ran for its duration");
+		check(near(period, 1000000, 50000) && near(highTime, 500000, 100000), "1 kHz period and duty cycle");
+		check(now - lastWrite > 50000000, "1 kHz wave stopped low");
+
+		recorder->Measure(1, &numRising, &period, &highTime, &lastWrite);
+		check(near(period, 2000000, 50000) && now - lastWrite < 10000000, "500 Hz wave still running");
+	}
+
+	//------------------------------------- Restart On The Same Pin -------------------------------------
+	{
+		check(dev.DigitalWriteSquareWave(11, 250, 0) == L_OK, "restart at 250 Hz");
+		recorder->Clear();
+		usleep(100000);
+		recorder->Measure(1, &numRising, &period, &highTime, &lastWrite);
+		check(near(period, 4000000, 50000) && numRising >= 20 && numRising <= 26, "new wave replaced the old one");
+
+		check(dev.DigitalWriteSquareWave(7, 2000, 20) == L_OK, "restart finished wave");
+		recorder->Clear();
+		usleep(60000);
+		recorder->Measure(0, &numRising, &period, &highTime, &lastWrite);
+		check(numRising >= 38 && numRising <= 41 && near(period, 500000, 50000), "finished wave runs again");
+	}
+
+	//------------------------------------- Stop -------------------------------------
+	{
+		check(dev.DigitalWriteSquareWave(11, 0, 0) == L_OK && recorder->NumLines == 1 && recorder->Lines[0] == 4, "0 Hz stops the wave");
+		dev.OpenDigital(7);
+		check(recorder->NumLines == 0, "digital use cancels the wave");
+
+		unsigned char notDigital = 40;
+		check(dev.DigitalWriteSquareWave(notDigital, 1000, 0) == L_FUNCTION_NOT_SUPPORTED, "non digital channel rejected");
+		check(dev.DigitalWriteSquareWave(7, 1000000000UL / SOFT_PWM_MIN_PERIOD_NS + 1, 0) == L_UNKNOWN_ERROR && recorder->NumLines == 0, "frequency above the soft PWM limit rejected");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		LinxListener listener;
+		listener.LinxDev = &dev;
+
+		unsigned char cmd[] = {0xFF, 16, 0x00, 0x01, 0x00, 0x43, 7, 0x00, 0x00, 0x03, 0xE8, 0x00, 0x00, 0x00, 0x0A, 0};
+		unsigned char resp[32];
+		cmd[15] = listener.ComputeChecksum(cmd);
+		recorder->Clear();
+		listener.ProcessCommand(cmd, resp);
+		check(resp[4] == L_OK, "listener starts wave without blocking");
+		usleep(40000);
+		recorder->Measure(0, &numRising, &period, &highTime, &lastWrite);
+		check(numRising >= 9 && numRising <= 11, "listener wave duration");
+	}
+
+	return checkSummary();
+}
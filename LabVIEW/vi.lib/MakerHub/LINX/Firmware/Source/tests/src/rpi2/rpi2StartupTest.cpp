@@ -0,0 +1,66 @@
+/****************************************************************************************
+**  Host side test for lazy Raspberry Pi 2 B start up.
+**
+**  Checks that construction does not export any GPIO, that each construction step is
+**  timed and that prewarming rejects unknown channels.  Returns the number of failed
+**  checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "LinxRaspberryPi2B.h"
+#include "../LinxTestCheck.h"
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Raspberry Pi Start Up Test :.\r\n\r\n");
+
+	//------------------------------------- Construction -------------------------------------
+	{
+		unsigned long long start = monotonicUs();
+		LinxRaspberryPi2B* dev = new LinxRaspberryPi2B();
+		unsigned long long elapsed = monotonicUs() - start;
+		fprintf(stdout, "      constructed in %llu uS\n", elapsed);
+		check(elapsed < 200000, "construction well under a second");
+
+		bool untouched = true;
+		for(int i=0; i<NUM_DIGITAL_CHANS; i++)
+		{
+			untouched &= (dev->DigitalDirHandles[dev->DigitalChans[i]] == NULL && dev->DigitalValueHandles[dev->DigitalChans[i]] == NULL);
+		}
+		check(untouched, "no DIO handles opened at construction");
+		check(dev->DigitalChannels.Size() == NUM_DIGITAL_CHANS && dev->DigitalChannels[7] == (unsigned int)(dev->GpioChipBase + 4), "channel maps still filled");
+		check(!dev->DigitalChannels.Contains(8) && dev->DigitalChannels[8] == 0 && dev->DigitalChannels.Size() == NUM_DIGITAL_CHANS, "unknown channel looked up without growing the table");
+		check(dev->PwmPeriods.Contains(7) && dev->PwmPeriods[7] == 0 && !dev->PwmChipChans.Contains(7), "soft PWM state covers digital channels");
+
+		//------------------------------------- Startup Timing -------------------------------------
+		check(dev->NumStartupPhases == 4, "four construction steps timed");
+		bool named = true;
+		unsigned long long total = 0;
+		for(int i=0; i<dev->NumStartupPhases; i++)
+		{
+			named &= (dev->StartupPhaseNames[i] != NULL && strlen(dev->StartupPhaseNames[i]) > 0);
+			total += dev->StartupPhaseTimes[i];
+		}
+		check(named && strcmp(dev->StartupPhaseNames[0], "Non-Volatile Storage") == 0 && strcmp(dev->StartupPhaseNames[3], "Channel Maps") == 0, "steps named in order");
+		check(total <= elapsed, "step times add up to no more than construction");
+		dev->PrintStartupTiming();
+
+		//------------------------------------- Prewarm -------------------------------------
+		unsigned char badChans[2] = {7, 8};
+		check(dev->DigitalPrewarm(2, badChans) == LDIGITAL_PIN_DNE, "prewarm rejects unknown channel");
+		check(dev->DigitalDirHandles[7] == NULL, "nothing claimed when prewarm rejected");
+		check(dev->DigitalPrewarm(0, badChans) == L_OK, "empty prewarm");
+
+		delete dev;
+	}
+
+	return checkSummary();
+}
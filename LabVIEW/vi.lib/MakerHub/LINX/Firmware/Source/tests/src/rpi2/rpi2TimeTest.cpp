@@ -0,0 +1,74 @@
+/****************************************************************************************
+**  Host side test for the 64 bit monotonic device clock on the Raspberry Pi family.
+**
+**  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+//8 Byte Big Endian Value From A Response
+unsigned long long responseTime(unsigned char* resp)
+{
+	unsigned long long value = 0;
+	for(int i=0; i<8; i++)
+	{
+		value = (value << 8) | resp[5+i];
+	}
+	return value;
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Device Time Test :.\r\n\r\n");
+
+	LinxRaspberryPi dev;
+
+	//------------------------------------- Device -------------------------------------
+	{
+		unsigned long long startUs = dev.GetMicroSeconds();
+		unsigned long long startNs = dev.GetNanoSeconds();
+		usleep(20000);
+		unsigned long long elapsedUs = dev.GetMicroSeconds() - startUs;
+		unsigned long long elapsedNs = dev.GetNanoSeconds() - startNs;
+
+		check(elapsedUs >= 20000 && elapsedUs < 100000, "microseconds advance with sleep");
+		check(elapsedNs >= 20000000ULL && elapsedNs < 100000000ULL, "nanoseconds advance with sleep");
+		check(startNs / 1000 >= startUs && startNs / 1000 - startUs < 1000, "clocks share a timebase");
+		unsigned long ms = dev.GetMilliSeconds();
+		check(dev.GetMicroSeconds() / 1000 - ms < 2, "matches milliseconds");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		LinxListener listener;
+		listener.LinxDev = &dev;
+		unsigned char resp[32];
+
+		unsigned char cmd[] = {0xFF, 7, 0x00, 0x01, 0x00, 0x26, 0};
+		cmd[6] = listener.ComputeChecksum(cmd);
+		unsigned long long before = dev.GetMicroSeconds();
+		listener.ProcessCommand(cmd, resp);
+		unsigned long long after = dev.GetMicroSeconds();
+		unsigned long long deviceUs = responseTime(resp);
+		check(resp[4] == L_OK && resp[1] == 14 && listener.ChecksumPassed(resp), "listener device time response");
+		check(deviceUs >= before && deviceUs <= after, "listener time in microseconds");
+
+		unsigned char cmdNs[] = {0xFF, 8, 0x00, 0x02, 0x00, 0x26, 1, 0};
+		cmdNs[7] = listener.ComputeChecksum(cmdNs);
+		before = dev.GetNanoSeconds();
+		listener.ProcessCommand(cmdNs, resp);
+		after = dev.GetNanoSeconds();
+		unsigned long long deviceNs = responseTime(resp);
+		check(resp[4] == L_OK && deviceNs >= before && deviceNs <= after, "listener time in nanoseconds");
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,168 @@
+/****************************************************************************************
+**  Host side test for UART passthrough through the Linux TCP listener.
+**
+**  The UART is replaced with a pseudo terminal and the client connection with a socket
+**  pair so the test runs without hardware or a network.  Returns the number of failed
+**  checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pty.h>
+#include <sys/socket.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "utility/LinxListener.h"
+#include "LinxLinuxTcpListener.h"
+#include "../LinxTestCheck.h"
+
+const unsigned char uartChans[1] = {0};
+constexpr LinxChannelSlots uartSlots(1, uartChans);
+
+//Raspberry Pi With The UART Replaced By A pty
+class PtyRaspberryPi : public LinxRaspberryPi
+{
+	public:
+		PtyRaspberryPi(const char* path)
+		{
+			UartMaxBaud = 4000000;
+			bindUartSlots(&uartSlots);
+			UartPaths[0] = path;
+			UartHandles[0] = 0;
+		}
+};
+
+int master = -1;
+int host = -1;
+
+//Build A Command Packet With The Given Command And Data
+int buildCommand(LinxListener& listener, unsigned char* packet, unsigned short command, const unsigned char* data, int dataSize)
+{
+	packet[0] = 0xFF;
+	packet[1] = dataSize + 7;
+	packet[2] = 0x00;
+	packet[3] = 0x01;
+	packet[4] = command >> 8;
+	packet[5] = command & 0xFF;
+	memcpy(&packet[6], data, dataSize);
+	packet[dataSize + 6] = listener.ComputeChecksum(packet);
+	return dataSize + 7;
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: UART Passthrough Test :.\r\n\r\n");
+
+	int slave = -1;
+	char slaveName[64];
+	int sockets[2];
+	if(openpty(&master, &slave, slaveName, NULL, NULL) < 0 || socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) < 0)
+	{
+		fprintf(stdout, "openpty / socketpair failed\n");
+		return 1;
+	}
+	host = sockets[0];
+
+	PtyRaspberryPi dev(slaveName);
+	unsigned long actualBaud = 0;
+	dev.UartOpen(0, 115200, &actualBaud);
+
+	LinxLinuxTcpListener listener;
+	listener.LinxDev = &dev;
+	listener.recBuffer = (unsigned char*)malloc(dev.ListenerBufferSize);
+	listener.sendBuffer = (unsigned char*)malloc(dev.ListenerBufferSize);
+	listener.ClientSocket = sockets[1];
+	listener.State = CONNECTED;
+
+	unsigned char packet[256];
+	unsigned char resp[256];
+	unsigned char channel = 0;
+
+	//------------------------------------- Start -------------------------------------
+	{
+		int size = buildCommand(listener, packet, 0x00C8, &channel, 1);
+		check(write(host, packet, size) == size, "send passthrough start");
+		listener.Connected();
+		check(read(host, resp, sizeof(resp)) == 6 && resp[4] == L_OK, "passthrough start response");
+		check(listener.PassthroughActive(), "passthrough active");
+	}
+
+	//------------------------------------- UART To Client -------------------------------------
+	{
+		unsigned char data[1000];
+		for(int i=0; i<1000; i++)
+		{
+			data[i] = i * 7;
+		}
+		check(write(master, data, 1000) == 1000, "write pty");
+
+		//Collect Frames Until All Data Arrived
+		unsigned char stream[4096];
+		int streamSize = 0;
+		unsigned char received[1000];
+		int numReceived = 0;
+		bool framesValid = true;
+		for(int loop=0; loop<100 && numReceived < 1000; loop++)
+		{
+			listener.Connected();
+			int bytesRead = recv(host, stream + streamSize, sizeof(stream) - streamSize, MSG_DONTWAIT);
+			if(bytesRead > 0)
+			{
+				streamSize += bytesRead;
+			}
+			while(streamSize >= 2 && streamSize >= stream[1])
+			{
+				int frameSize = stream[1];
+				if(stream[0] != PASSTHROUGH_SOF || stream[2] != channel || !listener.ChecksumPassed(stream))
+				{
+					framesValid = false;
+				}
+				memcpy(received + numReceived, &stream[3], frameSize - 4);
+				numReceived += frameSize - 4;
+				memmove(stream, stream + frameSize, streamSize - frameSize);
+				streamSize -= frameSize;
+			}
+		}
+		check(framesValid, "frames valid");
+		check(numReceived == 1000 && memcmp(received, data, 1000) == 0, "UART data forwarded");
+	}
+
+	//------------------------------------- Client To UART, Interleaved With A Command -------------------------------------
+	{
+		unsigned char frame[16] = {PASSTHROUGH_SOF, 9, 0, 'h', 'e', 'l', 'l', 'o'};
+		frame[8] = listener.ComputeChecksum(frame);
+		int size = buildCommand(listener, packet, 0x0000, NULL, 0);
+		memcpy(packet + size, frame, 9);
+
+		check(write(host, packet, size + 9) == size + 9, "send sync and frame together");
+		listener.Connected();
+		listener.Connected();
+
+		check(read(host, resp, sizeof(resp)) == 6 && resp[4] == L_OK, "sync response");
+
+		char text[16] = {0};
+		usleep(10000);
+		check(read(master, text, sizeof(text)) == 5 && strcmp(text, "hello") == 0, "frame written to UART");
+	}
+
+	//------------------------------------- Stop -------------------------------------
+	{
+		int size = buildCommand(listener, packet, 0x00C9, &channel, 1);
+		check(write(host, packet, size) == size, "send passthrough stop");
+		listener.Connected();
+		check(read(host, resp, sizeof(resp)) == 6 && resp[4] == L_OK, "passthrough stop response");
+		check(!listener.PassthroughActive(), "passthrough stopped");
+	}
+
+	dev.UartClose(0);
+	close(master);
+	close(sockets[0]);
+	close(sockets[1]);
+
+	return checkSummary();
+}
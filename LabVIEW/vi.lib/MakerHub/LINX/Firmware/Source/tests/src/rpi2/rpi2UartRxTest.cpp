@@ -0,0 +1,147 @@
+/****************************************************************************************
+**  Host side test for the UART receive thread on the Raspberry Pi family.
+**
+**  The UART is replaced with a pseudo terminal so the test runs without hardware.  The
+**  test writes into the pty master and reads back through the LINX UART functions.
+**  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pty.h>
+#include <pthread.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+const unsigned char uartChans[1] = {0};
+constexpr LinxChannelSlots uartSlots(1, uartChans);
+
+//Raspberry Pi With The UART Replaced By A pty
+class PtyRaspberryPi : public LinxRaspberryPi
+{
+	public:
+		PtyRaspberryPi(const char* path)
+		{
+			UartMaxBaud = 4000000;
+			bindUartSlots(&uartSlots);
+			UartPaths[0] = path;
+			UartHandles[0] = 0;
+		}
+};
+
+int master = -1;
+
+void writeMaster(unsigned long numBytes, unsigned char first)
+{
+	unsigned char data[4096];
+	for(unsigned long i=0; i<numBytes; i++)
+	{
+		data[i] = (unsigned char)(first + i);
+	}
+	if(write(master, data, numBytes) != (int)numBytes)
+	{
+		fprintf(stdout, "pty write failed\n");
+	}
+}
+
+void* lateWriter(void* arg)
+{
+	usleep(20000);
+	writeMaster(10, 0x40);
+	return NULL;
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: UART RX Thread Test :.\r\n\r\n");
+
+	int slave = -1;
+	char slaveName[64];
+	if(openpty(&master, &slave, slaveName, NULL, NULL) < 0)
+	{
+		fprintf(stdout, "openpty failed\n");
+		return 1;
+	}
+
+	PtyRaspberryPi dev(slaveName);
+	unsigned long actualBaud = 0;
+	check(dev.UartOpen(0, 3000000, &actualBaud) == L_OK && actualBaud != 0, "open at 3 Mbaud");
+	check(dev.UartSetBaudRate(0, 8000000, &actualBaud) == L_OK && actualBaud <= 4000000, "baud clamped to UartMaxBaud");
+
+	//------------------------------------- Without RX Thread -------------------------------------
+	{
+		unsigned char rx[64];
+		unsigned long numRead = 0;
+		unsigned long long timestamp = 0;
+
+		writeMaster(20, 0);
+		check(dev.UartReadTimeout(0, 20, 200, rx, &numRead, &timestamp) == L_OK && numRead == 20 && rx[19] == 19, "poll read without thread");
+		check(timestamp != 0, "poll read timestamp");
+		check(dev.UartReadTimeout(0, 1, 20, rx, &numRead, &timestamp) == L_OK && numRead == 0, "poll read times out");
+	}
+
+	//------------------------------------- With RX Thread -------------------------------------
+	{
+		unsigned char rx[2048];
+		unsigned char count = 0;
+		unsigned long buffered = 0;
+		unsigned long numRead = 0;
+		unsigned long long timestamp = 0;
+
+		check(dev.UartEnableRxThread(0, 0xFFFFFFFF) == LUART_OPEN_FAIL && dev.UartRxThreads[0] == NULL, "oversized ring rejected");
+		check(dev.UartEnableRxThread(0, 1024) == L_OK, "enable rx thread");
+
+		writeMaster(300, 0);
+		usleep(50000);
+		check(dev.UartGetBytesAvailable(0, &count) == L_OK && count == 255, "bytes available clamped to 255");
+		check(dev.UartGetBytesBuffered(0, &buffered) == L_OK && buffered == 300, "bytes buffered not truncated");
+
+		unsigned char numReadByte = 0;
+		check(dev.UartRead(0, 100, rx, &numReadByte) == L_OK && numReadByte == 100 && rx[99] == 99, "read from ring");
+		check(dev.UartReadTimeout(0, 200, 0, rx, &numRead, &timestamp) == L_OK && numRead == 200 && rx[0] == 100, "read rest of ring");
+		check(timestamp != 0, "ring timestamp");
+
+		pthread_t writer;
+		pthread_create(&writer, NULL, lateWriter, NULL);
+		check(dev.UartReadTimeout(0, 10, 1000, rx, &numRead, NULL) == L_OK && numRead == 10 && rx[0] == 0x40, "blocking read waits for data");
+		pthread_join(writer, NULL);
+
+		check(dev.UartReadTimeout(0, 1, 20, rx, &numRead, NULL) == L_OK && numRead == 0, "blocking read times out");
+
+		//Ring Holds 1024, Send More Without Reading
+		writeMaster(1500, 0);
+		usleep(100000);
+		check(dev.UartReadTimeout(0, 2048, 0, rx, &numRead, NULL) == LUART_OVERRUN && numRead == 1024, "overrun reported");
+		check(dev.UartReadTimeout(0, 1, 0, rx, &numRead, NULL) == L_OK, "overrun cleared after report");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		LinxListener listener;
+		listener.LinxDev = &dev;
+
+		unsigned char cmd[64];
+		unsigned char resp[256];
+		unsigned char packet[] = {0xFF, 11, 0x00, 0x01, 0x00, 0xC7, 0, 5, 0x00, 0x64, 0};
+		memcpy(cmd, packet, sizeof(packet));
+		cmd[10] = listener.ComputeChecksum(cmd);
+
+		writeMaster(5, 0x20);
+		listener.ProcessCommand(cmd, resp);
+		check(resp[4] == L_OK && resp[1] == 6 + 8 + 5, "listener response status and size");
+		check(resp[13] == 0x20 && resp[17] == 0x24, "listener response data");
+		check((resp[5] | resp[6] | resp[7] | resp[8] | resp[9] | resp[10] | resp[11] | resp[12]) != 0, "listener timestamp");
+		check(listener.ChecksumPassed(resp), "listener response checksum");
+	}
+
+	check(dev.UartClose(0) == L_OK, "close stops rx thread");
+
+	close(master);
+	return checkSummary();
+}
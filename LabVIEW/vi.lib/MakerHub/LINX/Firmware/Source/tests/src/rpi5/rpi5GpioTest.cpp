@@ -0,0 +1,199 @@
+/****************************************************************************************
+**  Host side test for Raspberry Pi 5 digital I/O on the GPIO character device.
+**
+**  GPIO ioctls are answered by a fake RP1 chip that tracks each requested line's
+**  direction and level, so the test runs without hardware.  Returns the number of
+**  failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <map>
+#include <linux/gpio.h>
+
+#include "LinxDevice.h"
+#include "LinxRaspberryPi.h"
+#include "LinxRaspberryPi5.h"
+#include "LinxSoftPwm.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+using namespace std;
+
+typedef struct FakeLine
+{
+	unsigned int offset;
+	unsigned long long flags;
+	unsigned char level;
+}FakeLine;
+
+//Scheduler That Accepts Every Line Without Driving A gpiochip
+class NullSoftPwm : public LinxSoftPwm
+{
+	public:
+		NullSoftPwm() : LinxSoftPwm("/dev/null")
+		{
+		}
+
+		~NullSoftPwm()
+		{
+			Close();
+		}
+
+	protected:
+		int requestLines(const unsigned int* lines, const unsigned char* levels, int numLines)
+		{
+			return L_OK;
+		}
+
+		void releaseLines()
+		{
+		}
+
+		int writeLines(unsigned long long mask, unsigned long long bits)
+		{
+			return L_OK;
+		}
+};
+
+//Raspberry Pi 5 With GPIO ioctls Answered By A Fake RP1
+class FakeGpioRaspberryPi5 : public LinxRaspberryPi5
+{
+	public:
+		map<int, FakeLine> Lines;				//By Line Request Handle
+		int NumRequests;
+		int NumConfigs;
+		int NumValueIoctls;
+
+		FakeGpioRaspberryPi5()
+		{
+			GpioChipPath = "/dev/null";
+			NumRequests = 0;
+			NumConfigs = 0;
+			NumValueIoctls = 0;
+			SoftPwm = new NullSoftPwm();
+		}
+
+		FakeLine* Line(unsigned char channel)
+		{
+			if(DigitalLineHandles[channel] < 0)
+			{
+				return NULL;
+			}
+			return &Lines[DigitalLineHandles[channel]];
+		}
+
+	protected:
+		int gpioIoctl(int handle, unsigned long request, void* arg)
+		{
+			if(request == GPIO_V2_GET_LINE_IOCTL)
+			{
+				struct gpio_v2_line_request* lineRequest = (struct gpio_v2_line_request*)arg;
+				lineRequest->fd = open("/dev/null", O_RDONLY);
+				FakeLine line = {lineRequest->offsets[0], lineRequest->config.flags, 0};
+				Lines[lineRequest->fd] = line;
+				NumRequests++;
+				return 0;
+			}
+			if(Lines.find(handle) == Lines.end())
+			{
+				return -1;
+			}
+			if(request == GPIO_V2_LINE_SET_CONFIG_IOCTL)
+			{
+				Lines[handle].flags = ((struct gpio_v2_line_config*)arg)->flags;
+				NumConfigs++;
+				return 0;
+			}
+			if(request == GPIO_V2_LINE_SET_VALUES_IOCTL)
+			{
+				Lines[handle].level = ((struct gpio_v2_line_values*)arg)->bits & 0x01;
+				NumValueIoctls++;
+				return 0;
+			}
+			if(request == GPIO_V2_LINE_GET_VALUES_IOCTL)
+			{
+				((struct gpio_v2_line_values*)arg)->bits = Lines[handle].level;
+				NumValueIoctls++;
+				return 0;
+			}
+			return -1;
+		}
+};
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Raspberry Pi 5 GPIO Test :.\r\n\r\n");
+
+	FakeGpioRaspberryPi5 dev;
+
+	//------------------------------------- Identity -------------------------------------
+	check(dev.DeviceFamily == 0x04 && dev.DeviceId == 0x05, "family and device id");
+	check(dev.NumDigitalChans == 17 && dev.DigitalChannels[7] == 4 && dev.DigitalChannels[40] == 21, "header pins map to RP1 lines");
+	check(dev.Lines.size() == 0, "no lines requested before use");
+
+	//------------------------------------- Write -------------------------------------
+	{
+		unsigned char chans[2] = {7, 11};
+		unsigned char values[1] = {0x01};
+		check(dev.DigitalWrite(2, chans, values) == L_OK && dev.NumRequests == 2, "write requests both lines");
+		check(dev.Line(7)->offset == 4 && dev.Line(11)->offset == 17, "line offsets");
+		check((dev.Line(7)->flags & GPIO_V2_LINE_FLAG_OUTPUT) && dev.Line(7)->level == 1 && dev.Line(11)->level == 0, "bit packed write");
+
+		int numConfigs = dev.NumConfigs;
+		values[0] = 0x02;
+		check(dev.DigitalWrite(2, chans, values) == L_OK && dev.NumConfigs == numConfigs && dev.NumRequests == 2, "repeat write is value ioctls only");
+		check(dev.Line(7)->level == 0 && dev.Line(11)->level == 1, "second write");
+
+		unsigned char unpacked[2] = {1, 1};
+		check(dev.DigitalWriteNoPacking(2, chans, unpacked) == L_OK && dev.Line(7)->level == 1 && dev.Line(11)->level == 1, "write without packing");
+	}
+
+	//------------------------------------- Read -------------------------------------
+	{
+		unsigned char chans[3] = {7, 11, 12};
+		unsigned char values[1] = {0};
+		dev.Lines[dev.DigitalLineHandles[7]].level = 1;
+		check(dev.DigitalRead(3, chans, values) == L_OK, "read");
+		check((dev.Line(7)->flags & GPIO_V2_LINE_FLAG_INPUT) && (dev.Line(12)->flags & GPIO_V2_LINE_FLAG_INPUT), "read switches lines to input");
+		check(values[0] == 0xC0, "read packed MSb first");
+
+		unsigned char unpacked[3] = {0xFF, 0xFF, 0xFF};
+		check(dev.DigitalReadNoPacking(3, chans, unpacked) == L_OK && unpacked[0] == 1 && unpacked[1] == 1 && unpacked[2] == 0, "read without packing");
+
+		unsigned char notDigital = 41;
+		check(dev.DigitalRead(1, &notDigital, values) != L_OK, "non digital channel rejected");
+	}
+
+	//------------------------------------- Square Wave Hand Off -------------------------------------
+	{
+		check(dev.DigitalWriteSquareWave(7, 1000, 0) == L_OK && dev.Line(7) == NULL, "square wave takes the line");
+		unsigned char chan = 7;
+		unsigned char value = 1;
+		check(dev.DigitalWrite(1, &chan, &value) == L_OK && dev.Line(7) != NULL && dev.Line(7)->level == 1, "digital write takes it back");
+		check((dev.Line(7)->flags & GPIO_V2_LINE_FLAG_OUTPUT) != 0, "direction set again after hand off");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		LinxListener listener;
+		listener.LinxDev = &dev;
+
+		unsigned char cmd[] = {0xFF, 10, 0x00, 0x01, 0x00, 0x41, 1, 40, 0x01, 0};
+		unsigned char resp[32];
+		cmd[9] = listener.ComputeChecksum(cmd);
+		listener.ProcessCommand(cmd, resp);
+		check(resp[4] == L_OK && dev.Line(40) != NULL && dev.Line(40)->level == 1, "listener digital write");
+
+		unsigned char id[] = {0xFF, 7, 0x00, 0x02, 0x00, 0x03, 0};
+		id[6] = listener.ComputeChecksum(id);
+		listener.ProcessCommand(id, resp);
+		check(resp[4] == L_OK && resp[5] == 0x04 && resp[6] == 0x05, "listener device id");
+	}
+
+	return checkSummary();
+}
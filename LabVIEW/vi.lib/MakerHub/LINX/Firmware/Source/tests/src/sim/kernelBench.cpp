@@ -0,0 +1,285 @@
+/****************************************************************************************
+**  Micro benchmark for the LINX protocol and packing kernels.
+**
+**  Times packet checksums, response packetizing, command dispatch, N bit sample
+**  packing, DIO bitmaps and buffer bit reversal across buffer sizes.  Each case is
+**  calibrated to run for a fixed time and the median of several runs is kept.  Prints
+**  one JSON object per line with the time per call and per byte.
+**
+**  Usage: kernelBench.out [Filter]       Only cases whose name contains Filter run.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+
+#include "LinxDevice.h"
+#include "LinxBitPack.h"
+#include "LinxSimDevice.h"
+#include "utility/LinxListener.h"
+
+using namespace std;
+
+#define BENCH_TARGET_NS 20000000ULL		//Each Run Of A Case Lasts About This Long
+#define BENCH_RUNS 5					//Median Of This Many Runs Is Reported
+
+//Keep The Compiler From Dropping Work Whose Result Is Unused
+#define BENCH_USE(ptr) __asm__ __volatile__("" : : "r"(ptr) : "memory")
+
+typedef void (*BenchFunction)(unsigned long size, unsigned long iterations);
+
+static const char* Filter = NULL;
+static LinxListener* Listener;
+
+static unsigned char Src[1 << 16];
+static unsigned char Dst[1 << 16];
+static unsigned long Samples[1 << 14];
+
+unsigned long long monotonicNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+//------------------------------------- Cases -------------------------------------
+//size Is The Packet Length In Bytes
+void benchChecksum(unsigned long size, unsigned long iterations)
+{
+	Src[0] = 0xFF;
+	Src[1] = (unsigned char)size;
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		unsigned char checksum = Listener->ComputeChecksum(Src);
+		BENCH_USE(&checksum);
+	}
+}
+
+//size Is The Response Data Length In Bytes
+void benchPacketize(unsigned long size, unsigned long iterations)
+{
+	unsigned char command[8] = {0xFF, 7, 0x12, 0x34, 0x00, 0x00, 0};
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		Listener->PacketizeAndSend(command, Dst, size, L_OK);
+		BENCH_USE(Dst);
+	}
+}
+
+//size Is The Number Of Channels In A Digital Write, Decoded And Dispatched To The Simulated Device.  The Packet Carries About 1.125 Bytes Per Channel.
+void benchProcessDigitalWrite(unsigned long size, unsigned long iterations)
+{
+	unsigned char command[255];
+	command[0] = 0xFF;
+	command[1] = 7 + 1 + size + (size + 7) / 8;
+	command[2] = 0;
+	command[3] = 1;
+	command[4] = 0x00;
+	command[5] = 0x41;
+	command[6] = (unsigned char)size;
+	for(unsigned long i=0; i<size; i++)
+	{
+		command[7 + i] = i % NUM_DIGITAL_CHANS;
+	}
+	memset(command + 7 + size, 0xA5, (size + 7) / 8);
+	command[command[1] - 1] = Listener->ComputeChecksum(command);
+
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		Listener->ProcessCommand(command, Dst);
+		BENCH_USE(Dst);
+	}
+}
+
+//size Is The Number Of Samples, At The 12 Bit Resolution Most Boards Use
+void benchPack12(unsigned long size, unsigned long iterations)
+{
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		LinxBitPack::Pack(size, Samples, 12, Dst);
+		BENCH_USE(Dst);
+	}
+}
+
+void benchPack16(unsigned long size, unsigned long iterations)
+{
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		LinxBitPack::Pack(size, Samples, 16, Dst);
+		BENCH_USE(Dst);
+	}
+}
+
+void benchUnpack12(unsigned long size, unsigned long iterations)
+{
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		LinxBitPack::Unpack(size, Src, 12, Samples);
+		BENCH_USE(Samples);
+	}
+}
+
+//size Is The Number Of Channels
+void benchPackBits(unsigned long size, unsigned long iterations)
+{
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		LinxBitPack::PackBits(size, Src, Dst);
+		BENCH_USE(Dst);
+	}
+}
+
+void benchUnpackBits(unsigned long size, unsigned long iterations)
+{
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		LinxBitPack::UnpackBits(size, Src, Dst);
+		BENCH_USE(Dst);
+	}
+}
+
+//size Is The Number Of Bytes
+void benchReverseBits(unsigned long size, unsigned long iterations)
+{
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		LinxBitPack::ReverseBits(size, Src, Dst);
+		BENCH_USE(Dst);
+	}
+}
+
+void benchReverseBitsBytewise(unsigned long size, unsigned long iterations)
+{
+	for(unsigned long i=0; i<iterations; i++)
+	{
+		for(unsigned long j=0; j<size; j++)
+		{
+			Dst[j] = LinxBitPack::ReverseBits(Src[j]);
+		}
+		BENCH_USE(Dst);
+	}
+}
+
+//------------------------------------- Harness -------------------------------------
+//Grow The Iteration Count Until One Run Takes A Measurable Time, Then Scale To The Target
+unsigned long calibrate(BenchFunction function, unsigned long size)
+{
+	unsigned long iterations = 1;
+	while(1)
+	{
+		unsigned long long start = monotonicNs();
+		function(size, iterations);
+		unsigned long long elapsed = monotonicNs() - start;
+		if(elapsed > BENCH_TARGET_NS / 10 || iterations >= (1UL << 30))
+		{
+			unsigned long long scaled = (unsigned long long)iterations * BENCH_TARGET_NS / (elapsed ? elapsed : 1);
+			return (scaled > 0) ? (unsigned long)scaled : 1;
+		}
+		iterations *= 10;
+	}
+}
+
+//bytesPerUnit Converts size To Bytes Touched For The Per Byte Figure
+void run(const char* name, BenchFunction function, unsigned long size, double bytesPerUnit)
+{
+	if(Filter != NULL && strstr(name, Filter) == NULL)
+	{
+		return;
+	}
+
+	unsigned long iterations = calibrate(function, size);
+	double nsPerCall[BENCH_RUNS];
+	for(int r=0; r<BENCH_RUNS; r++)
+	{
+		unsigned long long start = monotonicNs();
+		function(size, iterations);
+		nsPerCall[r] = (double)(monotonicNs() - start) / iterations;
+	}
+	sort(nsPerCall, nsPerCall + BENCH_RUNS);
+
+	double median = nsPerCall[BENCH_RUNS / 2];
+	double bytes = size * bytesPerUnit;
+	fprintf(stdout, "{\"kernel\":\"%s\",\"size\":%lu,\"iterations\":%lu,\"ns_per_call\":%.2f,\"ns_per_byte\":%.3f,\"min_ns_per_call\":%.2f,\"max_ns_per_call\":%.2f}\n", name, size, iterations, median, (bytes > 0) ? median / bytes : 0, nsPerCall[0], nsPerCall[BENCH_RUNS - 1]);
+	fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+	Filter = (argc > 1) ? argv[1] : NULL;
+
+	srand(1);
+	for(unsigned long i=0; i<sizeof(Src); i++)
+	{
+		Src[i] = (unsigned char)rand();
+	}
+	for(unsigned long i=0; i<sizeof(Samples) / sizeof(Samples[0]); i++)
+	{
+		Samples[i] = rand() & 0xFFFF;
+	}
+
+	LinxSimDevice dev;
+	LinxListener listener;
+	listener.LinxDev = &dev;
+	Listener = &listener;
+
+	fprintf(stderr, "reverse kernel %s\n", LinxBitPack::ReverseKernel());
+
+	//Protocol, Up To The Largest Packet The Listener Buffers Take
+	static const unsigned long packetSizes[] = {8, 16, 32, 64, 128, 255};
+	for(unsigned int i=0; i<sizeof(packetSizes) / sizeof(packetSizes[0]); i++)
+	{
+		run("checksum", benchChecksum, packetSizes[i], 1);
+	}
+	for(unsigned int i=0; i<sizeof(packetSizes) / sizeof(packetSizes[0]); i++)
+	{
+		run("packetize", benchPacketize, packetSizes[i] - 6, 1);
+	}
+	static const unsigned long dioSizes[] = {1, 8, 32, 64};
+	for(unsigned int i=0; i<sizeof(dioSizes) / sizeof(dioSizes[0]); i++)
+	{
+		run("process_digital_write", benchProcessDigitalWrite, dioSizes[i], 1.125);
+	}
+
+	//Sample Packing, From One Listener Packet Up To A Large Stream Read
+	static const unsigned long sampleSizes[] = {8, 64, 160, 1024, 16384};
+	for(unsigned int i=0; i<sizeof(sampleSizes) / sizeof(sampleSizes[0]); i++)
+	{
+		run("pack12", benchPack12, sampleSizes[i], 1.5);
+	}
+	for(unsigned int i=0; i<sizeof(sampleSizes) / sizeof(sampleSizes[0]); i++)
+	{
+		run("pack16", benchPack16, sampleSizes[i], 2);
+	}
+	for(unsigned int i=0; i<sizeof(sampleSizes) / sizeof(sampleSizes[0]); i++)
+	{
+		run("unpack12", benchUnpack12, sampleSizes[i], 1.5);
+	}
+
+	//DIO Bitmaps, Per Channel
+	static const unsigned long bitSizes[] = {8, 32, 64, 256, 2000};
+	for(unsigned int i=0; i<sizeof(bitSizes) / sizeof(bitSizes[0]); i++)
+	{
+		run("pack_bits", benchPackBits, bitSizes[i], 1);
+	}
+	for(unsigned int i=0; i<sizeof(bitSizes) / sizeof(bitSizes[0]); i++)
+	{
+		run("unpack_bits", benchUnpackBits, bitSizes[i], 1);
+	}
+
+	//SPI Bit Reversal
+	static const unsigned long byteSizes[] = {4, 16, 64, 255, 4096, 65536};
+	for(unsigned int i=0; i<sizeof(byteSizes) / sizeof(byteSizes[0]); i++)
+	{
+		run("reverse_bits", benchReverseBits, byteSizes[i], 1);
+	}
+	for(unsigned int i=0; i<sizeof(byteSizes) / sizeof(byteSizes[0]); i++)
+	{
+		run("reverse_bits_bytewise", benchReverseBitsBytewise, byteSizes[i], 1);
+	}
+
+	return 0;
+}
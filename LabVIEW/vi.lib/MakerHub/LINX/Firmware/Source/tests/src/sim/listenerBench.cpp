@@ -0,0 +1,386 @@
+/****************************************************************************************
+**  End to end loopback benchmark for the LINX listeners.
+**
+**  Runs the TCP listener on localhost and the serial listener over a pty pair, each in
+**  a child process against a simulated device, and drives a fixed mix of commands at
+**  them one at a time.  Prints one JSON object per line: the round trip latency
+**  percentiles, commands per second and CPU per command for each transport, followed
+**  by the latency percentiles of each command in the mix.
+**
+**  Usage: listenerBench.out [Commands Per Transport]
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <vector>
+#include <algorithm>
+
+#include "LinxDevice.h"
+#include "LinxSimDevice.h"
+#include "LinxSerialListener.h"
+#include "LinxLinuxTcpListener.h"
+
+using namespace std;
+
+#define BENCH_DEFAULT_COMMANDS 20000
+#define BENCH_WARMUP_COMMANDS 200
+#define BENCH_TIMEOUT_MS 2000
+#define BENCH_SERIAL_CHAN 0
+#define BENCH_UART_CHAN 1
+#define BENCH_I2C_ADDRESS 0x50
+
+typedef struct BenchCommand
+{
+	const char* name;
+	unsigned short command;
+	unsigned char numBytes;
+	unsigned char payload[32];
+}BenchCommand;
+
+//Mix Roughly Like A LabVIEW Loop Polling A Few Sensors And Setting Outputs, Repeated In Order
+static const BenchCommand Mix[] =
+{
+	{"sync", 0x0000, 0, {0}},
+	{"digital_write", 0x0041, 5, {4, 2, 3, 4, 5, 0x05}},
+	{"digital_read", 0x0042, 4, {6, 7, 8, 9}},
+	{"analog_read", 0x0064, 4, {0, 1, 2, 3}},
+	{"spi_write_read", 0x0107, 12, {0, 8, 10, 0, 1, 2, 3, 4, 5, 6, 7, 8}},
+	{"i2c_write", 0x00E2, 6, {0, BENCH_I2C_ADDRESS, EOF_STOP, 0x10, 0xDE, 0xAD}},
+	{"uart_write", 0x00C4, 9, {BENCH_UART_CHAN, 'L', 'I', 'N', 'X', 'B', 'E', 'N', 'C'}},
+	{"uart_read", 0x00C3, 2, {BENCH_UART_CHAN, 8}},
+	{"pwm_set_duty_cycle", 0x0083, 5, {2, 3, 5, 0x80, 0x40}},
+};
+#define BENCH_MIX_SIZE (sizeof(Mix) / sizeof(Mix[0]))
+
+//Untimed Commands That Open The Peripherals The Mix Uses
+static const BenchCommand Setup[] =
+{
+	{"uart_open", 0x00C0, 5, {BENCH_UART_CHAN, 0x00, 0x01, 0xC2, 0x00}},
+	{"i2c_open", 0x00E0, 1, {0}},
+	{"spi_open", 0x0100, 1, {0}},
+};
+#define BENCH_SETUP_SIZE (sizeof(Setup) / sizeof(Setup[0]))
+
+unsigned long long monotonicNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+unsigned long long cpuUs(int who)
+{
+	struct rusage usage;
+	getrusage(who, &usage);
+	return (unsigned long long)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ULL + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+//Device The Listener Child Serves, With An I2C Slave So Writes Are ACKed
+LinxSimDevice* newBenchDevice(LinxSimSlave* slave)
+{
+	LinxSimDevice* dev = new LinxSimDevice();
+	dev->AttachI2cSlave(0, BENCH_I2C_ADDRESS, slave);
+	return dev;
+}
+
+int buildPacket(const BenchCommand* command, unsigned short packetNum, unsigned char* packet)
+{
+	packet[0] = 0xFF;
+	packet[1] = command->numBytes + 7;
+	packet[2] = packetNum >> 8;
+	packet[3] = packetNum & 0xFF;
+	packet[4] = command->command >> 8;
+	packet[5] = command->command & 0xFF;
+	memcpy(packet + 6, command->payload, command->numBytes);
+
+	unsigned char checksum = 0;
+	for(int i=0; i<packet[1]-1; i++)
+	{
+		checksum += packet[i];
+	}
+	packet[packet[1]-1] = checksum;
+	return packet[1];
+}
+
+//Read Exactly numBytes Or Fail After The Timeout
+bool readFully(int fd, unsigned char* buffer, int numBytes)
+{
+	int received = 0;
+	while(received < numBytes)
+	{
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		if(poll(&pfd, 1, BENCH_TIMEOUT_MS) <= 0)
+		{
+			return false;
+		}
+		int result = read(fd, buffer + received, numBytes - received);
+		if(result < 0 && (errno == EAGAIN || errno == EINTR))
+		{
+			continue;
+		}
+		if(result <= 0)
+		{
+			return false;
+		}
+		received += result;
+	}
+	return true;
+}
+
+bool writeFully(int fd, const unsigned char* buffer, int numBytes)
+{
+	int written = 0;
+	while(written < numBytes)
+	{
+		int result = write(fd, buffer + written, numBytes - written);
+		if(result < 0 && (errno == EAGAIN || errno == EINTR))
+		{
+			continue;
+		}
+		if(result <= 0)
+		{
+			return false;
+		}
+		written += result;
+	}
+	return true;
+}
+
+//One Command, One Response.  Returns The Round Trip In nS Or 0 On Failure.
+unsigned long long roundTrip(int fd, const BenchCommand* command, unsigned short packetNum)
+{
+	unsigned char packet[64];
+	unsigned char response[256];
+	int size = buildPacket(command, packetNum, packet);
+
+	unsigned long long start = monotonicNs();
+	if(!writeFully(fd, packet, size) || !readFully(fd, response, 2) || !readFully(fd, response + 2, response[1] - 2))
+	{
+		return 0;
+	}
+	unsigned long long elapsed = monotonicNs() - start;
+
+	if(response[0] != 0xFF || response[2] != packet[2] || response[3] != packet[3] || response[4] != L_OK)
+	{
+		fprintf(stderr, "%s failed with status %d\n", command->name, response[4]);
+		return 0;
+	}
+	return elapsed;
+}
+
+unsigned long long percentile(vector<unsigned long long>& sorted, double fraction)
+{
+	if(sorted.empty())
+	{
+		return 0;
+	}
+	size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+void printLatencies(vector<unsigned long long>& samples)
+{
+	sort(samples.begin(), samples.end());
+	fprintf(stdout, "\"p50_us\":%.2f,\"p99_us\":%.2f,\"p999_us\":%.2f,\"max_us\":%.2f", percentile(samples, 0.50) / 1000.0, percentile(samples, 0.99) / 1000.0, percentile(samples, 0.999) / 1000.0, percentile(samples, 1.0) / 1000.0);
+}
+
+//Drive The Mix Through fd, Then Stop The Listener Child And Report
+int runBench(const char* transport, int fd, pid_t listener, unsigned long numCommands)
+{
+	unsigned long long childCpuBefore = cpuUs(RUSAGE_CHILDREN);
+	unsigned short packetNum = 0;
+
+	for(unsigned int i=0; i<BENCH_SETUP_SIZE; i++)
+	{
+		if(roundTrip(fd, &Setup[i], packetNum++) == 0)
+		{
+			fprintf(stderr, "%s: %s failed\n", transport, Setup[i].name);
+			kill(listener, SIGKILL);
+			waitpid(listener, NULL, 0);
+			return -1;
+		}
+	}
+	for(unsigned int i=0; i<BENCH_WARMUP_COMMANDS; i++)
+	{
+		roundTrip(fd, &Mix[i % BENCH_MIX_SIZE], packetNum++);
+	}
+
+	vector<unsigned long long> all;
+	vector<unsigned long long> byCommand[BENCH_MIX_SIZE];
+	all.reserve(numCommands);
+	unsigned long numFailed = 0;
+
+	unsigned long long clientCpuStart = cpuUs(RUSAGE_SELF);
+	unsigned long long start = monotonicNs();
+	for(unsigned long i=0; i<numCommands; i++)
+	{
+		unsigned long long elapsed = roundTrip(fd, &Mix[i % BENCH_MIX_SIZE], packetNum++);
+		if(elapsed == 0)
+		{
+			numFailed++;
+			continue;
+		}
+		all.push_back(elapsed);
+		byCommand[i % BENCH_MIX_SIZE].push_back(elapsed);
+	}
+	unsigned long long wallNs = monotonicNs() - start;
+	unsigned long long clientCpu = cpuUs(RUSAGE_SELF) - clientCpuStart;
+
+	//Listener CPU Covers Setup And Warm Up Too, Which Is Small Next To The Run
+	close(fd);
+	kill(listener, SIGTERM);
+	waitpid(listener, NULL, 0);
+	unsigned long long listenerCpu = cpuUs(RUSAGE_CHILDREN) - childCpuBefore;
+
+	unsigned long numDone = all.size();
+	fprintf(stdout, "{\"transport\":\"%s\",\"command\":\"mix\",\"commands\":%lu,\"failed\":%lu,", transport, numDone, numFailed);
+	printLatencies(all);
+	fprintf(stdout, ",\"commands_per_s\":%.0f,\"listener_cpu_us_per_cmd\":%.2f,\"client_cpu_us_per_cmd\":%.2f}\n", numDone * 1e9 / wallNs, numDone ? (double)listenerCpu / numDone : 0, numDone ? (double)clientCpu / numDone : 0);
+
+	for(unsigned int i=0; i<BENCH_MIX_SIZE; i++)
+	{
+		fprintf(stdout, "{\"transport\":\"%s\",\"command\":\"%s\",\"commands\":%lu,", transport, Mix[i].name, (unsigned long)byCommand[i].size());
+		printLatencies(byCommand[i]);
+		fprintf(stdout, "}\n");
+	}
+	fflush(stdout);
+	return (numFailed == 0) ? 0 : -1;
+}
+
+//------------------------------------- TCP -------------------------------------
+unsigned short freePort()
+{
+	int probe = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	bind(probe, (struct sockaddr*)&address, sizeof(address));
+	socklen_t length = sizeof(address);
+	getsockname(probe, (struct sockaddr*)&address, &length);
+	close(probe);
+	return ntohs(address.sin_port);
+}
+
+int benchTcp(unsigned long numCommands)
+{
+	unsigned short port = freePort();
+	pid_t listener = fork();
+	if(listener == 0)
+	{
+		LinxSimSlave slave;
+		LinxSimDevice* dev = newBenchDevice(&slave);
+		if(LinxTcpConnection.Start(dev, port) != 0)
+		{
+			_exit(1);
+		}
+		while(1)
+		{
+			LinxTcpConnection.CheckForCommands();
+		}
+	}
+
+	//Connect Once The Child Is Listening
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	int attempts = 0;
+	while(connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0)
+	{
+		if(++attempts > 200)
+		{
+			fprintf(stderr, "tcp: unable to connect to the listener\n");
+			kill(listener, SIGKILL);
+			waitpid(listener, NULL, 0);
+			return -1;
+		}
+		close(fd);
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+		usleep(10000);
+	}
+	int noDelay = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+	return runBench("tcp", fd, listener, numCommands);
+}
+
+//------------------------------------- Serial -------------------------------------
+void makeRaw(int fd)
+{
+	struct termios options;
+	tcgetattr(fd, &options);
+	cfmakeraw(&options);
+	tcsetattr(fd, TCSANOW, &options);
+}
+
+int benchSerial(unsigned long numCommands)
+{
+	int masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+	if(masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0)
+	{
+		fprintf(stderr, "serial: unable to open a pty\n");
+		return -1;
+	}
+	makeRaw(masterFd);
+	int slaveFd = open(ptsname(masterFd), O_RDWR | O_NOCTTY);
+	if(slaveFd < 0)
+	{
+		fprintf(stderr, "serial: unable to open %s\n", ptsname(masterFd));
+		return -1;
+	}
+	makeRaw(slaveFd);
+
+	pid_t listener = fork();
+	if(listener == 0)
+	{
+		close(slaveFd);
+		fcntl(masterFd, F_SETFL, O_NONBLOCK);
+		LinxSimSlave slave;
+		LinxSimDevice* dev = newBenchDevice(&slave);
+		dev->UartAttach(BENCH_SERIAL_CHAN, masterFd);
+		LinxSerialConnection.Start(dev, BENCH_SERIAL_CHAN);
+		while(1)
+		{
+			LinxSerialConnection.CheckForCommands();
+		}
+	}
+	close(masterFd);
+
+	return runBench("serial", slaveFd, listener, numCommands);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned long numCommands = (argc > 1) ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_COMMANDS;
+	if(numCommands == 0)
+	{
+		fprintf(stderr, "Usage: %s [Commands Per Transport]\n", argv[0]);
+		return -1;
+	}
+
+	int status = 0;
+	status |= benchTcp(numCommands);
+	status |= benchSerial(numCommands);
+	return (status == 0) ? 0 : 1;
+}
@@ -0,0 +1,372 @@
+/****************************************************************************************
+**  Host side test for the simulated LINX device.
+**
+**  Drives the device directly and through the listener's packet handling: DIO state,
+**  AI waveforms and streaming, SPI and I2C slaves, UART loopback, the latency model
+**  and the listener's per command timing stats and event trace.  Returns the number of
+**  failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "LinxDevice.h"
+#include "LinxSimDevice.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+//Build A Command Packet Around The Payload And Process It, Returns The Response Status
+int sendCommand(LinxListener* listener, unsigned short command, const unsigned char* payload, unsigned char numBytes, unsigned char* resp)
+{
+	unsigned char cmd[255];
+	cmd[0] = 0xFF;
+	cmd[1] = numBytes + 7;
+	cmd[2] = 0x00;
+	cmd[3] = 0x01;
+	cmd[4] = command >> 8;
+	cmd[5] = command & 0xFF;
+	memcpy(cmd + 6, payload, numBytes);
+	cmd[numBytes + 6] = listener->ComputeChecksum(cmd);
+	listener->ProcessCommand(cmd, resp);
+	return resp[4];
+}
+
+//Slave That Answers Every SPI Byte With Its Complement
+class InvertingSlave : public LinxSimSlave
+{
+	public:
+		void SpiTransfer(unsigned char numBytes, const unsigned char* mosi, unsigned char* miso)
+		{
+			for(int i=0; i<numBytes; i++)
+			{
+				miso[i] = ~mosi[i];
+			}
+		}
+};
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Simulated Device Test :.\r\n\r\n");
+
+	LinxSimDevice dev;
+	LinxListener listener;
+	listener.LinxDev = &dev;
+	unsigned char resp[255];
+
+	//------------------------------------- Identity -------------------------------------
+	{
+		check(sendCommand(&listener, 0x0003, NULL, 0, resp) == L_OK && resp[5] == 0xFE && resp[6] == 0x01, "listener device id");
+	}
+
+	//------------------------------------- Digital -------------------------------------
+	{
+		unsigned char write[] = {3, 2, 9, 31, 0x05};
+		check(sendCommand(&listener, 0x0041, write, sizeof(write), resp) == L_OK, "listener digital write");
+		check(dev.DigitalOutputs[2] == HIGH && dev.DigitalOutputs[9] == LOW && dev.DigitalOutputs[31] == HIGH && dev.DigitalDirs[9] == OUTPUT, "write latches levels and makes outputs");
+
+		dev.SetDigitalInput(4, HIGH);
+		dev.SetDigitalInput(6, HIGH);
+		unsigned char read[] = {4, 5, 6};
+		check(sendCommand(&listener, 0x0042, read, sizeof(read), resp) == L_OK && resp[5] == 0xA0, "listener digital read");
+		check(dev.DigitalDirs[4] == INPUT, "read makes inputs");
+
+		unsigned char bad[] = {1, 32, 0x01};
+		check(sendCommand(&listener, 0x0041, bad, sizeof(bad), resp) == LDIGITAL_PIN_DNE, "unknown pin rejected");
+	}
+
+	//------------------------------------- Analog -------------------------------------
+	{
+		dev.SetAnalogWaveform(0, SIM_WAVE_CONSTANT, 1234, 0, 0);
+		dev.SetAnalogWaveform(1, SIM_WAVE_CONSTANT, 5000, 0, 0);
+		unsigned char chans[] = {0, 1};
+		check(sendCommand(&listener, 0x0064, chans, sizeof(chans), resp) == L_OK && resp[5] == 12, "listener analog read");
+		check(resp[6] == 0xD2 && resp[7] == 0xF4 && resp[8] == 0xFF, "values packed and clamped to resolution");
+
+		dev.SetAnalogWaveform(2, SIM_WAVE_SINE, 2048, 1000, 50);
+		unsigned long minimum = 4095;
+		unsigned long maximum = 0;
+		for(int i=0; i<200; i++)
+		{
+			unsigned char chan = 2;
+			unsigned long value;
+			dev.AnalogReadNoPacking(1, &chan, &value);
+			minimum = (value < minimum) ? value : minimum;
+			maximum = (value > maximum) ? value : maximum;
+			usleep(100);
+		}
+		check(minimum >= 1048 && maximum <= 3048 && maximum - minimum > 1000, "sine stays within offset +/- amplitude");
+
+		dev.SetAnalogStreamRate(10000);
+		unsigned char streamChans[] = {0, 1};
+		unsigned long values[2 * 50];
+		unsigned long numRead = 0;
+		check(dev.AnalogStreamStart(2, streamChans, 100) == L_OK, "stream start");
+		int status = dev.AnalogStreamReadNoPacking(50, 1000, values, &numRead);
+		check(status == L_OK && numRead == 50 && values[0] == 1234 && values[50] == 4095, "stream scans channel major");
+		usleep(50000);
+		status = dev.AnalogStreamReadNoPacking(50, 1000, values, &numRead);
+		check(status == LANALOG_STREAM_OVERRUN && numRead == 50, "late read reports overrun once");
+		status = dev.AnalogStreamReadNoPacking(10, 1000, values, &numRead);
+		check(status == L_OK, "overrun cleared");
+		dev.AnalogStreamStop();
+		check(dev.AnalogStreamReadNoPacking(1, 0, values, &numRead) == LANALOG_STREAM_OPEN_FAIL, "read after stop fails");
+	}
+
+	//------------------------------------- SPI -------------------------------------
+	{
+		unsigned char send[4] = {0x01, 0x80, 0x3C, 0xA5};
+		unsigned char rec[4];
+		check(dev.SpiWriteRead(0, 4, 1, 8, 0, send, rec) == L_OK && memcmp(send, rec, 4) == 0, "no slave loops back");
+		check(dev.DigitalOutputs[8] == HIGH, "chip select released");
+
+		InvertingSlave inverter;
+		dev.AttachSpiSlave(1, &inverter);
+		dev.SpiWriteRead(1, 2, 2, 8, 0, send, rec);
+		check(rec[0] == 0xFE && rec[1] == 0x7F && rec[3] == 0x5A, "slave answers full duplex");
+
+		LinxSimSlave registers;
+		dev.AttachSpiSlave(0, &registers);
+		dev.SpiSetBitOrder(0, LSBFIRST);
+		unsigned char writeReg[2] = {0x80, 0x01};
+		dev.SpiWriteRead(0, 2, 1, 8, 0, writeReg, rec);
+		check(registers.Registers[1] == 0x80, "slave sees LSb first bytes on the wire");
+
+		unsigned long actual = 0;
+		dev.SpiSetSpeed(0, 3000000, &actual);
+		check(actual == 2000000, "speed rounds down to a supported rate");
+	}
+
+	//------------------------------------- I2C -------------------------------------
+	{
+		LinxSimSlave eeprom;
+		dev.AttachI2cSlave(0, 0x50, &eeprom);
+
+		unsigned char open[] = {0};
+		check(sendCommand(&listener, 0x00E0, open, 1, resp) == L_OK, "listener i2c open");
+
+		unsigned char write[] = {0, 0x50, EOF_STOP, 0x10, 0xDE, 0xAD};
+		check(sendCommand(&listener, 0x00E2, write, sizeof(write), resp) == L_OK && eeprom.Registers[0x10] == 0xDE && eeprom.Registers[0x11] == 0xAD, "listener i2c write");
+
+		unsigned char pointer[] = {0, 0x50, EOF_STOP, 0x10};
+		sendCommand(&listener, 0x00E2, pointer, sizeof(pointer), resp);
+		unsigned char read[] = {0, 0x50, 2, 0, 100, EOF_STOP};
+		check(sendCommand(&listener, 0x00E3, read, sizeof(read), resp) == L_OK && resp[5] == 0xDE && resp[6] == 0xAD, "listener i2c read");
+
+		unsigned char nack[] = {0, 0x51, EOF_STOP, 0x00};
+		check(sendCommand(&listener, 0x00E2, nack, sizeof(nack), resp) == LI2C_WRITE_FAIL, "empty address nacks");
+
+		unsigned char writeRead[] = {0, 0x50, 2, 0, 100, 0x10};
+		check(sendCommand(&listener, 0x00E5, writeRead, sizeof(writeRead), resp) == L_OK && resp[5] == 0xDE && resp[6] == 0xAD, "listener i2c write read");
+		check(sendCommand(&listener, 0x00E5, writeRead, 4, resp) == LI2C_INVALID_TRANSACTION, "short write read rejected");
+		writeRead[2] = 250;
+		check(sendCommand(&listener, 0x00E5, writeRead, sizeof(writeRead), resp) == LI2C_INVALID_TRANSACTION, "oversized write read rejected");
+	}
+
+	//------------------------------------- UART -------------------------------------
+	{
+		unsigned long baud = 0;
+		dev.UartOpen(1, 115200, &baud);
+		unsigned char send[] = {1, 'L', 'I', 'N', 'X'};
+		check(sendCommand(&listener, 0x00C4, send, sizeof(send), resp) == L_OK, "listener uart write");
+
+		unsigned char available = 0;
+		dev.UartGetBytesAvailable(1, &available);
+		check(available == 4, "loopback holds written bytes");
+
+		unsigned char receive[] = {1, 4};
+		check(sendCommand(&listener, 0x00C3, receive, sizeof(receive), resp) == L_OK && resp[1] == 10 && memcmp(resp + 5, "LINX", 4) == 0, "listener uart read");
+
+		int fds[2];
+		pipe(fds);
+		dev.UartAttach(2, fds[0]);
+		dev.UartOpen(2, 9600, &baud);
+		write(fds[1], "ok", 2);
+		unsigned char rec[2];
+		unsigned char numRead = 0;
+		dev.UartRead(2, 2, rec, &numRead);
+		check(numRead == 2 && rec[0] == 'o' && rec[1] == 'k', "attached handle carries the uart");
+		close(fds[0]);
+		close(fds[1]);
+	}
+
+	//------------------------------------- Latency -------------------------------------
+	{
+		unsigned long before = dev.OpCounts[SIM_OP_DIGITAL];
+		dev.SetLatency(SIM_OP_DIGITAL, 500000, 100000, 0);
+		unsigned char chans[] = {0, 1, 2, 3, 4};
+		unsigned char values[] = {0x1F};
+		unsigned long long start = monotonicUs();
+		dev.DigitalWrite(5, chans, values);
+		unsigned long long elapsed = monotonicUs() - start;
+		check(elapsed >= 1000 && elapsed < 20000, "fixed plus per channel latency");
+		check(dev.OpCounts[SIM_OP_DIGITAL] == before + 1, "operations counted");
+		dev.SetLatency(SIM_OP_DIGITAL, 0, 0, 0);
+	}
+
+	//------------------------------------- Non Volatile -------------------------------------
+	{
+		unsigned char data[3] = {1, 2, 3};
+		unsigned char back[3];
+		dev.NonVolatileWriteBlock(100, 3, data);
+		dev.NonVolatileReadBlock(100, 3, back);
+		check(memcmp(data, back, 3) == 0 && dev.NonVolatileRead(99) == 0xFF, "nvs round trip");
+	}
+
+	//------------------------------------- Command Stats -------------------------------------
+	{
+		bool edges = true;
+		for(unsigned long long ns=1; ns<(1ULL << 40); ns=ns*3+1)
+		{
+			unsigned int bucket = LinxCommandStats::BucketOf(ns);
+			edges &= (ns <= LinxCommandStats::BucketUpperEdge(bucket) || bucket == STATS_NUM_BUCKETS - 1);
+			edges &= (bucket == 0 || ns > LinxCommandStats::BucketUpperEdge(bucket - 1));
+		}
+		check(edges, "every time falls inside its bucket");
+		check(LinxCommandStats::BucketOf(1000) == LinxCommandStats::BucketOf(1023) && LinxCommandStats::BucketOf(1023) != LinxCommandStats::BucketOf(1024), "log linear bucket boundaries");
+
+		check(sendCommand(&listener, 0x0029, NULL, 0, resp) == L_OK, "listener stats reset");
+		dev.SetLatency(SIM_OP_DIGITAL, 200000, 0, 0);
+		unsigned char write[] = {1, 2, 0x01};
+		for(int i=0; i<10; i++)
+		{
+			sendCommand(&listener, 0x0041, write, sizeof(write), resp);
+			listener.ResponseSent();
+		}
+		dev.SetLatency(SIM_OP_DIGITAL, 0, 0, 0);
+
+		unsigned char first[] = {0};
+		check(sendCommand(&listener, 0x0027, first, 1, resp) == L_OK && resp[6] == 1 && resp[7] >= 1, "listener stats summary");
+		//Entries Are The Opcode Then Count, Min, Mean, Max, p50, p99, p999 For Handler And End To End
+		unsigned char* entry = &resp[8];
+		check(entry[0] == 0x00 && entry[1] == 0x29, "reset is the first opcode seen");
+		entry += 2 + STATS_NUM_KINDS*STATS_NUM_VALUES*4;
+		unsigned long count = ((unsigned long)entry[2] << 24) | (entry[3] << 16) | (entry[4] << 8) | entry[5];
+		unsigned long minimum = ((unsigned long)entry[6] << 24) | (entry[7] << 16) | (entry[8] << 8) | entry[9];
+		unsigned long p50 = ((unsigned long)entry[18] << 24) | (entry[19] << 16) | (entry[20] << 8) | entry[21];
+		unsigned long endToEnd = ((unsigned long)entry[30] << 24) | (entry[31] << 16) | (entry[32] << 8) | entry[33];
+		check(entry[0] == 0x00 && entry[1] == 0x41 && count == 10, "digital write counted");
+		check(minimum >= 200000 && p50 >= minimum && p50 < 400000, "handler time covers the simulated latency");
+		check(endToEnd == 10, "end to end counted per response");
+
+		unsigned char histogram[] = {0x00, 0x41, STATS_HANDLER, 0};
+		check(sendCommand(&listener, 0x0028, histogram, sizeof(histogram), resp) == L_OK && resp[5] == STATS_SUB_BITS && resp[6] == STATS_NUM_BUCKETS && resp[8] > 0, "listener stats histogram");
+		unsigned long total = 0;
+		for(unsigned char first=0; first<STATS_NUM_BUCKETS; first+=resp[8])
+		{
+			histogram[3] = first;
+			sendCommand(&listener, 0x0028, histogram, sizeof(histogram), resp);
+			for(int i=0; i<resp[8]; i++)
+			{
+				total += ((unsigned long)resp[9+i*4] << 24) | (resp[10+i*4] << 16) | (resp[11+i*4] << 8) | resp[12+i*4];
+			}
+		}
+		check(total == 10, "histogram holds every sample");
+	}
+
+	//------------------------------------- Trace -------------------------------------
+	{
+		unsigned char configure[] = {0xFF, 0xFF, 1};
+		check(sendCommand(&listener, 0x002B, configure, sizeof(configure), resp) == L_OK, "listener trace clear");
+		unsigned char write[] = {1, 2, 0x01};
+		for(int i=0; i<3; i++)
+		{
+			sendCommand(&listener, 0x0041, write, sizeof(write), resp);
+			listener.ResponseSent();
+		}
+		listener.PacketDropped(TRACE_DROP_CHECKSUM);
+		LinxListenerState previous = listener.State;
+		listener.State = CLOSE;
+		listener.StateChanged(previous);
+		listener.State = previous;
+
+		//Page Through Everything Since The Clear, The Get Trace Commands Trace Themselves As Well
+		LinxTraceEvent events[64];
+		unsigned int numEvents = 0;
+		unsigned long next = 0;
+		bool paged = true;
+		unsigned char get[4] = {0, 0, 0, 0};
+		while(numEvents < 40)
+		{
+			paged &= (sendCommand(&listener, 0x002A, get, sizeof(get), resp) == L_OK && resp[13] <= 15 && resp[1] == 15 + resp[13]*TRACE_EVENT_SIZE);
+			unsigned long first = ((unsigned long)resp[9] << 24) | (resp[10] << 16) | (resp[11] << 8) | resp[12];
+			next = ((unsigned long)resp[5] << 24) | (resp[6] << 16) | (resp[7] << 8) | resp[8];
+			paged &= (numEvents == 0 || first == next - resp[13] || resp[13] == 0);
+			for(int i=0; i<resp[13]; i++)
+			{
+				LinxTrace::DecodeEvent(&resp[14 + i*TRACE_EVENT_SIZE], &events[numEvents++]);
+			}
+			if(resp[13] == 0 || first + resp[13] >= next)
+			{
+				break;
+			}
+			unsigned long following = first + resp[13];
+			get[0] = following >> 24;
+			get[1] = following >> 16;
+			get[2] = following >> 8;
+			get[3] = following;
+		}
+		check(paged && numEvents > 15, "listener trace pages");
+
+		//Configure's Own End, Three Writes, The Drop, The State Change
+		check(events[0].type == TRACE_HANDLER_END && events[0].command == 0x002B, "trace starts at the clear");
+		bool writes = true;
+		for(int i=0; i<3; i++)
+		{
+			LinxTraceEvent* e = &events[1 + i*4];
+			writes &= (e[0].type == TRACE_PACKET_RX && e[0].command == 0x0041 && (e[0].arg >> 16) == 10);
+			writes &= (e[1].type == TRACE_HANDLER_START && e[2].type == TRACE_HANDLER_END && e[2].status == L_OK && e[2].arg == 6);
+			writes &= (e[3].type == TRACE_PACKET_TX && e[3].command == 0x0041 && e[3].arg > 0);
+			writes &= (e[0].time <= e[1].time && e[1].time <= e[2].time && e[2].time <= e[3].time);
+		}
+		check(writes, "packet, handler and response events in order");
+		check(events[13].type == TRACE_DROP && events[13].status == TRACE_DROP_CHECKSUM, "drop traced");
+		check(events[14].type == TRACE_STATE && events[14].status == CLOSE && events[14].arg == (unsigned long)previous, "state change traced");
+
+		//Masked Types Are Not Recorded
+		unsigned char dropsOnly[] = {0x00, 1 << TRACE_DROP, 0};
+		sendCommand(&listener, 0x002B, dropsOnly, sizeof(dropsOnly), resp);
+		unsigned long before = listener.Trace.Next();
+		sendCommand(&listener, 0x0041, write, sizeof(write), resp);
+		check(listener.Trace.Next() == before, "trace mask");
+		listener.Trace.Mask = 0xFFFF;
+
+		//Once Wrapped The Slot Being Written Next Is Never Reported
+		for(int i=0; i<TRACE_NUM_EVENTS + 10; i++)
+		{
+			listener.Trace.Record(i, TRACE_USER, 0, 0, i);
+		}
+		uint32_t first = 0;
+		unsigned int numRead = listener.Trace.Read(&first, events, 64);
+		check(listener.Trace.Oldest() == listener.Trace.Next() - (TRACE_NUM_EVENTS - 1) && first == listener.Trace.Oldest(), "trace ring wraps");
+		check(numRead == 64 && events[0].arg == 11 && events[63].arg == 74, "oldest events read after wrapping");
+
+		//Dump On A Signal, Then Read The File Back
+		char path[64];
+		snprintf(path, sizeof(path), "/tmp/linx_trace_test_%d.bin", (int)getpid());
+		check(listener.Trace.DumpOnSignal(SIGUSR2, path) == L_OK, "trace dump signal installed");
+		raise(SIGUSR2);
+		unsigned char header[TRACE_FILE_HEADER_SIZE];
+		unsigned char last[TRACE_EVENT_SIZE];
+		FILE* file = fopen(path, "rb");
+		bool dumped = (file != NULL && fread(header, 1, sizeof(header), file) == sizeof(header));
+		unsigned long count = dumped ? ((unsigned long)header[12] << 24) | (header[13] << 16) | (header[14] << 8) | header[15] : 0;
+		dumped &= (header[0] == 'L' && header[1] == 'X' && header[2] == 'T' && header[3] == 'R' && count == TRACE_NUM_EVENTS - 1);
+		dumped &= (fseek(file, TRACE_FILE_HEADER_SIZE + (count - 1)*TRACE_EVENT_SIZE, SEEK_SET) == 0 && fread(last, 1, sizeof(last), file) == sizeof(last));
+		LinxTraceEvent event;
+		LinxTrace::DecodeEvent(last, &event);
+		check(dumped && event.type == TRACE_USER && event.arg == TRACE_NUM_EVENTS + 9, "trace dumped on signal");
+		if(file != NULL)
+		{
+			fclose(file);
+		}
+		unlink(path);
+		signal(SIGUSR2, SIG_DFL);
+	}
+
+	return checkSummary();
+}
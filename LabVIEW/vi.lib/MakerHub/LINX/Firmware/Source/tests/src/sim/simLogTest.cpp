@@ -0,0 +1,250 @@
+/****************************************************************************************
+**  Host side test for deferred logging.
+**
+**  Captures messages through a sink and checks formatting of each conversion, that %s
+**  arguments are copied when the message is written, runtime level filtering, drop
+**  counting when the ring is full and the listener's Get / Set Log Level command.  Also
+**  prints the cost of capturing a message against formatting and writing it in place.
+**  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "LinxDevice.h"
+#include "LinxSimDevice.h"
+#include "LinxLog.h"
+#include "utility/LinxListener.h"
+#include "../LinxTestCheck.h"
+
+#define MAX_LINES (LOG_NUM_RECORDS + 16)
+#define BENCH_MESSAGES (LOG_NUM_RECORDS / 2)
+
+//Written By Whoever Is Polling, Read By main() After Flush()
+char Lines[MAX_LINES][LOG_LINE_SIZE];
+int NumLines = 0;
+volatile bool HoldSink = false;
+volatile bool SinkEntered = false;
+
+unsigned long long monotonicNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+//While HoldSink Is Set The First Line Parks The Formatter Here, So Nothing Else Leaves The Ring
+void captureSink(int level, const char* line)
+{
+	if(__atomic_load_n(&HoldSink, __ATOMIC_ACQUIRE))
+	{
+		__atomic_store_n(&SinkEntered, true, __ATOMIC_RELEASE);
+		while(__atomic_load_n(&HoldSink, __ATOMIC_ACQUIRE))
+		{
+			usleep(100);
+		}
+	}
+	if(NumLines < MAX_LINES)
+	{
+		strncpy(Lines[NumLines], line, LOG_LINE_SIZE - 1);
+		Lines[NumLines][LOG_LINE_SIZE - 1] = '\0';
+	}
+	NumLines++;
+}
+
+void holdFormatter()
+{
+	SinkEntered = false;
+	__atomic_store_n(&HoldSink, true, __ATOMIC_RELEASE);
+	LINX_LOG_ERROR("Hold");
+	while(!__atomic_load_n(&SinkEntered, __ATOMIC_ACQUIRE))
+	{
+		usleep(100);
+	}
+}
+
+void releaseFormatter()
+{
+	__atomic_store_n(&HoldSink, false, __ATOMIC_RELEASE);
+	LinxLogger.Flush();
+}
+
+//Text After The "[L s.mmm] " Prefix
+const char* body(int line)
+{
+	if(line < 0 || line >= NumLines || line >= MAX_LINES)
+	{
+		return "";
+	}
+	const char* text = strstr(Lines[line], "] ");
+	return (text != NULL) ? text + 2 : Lines[line];
+}
+
+int sendCommand(LinxListener* listener, unsigned short command, const unsigned char* payload, unsigned char numBytes, unsigned char* resp)
+{
+	unsigned char cmd[255];
+	cmd[0] = 0xFF;
+	cmd[1] = numBytes + 7;
+	cmd[2] = 0x00;
+	cmd[3] = 0x01;
+	cmd[4] = command >> 8;
+	cmd[5] = command & 0xFF;
+	memcpy(cmd + 6, payload, numBytes);
+	cmd[numBytes + 6] = listener->ComputeChecksum(cmd);
+	listener->ProcessCommand(cmd, resp);
+	return resp[4];
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Deferred Log Test :.\r\n\r\n");
+
+	LinxSimDevice dev;
+	LinxListener listener;
+	listener.LinxDev = &dev;
+	unsigned char resp[255];
+
+	LinxLogger.Attach(&dev);
+	LinxLogger.SetSink(captureSink);
+	LinxLogger.Level = LOG_LEVEL_DEBUG;
+
+	//------------------------------------- Formatting -------------------------------------
+	{
+		NumLines = 0;
+		LINX_LOG_INFO("Int %d Neg %i Unsigned %u Hex 0x%04X Long %ld Long Long %lld", 42, -7, 3000000000u, 0xBEEF, -123456789L, 1234567890123LL);
+		LINX_LOG_DEBUG("%c %.2f %s|%5s|%-4d| 100%%", 'x', 3.14159, "abc", "ab", 7);
+		LINX_LOG_DEBUG("%d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7);
+		LINX_LOG_WARN("Short %hu Char %hhu", (unsigned short)65535, (unsigned char)200);
+		LinxLogger.Flush();
+
+		check(NumLines == 4, "every message is output");
+		check(strncmp(Lines[0], "[I ", 3) == 0 && strncmp(Lines[3], "[W ", 3) == 0, "prefix carries the level");
+		check(strcmp(body(0), "Int 42 Neg -7 Unsigned 3000000000 Hex 0xBEEF Long -123456789 Long Long 1234567890123") == 0, "integer conversions");
+		check(strcmp(body(1), "x 3.14 abc|   ab|7   | 100%") == 0, "char, double, string, width and %%");
+		check(strcmp(body(2), "1 2 3 4 5 6 ?") == 0, "arguments past the limit print as ?");
+		check(strcmp(body(3), "Short 65535 Char 200") == 0, "h and hh lengths");
+	}
+
+	//------------------------------------- Copying -------------------------------------
+	{
+		NumLines = 0;
+		char name[LOG_TEXT_SIZE * 2];
+		strcpy(name, "before");
+		holdFormatter();
+		LINX_LOG_DEBUG("Name %s", name);
+		strcpy(name, "after");
+
+		memset(name, 'z', sizeof(name) - 1);
+		name[sizeof(name) - 1] = '\0';
+		LINX_LOG_DEBUG("Long %s End", name);
+		const char* volatile nullName = NULL;		//Volatile So The Compiler Cannot See The NULL And Warn
+		LINX_LOG_DEBUG("Null %s", nullName);
+		releaseFormatter();
+
+		check(NumLines == 4 && strcmp(body(1), "Name before") == 0, "strings are copied when written");
+		check(strlen(body(2)) == strlen("Long  End") + LOG_TEXT_SIZE - 1 && strstr(body(2), " End") != NULL, "long strings are truncated to the text area");
+		check(strcmp(body(3), "Null (null)") == 0, "null string");
+	}
+
+	//------------------------------------- Levels -------------------------------------
+	{
+		NumLines = 0;
+		LinxLogger.Level = LOG_LEVEL_WARN;
+		LINX_LOG_DEBUG("Debug");
+		LINX_LOG_INFO("Info");
+		LINX_LOG_WARN("Warn");
+		LINX_LOG_ERROR("Error");
+		LinxLogger.Flush();
+		check(NumLines == 2 && strcmp(body(0), "Warn") == 0 && strcmp(body(1), "Error") == 0, "runtime level filters");
+
+		NumLines = 0;
+		LinxLogger.Level = LOG_LEVEL_NONE;
+		LINX_LOG_ERROR("Error");
+		LinxLogger.Flush();
+		check(NumLines == 0 && LinxLogger.Dropped == 0, "level none captures nothing");
+		LinxLogger.Level = LOG_LEVEL_DEBUG;
+	}
+
+	//------------------------------------- Overflow -------------------------------------
+	{
+		NumLines = 0;
+		holdFormatter();
+		for(int i=0; i<LOG_NUM_RECORDS + 5; i++)
+		{
+			LINX_LOG_DEBUG("Message %d", i);
+		}
+		check(LinxLogger.Dropped == 5, "full ring drops instead of blocking");
+		releaseFormatter();
+
+		//The Drop Report Comes At The End Of Whichever Poll Saw It, So It May Land Among The Messages
+		int next = 0;
+		int numReports = 0;
+		bool inOrder = true;
+		for(int i=1; i<NumLines && i<MAX_LINES; i++)
+		{
+			int number;
+			if(strstr(Lines[i], "5 Log Message(s) Dropped") != NULL)
+			{
+				numReports++;
+			}
+			else if(sscanf(body(i), "Message %d", &number) != 1 || number != next++)
+			{
+				inOrder = false;
+			}
+		}
+		check(NumLines == LOG_NUM_RECORDS + 2 && inOrder && next == LOG_NUM_RECORDS, "messages kept in order");
+		check(numReports == 1, "drops are reported once");
+	}
+
+	//------------------------------------- Listener -------------------------------------
+	{
+		check(sendCommand(&listener, 0x002C, NULL, 0, resp) == L_OK && resp[1] == 12, "listener get log level");
+		unsigned long dropped = (unsigned long)resp[7]<<24 | (unsigned long)resp[8]<<16 | resp[9]<<8 | resp[10];
+		check(resp[5] == LINX_LOG_LEVEL && resp[6] == LOG_LEVEL_DEBUG && dropped == 5, "compile level, runtime level and drops");
+
+		unsigned char warn[] = {LOG_LEVEL_WARN};
+		check(sendCommand(&listener, 0x002C, warn, sizeof(warn), resp) == L_OK && resp[6] == LOG_LEVEL_WARN && LinxLogger.Level == LOG_LEVEL_WARN, "listener set log level");
+
+		unsigned char none[] = {(unsigned char)LOG_LEVEL_NONE};
+		sendCommand(&listener, 0x002C, none, sizeof(none), resp);
+		check(LinxLogger.Level == LOG_LEVEL_NONE && (signed char)resp[6] == LOG_LEVEL_NONE, "listener turns logging off");
+		LinxLogger.Level = LOG_LEVEL_DEBUG;
+	}
+
+	//------------------------------------- Cost -------------------------------------
+	{
+		//The Formatter Is Held So Capture Does Not Share The CPU With It
+		holdFormatter();
+		unsigned long long start = monotonicNs();
+		for(int i=0; i<BENCH_MESSAGES; i++)
+		{
+			LINX_LOG_DEBUG("Servo %u Pulse Width %u", i & 7, 1500 + i);
+		}
+		unsigned long long capture = monotonicNs() - start;
+		releaseFormatter();
+
+		int devNull = open("/dev/null", O_WRONLY);
+		char line[LOG_LINE_SIZE];
+		start = monotonicNs();
+		for(int i=0; i<BENCH_MESSAGES; i++)
+		{
+			int n = snprintf(line, sizeof(line), "[D %lu.%03lu] Servo %u Pulse Width %u", dev.GetMilliSeconds() / 1000, dev.GetMilliSeconds() % 1000, i & 7, 1500 + i);
+			if(write(devNull, line, n) != n)
+			{
+				break;
+			}
+		}
+		unsigned long long synchronous = monotonicNs() - start;
+		close(devNull);
+
+		fprintf(stdout, "INFO  capture %.1f nS / message, format and write in place %.1f nS / message\n", (double)capture / BENCH_MESSAGES, (double)synchronous / BENCH_MESSAGES);
+		check(LinxLogger.Dropped == 5, "no drops below the ring size");
+	}
+
+	return checkSummary();
+}
@@ -0,0 +1,425 @@
+/****************************************************************************************
+**  Host side test for the remote LINX device.
+**
+**  Runs the TCP listener on localhost and the serial listener over a pty pair, each in
+**  a child process against a simulated device, and drives them through
+**  LinxRemoteDevice.  Checks the cached device description, each peripheral, batches,
+**  async futures, error reporting and closing.  Also prints the time per read for a run
+**  of pipelined reads and for the same reads one at a time.
+**  Returns the number of failed checks.
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "LinxDevice.h"
+#include "LinxSimDevice.h"
+#include "LinxRemoteDevice.h"
+#include "LinxSerialListener.h"
+#include "LinxLinuxTcpListener.h"
+#include "utility/LinxBitPack.h"
+#include "../LinxTestCheck.h"
+
+#define SERIAL_CHAN 0
+#define UART_CHAN 1
+#define I2C_ADDRESS 0x50
+#define AI_TICKS 1000
+#define NUM_INPUTS 8
+#define FIRST_INPUT 8
+#define NUM_BATCH 100
+#define NUM_ASYNC 48
+#define NUM_TIMED 2000
+#define NUM_TIMED_RUNS 5
+
+static const unsigned char Inputs[NUM_INPUTS] = {1, 0, 1, 1, 0, 0, 1, 0};
+
+unsigned long long monotonicNs()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+//Child Side Device With Known Inputs, A Constant AI Channel And An I2C Register File
+LinxSimDevice* newRemoteDevice(LinxSimSlave* slave)
+{
+	LinxSimDevice* dev = new LinxSimDevice();
+	for(int i=0; i<NUM_INPUTS; i++)
+	{
+		dev->SetDigitalInput(FIRST_INPUT + i, Inputs[i]);
+	}
+	dev->SetAnalogWaveform(0, SIM_WAVE_CONSTANT, AI_TICKS, 0, 0);
+	dev->AttachI2cSlave(0, I2C_ADDRESS, slave);
+	return dev;
+}
+
+void stopListener(pid_t listener)
+{
+	kill(listener, SIGKILL);
+	waitpid(listener, NULL, 0);
+}
+
+//------------------------------------- Common Checks -------------------------------------
+void checkDescription(LinxRemoteDevice* remote, const char* transport)
+{
+	char name[128];
+	snprintf(name, sizeof(name), "%s: device id, name and api version", transport);
+	check(remote->DeviceFamily == 0xFE && remote->DeviceId == 0x01 && remote->DeviceNameLen == DEVICE_NAME_LEN && strcmp((const char*)remote->DeviceName, "Simulated Device") == 0 && remote->LinxApiMajor == 2 && remote->LinxApiMinor == 2, name);
+
+	snprintf(name, sizeof(name), "%s: channel lists", transport);
+	check(remote->NumDigitalChans == NUM_DIGITAL_CHANS && remote->DigitalChans[31] == 31 && remote->NumAiChans == NUM_AI_CHANS && remote->NumPwmChans == NUM_PWM_CHANS && remote->PwmChans[0] == 3 && remote->NumSpiChans == NUM_SPI_CHANS && remote->NumI2cChans == NUM_I2C_CHANS && remote->NumUartChans == NUM_UART_CHANS && remote->NumServoChans == NUM_SERVO_CHANS && remote->NumAoChans == 0, name);
+
+	snprintf(name, sizeof(name), "%s: uart max baud, ai resolution and reference", transport);
+	check(remote->UartMaxBaud == UART_MAX_BAUD && remote->AiResolution == AI_RES_BITS && remote->AiRefSet == AI_REFV, name);
+
+	//The Description Is Cached, Reading It Sends Nothing
+	unsigned long numRequests = remote->NumRequests;
+	volatile unsigned char numChans = remote->NumDigitalChans;
+	(void)numChans;
+	snprintf(name, sizeof(name), "%s: description is cached", transport);
+	check(remote->NumRequests == numRequests, name);
+}
+
+void checkPeripherals(LinxRemoteDevice* remote, const char* transport)
+{
+	char name[128];
+	unsigned char channels[NUM_INPUTS];
+	for(int i=0; i<NUM_INPUTS; i++)
+	{
+		channels[i] = FIRST_INPUT + i;
+	}
+
+	//DIO
+	unsigned char bits[NUM_INPUTS];
+	unsigned char packed[1];
+	unsigned char expected[1];
+	LinxBitPack::PackBits(NUM_INPUTS, Inputs, expected);
+	snprintf(name, sizeof(name), "%s: digital read", transport);
+	check(remote->DigitalReadNoPacking(NUM_INPUTS, channels, bits) == L_OK && memcmp(bits, Inputs, NUM_INPUTS) == 0 && remote->DigitalRead(NUM_INPUTS, channels, packed) == L_OK && packed[0] == expected[0], name);
+
+	unsigned char outChans[3] = {2, 3, 4};
+	unsigned char outValues[3] = {1, 0, 1};
+	unsigned char badChan[1] = {NUM_DIGITAL_CHANS + 8};
+	snprintf(name, sizeof(name), "%s: digital write and device errors", transport);
+	check(remote->DigitalWriteNoPacking(3, outChans, outValues) == L_OK && remote->DigitalWriteNoPacking(1, badChan, outValues) == LDIGITAL_PIN_DNE, name);
+
+	//AI
+	unsigned char aiChans[2] = {0, 0};
+	unsigned long ticks[2] = {0, 0};
+	snprintf(name, sizeof(name), "%s: analog read", transport);
+	check(remote->AnalogReadNoPacking(2, aiChans, ticks) == L_OK && ticks[0] == AI_TICKS && ticks[1] == AI_TICKS, name);
+
+	//SPI Loops MOSI Back To MISO
+	unsigned long actual = 0;
+	unsigned char mosi[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+	unsigned char miso[8];
+	memset(miso, 0, sizeof(miso));
+	snprintf(name, sizeof(name), "%s: spi write read", transport);
+	check(remote->SpiOpenMaster(0) == L_OK && remote->SpiSetSpeed(0, 1000000, &actual) == L_OK && actual == 1000000 && remote->SpiWriteRead(0, 1, 8, 10, 0, mosi, miso) == L_OK && memcmp(mosi, miso, 8) == 0, name);
+
+	unsigned char first[4];
+	unsigned char last[2] = {0xAA, 0xAA};
+	LinxSpiSegment segments[3];
+	memset(segments, 0, sizeof(segments));
+	segments[0].type = SPI_SEGMENT_FULL_DUPLEX;
+	segments[0].numBytes = 4;
+	segments[0].sendBuffer = mosi;
+	segments[0].recBuffer = first;
+	segments[1].type = SPI_SEGMENT_TX_ONLY;
+	segments[1].numBytes = 3;
+	segments[1].sendBuffer = mosi;
+	segments[2].type = SPI_SEGMENT_RX_ONLY;
+	segments[2].numBytes = 2;
+	segments[2].recBuffer = last;
+	snprintf(name, sizeof(name), "%s: spi transaction", transport);
+	check(remote->SpiTransaction(0, 10, 0, 3, segments) == L_OK && memcmp(first, mosi, 4) == 0 && last[0] == 0 && last[1] == 0, name);
+
+	//I2C Register File
+	unsigned char reg[3] = {0x10, 0xDE, 0xAD};
+	unsigned char readBack[2] = {0, 0};
+	snprintf(name, sizeof(name), "%s: i2c write then write read", transport);
+	check(remote->I2cOpenMaster(0) == L_OK && remote->I2cWrite(0, I2C_ADDRESS, EOF_STOP, 3, reg) == L_OK && remote->I2cWriteRead(0, I2C_ADDRESS, 1, reg, 2, 100, readBack) == L_OK && readBack[0] == 0xDE && readBack[1] == 0xAD, name);
+
+	//UART Loopback
+	unsigned char text[4] = {'L', 'I', 'N', 'X'};
+	unsigned char received[8];
+	unsigned long numRead = 0;
+	unsigned long long timestamp = 0;
+	snprintf(name, sizeof(name), "%s: uart write and read with timeout", transport);
+	check(remote->UartOpen(UART_CHAN, 115200, &actual) == L_OK && actual == 115200 && remote->UartWrite(UART_CHAN, 4, text) == L_OK && remote->UartReadTimeout(UART_CHAN, 4, 100, received, &numRead, &timestamp) == L_OK && numRead == 4 && memcmp(received, text, 4) == 0, name);
+
+	//Servo And Time
+	unsigned short widths[2] = {1000, 2000};
+	snprintf(name, sizeof(name), "%s: servo pulse width", transport);
+	check(remote->ServoOpen(2, outChans) == L_OK && remote->ServoSetPulseWidth(2, outChans, widths) == L_OK, name);
+
+	unsigned long long before = remote->GetMicroSeconds();
+	unsigned long long after = remote->GetMicroSeconds();
+	snprintf(name, sizeof(name), "%s: device time", transport);
+	check(before > 0 && after >= before, name);
+
+	//Generic Command
+	unsigned char response[8];
+	unsigned char numBytesRead = 0;
+	snprintf(name, sizeof(name), "%s: raw command", transport);
+	check(remote->Command(0x0003, NULL, 0, response, sizeof(response), &numBytesRead) == L_OK && numBytesRead == 2 && response[0] == 0xFE, name);
+}
+
+void checkPipelining(LinxRemoteDevice* remote, const char* transport)
+{
+	char name[128];
+	unsigned char channels[NUM_INPUTS];
+	for(int i=0; i<NUM_INPUTS; i++)
+	{
+		channels[i] = FIRST_INPUT + i;
+	}
+	unsigned char expected[1];
+	LinxBitPack::PackBits(NUM_INPUTS, Inputs, expected);
+
+	//Batches Only Report The First Failure
+	unsigned char outChans[2] = {2, 3};
+	unsigned char badChan[1] = {NUM_DIGITAL_CHANS + 8};
+	unsigned char value[1] = {0x01};
+	unsigned long numRequests = remote->NumRequests;
+	remote->BeginBatch();
+	bool allQueued = true;
+	for(int i=0; i<NUM_BATCH; i++)
+	{
+		value[0] = i & 0x03;
+		allQueued = allQueued && (remote->DigitalWrite(2, outChans, value) == L_OK);
+	}
+	snprintf(name, sizeof(name), "%s: batch", transport);
+	check(allQueued && remote->EndBatch() == L_OK && remote->NumRequests - numRequests == NUM_BATCH, name);
+
+	remote->BeginBatch();
+	remote->DigitalWrite(2, outChans, value);
+	remote->DigitalWrite(1, badChan, value);
+	remote->DigitalWrite(2, outChans, value);
+	snprintf(name, sizeof(name), "%s: batch reports failures", transport);
+	check(remote->EndBatch() == LDIGITAL_PIN_DNE && remote->Sync() == L_OK, name);
+
+	//Futures Complete In Any Order They Are Waited On
+	LinxRemoteFuture futures[NUM_ASYNC];
+	unsigned char values[NUM_ASYNC];
+	memset(values, 0, sizeof(values));
+	bool submitted = true;
+	for(int i=0; i<NUM_ASYNC; i++)
+	{
+		submitted = submitted && (remote->DigitalReadAsync(NUM_INPUTS, channels, &values[i], &futures[i]) == L_OK);
+	}
+	bool allRead = submitted;
+	for(int i=NUM_ASYNC-1; i>=0; i--)
+	{
+		allRead = allRead && futures[i].Wait() == L_OK && futures[i].NumBytes == 1 && values[i] == expected[0];
+	}
+	snprintf(name, sizeof(name), "%s: async reads", transport);
+	check(allRead, name);
+
+	LinxRemoteFuture ready;
+	unsigned char aiChan[1] = {0};
+	unsigned char aiPacked[4];
+	remote->AnalogReadAsync(1, aiChan, aiPacked, &ready);
+	unsigned long long deadline = monotonicNs() + 1000000000ULL;
+	while(!ready.Ready() && monotonicNs() < deadline)
+	{
+		usleep(100);
+	}
+	unsigned long aiTicks = 0;
+	LinxBitPack::Unpack(1, aiPacked, AI_RES_BITS, &aiTicks);
+	snprintf(name, sizeof(name), "%s: polled future", transport);
+	check(ready.Done && ready.Status == L_OK && aiTicks == AI_TICKS, name);
+
+	LinxRemoteFuture fireAndForget;
+	unsigned char tooMany[255];
+	memset(tooMany, 0, sizeof(tooMany));
+	snprintf(name, sizeof(name), "%s: oversized requests are refused", transport);
+	check(remote->DigitalWriteAsync(255, tooMany, tooMany, &fireAndForget) == L_UNKNOWN_ERROR && fireAndForget.Done && fireAndForget.Wait() == L_UNKNOWN_ERROR, name);
+
+	//Same Reads One At A Time, Then Pipelined.  Best Of NUM_TIMED_RUNS Runs, Single Runs Are Noisy On A Shared Host.
+	unsigned char packed[1];
+	LinxRemoteFuture timed[REMOTE_MAX_REQUESTS];
+	unsigned char timedValues[REMOTE_MAX_REQUESTS];
+	unsigned long long sequential = 0;
+	unsigned long long pipelined = 0;
+	bool allMatch = true;
+	for(int run=0; run<NUM_TIMED_RUNS; run++)
+	{
+		unsigned long long start = monotonicNs();
+		for(int i=0; i<NUM_TIMED; i++)
+		{
+			remote->DigitalRead(NUM_INPUTS, channels, packed);
+		}
+		unsigned long long elapsed = monotonicNs() - start;
+		sequential = (run == 0 || elapsed < sequential) ? elapsed : sequential;
+
+		start = monotonicNs();
+		for(int i=0; i<NUM_TIMED; i++)
+		{
+			//Reusing A Slot Means Waiting For The Request That Last Used It
+			int slot = i % REMOTE_MAX_REQUESTS;
+			timed[slot].Wait();
+			remote->DigitalReadAsync(NUM_INPUTS, channels, &timedValues[slot], &timed[slot]);
+		}
+		int status = remote->Sync();
+		elapsed = monotonicNs() - start;
+		pipelined = (run == 0 || elapsed < pipelined) ? elapsed : pipelined;
+
+		allMatch = allMatch && (status == L_OK);
+		for(int i=0; i<REMOTE_MAX_REQUESTS; i++)
+		{
+			allMatch = allMatch && timed[i].Status == L_OK && timedValues[i] == expected[0];
+		}
+	}
+	snprintf(name, sizeof(name), "%s: pipelined reads", transport);
+	check(allMatch, name);
+	fprintf(stdout, "INFO  %s window %u: one at a time %.1f uS / read, pipelined %.1f uS / read (%.1fx)\n", transport, remote->MaxInFlight, (double)sequential / NUM_TIMED / 1000.0, (double)pipelined / NUM_TIMED / 1000.0, (double)sequential / pipelined);
+}
+
+void checkClose(LinxRemoteDevice* remote, const char* transport)
+{
+	char name[128];
+	unsigned char chan[1] = {FIRST_INPUT};
+	unsigned char packed[1];
+	snprintf(name, sizeof(name), "%s: close", transport);
+	check(remote->Close() == L_OK && !remote->IsConnected() && remote->DigitalRead(1, chan, packed) == L_DISCONNECT, name);
+}
+
+//------------------------------------- TCP -------------------------------------
+unsigned short freePort()
+{
+	int probe = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	bind(probe, (struct sockaddr*)&address, sizeof(address));
+	socklen_t length = sizeof(address);
+	getsockname(probe, (struct sockaddr*)&address, &length);
+	close(probe);
+	return ntohs(address.sin_port);
+}
+
+void testTcp()
+{
+	unsigned short port = freePort();
+	pid_t listener = fork();
+	if(listener == 0)
+	{
+		LinxSimSlave slave;
+		LinxSimDevice* dev = newRemoteDevice(&slave);
+		if(LinxTcpConnection.Start(dev, port) != 0)
+		{
+			_exit(1);
+		}
+		while(1)
+		{
+			LinxTcpConnection.CheckForCommands();
+		}
+	}
+
+	//Connect Once The Child Is Listening
+	LinxRemoteDevice remote;
+	int status = L_UNKNOWN_ERROR;
+	for(int attempts=0; attempts<200 && status != L_OK; attempts++)
+	{
+		status = remote.ConnectTcp("localhost", port);
+		if(status != L_OK)
+		{
+			usleep(10000);
+		}
+	}
+	check(status == L_OK && remote.IsConnected(), "tcp: connect");
+	if(status == L_OK)
+	{
+		checkDescription(&remote, "tcp");
+		checkPeripherals(&remote, "tcp");
+		checkPipelining(&remote, "tcp");
+		checkClose(&remote, "tcp");
+
+		//The Listener Goes Back To Accepting Connections After A Disconnect
+		check(remote.ConnectTcp("localhost", port) == L_OK && remote.NumDigitalChans == NUM_DIGITAL_CHANS && remote.Close() == L_OK, "tcp: reconnect");
+	}
+	stopListener(listener);
+}
+
+//------------------------------------- Serial -------------------------------------
+void makeRaw(int fd)
+{
+	struct termios options;
+	tcgetattr(fd, &options);
+	cfmakeraw(&options);
+	tcsetattr(fd, TCSANOW, &options);
+}
+
+void testSerial()
+{
+	int masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+	if(masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0)
+	{
+		check(false, "serial: open a pty");
+		return;
+	}
+	makeRaw(masterFd);
+
+	//Held Open So The Listener Never Sees The pty Hang Up
+	char path[128];
+	snprintf(path, sizeof(path), "%s", ptsname(masterFd));
+	int holdFd = open(path, O_RDWR | O_NOCTTY);
+
+	pid_t listener = fork();
+	if(listener == 0)
+	{
+		close(holdFd);
+		fcntl(masterFd, F_SETFL, O_NONBLOCK);
+		LinxSimSlave slave;
+		LinxSimDevice* dev = newRemoteDevice(&slave);
+		dev->UartAttach(SERIAL_CHAN, masterFd);
+		LinxSerialConnection.Start(dev, SERIAL_CHAN);
+		while(1)
+		{
+			LinxSerialConnection.CheckForCommands();
+		}
+	}
+	close(masterFd);
+
+	LinxRemoteDevice remote;
+	int status = remote.ConnectSerial(path, 115200);
+	check(status == L_OK && remote.IsConnected() && remote.MaxInFlight == REMOTE_SERIAL_WINDOW, "serial: connect");
+	if(status == L_OK)
+	{
+		checkDescription(&remote, "serial");
+		checkPeripherals(&remote, "serial");
+
+		//The Linux Serial Listener Reads From A Kernel Buffer, So It Can Take More Than One Packet At Once
+		remote.MaxInFlight = 8;
+		checkPipelining(&remote, "serial");
+		checkClose(&remote, "serial");
+	}
+	close(holdFd);
+	stopListener(listener);
+}
+
+int main()
+{
+	fprintf(stdout, "\r\n.: Remote Device Test :.\r\n\r\n");
+
+	//Writes To A Listener That Went Away Should Fail, Not Kill The Test
+	signal(SIGPIPE, SIG_IGN);
+
+	testTcp();
+	testSerial();
+
+	return checkSummary();
+}
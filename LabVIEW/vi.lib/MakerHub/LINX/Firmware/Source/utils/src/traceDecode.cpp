@@ -0,0 +1,172 @@
+/****************************************************************************************
+**  Decoder for LINX listener trace dumps.
+**
+**  Reads the binary file a listener writes when it gets SIGUSR2 (TRACE_DUMP_PATH,
+**  /tmp/linx_trace.bin by default) and prints one event per line with its time since the
+**  first event and since the previous one.  Handler end and response lines also show
+**  how long the handler ran and how long the packet took from arriving to being answered.
+**
+**  Usage: traceDecode.out [-j] [File]    -j Prints JSON lines instead, File Defaults To stdin
+**
+** BSD2 License.
+****************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "utility/LinxTrace.h"
+
+static const char* TypeNames[TRACE_NUM_TYPES] = {"rx", "handler_start", "handler_end", "tx", "drop", "state", "passthrough_rx", "passthrough_tx", "user"};
+static const char* DropNames[] = {"bad_sof", "checksum", "timeout"};
+static const char* StateNames[] = {"START", "LISTENING", "AVAILABLE", "ACCEPT", "CONNECTED", "CLOSE", "EXIT"};
+
+const char* typeName(unsigned char type)
+{
+	return (type < TRACE_NUM_TYPES) ? TypeNames[type] : "unknown";
+}
+
+const char* dropName(unsigned char reason)
+{
+	return (reason < sizeof(DropNames) / sizeof(DropNames[0])) ? DropNames[reason] : "unknown";
+}
+
+const char* stateName(unsigned long state)
+{
+	return (state < sizeof(StateNames) / sizeof(StateNames[0])) ? StateNames[state] : "unknown";
+}
+
+unsigned long readU32(const unsigned char* buffer)
+{
+	return ((unsigned long)buffer[0] << 24) | ((unsigned long)buffer[1] << 16) | ((unsigned long)buffer[2] << 8) | buffer[3];
+}
+
+int main(int argc, char** argv)
+{
+	bool json = false;
+	const char* path = NULL;
+	for(int i=1; i<argc; i++)
+	{
+		if(strcmp(argv[i], "-j") == 0)
+		{
+			json = true;
+		}
+		else
+		{
+			path = argv[i];
+		}
+	}
+
+	FILE* file = (path != NULL) ? fopen(path, "rb") : stdin;
+	if(file == NULL)
+	{
+		fprintf(stderr, "Usage: %s [-j] [File]\nFailed to open %s\n", argv[0], path);
+		return -1;
+	}
+
+	unsigned char header[TRACE_FILE_HEADER_SIZE];
+	if(fread(header, 1, sizeof(header), file) != sizeof(header) || readU32(header) != TRACE_FILE_MAGIC)
+	{
+		fprintf(stderr, "Not a LINX trace dump\n");
+		return -1;
+	}
+	unsigned long version = readU32(header + 4) >> 16;
+	unsigned long eventSize = readU32(header + 4) & 0xFFFF;
+	unsigned long sequence = readU32(header + 8);
+	unsigned long count = readU32(header + 12);
+	if(version != TRACE_FILE_VERSION || eventSize != TRACE_EVENT_SIZE)
+	{
+		fprintf(stderr, "Unsupported trace version %lu with %lu byte events\n", version, eventSize);
+		return -1;
+	}
+	if(!json)
+	{
+		printf("# %lu events from sequence %lu\n", count, sequence);
+	}
+
+	//Pair Each Handler End With The Start Before It
+	unsigned long long firstTime = 0;
+	unsigned long long lastTime = 0;
+	unsigned long long handlerStart = 0;
+	unsigned long numEvents = 0;
+
+	unsigned char buffer[TRACE_EVENT_SIZE];
+	while(numEvents < count && fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer))
+	{
+		LinxTraceEvent event;
+		LinxTrace::DecodeEvent(buffer, &event);
+		if(numEvents == 0)
+		{
+			firstTime = event.time;
+			lastTime = event.time;
+		}
+
+		double sinceStart = (double)(long long)(event.time - firstTime) / 1000.0;
+		double sincePrevious = (double)(long long)(event.time - lastTime) / 1000.0;
+		char detail[128] = "";
+		char jsonDetail[128] = "";
+
+		switch(event.type)
+		{
+			case TRACE_PACKET_RX:
+				snprintf(detail, sizeof(detail), "cmd 0x%04X size %lu packet %lu", event.command, (unsigned long)(event.arg >> 16), (unsigned long)(event.arg & 0xFFFF));
+				snprintf(jsonDetail, sizeof(jsonDetail), ",\"command\":%u,\"size\":%lu,\"packet\":%lu", event.command, (unsigned long)(event.arg >> 16), (unsigned long)(event.arg & 0xFFFF));
+				break;
+			case TRACE_HANDLER_START:
+				handlerStart = event.time;
+				snprintf(detail, sizeof(detail), "cmd 0x%04X packet %lu", event.command, (unsigned long)event.arg);
+				snprintf(jsonDetail, sizeof(jsonDetail), ",\"command\":%u,\"packet\":%lu", event.command, (unsigned long)event.arg);
+				break;
+			case TRACE_HANDLER_END:
+			{
+				double took = (handlerStart != 0) ? (double)(event.time - handlerStart) / 1000.0 : -1;
+				snprintf(detail, sizeof(detail), "cmd 0x%04X status %u size %lu took %.3f us", event.command, event.status, (unsigned long)event.arg, took);
+				snprintf(jsonDetail, sizeof(jsonDetail), ",\"command\":%u,\"status\":%u,\"size\":%lu,\"took_us\":%.3f", event.command, event.status, (unsigned long)event.arg, took);
+				handlerStart = 0;
+				break;
+			}
+			case TRACE_PACKET_TX:
+				snprintf(detail, sizeof(detail), "cmd 0x%04X end to end %.3f us", event.command, (double)event.arg / 1000.0);
+				snprintf(jsonDetail, sizeof(jsonDetail), ",\"command\":%u,\"end_to_end_us\":%.3f", event.command, (double)event.arg / 1000.0);
+				break;
+			case TRACE_DROP:
+				snprintf(detail, sizeof(detail), "%s", dropName(event.status));
+				snprintf(jsonDetail, sizeof(jsonDetail), ",\"reason\":\"%s\"", dropName(event.status));
+				break;
+			case TRACE_STATE:
+				snprintf(detail, sizeof(detail), "%s -> %s", stateName(event.arg), stateName(event.status));
+				snprintf(jsonDetail, sizeof(jsonDetail), ",\"from\":\"%s\",\"to\":\"%s\"", stateName(event.arg), stateName(event.status));
+				break;
+			case TRACE_PASSTHROUGH_RX:
+			case TRACE_PASSTHROUGH_TX:
+				snprintf(detail, sizeof(detail), "chan %u bytes %lu%s", event.command, (unsigned long)event.arg, event.status ? " rejected" : "");
+				snprintf(jsonDetail, sizeof(jsonDetail), ",\"channel\":%u,\"bytes\":%lu,\"rejected\":%s", event.command, (unsigned long)event.arg, event.status ? "true" : "false");
+				break;
+			default:
+				snprintf(detail, sizeof(detail), "cmd 0x%04X status %u arg %lu", event.command, event.status, (unsigned long)event.arg);
+				snprintf(jsonDetail, sizeof(jsonDetail), ",\"command\":%u,\"status\":%u,\"arg\":%lu", event.command, event.status, (unsigned long)event.arg);
+				break;
+		}
+
+		if(json)
+		{
+			printf("{\"seq\":%lu,\"time_ns\":%llu,\"t_us\":%.3f,\"dt_us\":%.3f,\"event\":\"%s\"%s}\n", (sequence + numEvents) & 0xFFFFFFFFUL, (unsigned long long)event.time, sinceStart, sincePrevious, typeName(event.type), jsonDetail);
+		}
+		else
+		{
+			printf("%10lu %14.3f %+12.3f  %-15s %s\n", (sequence + numEvents) & 0xFFFFFFFFUL, sinceStart, sincePrevious, typeName(event.type), detail);
+		}
+
+		lastTime = event.time;
+		numEvents++;
+	}
+
+	if(numEvents < count)
+	{
+		fprintf(stderr, "Dump ends after %lu of %lu events\n", numEvents, count);
+	}
+	if(file != stdin)
+	{
+		fclose(file);
+	}
+	return 0;
+}